@@ -127,11 +127,10 @@ static void setupParserRules()
 
         return [=](const DeckPreviewWidget *deck, const ExtraDeckSearchInfo &) -> bool {
             int count = 0;
-            auto cardNodes = deck->deckLoader->getDeck().deckList.getCardNodes();
-            for (auto node : cardNodes) {
-                auto cardInfoPtr = CardDatabaseManager::query()->getCardInfo(node->getName());
+            for (const DeckMetadata::Card &card : deck->metadata.cards) {
+                auto cardInfoPtr = CardDatabaseManager::query()->getCardInfo(card.name);
                 if (!cardInfoPtr.isNull() && cardFilter.check(cardInfoPtr)) {
-                    count += node->getNumber();
+                    count += card.count;
                 }
             }
             return numberMatcher(count);
@@ -147,7 +146,7 @@ static void setupParserRules()
     search["DeckNameQuery"] = [](const peg::SemanticValues &sv) -> DeckFilter {
         auto name = std::any_cast<QString>(sv[0]);
         return [=](const DeckPreviewWidget *deck, const ExtraDeckSearchInfo &) {
-            return deck->deckLoader->getDeck().deckList.getName().contains(name, Qt::CaseInsensitive);
+            return deck->metadata.name.contains(name, Qt::CaseInsensitive);
         };
     };
 
@@ -169,16 +168,14 @@ static void setupParserRules()
     search["FormatQuery"] = [](const peg::SemanticValues &sv) -> DeckFilter {
         auto format = std::any_cast<QString>(sv[0]);
         return [=](const DeckPreviewWidget *deck, const ExtraDeckSearchInfo &) {
-            auto gameFormat = deck->deckLoader->getDeck().deckList.getGameFormat();
-            return QString::compare(format, gameFormat, Qt::CaseInsensitive) == 0;
+            return QString::compare(format, deck->metadata.gameFormat, Qt::CaseInsensitive) == 0;
         };
     };
 
     search["CommentQuery"] = [](const peg::SemanticValues &sv) -> DeckFilter {
         auto value = std::any_cast<QString>(sv[0]);
         return [=](const DeckPreviewWidget *deck, const ExtraDeckSearchInfo &) {
-            auto comments = deck->deckLoader->getDeck().deckList.getComments();
-            return comments.contains(value, Qt::CaseInsensitive);
+            return deck->metadata.comments.contains(value, Qt::CaseInsensitive);
         };
     };
 
@@ -135,7 +135,7 @@ void MessageLogWidget::logAttachCard(PlayerLogic *player,
 
 void MessageLogWidget::logConcede(int playerId)
 {
-    soundEngine->playSound("player_concede");
+    playSound("player_concede");
     appendHtmlServerMessage(
         tr("%1 has conceded the game.")
             .arg(sanitizeHtml(game->getPlayerManager()->getPlayer(playerId)->getPlayerInfo()->getName())),
@@ -144,7 +144,7 @@ void MessageLogWidget::logConcede(int playerId)
 
 void MessageLogWidget::logUnconcede(int playerId)
 {
-    soundEngine->playSound("player_concede");
+    playSound("player_concede");
     appendHtmlServerMessage(
         tr("%1 has unconceded the game.")
             .arg(sanitizeHtml(game->getPlayerManager()->getPlayer(playerId)->getPlayerInfo()->getName())),
@@ -154,11 +154,11 @@ void MessageLogWidget::logUnconcede(int playerId)
 void MessageLogWidget::logConnectionStateChanged(PlayerLogic *player, bool connectionState)
 {
     if (connectionState) {
-        soundEngine->playSound("player_reconnect");
+        playSound("player_reconnect");
         appendHtmlServerMessage(
             tr("%1 has restored connection to the game.").arg(sanitizeHtml(player->getPlayerInfo()->getName())), true);
     } else {
-        soundEngine->playSound("player_disconnect");
+        playSound("player_disconnect");
         appendHtmlServerMessage(
             tr("%1 has lost connection to the game.").arg(sanitizeHtml(player->getPlayerInfo()->getName())), true);
     }
@@ -303,7 +303,7 @@ void MessageLogWidget::logMoveCard(PlayerLogic *player,
     QString finalStr;
     std::optional<QString> fourthArg;
     if (targetZoneName == ZoneNames::TABLE) {
-        soundEngine->playSound("play_card");
+        playSound("play_card");
         if (card->getFaceDown()) {
             finalStr = tr("%1 puts %2 into play%3 face down.");
         } else {
@@ -338,7 +338,7 @@ void MessageLogWidget::logMoveCard(PlayerLogic *player,
     } else if (targetZoneName == ZoneNames::SIDEBOARD) {
         finalStr = tr("%1 moves %2%3 to sideboard.");
     } else if (targetZoneName == ZoneNames::STACK) {
-        soundEngine->playSound("play_card");
+        playSound("play_card");
         if (card->getFaceDown()) {
             finalStr = tr("%1 plays %2%3 face down.");
         } else {
@@ -364,7 +364,7 @@ void MessageLogWidget::logMoveCard(PlayerLogic *player,
 
 void MessageLogWidget::logDrawCards(PlayerLogic *player, int number, bool deckIsEmpty)
 {
-    soundEngine->playSound("draw_card");
+    playSound("draw_card");
     if (currentContext == MessageContext_Mulligan) {
         logMulligan(player, number);
     } else {
@@ -423,13 +423,13 @@ void MessageLogWidget::logGameFlooded()
 
 void MessageLogWidget::logJoin(PlayerLogic *player)
 {
-    soundEngine->playSound("player_join");
+    playSound("player_join");
     appendHtmlServerMessage(tr("%1 has joined the game.").arg(sanitizeHtml(player->getPlayerInfo()->getName())));
 }
 
 void MessageLogWidget::logJoinSpectator(QString name)
 {
-    soundEngine->playSound("spectator_join");
+    playSound("spectator_join");
     appendHtmlServerMessage(tr("%1 is now watching the game.").arg(sanitizeHtml(std::move(name))));
 }
 
@@ -440,7 +440,7 @@ void MessageLogWidget::logKicked()
 
 void MessageLogWidget::logLeave(PlayerLogic *player, QString reason)
 {
-    soundEngine->playSound("player_leave");
+    playSound("player_leave");
     appendHtmlServerMessage(tr("%1 has left the game (%2).")
                                 .arg(sanitizeHtml(player->getPlayerInfo()->getName()), sanitizeHtml(std::move(reason))),
                             true);
@@ -448,7 +448,7 @@ void MessageLogWidget::logLeave(PlayerLogic *player, QString reason)
 
 void MessageLogWidget::logLeaveSpectator(QString name, QString reason)
 {
-    soundEngine->playSound("spectator_leave");
+    playSound("spectator_leave");
     appendHtmlServerMessage(tr("%1 is not watching the game any more (%2).")
                                 .arg(sanitizeHtml(std::move(name)), sanitizeHtml(std::move(reason))));
 }
@@ -612,7 +612,7 @@ void MessageLogWidget::logRollDie(PlayerLogic *player, int sides, const QList<ui
                                         .arg("<font class=\"blue\">" + rollsStrings.join(", ") + "</font>"));
         }
     }
-    soundEngine->playSound("roll_dice");
+    playSound("roll_dice");
 }
 
 void MessageLogWidget::logSay(PlayerLogic *player, QString message)
@@ -624,7 +624,7 @@ void MessageLogWidget::logSetActivePhase(int phaseNumber)
 {
     Phase phase = Phases::getPhase(phaseNumber);
 
-    soundEngine->playSound(phase.soundFileName);
+    playSound(phase.soundFileName);
 
     appendHtml("<font color=\"" + phase.color + "\"><b>" + QDateTime::currentDateTime().toString("[hh:mm:ss] ") +
                phase.getName() + "</b></font>");
@@ -668,7 +668,7 @@ void MessageLogWidget::logSetCardCounter(PlayerLogic *player, QString cardName,
 void MessageLogWidget::logSetCounter(PlayerLogic *player, QString counterName, int value, int oldValue)
 {
     if (counterName == "life") {
-        soundEngine->playSound("life_change");
+        playSound("life_change");
     }
 
     QString counterDisplayName = TranslateCounterName::getDisplayName(counterName);
@@ -736,9 +736,9 @@ void MessageLogWidget::logSetTapped(PlayerLogic *player, CardItem *card, bool ta
     }
 
     if (tapped) {
-        soundEngine->playSound("tap_card");
+        playSound("tap_card");
     } else {
-        soundEngine->playSound("untap_card");
+        playSound("untap_card");
     }
 
     QString str;
@@ -758,7 +758,7 @@ void MessageLogWidget::logShuffle(PlayerLogic *player, CardZoneLogic *zone, int
         return;
     }
 
-    soundEngine->playSound("shuffle");
+    playSound("shuffle");
     // start and end are indexes into the portion of the deck that was shuffled
     // with negitive numbers counging from the bottom up.
     if (start == 0 && end == -1) {
@@ -820,6 +820,14 @@ void MessageLogWidget::setContextJudgeName(QString name)
     messageSuffix = QString("</span> [<img height=12 src=\"theme:icons/scales\"> %1]").arg(sanitizeHtml(name));
 }
 
+void MessageLogWidget::playSound(const QString &fileName)
+{
+    // the log of skipped replay events is only appended, the sounds would all play at once
+    if (!isBulkAppending()) {
+        soundEngine->playSound(fileName);
+    }
+}
+
 void MessageLogWidget::appendHtmlServerMessage(const QString &html, bool optionalIsBold, QString optionalFontColor)
 {
 
@@ -31,6 +31,7 @@ private:
     QString messagePrefix, messageSuffix;
 
     static QPair<QString, QString> getFromStr(CardZoneLogic *zone, QString cardName, int position, bool ownerChange);
+    void playSound(const QString &fileName);
 
 public:
     void connectToPlayerEventHandler(PlayerEventHandler *player);
@@ -2,6 +2,7 @@
 
 #include "../board/card_item.h"
 #include "view_zone.h"
+#include "zone_layout_scheduler.h"
 
 #include <QGraphicsSceneMouseEvent>
 #include <QMenu>
@@ -13,7 +14,9 @@ CardZone::CardZone(CardZoneLogic *_logic, QGraphicsItem *parent)
     connect(logic, &CardZoneLogic::cardAdded, this, &CardZone::onCardAdded);
     connect(logic, &CardZoneLogic::setGraphicsVisibility, this, [this](bool v) { this->setVisible(v); });
     connect(logic, &CardZoneLogic::updateGraphics, this, [this]() { update(); });
-    connect(logic, &CardZoneLogic::reorganizeCards, this, &CardZone::reorganizeCards);
+    // relayouts requested by the logic are coalesced, see ZoneLayoutScheduler
+    connect(logic, &CardZoneLogic::reorganizeCards, this,
+            [this]() { ZoneLayoutScheduler::instance().schedule(this); });
 }
 
 void CardZone::onCardAdded(CardItem *addedCard)
@@ -25,6 +25,8 @@ inline Q_LOGGING_CATEGORY(CardZoneLog, "card_zone");
 class CardZone : public AbstractGraphicsItem
 {
     Q_OBJECT
+    friend class ZoneLayoutScheduler;
+
 protected:
     QMenu *menu;
     QAction *doubleClickAction;
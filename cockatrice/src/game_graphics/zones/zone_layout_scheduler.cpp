@@ -0,0 +1,54 @@
+#include "zone_layout_scheduler.h"
+
+#include "card_zone.h"
+
+#include <utility>
+
+Q_GLOBAL_STATIC(ZoneLayoutScheduler, zoneLayoutScheduler)
+
+ZoneLayoutScheduler &ZoneLayoutScheduler::instance()
+{
+    return *zoneLayoutScheduler;
+}
+
+void ZoneLayoutScheduler::schedule(CardZone *zone)
+{
+    if (!dirtyZones.contains(zone)) {
+        dirtyZones.append(zone);
+    }
+
+    if (!flushQueued && suspendCount == 0) {
+        flushQueued = true;
+        QMetaObject::invokeMethod(this, &ZoneLayoutScheduler::flush, Qt::QueuedConnection);
+    }
+}
+
+void ZoneLayoutScheduler::suspend()
+{
+    ++suspendCount;
+}
+
+void ZoneLayoutScheduler::resume()
+{
+    if (suspendCount > 0 && --suspendCount == 0) {
+        flush();
+    }
+}
+
+void ZoneLayoutScheduler::flush()
+{
+    flushQueued = false;
+    if (suspendCount > 0) {
+        return;
+    }
+
+    // laying out a zone can dirty another one (e.g. attached cards), so keep going until nothing is left
+    while (!dirtyZones.isEmpty()) {
+        const QList<QPointer<CardZone>> zones = std::exchange(dirtyZones, {});
+        for (const auto &zone : zones) {
+            if (zone) {
+                zone->reorganizeCards();
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file zone_layout_scheduler.h
+ * @ingroup GameGraphicsZones
+ * @brief Coalesces card zone relayouts requested by the game logic.
+ */
+
+#ifndef ZONE_LAYOUT_SCHEDULER_H
+#define ZONE_LAYOUT_SCHEDULER_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+class CardZone;
+
+/**
+ * Every card added to, removed from or moved within a zone makes the zone logic request a relayout. Instead of
+ * repositioning every card of the zone each time, CardZone marks itself dirty here and each dirty zone is laid out
+ * once, either when the game event handler finished a container or on the next event loop iteration.
+ *
+ * While suspended (e.g. during a replay seek) dirty zones are only collected and get laid out when the last
+ * suspension ends.
+ */
+class ZoneLayoutScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    static ZoneLayoutScheduler &instance();
+
+    /**
+     * Suspends layout for its lifetime.
+     */
+    class SuspendGuard
+    {
+    public:
+        SuspendGuard()
+        {
+            ZoneLayoutScheduler::instance().suspend();
+        }
+        ~SuspendGuard()
+        {
+            ZoneLayoutScheduler::instance().resume();
+        }
+        SuspendGuard(const SuspendGuard &) = delete;
+        SuspendGuard &operator=(const SuspendGuard &) = delete;
+    };
+
+    void schedule(CardZone *zone);
+    void suspend();
+    void resume();
+
+public slots:
+    /**
+     * Lays out all dirty zones now, unless layout is suspended.
+     */
+    void flush();
+
+private:
+    QList<QPointer<CardZone>> dirtyZones;
+    bool flushQueued = false;
+    int suspendCount = 0;
+};
+
+#endif
@@ -47,6 +47,8 @@ CardPictureLoader::CardPictureLoader() : QObject(nullptr)
             &CardPictureLoaderStatusBar::addQueuedImageLoad);
     connect(worker, &CardPictureLoaderWorker::imageRequestSucceeded, statusBar,
             &CardPictureLoaderStatusBar::addSuccessfulImageLoad);
+    connect(worker, &CardPictureLoaderWorker::imageRequestCancelled, statusBar,
+            &CardPictureLoaderStatusBar::removeQueuedImageLoad);
 }
 
 CardPictureLoader::~CardPictureLoader()
@@ -117,18 +119,18 @@ void CardPictureLoader::getCardBackLoadingFailedPixmap(QPixmap &pixmap, QSize si
     }
 }
 
-void CardPictureLoader::getPixmap(QPixmap &pixmap, const ExactCard &card, QSize size)
+bool CardPictureLoader::getPixmap(QPixmap &pixmap, const ExactCard &card, QSize size)
 {
     if (!card) {
         qCWarning(CardPictureLoaderLog) << "getPixmap called with null card!";
-        return;
+        return true;
     }
 
     QString key = card.getPixmapCacheKey();
     QString sizeKey = key + QLatin1Char('_') + QString::number(size.width()) + "x" + QString::number(size.height());
 
     if (QPixmapCache::find(sizeKey, &pixmap)) {
-        return; // Use cached version
+        return true; // Use cached version
     }
 
     // load the image and create a copy of the correct size
@@ -136,7 +138,7 @@ void CardPictureLoader::getPixmap(QPixmap &pixmap, const ExactCard &card, QSize
     if (QPixmapCache::find(key, &bigPixmap)) {
         if (bigPixmap.isNull()) {
             qCDebug(CardPictureLoaderLog) << "Cached pixmap for key" << key << "is NULL!";
-            return;
+            return true;
         }
 
         QScreen *screen = qApp->primaryScreen();
@@ -146,12 +148,13 @@ void CardPictureLoader::getPixmap(QPixmap &pixmap, const ExactCard &card, QSize
         pixmap = bigPixmap.scaled(size * dpr, Qt::KeepAspectRatio, Qt::SmoothTransformation);
         pixmap.setDevicePixelRatio(dpr);
         QPixmapCache::insert(sizeKey, pixmap);
-        return;
+        return true;
     }
 
     // add the card to the load queue
     qCDebug(CardPictureLoaderLog) << "Enqueuing " << card.getName() << " for " << card.getPixmapCacheKey();
     getInstance().worker->enqueueImageLoad(card);
+    return false;
 }
 
 void CardPictureLoader::imageLoaded(const ExactCard &card, const QImage &image)
@@ -297,7 +300,7 @@ void CardPictureLoader::cacheCardPixmaps(const QList<ExactCard> &cards)
             continue;
         }
 
-        getInstance().worker->enqueueImageLoad(card);
+        getInstance().worker->enqueueImageLoad(card, true);
     }
 }
 
@@ -63,8 +63,10 @@ public:
      * @param pixmap Reference to QPixmap where result will be stored.
      * @param card ExactCard to load.
      * @param size Desired size of pixmap.
+     * @return false if the image is still being loaded. Calling this again while it is marks the card as still
+     * being shown, which moves its download up the queue.
      */
-    static void getPixmap(QPixmap &pixmap, const ExactCard &card, QSize size);
+    static bool getPixmap(QPixmap &pixmap, const ExactCard &card, QSize size);
 
     /**
      * @brief Retrieve a generic card back pixmap.
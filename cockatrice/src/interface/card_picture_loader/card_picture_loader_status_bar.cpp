@@ -54,4 +54,15 @@ void CardPictureLoaderStatusBar::addSuccessfulImageLoad(const QUrl &url)
             statusDisplayWidget->setFinished();
         }
     }
-}
\ No newline at end of file
+}
+void CardPictureLoaderStatusBar::removeQueuedImageLoad(const QUrl &url)
+{
+    for (CardPictureLoaderRequestStatusDisplayWidget *statusDisplayWidget :
+         loadLog->popup->findChildren<CardPictureLoaderRequestStatusDisplayWidget *>()) {
+        if (!statusDisplayWidget->getFinished() && statusDisplayWidget->getUrl() == url.toString()) {
+            loadLog->removeSettingsWidget(statusDisplayWidget);
+            progressBar->setMaximum(progressBar->maximum() - 1);
+            return;
+        }
+    }
+}
@@ -44,6 +44,12 @@ public slots:
      */
     void addSuccessfulImageLoad(const QUrl &url);
 
+    /**
+     * @brief Removes the log entry of a queued image load that was cancelled before it started.
+     * @param url URL of the cancelled request
+     */
+    void removeQueuedImageLoad(const QUrl &url);
+
     /**
      * @brief Cleans up old entries from the log that have finished more than 10 seconds ago.
      *        Adjusts the progress bar accordingly.
@@ -16,11 +16,17 @@
 #include <utility>
 #include <version_string.h>
 
-static constexpr int MAX_REQUESTS_PER_SEC = 10;
+// rate limit and burst of each host, unless the host has its own entry in HOST_REQUEST_LIMITS
+static constexpr DownloadScheduler::HostLimit DEFAULT_REQUEST_LIMIT = {10, 10};
+
+// the scryfall api redirects image requests to its image host, which is not rate limited like the api itself
+static const QList<QPair<QString, DownloadScheduler::HostLimit>> HOST_REQUEST_LIMITS = {
+    {"cards.scryfall.io", {20, 20}},
+};
 
 CardPictureLoaderWorker::CardPictureLoaderWorker()
     : QObject(nullptr), picDownload(SettingsCache::instance().personal().getPicDownload()),
-      requestQuota(MAX_REQUESTS_PER_SEC)
+      scheduler(DEFAULT_REQUEST_LIMIT)
 {
     networkManager = new QNetworkAccessManager(this);
     // We need a timeout to ensure requests don't hang indefinitely in case of
@@ -54,15 +60,19 @@ CardPictureLoaderWorker::CardPictureLoaderWorker()
 
     localLoader = new CardPictureLoaderLocal(this);
 
+    for (const auto &hostLimit : HOST_REQUEST_LIMITS) {
+        scheduler.setHostLimit(hostLimit.first, hostLimit.second);
+    }
+    clock.start();
+    requestTimer = new QTimer(this);
+    requestTimer->setSingleShot(true);
+    connect(requestTimer, &QTimer::timeout, this, &CardPictureLoaderWorker::processQueuedRequests);
+
     pictureLoaderThread = new QThread;
     pictureLoaderThread->start(QThread::LowPriority);
     moveToThread(pictureLoaderThread);
 
     connect(this, &CardPictureLoaderWorker::imageLoadEnqueued, this, &CardPictureLoaderWorker::handleImageLoadEnqueued);
-
-    connect(&requestTimer, &QTimer::timeout, this, &CardPictureLoaderWorker::resetRequestQuota);
-    requestTimer.setInterval(1000);
-    requestTimer.start();
 }
 
 CardPictureLoaderWorker::~CardPictureLoaderWorker()
@@ -87,8 +97,10 @@ void CardPictureLoaderWorker::queueRequest(const QUrl &url, CardPictureLoaderWor
         makeRequest(url, worker);
         return;
     }
-    requestLoadQueue.append(qMakePair(url, worker));
-    emit imageRequestQueued(url, worker->cardToDownload.getCard(), worker->cardToDownload.getSetName());
+    // a url that is already queued or downloading gets no second request, the work waits for the first one
+    if (scheduler.request(url, reinterpret_cast<quintptr>(worker), clock.elapsed())) {
+        emit imageRequestQueued(url, worker->cardToDownload.getCard(), worker->cardToDownload.getSetName());
+    }
     processQueuedRequests();
 }
 
@@ -121,44 +133,80 @@ QNetworkReply *CardPictureLoaderWorker::makeRequest(const QUrl &url, CardPicture
     return reply;
 }
 
-void CardPictureLoaderWorker::resetRequestQuota()
+void CardPictureLoaderWorker::processQueuedRequests()
 {
-    requestQuota = MAX_REQUESTS_PER_SEC;
-    processQueuedRequests();
+    if (requestTimer->isActive() && requestTimer->remainingTime() > 0) {
+        // the queue is drained by the pending pass; enqueueing is frequent and only touches the scheduler
+        return;
+    }
+
+    dropUnwantedRequests();
+
+    while (auto request = scheduler.takeNext(clock.elapsed())) {
+        startRequest(request->url, reinterpret_cast<CardPictureLoaderWorkerWork *>(request->consumer));
+    }
+
+    const qint64 wait = scheduler.msecsUntilNext(clock.elapsed());
+    if (wait >= 0) {
+        requestTimer->start(static_cast<int>(wait));
+    }
 }
 
-void CardPictureLoaderWorker::processQueuedRequests()
+void CardPictureLoaderWorker::startRequest(const QUrl &url, CardPictureLoaderWorkerWork *work)
 {
-    while (requestQuota > 0 && processSingleRequest()) {
-        --requestQuota;
-    }
+    QNetworkReply *reply = makeRequest(url, work);
+
+    // connected after the work's own handler, so a work that asks for the same url again while handling the reply
+    // gets a request of its own
+    connect(reply, &QNetworkReply::finished, this, [this, url] {
+        const auto waiting = scheduler.finish(url);
+        for (const quintptr consumer : waiting) {
+            queueRequest(url, reinterpret_cast<CardPictureLoaderWorkerWork *>(consumer));
+        }
+    });
 }
 
-bool CardPictureLoaderWorker::processSingleRequest()
+void CardPictureLoaderWorker::dropUnwantedRequests()
 {
-    if (!requestLoadQueue.isEmpty()) {
-        auto request = requestLoadQueue.takeFirst();
-        makeRequest(request.first, request.second);
-        return true;
+    // requests seen within the last period are kept, their widget may not be connected to the card yet
+    const auto queued = scheduler.queuedConsumers(clock.elapsed() - DownloadScheduler::priorityPeriodMsecs);
+    for (const quintptr consumer : queued) {
+        auto *work = reinterpret_cast<CardPictureLoaderWorkerWork *>(consumer);
+        const ExactCard &card = work->cardToDownload.getCard();
+        const auto loading = currentlyLoading.constFind(card.getPixmapCacheKey());
+        if (loading == currentlyLoading.constEnd() || loading->preload || card.getCardPtr()->hasPixmapListeners()) {
+            continue;
+        }
+
+        qCDebug(CardPictureLoaderWorkerLog)
+            << "Dropping queued request for" << card.getName() << "because no widget shows it anymore";
+        currentlyLoading.erase(loading);
+        const QUrl droppedUrl = scheduler.cancel(consumer);
+        if (!droppedUrl.isEmpty()) {
+            emit imageRequestCancelled(droppedUrl);
+        }
+        work->deleteLater();
     }
-    return false;
 }
 
-void CardPictureLoaderWorker::enqueueImageLoad(const ExactCard &card)
+void CardPictureLoaderWorker::enqueueImageLoad(const ExactCard &card, bool preload)
 {
     // Send call through a connection to ensure the handling is run on the pictureLoader thread
-    emit imageLoadEnqueued(card);
+    emit imageLoadEnqueued(card, preload);
 }
 
-void CardPictureLoaderWorker::handleImageLoadEnqueued(const ExactCard &card)
+void CardPictureLoaderWorker::handleImageLoadEnqueued(const ExactCard &card, bool preload)
 {
-    // deduplicate loads for the same card
-    if (currentlyLoading.contains(card.getPixmapCacheKey())) {
-        qCDebug(CardPictureLoaderWorkerLog())
-            << "Skipping enqueued" << card.getName() << "because it's already being loaded";
+    // deduplicate loads for the same card, a repeated request means the card is still being shown
+    auto loading = currentlyLoading.find(card.getPixmapCacheKey());
+    if (loading != currentlyLoading.end()) {
+        loading->preload = loading->preload || preload;
+        if (loading->work) {
+            scheduler.touch(reinterpret_cast<quintptr>(loading->work), clock.elapsed());
+        }
         return;
     }
-    currentlyLoading.insert(card.getPixmapCacheKey());
+    currentlyLoading.insert(card.getPixmapCacheKey(), {nullptr, preload});
 
     // try to load image from local first
     QImage image = localLoader->tryLoad(card);
@@ -166,7 +214,13 @@ void CardPictureLoaderWorker::handleImageLoadEnqueued(const ExactCard &card)
         handleImageLoaded(card, image);
     } else {
         // queue up to load image from remote only after local loading failed
-        new CardPictureLoaderWorkerWork(this, card);
+        auto *work = new CardPictureLoaderWorkerWork(this, card);
+
+        // the work may already have given up while it was constructed
+        loading = currentlyLoading.find(card.getPixmapCacheKey());
+        if (loading != currentlyLoading.end()) {
+            loading->work = work;
+        }
     }
 }
 
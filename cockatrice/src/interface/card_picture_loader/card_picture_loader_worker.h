@@ -5,15 +5,16 @@
 #include "card_picture_loader_worker_work.h"
 #include "card_picture_to_load.h"
 
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QMutex>
 #include <QNetworkAccessManager>
 #include <QNetworkDiskCache>
 #include <QObject>
-#include <QQueue>
 #include <QTimer>
 #include <libcockatrice/card/card_info.h>
 #include <libcockatrice/card/database/card_database.h>
+#include <libcockatrice/utility/download_scheduler.h>
 
 #define REDIRECT_HEADER_NAME "redirects"
 #define REDIRECT_ORIGINAL_URL "original"
@@ -31,10 +32,11 @@ inline Q_LOGGING_CATEGORY(CardPictureLoaderWorkerLog, "card_picture_loader.worke
  * @brief Handles asynchronous loading of card images, both locally and via network.
  *
  * Responsibilities:
- * - Maintain a queue of network image requests with rate-limiting.
+ * - Schedule network image requests by how recently their cards were painted, rate-limited per host.
  * - Load images from local cache first via CardPictureLoaderLocal.
  * - Handle network redirects and persistent caching of redirects.
- * - Deduplicate simultaneous requests for the same card.
+ * - Deduplicate simultaneous requests for the same card and the same url.
+ * - Drop queued requests for cards nothing displays anymore.
  * - Emit signals for status updates and loaded images.
  */
 class CardPictureLoaderWorker : public QObject
@@ -54,10 +56,13 @@ public:
     /**
      * @brief Enqueues an ExactCard for loading.
      * @param card ExactCard to load
+     * @param preload Whether the image is loaded ahead of being displayed, which keeps the request even when no
+     * widget shows the card
      *
-     * This will first try to load the image locally; if that fails, it will enqueue a network request.
+     * This will first try to load the image locally; if that fails, it will enqueue a network request. Enqueueing a
+     * card that is already being loaded marks it as seen again, which moves its request up the queue.
      */
-    void enqueueImageLoad(const ExactCard &card);
+    void enqueueImageLoad(const ExactCard &card, bool preload = false);
 
     /**
      * @brief Queues a network request for a given URL and worker thread.
@@ -78,14 +83,12 @@ public slots:
      */
     QNetworkReply *makeRequest(const QUrl &url, CardPictureLoaderWorkerWork *workThread);
 
-    /** @brief Processes all queued requests respecting the request quota. */
-    void processQueuedRequests();
-
     /**
-     * @brief Processes a single queued request.
-     * @return true if a request was processed, false if queue is empty.
+     * @brief Starts as many queued requests as the per-host rate limits allow and schedules the next pass.
+     *
+     * Requests for cards that no widget listens to anymore are dropped first, unless they were preloads.
      */
-    bool processSingleRequest();
+    void processQueuedRequests();
 
     /**
      * @brief Handles an image that has finished loading.
@@ -108,13 +111,20 @@ private:
     QString cacheFilePath;                             ///< Path to persistent redirect cache file
     static constexpr int CacheTTLInDays = 30;          ///< Time-to-live for redirect cache entries (days)
     bool picDownload;                                  ///< Whether downloading images from network is enabled
-    QQueue<QPair<QUrl, CardPictureLoaderWorkerWork *>> requestLoadQueue; ///< Queue of pending network requests
 
-    int requestQuota;    ///< Remaining requests allowed per second
-    QTimer requestTimer; ///< Timer to reset the request quota
+    DownloadScheduler scheduler; ///< Pending network requests, consumers are the CardPictureLoaderWorkerWork
+    QElapsedTimer clock;         ///< Time base of the scheduler
+    QTimer *requestTimer;        ///< Single shot timer for the next pass over the queued requests
+
+    /** @brief A card whose image is being loaded. */
+    struct LoadingCard
+    {
+        CardPictureLoaderWorkerWork *work; ///< The work downloading the image, null while it is loaded locally
+        bool preload;                      ///< Whether the request is kept even if no widget shows the card
+    };
 
-    CardPictureLoaderLocal *localLoader; ///< Loader for local images
-    QSet<QString> currentlyLoading;      ///< Deduplication: contains pixmapCacheKey currently being loaded
+    CardPictureLoaderLocal *localLoader;          ///< Loader for local images
+    QHash<QString, LoadingCard> currentlyLoading; ///< Deduplication: cards being loaded by pixmapCacheKey
 
     /** @brief Returns cached redirect URL for the given original URL, if available. */
     [[nodiscard]] QUrl getCachedRedirect(const QUrl &originalUrl) const;
@@ -128,16 +138,19 @@ private:
     /** @brief Removes stale redirect entries older than TTL. */
     void cleanStaleEntries();
 
-private slots:
-    /** @brief Resets the request quota for rate-limiting. */
-    void resetRequestQuota();
+    /** @brief Cancels the queued requests of cards that are neither displayed nor preloaded. */
+    void dropUnwantedRequests();
+
+    /** @brief Starts a scheduled request and hands the url to the works that waited for it once it finishes. */
+    void startRequest(const QUrl &url, CardPictureLoaderWorkerWork *work);
 
+private slots:
     /** @brief Handles image load requests enqueued on this worker. */
-    void handleImageLoadEnqueued(const ExactCard &card);
+    void handleImageLoadEnqueued(const ExactCard &card, bool preload);
 
 signals:
     /** @brief Emitted when an image load is enqueued. */
-    void imageLoadEnqueued(const ExactCard &card);
+    void imageLoadEnqueued(const ExactCard &card, bool preload);
 
     /** @brief Emitted when an image has finished loading. */
     void imageLoaded(const ExactCard &card, const QImage &image);
@@ -147,6 +160,9 @@ signals:
 
     /** @brief Emitted when a network request successfully completes. */
     void imageRequestSucceeded(const QUrl &url);
+
+    /** @brief Emitted when a queued request is dropped because nothing displays its card anymore. */
+    void imageRequestCancelled(const QUrl &url);
 };
 
 #endif // PICTURE_LOADER_WORKER_H
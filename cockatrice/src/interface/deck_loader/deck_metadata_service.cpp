@@ -0,0 +1,308 @@
+#include "deck_metadata_service.h"
+
+#include "../../client/settings/cache_settings.h"
+#include "deck_loader.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrentRun>
+#include <utility>
+#include <libcockatrice/card/database/card_database_manager.h>
+
+static constexpr int SAVE_DELAY_MSECS = 5000;
+
+namespace
+{
+struct ParseResult
+{
+    bool valid = false;
+    DeckMetadata metadata;
+    QStringList colorCards; ///< Cards of the main deck and sideboard
+};
+} // namespace
+
+static QString normalizedPath(const QString &path)
+{
+    return QFileInfo(path).absoluteFilePath();
+}
+
+DeckMetadataService &DeckMetadataService::instance()
+{
+    // parented to the application, so it is around to save the index when the application quits
+    static DeckMetadataService *service = new DeckMetadataService(
+        SettingsCache::instance().getCachePath() + "/deck_metadata.idx", QCoreApplication::instance());
+    return *service;
+}
+
+DeckMetadataService::DeckMetadataService(const QString &indexFilePath, QObject *parent)
+    : QObject(parent), index(indexFilePath)
+{
+    if (index.load()) {
+        qCDebug(DeckMetadataServiceLog) << "Loaded" << index.size() << "deck metadata entries";
+    }
+
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this,
+            [this](const QString &directory) { scanDirectory(directory, true); });
+
+    saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(SAVE_DELAY_MSECS);
+    connect(saveTimer, &QTimer::timeout, this, &DeckMetadataService::save);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &DeckMetadataService::save);
+    }
+
+    connect(CardDatabaseManager::getInstance(), &CardDatabase::cardDatabaseLoadingFinished, this,
+            &DeckMetadataService::recomputeColorIdentities);
+    if (CardDatabaseManager::getInstance()->getLoadStatus() == LoadStatus::Ok) {
+        // entries left pending by an earlier session
+        recomputeColorIdentities();
+    }
+}
+
+const DeckMetadata *DeckMetadataService::find(const QString &filePath) const
+{
+    return index.find(QFileInfo(filePath));
+}
+
+void DeckMetadataService::refresh(const QString &filePath)
+{
+    const QString path = normalizedPath(filePath);
+    if (refreshing.contains(path)) {
+        return;
+    }
+    refreshing.insert(path);
+
+    auto *futureWatcher = new QFutureWatcher<ParseResult>(this);
+    connect(futureWatcher, &QFutureWatcher<ParseResult>::finished, this, [this, path, futureWatcher] {
+        futureWatcher->deleteLater();
+        refreshing.remove(path);
+
+        ParseResult result = futureWatcher->result();
+        if (!result.valid) {
+            return;
+        }
+
+        const QFileInfo file(path);
+        if (!result.metadata.matchesFile(file)) {
+            // written to while it was being parsed, unless the client wrote it and already stored the entry
+            if (!index.find(file)) {
+                refresh(path);
+            }
+            return;
+        }
+
+        setColorIdentity(path, result.metadata, result.colorCards);
+        store(path, result.metadata);
+        emit metadataChanged(path);
+    });
+
+    futureWatcher->setFuture(QtConcurrent::run([path] {
+        // the file is looked at before it is read, so a write during parsing makes the entry outdated, not wrong
+        DeckMetadata identity;
+        identity.setFile(QFileInfo(path));
+
+        ParseResult result;
+        std::optional<LoadedDeck> deck = DeckLoader::loadFromFile(path, DeckFileFormat::getFormatFromName(path), false);
+        if (!deck) {
+            return result;
+        }
+
+        result.valid = true;
+        result.metadata = DeckMetadata::fromDeckList(deck->deckList);
+        result.metadata.fileSize = identity.fileSize;
+        result.metadata.lastModified = identity.lastModified;
+        result.metadata.metadataChanged = identity.metadataChanged;
+        result.colorCards = deck->deckList.getCardList({DECK_ZONE_MAIN, DECK_ZONE_SIDE});
+        return result;
+    }));
+}
+
+DeckMetadata DeckMetadataService::update(const LoadedDeck &deck)
+{
+    const QString path = normalizedPath(deck.lastLoadInfo.fileName);
+
+    DeckMetadata metadata = DeckMetadata::fromDeckList(deck.deckList);
+    metadata.setFile(QFileInfo(path));
+    setColorIdentity(path, metadata, deck.deckList.getCardList({DECK_ZONE_MAIN, DECK_ZONE_SIDE}));
+    store(path, metadata);
+    return metadata;
+}
+
+void DeckMetadataService::store(const QString &filePath, const DeckMetadata &metadata)
+{
+    index.insert(filePath, metadata);
+    saveTimer->start();
+}
+
+void DeckMetadataService::watch(const QString &directory)
+{
+    const QString path = normalizedPath(directory);
+    if (watchedFiles.contains(path) || !QFileInfo(path).isDir()) {
+        return;
+    }
+
+    watcher->addPath(path);
+    scanDirectory(path, false);
+}
+
+QStringList DeckMetadataService::deckFilesIn(const QString &directory)
+{
+    QStringList files;
+    for (const QFileInfo &file : QDir(directory).entryInfoList(DeckLoader::ACCEPTED_FILE_EXTENSIONS, QDir::Files)) {
+        files << file.absoluteFilePath();
+    }
+    return files;
+}
+
+/**
+ * Compares the directory with how it looked at the last scan, and indexes the decks in it that are new or changed.
+ *
+ * @param directory The watched directory
+ * @param notify Whether to emit signals for the differences, false for the first scan
+ */
+void DeckMetadataService::scanDirectory(const QString &directory, bool notify)
+{
+    const QString path = normalizedPath(directory);
+    const QSet<QString> previousFiles = watchedFiles.value(path);
+
+    if (!QFileInfo(path).isDir()) {
+        // removed together with its files, the file system watcher already stopped watching it
+        watchedFiles.remove(path);
+        for (const QString &file : previousFiles) {
+            index.remove(file);
+            if (notify) {
+                emit fileRemoved(file);
+            }
+        }
+        saveTimer->start();
+        return;
+    }
+
+    const QStringList fileList = deckFilesIn(path);
+    QSet<QString> files(fileList.begin(), fileList.end());
+    watchedFiles.insert(path, files);
+
+    QStringList added;
+    for (const QString &file : fileList) {
+        if (!previousFiles.contains(file)) {
+            added << file;
+        }
+        if (!find(file)) {
+            refresh(file);
+        }
+    }
+
+    // also drops the entries of files that were deleted while the client was not running
+    index.removeMissing(path, fileList);
+    if (index.isDirty()) {
+        saveTimer->start();
+    }
+
+    if (notify) {
+        for (const QString &file : previousFiles) {
+            if (!files.contains(file)) {
+                emit fileRemoved(file);
+            }
+        }
+    }
+
+    for (const QFileInfo &subdir : QDir(path).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QString subdirPath = subdir.absoluteFilePath();
+        if (watchedFiles.contains(subdirPath)) {
+            continue;
+        }
+        if (notify) {
+            emit directoryAdded(subdirPath);
+        }
+        watcher->addPath(subdirPath);
+        scanDirectory(subdirPath, notify);
+    }
+
+    if (notify && !added.isEmpty()) {
+        emit filesAdded(path, added);
+    }
+}
+
+void DeckMetadataService::save()
+{
+    saveTimer->stop();
+    if (!index.save()) {
+        qCWarning(DeckMetadataServiceLog) << "Failed to write the deck metadata index";
+    }
+}
+
+/**
+ * Sets the color identity of the entry. If the card database is not loaded yet, the entry is marked as pending and the
+ * cards are kept to compute it again.
+ */
+void DeckMetadataService::setColorIdentity(const QString &filePath,
+                                           DeckMetadata &metadata,
+                                           const QStringList &colorCards)
+{
+    metadata.colorIdentity = computeColorIdentity(colorCards);
+    metadata.colorIdentityPending = CardDatabaseManager::getInstance()->getLoadStatus() != LoadStatus::Ok;
+    if (metadata.colorIdentityPending) {
+        colorCardsToRecompute.insert(filePath, colorCards);
+    } else {
+        colorCardsToRecompute.remove(filePath);
+    }
+}
+
+void DeckMetadataService::recomputeColorIdentities()
+{
+    const QHash<QString, QStringList> pending = std::exchange(colorCardsToRecompute, {});
+    for (const QString &filePath : index.filePaths()) {
+        // entries of files changed since are parsed again anyway
+        const DeckMetadata *entry = find(filePath);
+        if (!entry || !entry->colorIdentityPending) {
+            continue;
+        }
+
+        const auto cards = pending.constFind(filePath);
+        if (cards == pending.cend()) {
+            // left pending by an earlier session, the index does not know which cards are in the main deck
+            refresh(filePath);
+            continue;
+        }
+
+        DeckMetadata metadata = *entry;
+        setColorIdentity(filePath, metadata, *cards);
+        const bool changed = metadata.colorIdentity != entry->colorIdentity;
+        // stored either way, so the entry is no longer pending
+        store(filePath, metadata);
+        if (changed) {
+            emit metadataChanged(filePath);
+        }
+    }
+}
+
+QString DeckMetadataService::computeColorIdentity(const QStringList &cardNames)
+{
+    QSet<QChar> colorSet; // A set to collect unique color symbols (e.g., W, U, B, R, G)
+
+    for (const QString &cardName : cardNames) {
+        CardInfoPtr currentCard = CardDatabaseManager::query()->getCardInfo(cardName);
+        if (currentCard) {
+            for (const QChar &color : currentCard->getColors()) {
+                colorSet.insert(color);
+            }
+        }
+    }
+
+    // Ensure the color identity is in WUBRG order
+    QString colorIdentity;
+    const QString wubrgOrder = "WUBRG";
+    for (const QChar &color : wubrgOrder) {
+        if (colorSet.contains(color)) {
+            colorIdentity.append(color);
+        }
+    }
+
+    return colorIdentity;
+}
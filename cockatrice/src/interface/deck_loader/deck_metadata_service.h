@@ -0,0 +1,98 @@
+/**
+ * @file deck_metadata_service.h
+ * @ingroup ImportExport
+ * @brief Keeps the deck metadata index of the deck folders up to date.
+ */
+
+#ifndef DECK_METADATA_SERVICE_H
+#define DECK_METADATA_SERVICE_H
+
+#include "loaded_deck.h"
+
+#include <QHash>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <libcockatrice/deck_list/deck_metadata_index.h>
+
+inline Q_LOGGING_CATEGORY(DeckMetadataServiceLog, "deck_metadata_service");
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @class DeckMetadataService
+ * @brief Owns the DeckMetadataIndex of the client and parses deck files whose entry is missing or outdated.
+ *
+ * Parsing happens on the thread pool, one file at a time per path, and metadataChanged is emitted once the new entry is
+ * in the index. Watched directories are rescanned whenever the file system reports a change in them, which covers
+ * decks added, removed or saved by other programs while the client is running. The index is written to disk a few
+ * seconds after it changes and when the application quits. Color identities computed before the card database finished
+ * loading are marked as such in the index and computed again once it has, in a later session if need be.
+ */
+class DeckMetadataService : public QObject
+{
+    Q_OBJECT
+
+signals:
+    /** @brief The entry of the file was made or remade. */
+    void metadataChanged(const QString &filePath);
+    /** @brief Deck files appeared in a watched directory. */
+    void filesAdded(const QString &directory, const QStringList &filePaths);
+    /** @brief A deck file disappeared from a watched directory. */
+    void fileRemoved(const QString &filePath);
+    /** @brief A subdirectory appeared in a watched directory. */
+    void directoryAdded(const QString &directory);
+
+public:
+    static DeckMetadataService &instance();
+
+    explicit DeckMetadataService(const QString &indexFilePath, QObject *parent = nullptr);
+
+    /**
+     * @return The entry of the file, or nullptr if the file is not indexed yet or changed since it was.
+     */
+    [[nodiscard]] const DeckMetadata *find(const QString &filePath) const;
+
+    /**
+     * @brief Parses the file in the background and emits metadataChanged once its entry is updated.
+     * Does nothing if the file is already being parsed.
+     */
+    void refresh(const QString &filePath);
+
+    /**
+     * @brief Updates the entry of a deck the client just wrote to its file, without parsing the file again.
+     * @return The new entry
+     */
+    DeckMetadata update(const LoadedDeck &deck);
+
+    /**
+     * @brief Watches the directory and all its subdirectories, and indexes the decks in them that are not indexed yet.
+     */
+    void watch(const QString &directory);
+
+    /**
+     * @return The deck files in the directory, not including subdirectories.
+     */
+    static QStringList deckFilesIn(const QString &directory);
+
+private:
+    DeckMetadataIndex index;
+    QFileSystemWatcher *watcher;
+    QTimer *saveTimer;
+    QSet<QString> refreshing;                   ///< Files being parsed
+    QHash<QString, QSet<QString>> watchedFiles; ///< Deck files of each watched directory, as of the last scan
+    /// Cards of the entries of this session whose color identity was computed before the card database was loaded
+    QHash<QString, QStringList> colorCardsToRecompute;
+
+    void store(const QString &filePath, const DeckMetadata &metadata);
+    void scanDirectory(const QString &directory, bool notify);
+    void save();
+    void setColorIdentity(const QString &filePath, DeckMetadata &metadata, const QStringList &colorCards);
+    void recomputeColorIdentities();
+
+    static QString computeColorIdentity(const QStringList &cardNames);
+};
+
+#endif // DECK_METADATA_SERVICE_H
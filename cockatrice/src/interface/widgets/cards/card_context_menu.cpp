@@ -0,0 +1,105 @@
+#include "card_context_menu.h"
+
+#include "../../../interface/widgets/tabs/tab_supervisor.h"
+#include "../../window_main.h"
+
+#include <QApplication>
+#include <QMenu>
+#include <algorithm>
+#include <libcockatrice/card/database/card_database_manager.h>
+#include <libcockatrice/card/relation/card_relation.h>
+
+QMenu *CardContextMenu::create(const ExactCard &card, QWidget *parent, const ViewCard &viewCard)
+{
+    auto *cardMenu = new QMenu(parent);
+    cardMenu->setAttribute(Qt::WA_DeleteOnClose);
+
+    if (!card) {
+        return cardMenu;
+    }
+
+    cardMenu->addMenu(createViewRelatedCardsMenu(card, cardMenu, viewCard));
+    cardMenu->addMenu(createAddToOpenDeckMenu(card, cardMenu));
+
+    return cardMenu;
+}
+
+QMenu *CardContextMenu::createViewRelatedCardsMenu(const ExactCard &card, QMenu *parent, const ViewCard &viewCard)
+{
+    // the strings keep the translation context of the widget the menu was first written for
+    auto viewRelatedCards =
+        new QMenu(QCoreApplication::translate("CardInfoPictureWidget", "View related cards"), parent);
+
+    QList<CardRelation *> relatedCards = card.getInfo().getAllRelatedCards();
+
+    auto relatedCardExists = [](const CardRelation *cardRelation) {
+        return CardDatabaseManager::query()->getCardInfo(cardRelation->getName()) != nullptr;
+    };
+
+    bool atLeastOneGoodRelationFound = std::any_of(relatedCards.begin(), relatedCards.end(), relatedCardExists);
+
+    if (!atLeastOneGoodRelationFound) {
+        viewRelatedCards->setEnabled(false);
+        return viewRelatedCards;
+    }
+
+    const QString uuid = card.getPrinting().getUuid();
+    for (const auto &relatedCard : relatedCards) {
+        const QString relatedCardName = relatedCard->getName();
+        QAction *viewCardAction = viewRelatedCards->addAction(relatedCardName);
+        QObject::connect(viewCardAction, &QAction::triggered, viewRelatedCards, [viewCard, relatedCardName, uuid] {
+            viewCard(CardDatabaseManager::query()->getCard({relatedCardName, uuid}));
+        });
+    }
+
+    return viewRelatedCards;
+}
+
+/**
+ * Finds the single instance of the MainWindow in this application.
+ */
+static MainWindow *findMainWindow()
+{
+    for (auto widget : QApplication::topLevelWidgets()) {
+        if (auto mainWindow = qobject_cast<MainWindow *>(widget)) {
+            return mainWindow;
+        }
+    }
+    // This code should be unreachable
+    qCritical() << "Could not find MainWindow in QApplication::topLevelWidgets";
+    return nullptr;
+}
+
+QMenu *CardContextMenu::createAddToOpenDeckMenu(const ExactCard &card, QMenu *parent)
+{
+    auto addToOpenDeckMenu =
+        new QMenu(QCoreApplication::translate("CardInfoPictureWidget", "Add card to deck"), parent);
+
+    auto mainWindow = findMainWindow();
+    QList<AbstractTabDeckEditor *> deckEditorTabs =
+        mainWindow ? mainWindow->getTabSupervisor()->getDeckEditorTabs() : QList<AbstractTabDeckEditor *>();
+
+    if (deckEditorTabs.isEmpty()) {
+        addToOpenDeckMenu->setEnabled(false);
+        return addToOpenDeckMenu;
+    }
+
+    for (auto &deckEditorTab : deckEditorTabs) {
+        auto *addCardMenu = addToOpenDeckMenu->addMenu(deckEditorTab->getTabText());
+
+        QAction *addCard = addCardMenu->addAction(QCoreApplication::translate("CardInfoPictureWidget", "Mainboard"));
+        QObject::connect(addCard, &QAction::triggered, deckEditorTab, [card, deckEditorTab] {
+            deckEditorTab->updateCard(card);
+            deckEditorTab->addCard(card, DECK_ZONE_MAIN);
+        });
+
+        QAction *addCardSideboard =
+            addCardMenu->addAction(QCoreApplication::translate("CardInfoPictureWidget", "Sideboard"));
+        QObject::connect(addCardSideboard, &QAction::triggered, deckEditorTab, [card, deckEditorTab] {
+            deckEditorTab->updateCard(card);
+            deckEditorTab->addCard(card, DECK_ZONE_SIDE);
+        });
+    }
+
+    return addToOpenDeckMenu;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file card_context_menu.h
+ * @ingroup CardWidgets
+ * @brief The right-click menu of a card picture, shared by the card picture widgets and the card grid.
+ */
+
+#ifndef CARD_CONTEXT_MENU_H
+#define CARD_CONTEXT_MENU_H
+
+#include <functional>
+#include <libcockatrice/card/printing/exact_card.h>
+
+class QMenu;
+class QWidget;
+
+namespace CardContextMenu
+{
+using ViewCard = std::function<void(const ExactCard &card)>;
+
+/**
+ * @brief Builds the "View related cards" and "Add card to deck" menus of the card. The menu deletes itself once it is
+ * closed, so it can be popped up and forgotten.
+ * @param viewCard Called with the related card the user picked to view
+ */
+QMenu *create(const ExactCard &card, QWidget *parent, const ViewCard &viewCard);
+
+QMenu *createViewRelatedCardsMenu(const ExactCard &card, QMenu *parent, const ViewCard &viewCard);
+QMenu *createAddToOpenDeckMenu(const ExactCard &card, QMenu *parent);
+} // namespace CardContextMenu
+
+#endif // CARD_CONTEXT_MENU_H
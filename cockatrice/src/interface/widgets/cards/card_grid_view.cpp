@@ -0,0 +1,478 @@
+#include "card_grid_view.h"
+
+#include "../../../client/settings/cache_settings.h"
+#include "../../../interface/card_picture_loader/card_picture_loader.h"
+#include "card_context_menu.h"
+
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QScrollBar>
+#include <algorithm>
+#include <libcockatrice/settings/cards_display_settings.h>
+
+// Same cell size as a CardInfoPictureWidget, so switching between the two does not change the card size setting
+static constexpr qreal ASPECT_RATIO = 1.396;
+static constexpr int BASE_WIDTH = 200;
+
+CardGridView::CardGridView(QWidget *parent, int scale) : QAbstractItemView(parent)
+{
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setFrameShape(QFrame::NoFrame);
+    viewport()->setMouseTracking(true);
+
+    setScaleFactor(scale);
+
+    connect(&SettingsCache::instance().cardsDisplay(), &CardsDisplaySettings::roundCardCornersChanged, viewport(),
+            [this] { viewport()->update(); });
+}
+
+void CardGridView::setCardResolver(CardResolver resolver)
+{
+    cardResolver = std::move(resolver);
+    clearResolvedCards();
+    updateWindow();
+    viewport()->update();
+}
+
+void CardGridView::setModel(QAbstractItemModel *_model)
+{
+    QAbstractItemView::setModel(_model);
+    clearResolvedCards();
+    updateGeometries();
+}
+
+void CardGridView::setScaleFactor(int scale)
+{
+    const int width = BASE_WIDTH * scale / 100;
+    cellSize = QSize(width, static_cast<int>(width * ASPECT_RATIO));
+    windowLastRow = -1; // request the pictures again in the new size
+    updateGeometries();
+    viewport()->update();
+}
+
+ExactCard CardGridView::cardAt(const QModelIndex &index) const
+{
+    if (!index.isValid() || !cardResolver) {
+        return {};
+    }
+
+    auto it = resolvedCards.constFind(index.row());
+    if (it != resolvedCards.constEnd()) {
+        return *it;
+    }
+
+    // rows far from the viewport are resolved but not remembered, only clicks and keyboard navigation get there
+    const ExactCard card = cardResolver(index);
+    if (index.row() >= windowFirstRow && index.row() <= windowLastRow) {
+        resolvedCards.insert(index.row(), card);
+    }
+    return card;
+}
+
+int CardGridView::columnCount() const
+{
+    return std::max(1, (viewport()->width() - SPACING) / (cellSize.width() + SPACING));
+}
+
+int CardGridView::rowHeight() const
+{
+    return cellSize.height() + SPACING;
+}
+
+int CardGridView::cellCount() const
+{
+    return model() ? model()->rowCount(rootIndex()) : 0;
+}
+
+QRect CardGridView::cellRect(int row) const
+{
+    const int columns = columnCount();
+    const int x = SPACING + (row % columns) * (cellSize.width() + SPACING);
+    const int y = SPACING + (row / columns) * rowHeight();
+    return QRect(QPoint(x, y), cellSize);
+}
+
+std::pair<int, int> CardGridView::rowsBetween(int top, int bottom) const
+{
+    const int columns = columnCount();
+    const int firstLine = std::max(0, (top - SPACING) / rowHeight());
+    const int lastLine = std::max(0, (bottom - SPACING) / rowHeight());
+    return {firstLine * columns, std::min(cellCount(), (lastLine + 1) * columns) - 1};
+}
+
+QRect CardGridView::visualRect(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.parent() != rootIndex()) {
+        return {};
+    }
+    return cellRect(index.row()).translated(0, -verticalOffset());
+}
+
+QModelIndex CardGridView::indexAt(const QPoint &point) const
+{
+    const QPoint contentPoint = point + QPoint(0, verticalOffset());
+    const int columns = columnCount();
+    const int column = (contentPoint.x() - SPACING) / (cellSize.width() + SPACING);
+    const int line = (contentPoint.y() - SPACING) / rowHeight();
+    if (contentPoint.x() < SPACING || contentPoint.y() < SPACING || column >= columns) {
+        return {};
+    }
+
+    const int row = line * columns + column;
+    if (row >= cellCount() || !cellRect(row).contains(contentPoint)) {
+        return {}; // the spacing between cells
+    }
+    return model()->index(row, 0, rootIndex());
+}
+
+void CardGridView::scrollTo(const QModelIndex &index, ScrollHint hint)
+{
+    const QRect rect = visualRect(index);
+    if (!rect.isValid()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = verticalScrollBar();
+    if (hint == PositionAtTop || (hint == EnsureVisible && rect.top() < 0)) {
+        scrollBar->setValue(scrollBar->value() + rect.top() - SPACING);
+    } else if (hint == PositionAtBottom || (hint == EnsureVisible && rect.bottom() > viewport()->height())) {
+        scrollBar->setValue(scrollBar->value() + rect.bottom() + SPACING - viewport()->height());
+    } else if (hint == PositionAtCenter) {
+        scrollBar->setValue(scrollBar->value() + rect.center().y() - viewport()->height() / 2);
+    }
+}
+
+QModelIndex CardGridView::moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers /* modifiers */)
+{
+    const int count = cellCount();
+    if (count == 0) {
+        return {};
+    }
+
+    const int columns = columnCount();
+    const int rowsPerPage = std::max(1, viewport()->height() / rowHeight()) * columns;
+    int row = currentIndex().isValid() ? currentIndex().row() : 0;
+    switch (cursorAction) {
+        case MoveLeft:
+        case MovePrevious:
+            --row;
+            break;
+        case MoveRight:
+        case MoveNext:
+            ++row;
+            break;
+        case MoveUp:
+            row -= columns;
+            break;
+        case MoveDown:
+            row += columns;
+            break;
+        case MovePageUp:
+            row -= rowsPerPage;
+            break;
+        case MovePageDown:
+            row += rowsPerPage;
+            break;
+        case MoveHome:
+            row = 0;
+            break;
+        case MoveEnd:
+            row = count - 1;
+            break;
+    }
+    return model()->index(std::clamp(row, 0, count - 1), 0, rootIndex());
+}
+
+int CardGridView::horizontalOffset() const
+{
+    return 0;
+}
+
+int CardGridView::verticalOffset() const
+{
+    return verticalScrollBar()->value();
+}
+
+bool CardGridView::isIndexHidden(const QModelIndex & /* index */) const
+{
+    return false;
+}
+
+void CardGridView::setSelection(const QRect & /* rect */, QItemSelectionModel::SelectionFlags /* command */)
+{
+    // Cards are picked by clicking them, the view does not keep a selection
+}
+
+QRegion CardGridView::visualRegionForSelection(const QItemSelection & /* selection */) const
+{
+    return {};
+}
+
+void CardGridView::updateGeometries()
+{
+    const int columns = columnCount();
+    const int lines = (cellCount() + columns - 1) / columns;
+    const int contentHeight = lines * rowHeight() + SPACING;
+
+    QScrollBar *scrollBar = verticalScrollBar();
+    scrollBar->setSingleStep(std::max(1, rowHeight() / 4));
+    scrollBar->setPageStep(viewport()->height());
+    scrollBar->setRange(0, std::max(0, contentHeight - viewport()->height()));
+
+    QAbstractItemView::updateGeometries();
+    updateWindow();
+}
+
+void CardGridView::scrollContentsBy(int dx, int dy)
+{
+    QAbstractItemView::scrollContentsBy(dx, dy);
+    updateWindow();
+}
+
+void CardGridView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractItemView::resizeEvent(event);
+    updateGeometries();
+}
+
+void CardGridView::reset()
+{
+    QAbstractItemView::reset();
+    clearResolvedCards();
+    updateGeometries();
+}
+
+void CardGridView::doItemsLayout()
+{
+    // sorting or filtering moves cards to other rows
+    clearResolvedCards();
+    QAbstractItemView::doItemsLayout();
+}
+
+void CardGridView::rowsInserted(const QModelIndex &parent, int start, int end)
+{
+    QAbstractItemView::rowsInserted(parent, start, end);
+    clearResolvedCards();
+    updateGeometries();
+    viewport()->update();
+}
+
+void CardGridView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
+{
+    QAbstractItemView::rowsAboutToBeRemoved(parent, start, end);
+    clearResolvedCards();
+    QMetaObject::invokeMethod(this, [this] { updateGeometries(); }, Qt::QueuedConnection);
+    viewport()->update();
+}
+
+void CardGridView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    QAbstractItemView::dataChanged(topLeft, bottomRight, roles);
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        resolvedCards.remove(row);
+    }
+    viewport()->update();
+}
+
+void CardGridView::currentChanged(const QModelIndex &current, const QModelIndex &previous)
+{
+    QAbstractItemView::currentChanged(current, previous);
+    if (current.isValid()) {
+        emit hoveredOnCard(cardAt(current));
+    }
+}
+
+void CardGridView::clearResolvedCards()
+{
+    resolvedCards.clear();
+    windowFirstRow = 0;
+    windowLastRow = -1;
+    hoveredRow = -1;
+}
+
+/**
+ * @brief Requests the pictures of the cards in or near the viewport and listens for their updates.
+ *
+ * Cards are only listened to while they are near the viewport. Once a card is scrolled past, nothing is connected to
+ * its pixmapUpdated signal anymore and the picture loader is free to drop its queued download.
+ */
+void CardGridView::updateWindow()
+{
+    if (!model() || !cardResolver) {
+        return;
+    }
+
+    const int top = verticalOffset();
+    const int height = viewport()->height();
+    const auto [firstRow, lastRow] = rowsBetween(top - height, top + 2 * height);
+    if (firstRow == windowFirstRow && lastRow == windowLastRow) {
+        return;
+    }
+    windowFirstRow = firstRow;
+    windowLastRow = lastRow;
+
+    for (auto it = resolvedCards.begin(); it != resolvedCards.end();) {
+        if (it.key() < firstRow || it.key() > lastRow) {
+            it = resolvedCards.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    QSet<CardInfoPtr> nearCards;
+    QPixmap pixmap;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const ExactCard card = cardAt(model()->index(row, 0, rootIndex()));
+        if (!card) {
+            continue;
+        }
+        nearCards.insert(card.getCardPtr());
+        CardPictureLoader::getPixmap(pixmap, card, cellSize);
+    }
+
+    for (const CardInfoPtr &card : listenedCards) {
+        if (!nearCards.contains(card)) {
+            disconnect(card.data(), nullptr, this, nullptr);
+        }
+    }
+    for (const CardInfoPtr &card : nearCards) {
+        if (!listenedCards.contains(card)) {
+            connect(card.data(), &CardInfo::pixmapUpdated, this, [this] { viewport()->update(); });
+        }
+    }
+    listenedCards = nearCards;
+}
+
+void CardGridView::paintEvent(QPaintEvent *event)
+{
+    if (!model()) {
+        return;
+    }
+
+    QPainter painter(viewport());
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    const QRect exposed = event->rect();
+    const int top = verticalOffset();
+    const int currentRow = hasFocus() && currentIndex().isValid() ? currentIndex().row() : -1;
+    const auto [firstRow, lastRow] = rowsBetween(top + exposed.top(), top + exposed.bottom());
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const QRect rect = cellRect(row).translated(0, -top);
+        if (rect.intersects(exposed)) {
+            paintCell(painter, rect, cardAt(model()->index(row, 0, rootIndex())));
+            if (row == currentRow) {
+                paintCurrentFrame(painter, rect);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draws a card the way CardInfoPictureWidget does, centered in the cell with optionally rounded corners.
+ */
+void CardGridView::paintCell(QPainter &painter, const QRect &rect, const ExactCard &card) const
+{
+    QPixmap pixmap;
+    if (!card) {
+        CardPictureLoader::getCardBackLoadingFailedPixmap(pixmap, rect.size());
+    } else if (!CardPictureLoader::getPixmap(pixmap, card, rect.size())) {
+        // asked again on every repaint while loading, which tells the loader the card is still on screen
+        CardPictureLoader::getCardBackLoadingInProgressPixmap(pixmap, rect.size());
+    }
+    if (pixmap.isNull()) {
+        return;
+    }
+
+    if (card && SettingsCache::instance().cardsDisplay().getAutoRotateSidewaysLayoutCards() &&
+        card.getInfo().getUiAttributes().landscapeOrientation) {
+        QTransform transform;
+        transform.rotate(90);
+        pixmap = pixmap.transformed(transform, Qt::SmoothTransformation);
+    }
+
+    const QSize scaledSize = (pixmap.size() / pixmap.devicePixelRatio()).scaled(rect.size(), Qt::KeepAspectRatio);
+    const QRect targetRect(rect.topLeft() + QPoint((rect.width() - scaledSize.width()) / 2,
+                                                   (rect.height() - scaledSize.height()) / 2),
+                           scaledSize);
+
+    const qreal radius = SettingsCache::instance().cardsDisplay().getRoundCardCorners()
+                             ? 0.05 * static_cast<qreal>(targetRect.width())
+                             : 0.;
+
+    painter.save();
+    QPainterPath shape;
+    shape.addRoundedRect(targetRect, radius, radius);
+    painter.setClipPath(shape);
+    painter.drawPixmap(targetRect, pixmap);
+    painter.restore();
+}
+
+/**
+ * @brief Frames the cell of the current card in the highlight color, inside the spacing around the cell.
+ */
+void CardGridView::paintCurrentFrame(QPainter &painter, const QRect &rect) const
+{
+    const int width = SPACING / 2;
+    painter.save();
+    painter.setPen(QPen(palette().color(QPalette::Highlight), width));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRoundedRect(QRectF(rect).adjusted(-width / 2., -width / 2., width / 2., width / 2.), width, width);
+    painter.restore();
+}
+
+void CardGridView::mousePressEvent(QMouseEvent *event)
+{
+    const QModelIndex index = indexAt(event->pos());
+    if (!index.isValid()) {
+        QAbstractItemView::mousePressEvent(event);
+        return;
+    }
+
+    setCurrentIndex(index);
+    emit cardClicked(event, cardAt(index));
+}
+
+void CardGridView::contextMenuEvent(QContextMenuEvent *event)
+{
+    const bool fromKeyboard = event->reason() == QContextMenuEvent::Keyboard;
+    const QModelIndex index = fromKeyboard ? currentIndex() : indexAt(event->pos());
+    const ExactCard card = cardAt(index);
+    if (!card) {
+        QAbstractItemView::contextMenuEvent(event);
+        return;
+    }
+
+    // a related card is viewed the way a hovered one is, the grid keeps showing the cards of the model
+    QMenu *menu =
+        CardContextMenu::create(card, this, [this](const ExactCard &relatedCard) { emit hoveredOnCard(relatedCard); });
+    menu->popup(fromKeyboard ? viewport()->mapToGlobal(visualRect(index).center()) : event->globalPos());
+}
+
+void CardGridView::mouseMoveEvent(QMouseEvent *event)
+{
+    QAbstractItemView::mouseMoveEvent(event);
+
+    const QModelIndex index = indexAt(event->pos());
+    const int row = index.isValid() ? index.row() : -1;
+    if (row == hoveredRow) {
+        return;
+    }
+
+    hoveredRow = row;
+    if (index.isValid()) {
+        emit hoveredOnCard(cardAt(index));
+    }
+}
+
+void CardGridView::leaveEvent(QEvent *event)
+{
+    QAbstractItemView::leaveEvent(event);
+    hoveredRow = -1;
+}
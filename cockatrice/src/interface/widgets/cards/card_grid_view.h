@@ -0,0 +1,111 @@
+/**
+ * @file card_grid_view.h
+ * @ingroup CardWidgets
+ * @brief A scrollable grid of card pictures that only paints the cells in view.
+ */
+
+#ifndef CARD_GRID_VIEW_H
+#define CARD_GRID_VIEW_H
+
+#include <QAbstractItemView>
+#include <QHash>
+#include <QSet>
+#include <functional>
+#include <libcockatrice/card/printing/exact_card.h>
+
+/**
+ * @class CardGridView
+ * @brief Shows one card picture per row of its model, laid out in a grid that wraps to the width of the viewport.
+ *
+ * Unlike a FlowWidget of CardInfoPictureWidgets, the view creates no widget per card: cells are painted straight into
+ * the viewport, so scrolling through the whole database neither allocates nor lays out anything per card.
+ *
+ * Which card a row shows is decided by the card resolver, called for rows when they come close to the viewport and
+ * remembered until they leave it or the model changes. Pictures are requested for the rows in view and for one viewport
+ * height ahead in either direction, and the view only listens for picture updates of those cards, which lets the
+ * picture loader drop downloads of cards that were scrolled past.
+ *
+ * The current card can be moved with the keyboard and is framed while the view has focus; it is shown like a hovered
+ * card. Right-clicking a card, or the menu key, opens the same menu as on a CardInfoPictureWidget.
+ */
+class CardGridView : public QAbstractItemView
+{
+    Q_OBJECT
+
+public:
+    using CardResolver = std::function<ExactCard(const QModelIndex &index)>;
+
+    explicit CardGridView(QWidget *parent = nullptr, int scale = 100);
+
+    void setCardResolver(CardResolver resolver);
+    [[nodiscard]] ExactCard cardAt(const QModelIndex &index) const;
+
+    [[nodiscard]] QRect visualRect(const QModelIndex &index) const override;
+    void scrollTo(const QModelIndex &index, ScrollHint hint = EnsureVisible) override;
+    [[nodiscard]] QModelIndex indexAt(const QPoint &point) const override;
+
+    void setModel(QAbstractItemModel *model) override;
+    void reset() override;
+    void doItemsLayout() override;
+
+public slots:
+    /**
+     * @brief Resizes the cells, 100 being the size of a CardInfoPictureWidget at its default scale.
+     */
+    void setScaleFactor(int scale);
+
+signals:
+    void cardClicked(QMouseEvent *event, const ExactCard &card);
+    void hoveredOnCard(const ExactCard &hoveredCard);
+
+protected:
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    [[nodiscard]] int horizontalOffset() const override;
+    [[nodiscard]] int verticalOffset() const override;
+    [[nodiscard]] bool isIndexHidden(const QModelIndex &index) const override;
+    void setSelection(const QRect &rect, QItemSelectionModel::SelectionFlags command) override;
+    [[nodiscard]] QRegion visualRegionForSelection(const QItemSelection &selection) const override;
+
+    void updateGeometries() override;
+    void scrollContentsBy(int dx, int dy) override;
+    void rowsInserted(const QModelIndex &parent, int start, int end) override;
+    void rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end) override;
+    void dataChanged(const QModelIndex &topLeft,
+                     const QModelIndex &bottomRight,
+                     const QVector<int> &roles = QVector<int>()) override;
+    void currentChanged(const QModelIndex &current, const QModelIndex &previous) override;
+
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    static constexpr int SPACING = 6;
+
+    CardResolver cardResolver;
+    QSize cellSize;
+
+    /** Cards of the rows in or near the viewport, by row. */
+    mutable QHash<int, ExactCard> resolvedCards;
+    /** Cards whose pixmapUpdated signal is connected, those of the rows in or near the viewport. */
+    QSet<CardInfoPtr> listenedCards;
+    int windowFirstRow = 0;
+    int windowLastRow = -1;
+    int hoveredRow = -1;
+
+    [[nodiscard]] int columnCount() const;
+    [[nodiscard]] int rowHeight() const;
+    [[nodiscard]] int cellCount() const;
+    [[nodiscard]] QRect cellRect(int row) const;
+    [[nodiscard]] std::pair<int, int> rowsBetween(int top, int bottom) const;
+
+    void clearResolvedCards();
+    void updateWindow();
+    void paintCell(QPainter &painter, const QRect &rect, const ExactCard &card) const;
+    void paintCurrentFrame(QPainter &painter, const QRect &rect) const;
+};
+
+#endif // CARD_GRID_VIEW_H
@@ -3,16 +3,14 @@
 #include "../../../client/settings/cache_settings.h"
 #include "../../../game_graphics/board/card_item.h"
 #include "../../../interface/card_picture_loader/card_picture_loader.h"
-#include "../../../interface/widgets/tabs/tab_supervisor.h"
-#include "../../window_main.h"
+#include "card_context_menu.h"
 
+#include <QGuiApplication>
 #include <QMenu>
 #include <QMouseEvent>
 #include <QScreen>
 #include <QStylePainter>
 #include <QWidget>
-#include <libcockatrice/card/database/card_database_manager.h>
-#include <libcockatrice/card/relation/card_relation.h>
 #include <libcockatrice/settings/cards_display_settings.h>
 #include <utility>
 
@@ -164,12 +162,12 @@ void CardInfoPictureWidget::loadPixmap()
 {
     CardPictureLoader::getCardBackLoadingInProgressPixmap(resizedPixmap, size());
     if (exactCard) {
-        CardPictureLoader::getPixmap(resizedPixmap, exactCard, size());
+        // stays dirty while the image loads, so every repaint tells the loader the card is still on screen
+        pixmapDirty = !CardPictureLoader::getPixmap(resizedPixmap, exactCard, size());
     } else {
         CardPictureLoader::getCardBackLoadingFailedPixmap(resizedPixmap, size());
+        pixmapDirty = false;
     }
-
-    pixmapDirty = false;
 }
 
 /**
@@ -360,92 +358,7 @@ void CardInfoPictureWidget::hideEvent(QHideEvent *event)
 
 QMenu *CardInfoPictureWidget::createRightClickMenu()
 {
-    auto *cardMenu = new QMenu(this);
-
-    if (!exactCard) {
-        return cardMenu;
-    }
-
-    cardMenu->addMenu(createViewRelatedCardsMenu());
-    cardMenu->addMenu(createAddToOpenDeckMenu());
-
-    return cardMenu;
-}
-
-QMenu *CardInfoPictureWidget::createViewRelatedCardsMenu()
-{
-    auto viewRelatedCards = new QMenu(tr("View related cards"));
-
-    QList<CardRelation *> relatedCards = exactCard.getInfo().getAllRelatedCards();
-
-    auto relatedCardExists = [](const CardRelation *cardRelation) {
-        return CardDatabaseManager::query()->getCardInfo(cardRelation->getName()) != nullptr;
-    };
-
-    bool atLeastOneGoodRelationFound = std::any_of(relatedCards.begin(), relatedCards.end(), relatedCardExists);
-
-    if (!atLeastOneGoodRelationFound) {
-        viewRelatedCards->setEnabled(false);
-        return viewRelatedCards;
-    }
-
-    for (const auto &relatedCard : relatedCards) {
-        const auto &relatedCardName = relatedCard->getName();
-        QAction *viewCard = viewRelatedCards->addAction(relatedCardName);
-        connect(viewCard, &QAction::triggered, this, [this, &relatedCardName] {
-            emit cardChanged(
-                CardDatabaseManager::query()->getCard({relatedCardName, exactCard.getPrinting().getUuid()}));
-        });
-        viewRelatedCards->addAction(viewCard);
-    }
-
-    return viewRelatedCards;
-}
-
-/**
- * Finds the single instance of the MainWindow in this application.
- */
-static MainWindow *findMainWindow()
-{
-    for (auto widget : QApplication::topLevelWidgets()) {
-        if (auto mainWindow = qobject_cast<MainWindow *>(widget)) {
-            return mainWindow;
-        }
-    }
-    // This code should be unreachable
-    qCritical() << "Could not find MainWindow in QApplication::topLevelWidgets";
-    return nullptr;
-}
-
-QMenu *CardInfoPictureWidget::createAddToOpenDeckMenu()
-{
-    auto addToOpenDeckMenu = new QMenu(tr("Add card to deck"));
-
-    auto mainWindow = findMainWindow();
-    QList<AbstractTabDeckEditor *> deckEditorTabs = mainWindow->getTabSupervisor()->getDeckEditorTabs();
-
-    if (deckEditorTabs.isEmpty()) {
-        addToOpenDeckMenu->setEnabled(false);
-        return addToOpenDeckMenu;
-    }
-
-    for (auto &deckEditorTab : deckEditorTabs) {
-        auto *addCardMenu = addToOpenDeckMenu->addMenu(deckEditorTab->getTabText());
-
-        QAction *addCard = addCardMenu->addAction(tr("Mainboard"));
-        connect(addCard, &QAction::triggered, this, [this, deckEditorTab] {
-            deckEditorTab->updateCard(exactCard);
-            deckEditorTab->addCard(exactCard, DECK_ZONE_MAIN);
-        });
-
-        QAction *addCardSideboard = addCardMenu->addAction(tr("Sideboard"));
-        connect(addCardSideboard, &QAction::triggered, this, [this, deckEditorTab] {
-            deckEditorTab->updateCard(exactCard);
-            deckEditorTab->addCard(exactCard, DECK_ZONE_SIDE);
-        });
-    }
-
-    return addToOpenDeckMenu;
+    return CardContextMenu::create(exactCard, this, [this](const ExactCard &card) { emit cardChanged(card); });
 }
 
 /**
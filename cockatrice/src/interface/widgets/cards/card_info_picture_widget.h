@@ -81,8 +81,6 @@ private:
     QPoint originalPos; // Store the original position
 
     QMenu *createRightClickMenu();
-    QMenu *createViewRelatedCardsMenu();
-    QMenu *createAddToOpenDeckMenu();
 };
 
 #endif
@@ -68,6 +68,8 @@ void DeckEditorDeckDockWidget::createDeckDock()
             &DeckEditorDeckDockWidget::syncDisplayWidgetsToModel);
     connect(deckStateManager, &DeckStateManager::deckReplaced, this,
             &DeckEditorDeckDockWidget::applyActiveGroupCriteria);
+    connect(deckStateManager, &DeckStateManager::metadataReplaced, this,
+            &DeckEditorDeckDockWidget::syncDisplayWidgetsToModel);
 
     deckView = new QTreeView();
     deckView->setObjectName("deckView");
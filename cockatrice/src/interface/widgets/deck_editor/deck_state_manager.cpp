@@ -2,6 +2,7 @@
 
 #include <libcockatrice/card/database/card_database_manager.h>
 #include <libcockatrice/deck_list/deck_list_history_manager.h>
+#include <utility>
 
 DeckStateManager::DeckStateManager(QObject *parent)
     : QObject(parent), deckList(QSharedPointer<DeckList>(new DeckList)),
@@ -110,10 +111,10 @@ void DeckStateManager::setName(const QString &name)
         return;
     }
 
-    requestHistorySave(tr("Rename deck to \"%1\" from \"%2\"").arg(name).arg(previous));
+    DeckListEditableMetadata before = deckList->getEditableMetadata();
     deckList->setName(name);
 
-    doMetadataModified();
+    saveMetadataChange(tr("Rename deck to \"%1\" from \"%2\"").arg(name).arg(previous), before);
 }
 
 void DeckStateManager::setComments(const QString &comments)
@@ -123,10 +124,11 @@ void DeckStateManager::setComments(const QString &comments)
         return;
     }
 
-    requestHistorySave(tr("Updated comments (was %1 chars, now %2 chars)").arg(previous.size()).arg(comments.size()));
+    DeckListEditableMetadata before = deckList->getEditableMetadata();
     deckList->setComments(comments);
 
-    doMetadataModified();
+    saveMetadataChange(tr("Updated comments (was %1 chars, now %2 chars)").arg(previous.size()).arg(comments.size()),
+                       before);
 }
 
 void DeckStateManager::setBannerCard(const CardRef &bannerCard)
@@ -136,10 +138,10 @@ void DeckStateManager::setBannerCard(const CardRef &bannerCard)
         return;
     }
 
-    requestHistorySave(tr("Set banner card to %1 (%2)").arg(bannerCard.name).arg(bannerCard.providerId));
+    DeckListEditableMetadata before = deckList->getEditableMetadata();
     deckList->setBannerCard(bannerCard);
 
-    doMetadataModified();
+    saveMetadataChange(tr("Set banner card to %1 (%2)").arg(bannerCard.name).arg(bannerCard.providerId), before);
 }
 
 void DeckStateManager::setTags(const QStringList &tags)
@@ -149,10 +151,10 @@ void DeckStateManager::setTags(const QStringList &tags)
         return;
     }
 
-    requestHistorySave(tr("Tags changed"));
+    DeckListEditableMetadata before = deckList->getEditableMetadata();
     deckList->setTags(tags);
 
-    doMetadataModified();
+    saveMetadataChange(tr("Tags changed"), before);
 }
 
 void DeckStateManager::setFormat(const QString &format)
@@ -161,10 +163,10 @@ void DeckStateManager::setFormat(const QString &format)
         return;
     }
 
-    requestHistorySave(tr("Set format to %1").arg(format));
+    DeckListEditableMetadata before = deckList->getEditableMetadata();
     deckListModel->setActiveFormat(format);
 
-    doMetadataModified();
+    saveMetadataChange(tr("Set format to %1").arg(format), before);
 }
 
 QModelIndex DeckStateManager::addCard(const ExactCard &card, const QString &zoneName)
@@ -181,9 +183,12 @@ QModelIndex DeckStateManager::addCard(const ExactCard &card, const QString &zone
     QString reason =
         tr("Added (%1): %2 (%3) %4").arg(zone, card.getName(), setName, card.getPrinting().getProperty("num"));
 
-    QModelIndex idx = modifyDeck(reason, [&card, &zone](auto model) { return model->addCard(card, zone); });
+    QModelIndex idx = deckListModel->addCard(card, zone);
 
     if (idx.isValid()) {
+        if (auto change = deckListModel->getCardChange(idx, 1)) {
+            saveCardChanges(reason, {*change});
+        }
         emit focusIndexChanged(idx, true);
     }
 
@@ -219,25 +224,20 @@ QModelIndex DeckStateManager::decrementCard(const ExactCard &card, const QString
     return newIdx;
 }
 
-static bool doSwapCard(DeckListModel *model,
-                       const QModelIndex &idx,
-                       const QString &cardName,
-                       const QString &providerId,
-                       const QString &otherZone)
+/**
+ * @return The index of the card in the other zone
+ */
+static QModelIndex doSwapCard(DeckListModel *model,
+                              const QString &cardName,
+                              const QString &providerId,
+                              const QString &otherZone)
 {
-    bool success = model->offsetCountAtIndex(idx, -1);
-    if (!success) {
-        return false;
-    }
-
     if (ExactCard card = CardDatabaseManager::query()->getCard({cardName, providerId})) {
-        model->addCard(card, otherZone);
-    } else {
-        // Third argument (true) says create the card no matter what, even if not in DB
-        model->addPreferredPrintingCard(cardName, otherZone, true);
+        return model->addCard(card, otherZone);
     }
 
-    return true;
+    // Third argument (true) says create the card no matter what, even if not in DB
+    return model->addPreferredPrintingCard(cardName, otherZone, true);
 }
 
 bool DeckStateManager::swapCardAtIndex(const QModelIndex &idx)
@@ -266,9 +266,20 @@ bool DeckStateManager::swapCardAtIndex(const QModelIndex &idx)
                          .arg(cardName)
                          .arg(providerId);
 
-    return modifyDeck(reason, [&idx, &cardName, &providerId, &otherZoneName](auto model) {
-        return doSwapCard(model, idx, cardName, providerId, otherZoneName);
-    });
+    // the card may not be added with the same printing, so both halves of the move are recorded separately
+    auto removal = deckListModel->getCardChange(idx, -1);
+    if (!removal || !deckListModel->offsetCountAtIndex(idx, -1)) {
+        return false;
+    }
+
+    QList<DeckListCardChange> changes = {*removal};
+    QModelIndex addedIdx = doSwapCard(deckListModel, cardName, providerId, otherZoneName);
+    if (auto addition = deckListModel->getCardChange(addedIdx, 1)) {
+        changes.append(*addition);
+    }
+
+    saveCardChanges(reason, changes);
+    return true;
 }
 
 bool DeckStateManager::removeCardAtIndex(const QModelIndex &idx)
@@ -281,7 +292,14 @@ bool DeckStateManager::removeCardAtIndex(const QModelIndex &idx)
 
     QString reason = tr("Removed \"%1\" (all copies)").arg(cardName);
 
-    return modifyDeck(reason, [&idx](auto model) { return model->removeRow(idx.row(), idx.parent()); });
+    auto change = deckListModel->getCardChange(
+        idx, -idx.siblingAtColumn(DeckListModelColumns::CARD_AMOUNT).data(Qt::EditRole).toInt());
+    if (!change || !deckListModel->removeRow(idx.row(), idx.parent())) {
+        return false;
+    }
+
+    saveCardChanges(reason, {*change});
+    return true;
 }
 
 bool DeckStateManager::incrementCountAtIndex(const QModelIndex &idx)
@@ -308,7 +326,13 @@ bool DeckStateManager::offsetCountAtIndex(const QModelIndex &idx, int offset)
                          .arg(cardName)
                          .arg(providerId);
 
-    return modifyDeck(reason, [&idx, &offset](auto model) { return model->offsetCountAtIndex(idx, offset); });
+    auto change = deckListModel->getCardChange(idx, offset);
+    if (!change || !deckListModel->offsetCountAtIndex(idx, offset)) {
+        return false;
+    }
+
+    saveCardChanges(reason, {*change});
+    return true;
 }
 
 void DeckStateManager::undo(int steps)
@@ -317,17 +341,9 @@ void DeckStateManager::undo(int steps)
         return;
     }
 
-    for (int i = 0; i < steps; i++) {
-        if (!historyManager->canUndo()) {
-            continue;
-        }
-        historyManager->undo(deckList.get());
-    }
-
-    deckListModel->rebuildTree();
-
-    emit deckListModel->layoutChanged();
-    emit deckReplaced();
+    bool restored =
+        historyManager->undo(deckList.get(), steps, [this](const DeckListMemento &change) { applyChange(change); });
+    doHistoryApplied(restored);
 }
 
 void DeckStateManager::redo(int steps)
@@ -336,17 +352,9 @@ void DeckStateManager::redo(int steps)
         return;
     }
 
-    for (int i = 0; i < steps; i++) {
-        if (!historyManager->canRedo()) {
-            continue;
-        }
-        historyManager->redo(deckList.get());
-    }
-
-    deckListModel->rebuildTree();
-
-    emit deckListModel->layoutChanged();
-    emit deckReplaced();
+    bool restored =
+        historyManager->redo(deckList.get(), steps, [this](const DeckListMemento &change) { applyChange(change); });
+    doHistoryApplied(restored);
 }
 
 void DeckStateManager::requestHistorySave(const QString &reason)
@@ -354,6 +362,61 @@ void DeckStateManager::requestHistorySave(const QString &reason)
     historyManager->save(deckList->createMemento(reason));
 }
 
+void DeckStateManager::saveCardChanges(const QString &reason, const QList<DeckListCardChange> &changes)
+{
+    historyManager->saveChange(DeckListMemento(changes, reason), *deckList);
+    doCardModified();
+}
+
+void DeckStateManager::saveMetadataChange(const QString &reason, const DeckListEditableMetadata &before)
+{
+    historyManager->saveChange(DeckListMemento(DeckListMetadataChange{before, deckList->getEditableMetadata()}, reason),
+                               *deckList);
+    doMetadataModified();
+}
+
+/**
+ * @brief Applies a change entry of the history through the model, so that only the affected card nodes are updated
+ */
+void DeckStateManager::applyChange(const DeckListMemento &change)
+{
+    for (const auto &cardChange : change.getCardChanges()) {
+        deckListModel->applyCardChange(cardChange);
+    }
+
+    if (const auto &metadataChange = change.getMetadataChange()) {
+        deckList->setEditableMetadata(metadataChange->after);
+        if (metadataChange->before.gameFormat != metadataChange->after.gameFormat) {
+            deckListModel->setActiveFormat(metadataChange->after.gameFormat);
+        }
+        pendingMetadataSync = true;
+    }
+}
+
+/**
+ * @brief Updates the views after undoing or redoing. Views only need to be rebuilt if the deck was restored from a
+ * snapshot, change entries have already been applied to the model.
+ */
+void DeckStateManager::doHistoryApplied(bool restored)
+{
+    if (restored) {
+        pendingMetadataSync = false;
+
+        deckListModel->rebuildTree();
+
+        emit deckListModel->layoutChanged();
+        emit deckReplaced();
+        return;
+    }
+
+    emit cardModified();
+    if (std::exchange(pendingMetadataSync, false)) {
+        emit metadataModified();
+        emit metadataReplaced();
+    }
+    emit deckModified();
+}
+
 /**
  * @brief Handles updating state and emitting signals whenever the cards are modified
  */
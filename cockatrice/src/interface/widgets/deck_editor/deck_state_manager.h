@@ -28,6 +28,7 @@ class DeckStateManager : public QObject
     DeckListHistoryManager *historyManager;
 
     bool modified = false;
+    bool pendingMetadataSync = false;
 
 public:
     explicit DeckStateManager(QObject *parent = nullptr);
@@ -248,6 +249,10 @@ public slots:
 
 private:
     bool offsetCountAtIndex(const QModelIndex &idx, int offset);
+    void saveCardChanges(const QString &reason, const QList<DeckListCardChange> &changes);
+    void saveMetadataChange(const QString &reason, const DeckListEditableMetadata &before);
+    void applyChange(const DeckListMemento &change);
+    void doHistoryApplied(bool restored);
     void doCardModified();
     void doMetadataModified();
 
@@ -283,6 +288,11 @@ signals:
      */
     void deckReplaced();
 
+    /**
+     * The metadata has been changed by undoing or redoing and views of it need to be re-synced.
+     */
+    void metadataReplaced();
+
     /**
      * The isModified state of the deck has changed
      * @param isModified the new state
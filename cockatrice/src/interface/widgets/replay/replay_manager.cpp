@@ -1,9 +1,11 @@
 #include "replay_manager.h"
 
 #include "../../../client/settings/cache_settings.h"
+#include "../../../game_graphics/zones/zone_layout_scheduler.h"
 
 #include <QTimer>
 #include <libcockatrice/settings/interface_settings.h>
+#include <optional>
 
 static constexpr int TIMER_INTERVAL_MS = 200;
 
@@ -126,6 +128,14 @@ void ReplayManager::processNewEvents(PlaybackMode playbackMode)
 {
     currentProcessedTime = currentVisualTime;
 
+    // the intermediate board states of a skip are never shown, so only lay out the zones once it is done
+    const bool isSkip = playbackMode != NORMAL_PLAYBACK;
+    std::optional<ZoneLayoutScheduler::SuspendGuard> layoutSuspension;
+    if (isSkip) {
+        layoutSuspension.emplace();
+        emit skipStarted();
+    }
+
     while (currentEvent < replayTimeline.size() && replayTimeline[currentEvent] < currentProcessedTime) {
         EventProcessingOptions options;
 
@@ -135,14 +145,17 @@ void ReplayManager::processNewEvents(PlaybackMode playbackMode)
             options |= SKIP_REVEAL_WINDOW;
         }
 
-        // backwards skip => always skip tap animation
-        if (playbackMode == BACKWARD_SKIP) {
+        // any skip => skip tap animation
+        if (isSkip) {
             options |= SKIP_TAP_ANIMATION;
         }
 
         emit eventReplayed(replay->event_list(currentEvent), options);
         ++currentEvent;
     }
+    if (isSkip) {
+        emit skipFinished();
+    }
     if (currentEvent == replayTimeline.size()) {
         emit replayFinished();
         replayTimer->stop();
@@ -75,6 +75,11 @@ signals:
     void eventReplayed(const GameEventContainer &cont, EventProcessingOptions options);
     void replayFinished();
     void rewound();
+    /**
+     * Emitted around the events processed by a skip. None of the intermediate states are meant to be shown.
+     */
+    void skipStarted();
+    void skipFinished();
 };
 
 #endif // COCKATRICE_REPLAY_MANAGER_H
@@ -18,6 +18,8 @@ ReplayWidget::ReplayWidget(QWidget *parent, GameReplay *replay)
     connect(replayManager, &ReplayManager::eventReplayed, this, &ReplayWidget::eventReplayed);
     connect(replayManager, &ReplayManager::replayFinished, this, &ReplayWidget::replayFinished);
     connect(replayManager, &ReplayManager::rewound, this, &ReplayWidget::rewound);
+    connect(replayManager, &ReplayManager::skipStarted, this, &ReplayWidget::skipStarted);
+    connect(replayManager, &ReplayManager::skipFinished, this, &ReplayWidget::skipFinished);
 
     // timeline widget
     timelineWidget = new ReplayTimelineWidget;
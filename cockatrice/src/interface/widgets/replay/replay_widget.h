@@ -36,6 +36,8 @@ public:
 signals:
     void rewound();
     void eventReplayed(const GameEventContainer &cont, EventProcessingOptions options);
+    void skipStarted();
+    void skipFinished();
 
 private:
     ReplayManager *replayManager;
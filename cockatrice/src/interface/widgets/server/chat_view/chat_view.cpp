@@ -8,20 +8,30 @@
 #include "../user/user_list_manager.h"
 #include "../user/user_list_proxy.h"
 
+#include <QAbstractTextDocumentLayout>
 #include <QApplication>
+#include <QDataStream>
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QMouseEvent>
 #include <QScrollBar>
+#include <QTextBlock>
+#include <QTextDocumentFragment>
+#include <QUrl>
 #include <libcockatrice/network/server/remote/user_level.h>
 #include <libcockatrice/settings/chat_settings.h>
 
 const QColor DEFAULT_MENTION_COLOR = QColor(194, 31, 47);
 
-UserMessagePosition::UserMessagePosition(QTextCursor &cursor)
+// blocks kept in the document, older ones are moved to the history in batches
+static constexpr int maxDocumentBlocks = 1000;
+// even, so moving a batch does not change which blocks are drawn in the alternate color
+static constexpr int historyBatchSize = 200;
+static constexpr int maxHistoryBatches = 100;
+
+UserMessagePosition::UserMessagePosition(qint64 _blockId, int _relativePosition)
+    : blockId(_blockId), relativePosition(_relativePosition)
 {
-    block = cursor.block();
-    relativePosition = cursor.position() - block.position();
 }
 
 ChatView::ChatView(TabSupervisor *_tabSupervisor, AbstractGame *_game, bool _showTimestamps, QWidget *parent)
@@ -45,8 +55,15 @@ ChatView::ChatView(TabSupervisor *_tabSupervisor, AbstractGame *_game, bool _sho
     mentionFormatOtherUser.setForeground(linkColor);
     mentionFormatOtherUser.setAnchor(true);
 
+    rebuildHighlightMatcher();
+    connect(&SettingsCache::instance().chat(), &ChatSettings::highlightWordsChanged, this,
+            &ChatView::rebuildHighlightMatcher);
+
     viewport()->setCursor(Qt::IBeamCursor);
     setReadOnly(true);
+    // the chat is never edited, recording every insertion for undo only costs memory
+    document()->setUndoRedoEnabled(false);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &ChatView::loadHistory);
     setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::LinksAccessibleByMouse);
     setOpenLinks(false);
     connect(this, &ChatView::anchorClicked, this, &ChatView::openLink);
@@ -143,12 +160,132 @@ QTextCursor ChatView::prepareBlock(bool same)
     return cursor;
 }
 
+UserMessagePosition ChatView::messagePosition(const QTextCursor &cursor) const
+{
+    return UserMessagePosition(trimmedBlocks + cursor.blockNumber(), cursor.positionInBlock());
+}
+
+void ChatView::scrollToBottom()
+{
+    // the document is only trimmed while the newest messages are followed, so the text being read does not move
+    if (!isBulkAppending()) {
+        trimDocument();
+    }
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void ChatView::trimDocument()
+{
+    QTextDocument *doc = document();
+    if (doc->blockCount() - maxDocumentBlocks < historyBatchSize) {
+        return;
+    }
+
+    QTextCursor cursor(doc);
+    cursor.beginEditBlock();
+    while (doc->blockCount() - maxDocumentBlocks >= historyBatchSize) {
+        HistoryBatch batch;
+        QStringList blocks;
+        QTextBlock block = doc->begin();
+        for (int i = 0; i < historyBatchSize; ++i, block = block.next()) {
+            cursor.setPosition(block.position());
+            cursor.setPosition(block.position() + block.length() - 1, QTextCursor::KeepAnchor);
+            blocks << cursor.selection().toHtml();
+            batch.formats << block.blockFormat();
+        }
+
+        // the remaining block is merged into the first one, which keeps its own format
+        const QTextBlockFormat firstFormat = block.blockFormat();
+        cursor.setPosition(0);
+        cursor.setPosition(block.position(), QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        cursor.setBlockFormat(firstFormat);
+
+        QDataStream stream(&batch.html, QIODevice::WriteOnly);
+        stream << blocks;
+        batch.html = qCompress(batch.html);
+        history.append(batch);
+        trimmedBlocks += historyBatchSize;
+    }
+    cursor.endEditBlock();
+
+    if (history.size() > maxHistoryBatches) {
+        dropHistory();
+    }
+}
+
+void ChatView::dropHistory()
+{
+    while (history.size() > maxHistoryBatches) {
+        history.removeFirst();
+        droppedBlocks += historyBatchSize;
+    }
+
+    // forget the positions of the dropped messages, they are stored in order
+    for (auto it = userMessagePositions.begin(); it != userMessagePositions.end();) {
+        auto &positions = it.value();
+        qsizetype dropped = 0;
+        while (dropped < positions.size() && positions[dropped].blockId < droppedBlocks) {
+            ++dropped;
+        }
+        positions.remove(0, dropped);
+        it = positions.isEmpty() ? userMessagePositions.erase(it) : std::next(it);
+    }
+    for (auto it = pendingRedactions.begin(); it != pendingRedactions.end();) {
+        it = it.key() < droppedBlocks ? pendingRedactions.erase(it) : std::next(it);
+    }
+}
+
+void ChatView::loadHistory(int scrollValue)
+{
+    if (history.isEmpty() || isBulkAppending() || scrollValue > verticalScrollBar()->minimum()) {
+        return;
+    }
+
+    const HistoryBatch batch = history.takeLast();
+    QStringList blocks;
+    QDataStream stream(qUncompress(batch.html));
+    stream >> blocks;
+    trimmedBlocks -= historyBatchSize;
+
+    QTextDocument *doc = document();
+    QTextCursor cursor(doc);
+    cursor.beginEditBlock();
+    for (qsizetype i = blocks.size() - 1; i >= 0; --i) {
+        // split off an empty first block and fill it
+        cursor.setPosition(0);
+        cursor.insertBlock(doc->begin().blockFormat());
+        cursor.setPosition(0);
+
+        // the colors may have changed since the block was trimmed
+        QTextBlockFormat format = batch.formats[i];
+        format.setBackground(i % 2 == 0 ? palette().base() : palette().window());
+        format.setForeground(palette().text());
+        cursor.setBlockFormat(format);
+        cursor.insertFragment(QTextDocumentFragment::fromHtml(blocks[i], doc));
+
+        const auto redaction = pendingRedactions.constFind(trimmedBlocks + i);
+        if (redaction != pendingRedactions.constEnd()) {
+            cursor.setPosition(*redaction);
+            cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+            pendingRedactions.erase(redaction);
+        }
+    }
+    cursor.endEditBlock();
+
+    // keep showing the messages that were at the top before
+    const QTextBlock firstOldBlock = doc->findBlockByNumber(static_cast<int>(blocks.size()));
+    const qreal loadedHeight = doc->documentLayout()->blockBoundingRect(firstOldBlock).top();
+    verticalScrollBar()->setValue(scrollValue + qRound(loadedHeight));
+}
+
 void ChatView::appendHtml(const QString &html)
 {
     bool atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
     prepareBlock().insertHtml(html);
     if (atBottom) {
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
     }
 }
 
@@ -166,10 +303,34 @@ void ChatView::appendHtmlServerMessage(const QString &html, bool optionalIsBold,
 
     prepareBlock().insertHtml(htmlText);
     if (atBottom) {
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
     }
 }
 
+QString ChatView::userLevelImage(int pixelSize, const ServerInfo_User &userInfo, bool isBuddy)
+{
+    const UserLevelFlags userLevel = UserLevelFlags(userInfo.user_level());
+    const QString privLevel = userInfo.has_privlevel() ? QString::fromStdString(userInfo.privlevel()) : "NONE";
+    const auto &pawnColors = userInfo.pawn_colors();
+
+    // inserting the image itself would add a resource to the document for every message, which is never freed
+    const auto encoded = [](const QString &part) { return QString::fromLatin1(QUrl::toPercentEncoding(part)); };
+    const QStringList parts = {QString::number(pixelSize),
+                               QString::number(static_cast<int>(userLevel)),
+                               QString::number(isBuddy ? 1 : 0),
+                               encoded(privLevel.toLower()),
+                               encoded(QString::fromStdString(pawnColors.left_side())),
+                               encoded(QString::fromStdString(pawnColors.right_side()))};
+    const QString name = "userlevel:" + parts.join('/');
+    if (!userLevelImages.contains(name)) {
+        const QPixmap pixmap =
+            UserLevelPixmapGenerator::generatePixmap(pixelSize, userLevel, pawnColors, isBuddy, privLevel);
+        document()->addResource(QTextDocument::ImageResource, QUrl(name), pixmap.toImage());
+        userLevelImages.insert(name);
+    }
+    return name;
+}
+
 void ChatView::appendCardTag(QTextCursor &cursor, const QString &cardName)
 {
     QTextCharFormat oldFormat = cursor.charFormat();
@@ -246,15 +407,12 @@ void ChatView::appendMessage(QString message,
         } else {
             const int pixelSize = QFontInfo(cursor.charFormat().font()).pixelSize();
             bool isBuddy = userListProxy->isUserBuddy(userName);
-            const QString privLevel = userInfo.has_privlevel() ? QString::fromStdString(userInfo.privlevel()) : "NONE";
-            cursor.insertImage(UserLevelPixmapGenerator::generatePixmap(pixelSize, userLevel, userInfo.pawn_colors(),
-                                                                        isBuddy, privLevel)
-                                   .toImage());
+            cursor.insertImage(userLevelImage(pixelSize, userInfo, isBuddy));
             cursor.insertText(" ");
             cursor.setCharFormat(senderFormat);
             cursor.insertText(userName);
             cursor.insertText(": ");
-            userMessagePositions[userName].append(cursor);
+            userMessagePositions[userName].append(messagePosition(cursor));
         }
     }
 
@@ -270,7 +428,7 @@ void ChatView::appendMessage(QString message,
             auto match = userNameRegex.match(message);
             if (match.hasMatch()) {
                 cursor.setCharFormat(defaultFormat);
-                UserMessagePosition pos(cursor);
+                UserMessagePosition pos = messagePosition(cursor);
                 pos.relativePosition = match.captured(0).length(); // set message start
                 auto before = match.captured(1);
                 auto sentBy = match.captured(2);
@@ -294,10 +452,27 @@ void ChatView::appendMessage(QString message,
     cursor.setCharFormat(defaultFormat);
 
     bool mentionEnabled = SettingsCache::instance().chat().getChatMention();
-    highlightedWords = SettingsCache::instance().chat().getHighlightWords().split(' ', Qt::SkipEmptyParts);
+
+    // find the own mention and the highlight words in one pass, the parser below only compares positions
+    const QList<TextPatternMatcher::Match> highlights = highlightMatcher.findAll(message);
+    auto nextHighlight = highlights.cbegin();
+    const qsizetype messageSize = message.size();
 
     // parse the message
     while (message.size()) {
+        const qsizetype position = messageSize - message.size();
+        // skip the matches inside tags and urls, which are printed as a whole
+        while (nextHighlight != highlights.cend() && nextHighlight->start < position) {
+            ++nextHighlight;
+        }
+        if (nextHighlight != highlights.cend() && nextHighlight->start == position &&
+            (nextHighlight->tag != HighlightOwnMention || mentionEnabled)) {
+            appendHighlight(cursor, message.left(nextHighlight->length), nextHighlight->tag, userName);
+            message = message.mid(nextHighlight->length);
+            ++nextHighlight;
+            continue;
+        }
+
         QChar c = message.at(0);
         switch (c.toLatin1()) {
             case '[':
@@ -327,7 +502,7 @@ void ChatView::appendMessage(QString message,
     }
 
     if (atBottom) {
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
     }
 }
 
@@ -389,27 +564,15 @@ void ChatView::checkMention(QTextCursor &cursor, QString &message, const QString
 
     while (fullMentionUpToSpaceOrEnd.size()) {
         const ServerInfo_User *onlineUser = userListProxy->getOnlineUser(fullMentionUpToSpaceOrEnd);
+        // mentions of yourself are found by the highlight matcher
         if (onlineUser) // Is there a user online named this?
         {
-            if (ownUserName.toLower() == fullMentionUpToSpaceOrEnd.toLower()) // Is this user you?
-            {
-                // You have received a valid mention!!
-                soundEngine->playSound("chat_mention");
-                mentionFormat.setBackground(QBrush(getCustomMentionColor()));
-                mentionFormat.setForeground(SettingsCache::instance().chat().getChatMentionForeground()
-                                                ? QBrush(Qt::white)
-                                                : QBrush(Qt::black));
-                cursor.insertText(mention, mentionFormat);
-                message = message.mid(mention.size());
-                showSystemPopup(userName);
-            } else {
-                QString correctUserName = QString::fromStdString(onlineUser->name());
-                mentionFormatOtherUser.setAnchorHref("user://" + QString::number(onlineUser->user_level()) + "_" +
-                                                     correctUserName);
-                cursor.insertText("@" + correctUserName, mentionFormatOtherUser);
+            QString correctUserName = QString::fromStdString(onlineUser->name());
+            mentionFormatOtherUser.setAnchorHref("user://" + QString::number(onlineUser->user_level()) + "_" +
+                                                 correctUserName);
+            cursor.insertText("@" + correctUserName, mentionFormatOtherUser);
 
-                message = message.mid(correctUserName.size() + 1);
-            }
+            message = message.mid(correctUserName.size() + 1);
 
             cursor.setCharFormat(defaultFormat);
             return;
@@ -462,24 +625,31 @@ void ChatView::checkWord(QTextCursor &cursor, QString &message)
         }
     }
 
-    // check word mentions
-    for (const QString &word : highlightedWords) {
-        if (fullWordUpToSpaceOrEnd.compare(word, Qt::CaseInsensitive) == 0) {
-            // You have received a valid mention of custom word!!
-            highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
-            highlightFormat.setForeground(
-                SettingsCache::instance().chat().getChatHighlightForeground() ? QBrush(Qt::white) : QBrush(Qt::black));
-            cursor.insertText(fullWordUpToSpaceOrEnd, highlightFormat);
-            cursor.insertText(rest, defaultFormat);
-            QApplication::alert(this);
-            return;
-        }
-    }
-
     // not a special word; just print it
     cursor.insertText(fullWordUpToSpaceOrEnd + rest, defaultFormat);
 }
 
+void ChatView::appendHighlight(QTextCursor &cursor, const QString &text, int highlightType, const QString &userName)
+{
+    if (highlightType == HighlightOwnMention) {
+        // You have received a valid mention!!
+        soundEngine->playSound("chat_mention");
+        mentionFormat.setBackground(QBrush(getCustomMentionColor()));
+        mentionFormat.setForeground(
+            SettingsCache::instance().chat().getChatMentionForeground() ? QBrush(Qt::white) : QBrush(Qt::black));
+        cursor.insertText(mention, mentionFormat);
+        showSystemPopup(userName);
+    } else {
+        // You have received a valid mention of custom word!!
+        highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
+        highlightFormat.setForeground(
+            SettingsCache::instance().chat().getChatHighlightForeground() ? QBrush(Qt::white) : QBrush(Qt::black));
+        cursor.insertText(text, highlightFormat);
+        QApplication::alert(this);
+    }
+    cursor.setCharFormat(defaultFormat);
+}
+
 QString ChatView::extractNextWord(QString &message, QString &rest)
 {
     // get the first next space and extract the word
@@ -516,6 +686,22 @@ bool ChatView::isModeratorSendingGlobal(QFlags<ServerInfo_User::UserLevelFlag> u
             (userLevel & ServerInfo_User::IsModerator || userLevel & ServerInfo_User::IsAdmin));
 }
 
+/**
+ * Compiles the own mention and the highlight words into the matcher used for every appended message.
+ */
+void ChatView::rebuildHighlightMatcher()
+{
+    highlightMatcher.clear();
+    // added first, so it keeps its type if it is also a highlight word
+    if (!ownUserName.isEmpty()) {
+        highlightMatcher.addPattern(mention, HighlightOwnMention);
+    }
+    for (const QString &word : SettingsCache::instance().chat().getHighlightWords().split(' ', Qt::SkipEmptyParts)) {
+        highlightMatcher.addPattern(word, HighlightWord);
+    }
+    highlightMatcher.build();
+}
+
 void ChatView::actMessageClicked()
 {
     emit messageClickedSignal();
@@ -553,9 +739,41 @@ QColor ChatView::getCustomHighlightColor()
 
 void ChatView::clearChat()
 {
+    // clearing the document drops its resources as well
     document()->clear();
+    userLevelImages.clear();
     lastSender = "";
     evenNumber = true;
+    userMessagePositions.clear();
+    history.clear();
+    pendingRedactions.clear();
+    droppedBlocks = 0;
+    trimmedBlocks = 0;
+}
+
+void ChatView::beginBulkAppend()
+{
+    if (bulkAppendDepth++ > 0) {
+        return;
+    }
+
+    bulkAppendAtBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    // an edit block defers the relayout of the document until it ends, no matter which cursor inserts the text
+    bulkAppendCursor = QTextCursor(document());
+    bulkAppendCursor.beginEditBlock();
+}
+
+void ChatView::endBulkAppend()
+{
+    if (bulkAppendDepth == 0 || --bulkAppendDepth > 0) {
+        return;
+    }
+
+    bulkAppendCursor.endEditBlock();
+    bulkAppendCursor = QTextCursor();
+    if (bulkAppendAtBottom) {
+        scrollToBottom();
+    }
 }
 
 void ChatView::redactMessages(const QString &userName, int amount)
@@ -564,8 +782,23 @@ void ChatView::redactMessages(const QString &userName, int amount)
     bool removedLastMessage = false;
     QTextCursor cursor(document());
     for (; !messagePositions.isEmpty() && amount != 0; --amount) {
-        auto position = messagePositions.takeLast();   // go backwards from last message
-        cursor.setPosition(position.block.position()); // move to start of block, then continue to start of message
+        auto position = messagePositions.takeLast(); // go backwards from last message
+        if (position.blockId < droppedBlocks) {
+            continue;
+        }
+        if (position.blockId < trimmedBlocks) {
+            // the block is in the history, the rest of the block is removed when it is loaded again
+            auto redaction = pendingRedactions.find(position.blockId);
+            if (redaction == pendingRedactions.end()) {
+                pendingRedactions.insert(position.blockId, position.relativePosition);
+            } else if (*redaction > position.relativePosition) {
+                *redaction = position.relativePosition;
+            }
+            continue;
+        }
+        // move to start of block, then continue to start of message
+        const QTextBlock block = document()->findBlockByNumber(static_cast<int>(position.blockId - trimmedBlocks));
+        cursor.setPosition(block.position());
         cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, position.relativePosition);
         cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor); // select until end of block
         cursor.removeSelectedText();
@@ -575,7 +808,7 @@ void ChatView::redactMessages(const QString &userName, int amount)
     }
     if (removedLastMessage) {
         cursor.movePosition(QTextCursor::End);
-        messagePositions.append(cursor);
+        messagePositions.append(messagePosition(cursor));
         // note that this message might stay empty, this is not harmful as it will simply remove nothing the next time
     }
 }
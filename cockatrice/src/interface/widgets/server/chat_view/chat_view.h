@@ -13,11 +13,15 @@
 
 #include <QAction>
 #include <QColor>
+#include <QHash>
+#include <QSet>
+#include <QTextBlockFormat>
 #include <QTextBrowser>
 #include <QTextCursor>
 #include <QTextFragment>
 #include <libcockatrice/network/server/remote/room_message_type.h>
 #include <libcockatrice/network/server/remote/user_level.h>
+#include <libcockatrice/utility/text_pattern_matcher.h>
 
 class AbstractGame;
 class QTextTable;
@@ -25,12 +29,16 @@ class QMouseEvent;
 class UserContextMenu;
 class UserListProxy;
 
+/**
+ * Where a message starts. The block is identified by its number counted from the first block ever appended, which
+ * stays the same when older blocks are moved out of the document into the history and back.
+ */
 class UserMessagePosition
 {
 public:
-    UserMessagePosition(QTextCursor &cursor);
+    UserMessagePosition(qint64 _blockId, int _relativePosition);
+    qint64 blockId;
     int relativePosition;
-    QTextBlock block;
 };
 
 class ChatView : public QTextBrowser
@@ -48,6 +56,11 @@ private:
         HoveredCard,
         HoveredUser
     };
+    enum HighlightType
+    {
+        HighlightOwnMention,
+        HighlightWord
+    };
     const UserListProxy *const userListProxy;
     UserContextMenu *userContextMenu;
     QString lastSender;
@@ -57,7 +70,7 @@ private:
     QTextCharFormat highlightFormat;
     QTextCharFormat mentionFormatOtherUser;
     QTextCharFormat defaultFormat;
-    QStringList highlightedWords;
+    TextPatternMatcher highlightMatcher;
     bool evenNumber;
     bool showTimestamps;
     HoveredItemType hoveredItemType;
@@ -65,8 +78,36 @@ private:
     QAction *messageClicked;
     QMap<QString, QVector<UserMessagePosition>> userMessagePositions;
 
+    /**
+     * A run of blocks trimmed from the top of the document. The contents of the blocks are kept as compressed html,
+     * one entry per block, so a long session costs a few bytes per message instead of a laid out block.
+     */
+    struct HistoryBatch
+    {
+        QList<QTextBlockFormat> formats;
+        QByteArray html;
+    };
+    // oldest first, the last batch is the one right above the top of the document
+    QList<HistoryBatch> history;
+    // blocks that were dropped from the history altogether
+    qint64 droppedBlocks = 0;
+    // blocks above the first block of the document, in the history or dropped
+    qint64 trimmedBlocks = 0;
+    // messages redacted while their block was in the history, by block id, removed once the block is loaded again
+    QHash<qint64, int> pendingRedactions;
+    // names of the user level images added to the document, each one is shared by all messages showing it
+    QSet<QString> userLevelImages;
+    int bulkAppendDepth = 0;
+    bool bulkAppendAtBottom = false;
+    QTextCursor bulkAppendCursor;
+
     [[nodiscard]] QTextFragment getFragmentUnderMouse(const QPoint &pos) const;
     QTextCursor prepareBlock(bool same = false);
+    [[nodiscard]] UserMessagePosition messagePosition(const QTextCursor &cursor) const;
+    void scrollToBottom();
+    void trimDocument();
+    void dropHistory();
+    QString userLevelImage(int pixelSize, const ServerInfo_User &userInfo, bool isBuddy);
     void appendCardTag(QTextCursor &cursor, const QString &cardName);
     void appendUrlTag(QTextCursor &cursor, QString url);
     static QColor getCustomMentionColor();
@@ -76,6 +117,7 @@ private:
     void checkTag(QTextCursor &cursor, QString &message);
     void checkMention(QTextCursor &cursor, QString &message, const QString &userName, UserLevelFlags userLevel);
     void checkWord(QTextCursor &cursor, QString &message);
+    void appendHighlight(QTextCursor &cursor, const QString &text, int highlightType, const QString &userName);
     QString extractNextWord(QString &message, QString &rest);
 
     QColor otherUserColor = QColor(0, 65, 255); // dark blue
@@ -86,6 +128,8 @@ private slots:
     void openLink(const QUrl &link);
     void actMessageClicked();
     void adjustColorsToPalette();
+    void loadHistory(int scrollValue);
+    void rebuildHighlightMatcher();
     void refreshBlockColors();
 
 public:
@@ -101,8 +145,18 @@ public:
                        bool playerBold = false);
     void clearChat();
     void redactMessages(const QString &userName, int amount);
+    /**
+     * Messages appended until the matching endBulkAppend() are laid out in one go instead of one by one.
+     * Calls may be nested.
+     */
+    void beginBulkAppend();
+    void endBulkAppend();
 
 protected:
+    [[nodiscard]] bool isBulkAppending() const
+    {
+        return bulkAppendDepth > 0;
+    }
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     void enterEvent(QEnterEvent *event) override;
 #else
@@ -155,11 +155,17 @@ GameSelector::GameSelector(AbstractClient *_client,
             &GameSelector::actSelectedGameChanged);
     connect(gameListView, &QTreeView::activated, this, &GameSelector::actJoin);
 
+    connect(client, &AbstractClient::buddyListReceived, this, &GameSelector::buddyListReceived);
     connect(client, &AbstractClient::ignoreListReceived, this, &GameSelector::ignoreListReceived);
     connect(client, &AbstractClient::addToListEventReceived, this, &GameSelector::processAddToListEvent);
     connect(client, &AbstractClient::removeFromListEventReceived, this, &GameSelector::processRemoveFromListEvent);
 }
 
+void GameSelector::buddyListReceived(const QList<ServerInfo_User> &)
+{
+    gameListProxyModel->refresh();
+}
+
 void GameSelector::ignoreListReceived(const QList<ServerInfo_User> &)
 {
     gameListProxyModel->refresh();
@@ -167,7 +173,8 @@ void GameSelector::ignoreListReceived(const QList<ServerInfo_User> &)
 
 void GameSelector::processAddToListEvent(const Event_AddToList &event)
 {
-    if (event.list_name() == "ignore") {
+    // the proxy caches the buddy and ignore status of the game creators
+    if (event.list_name() == "ignore" || event.list_name() == "buddy") {
         gameListProxyModel->refresh();
     }
     updateTitle();
@@ -175,7 +182,7 @@ void GameSelector::processAddToListEvent(const Event_AddToList &event)
 
 void GameSelector::processRemoveFromListEvent(const Event_RemoveFromList &event)
 {
-    if (event.list_name() == "ignore") {
+    if (event.list_name() == "ignore" || event.list_name() == "buddy") {
         gameListProxyModel->refresh();
     }
     updateTitle();
@@ -430,7 +437,26 @@ void GameSelector::retranslateUi()
 void GameSelector::processGameInfo(const ServerInfo_Game &info)
 {
     gameListModel->updateGameList(info);
-    updateTitle();
+    if (gameListUpdateDepth == 0) {
+        updateTitle();
+    }
+}
+
+void GameSelector::beginGameListUpdate()
+{
+    ++gameListUpdateDepth;
+    gameListModel->beginGameListUpdate();
+}
+
+void GameSelector::endGameListUpdate()
+{
+    if (gameListUpdateDepth == 0) {
+        return;
+    }
+    gameListModel->endGameListUpdate();
+    if (--gameListUpdateDepth == 0) {
+        updateTitle();
+    }
 }
 
 void GameSelector::actSelectedGameChanged(const QModelIndex &current, const QModelIndex & /* previous */)
@@ -92,6 +92,12 @@ private slots:
      */
     void checkResponse(const Response &response);
 
+    /**
+     * @brief Refreshes the game list when the buddy list is received from the server.
+     * @param _buddyList The list of buddies.
+     */
+    void buddyListReceived(const QList<ServerInfo_User> &_buddyList);
+
     /**
      * @brief Refreshes the game list when the ignore list is received from the server.
      * @param _ignoreList The list of users being ignored.
@@ -125,6 +131,7 @@ private:
     QTreeView *gameListView;             /**< View widget for displaying the game list. */
     GamesModel *gameListModel;           /**< Model containing all games. */
     GamesProxyModel *gameListProxyModel; /**< Proxy model for filtering and sorting the game list. */
+    int gameListUpdateDepth = 0;         /**< Nesting depth of beginGameListUpdate() calls. */
 
     GameSelectorQuickFilterToolBar *quickFilterToolBar;
 
@@ -202,6 +209,13 @@ public:
      * @param info The ServerInfo_Game object containing information about the game to update.
      */
     void processGameInfo(const ServerInfo_Game &info);
+
+    /**
+     * @brief Games processed until the matching endGameListUpdate() are applied to the list in one go.
+     * Calls may be nested.
+     */
+    void beginGameListUpdate();
+    void endGameListUpdate();
 };
 
 #endif
@@ -9,6 +9,8 @@
 #include <QDateTime>
 #include <QIcon>
 #include <QTimeZone>
+#include <algorithm>
+#include <functional>
 #include <libcockatrice/protocol/pb/serverinfo_game.pb.h>
 #include <libcockatrice/settings/game_filters_settings.h>
 
@@ -264,22 +266,89 @@ const ServerInfo_Game &GamesModel::getGame(int row)
 
 void GamesModel::updateGameList(const ServerInfo_Game &game)
 {
-    for (int i = 0; i < gameList.size(); i++) {
-        if (gameList[i].game_id() == game.game_id()) {
-            if (game.closed()) {
-                beginRemoveRows(QModelIndex(), i, i);
-                gameList.removeAt(i);
-                endRemoveRows();
+    beginGameListUpdate();
+
+    const auto rowIt = gameRows.constFind(game.game_id());
+    if (rowIt == gameRows.constEnd()) {
+        if (!game.closed()) {
+            gameRows.insert(game.game_id(), static_cast<int>(gameList.size() + pendingGames.size()));
+            pendingGames.append(game);
+        }
+    } else {
+        const int row = *rowIt;
+        if (game.closed()) {
+            // leave a tombstone, the rows are removed and renumbered once when the update ends
+            gameRows.erase(rowIt);
+            if (row < gameList.size()) {
+                closedRows.append(row);
             } else {
-                gameList[i].MergeFrom(game);
-                emit dataChanged(index(i, 0), index(i, NUM_COLS - 1));
+                pendingGames[row - gameList.size()].set_closed(true);
             }
-            return;
+        } else if (row < gameList.size()) {
+            gameList[row].MergeFrom(game);
+            firstChangedRow = firstChangedRow == -1 ? row : qMin(firstChangedRow, row);
+            lastChangedRow = qMax(lastChangedRow, row);
+        } else {
+            pendingGames[row - gameList.size()].MergeFrom(game);
+        }
+    }
+
+    endGameListUpdate();
+}
+
+void GamesModel::beginGameListUpdate()
+{
+    ++updateDepth;
+}
+
+void GamesModel::endGameListUpdate()
+{
+    if (updateDepth == 0 || --updateDepth > 0) {
+        return;
+    }
+
+    if (firstChangedRow != -1) {
+        emit dataChanged(index(firstChangedRow, 0), index(lastChangedRow, NUM_COLS - 1));
+        firstChangedRow = -1;
+        lastChangedRow = -1;
+    }
+
+    // remove the closed games from the back, one contiguous range at a time
+    bool rowsRemoved = !closedRows.isEmpty();
+    std::sort(closedRows.begin(), closedRows.end(), std::greater<int>());
+    for (qsizetype i = 0; i < closedRows.size();) {
+        const int last = closedRows[i];
+        int first = last;
+        while (++i < closedRows.size() && closedRows[i] == first - 1) {
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        gameList.erase(gameList.begin() + first, gameList.begin() + last + 1);
+        endRemoveRows();
+    }
+    closedRows.clear();
+
+    // games that were added and closed during the update are dropped, which moves the pending games after them
+    const qsizetype pendingCount = pendingGames.size();
+    pendingGames.erase(std::remove_if(pendingGames.begin(), pendingGames.end(),
+                                      [](const ServerInfo_Game &game) { return game.closed(); }),
+                       pendingGames.end());
+    rowsRemoved = rowsRemoved || pendingGames.size() != pendingCount;
+    if (!pendingGames.isEmpty()) {
+        const int first = static_cast<int>(gameList.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(pendingGames.size()) - 1);
+        gameList.append(pendingGames);
+        pendingGames.clear();
+        endInsertRows();
+    }
+
+    if (rowsRemoved) {
+        gameRows.clear();
+        gameRows.reserve(gameList.size());
+        for (int row = 0; row < gameList.size(); ++row) {
+            gameRows.insert(gameList[row].game_id(), row);
         }
     }
-    beginInsertRows(QModelIndex(), gameList.size(), gameList.size());
-    gameList.append(game);
-    endInsertRows();
 }
 
 GamesProxyModel::GamesProxyModel(QObject *parent, const UserListProxy *_userListProxy)
@@ -311,13 +380,8 @@ int GamesProxyModel::getNumFilteredGames() const
         return 0;
     }
 
-    int numFilteredGames = 0;
-    for (int row = 0; row < model->rowCount(); ++row) {
-        if (!filterAcceptsRow(row)) {
-            ++numFilteredGames;
-        }
-    }
-    return numFilteredGames;
+    // the proxy only has rows for the accepted games
+    return model->rowCount() - rowCount();
 }
 
 void GamesProxyModel::resetFilterParameters()
@@ -408,12 +472,10 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow) const
     if (filters.hideOpenDecklistGames && game.share_decklists_on_load()) {
         return false;
     }
-    if (filters.hideIgnoredUserGames &&
-        userListProxy->isUserIgnored(QString::fromStdString(game.creator_info().name()))) {
+    if (filters.hideIgnoredUserGames && getCreatorStatus(game).isIgnored) {
         return false;
     }
-    if (filters.hideNotBuddyCreatedGames &&
-        !userListProxy->isUserBuddy(QString::fromStdString(game.creator_info().name()))) {
+    if (filters.hideNotBuddyCreatedGames && !getCreatorStatus(game).isBuddy) {
         return false;
     }
     if (filters.hideFullGames && game.player_count() == game.max_players()) {
@@ -447,12 +509,12 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow) const
         }
     }
 
-    QSet<int> gameTypes;
-    for (int i = 0; i < game.game_types_size(); ++i) {
-        gameTypes.insert(game.game_types(i));
-    }
-    if (!filters.gameTypeFilter.isEmpty() && gameTypes.intersect(filters.gameTypeFilter).isEmpty()) {
-        return false;
+    if (!filters.gameTypeFilter.isEmpty()) {
+        const auto &gameTypes = game.game_types();
+        if (std::none_of(gameTypes.begin(), gameTypes.end(),
+                         [this](int gameType) { return filters.gameTypeFilter.contains(gameType); })) {
+            return false;
+        }
     }
 
     if (static_cast<int>(game.max_players()) < filters.maxPlayersFilterMin) {
@@ -491,11 +553,50 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow) const
     return true;
 }
 
+GamesProxyModel::CreatorStatus GamesProxyModel::getCreatorStatus(const ServerInfo_Game &game) const
+{
+    const auto cached = creatorStatus.constFind(game.game_id());
+    if (cached != creatorStatus.constEnd()) {
+        return *cached;
+    }
+
+    const QString creatorName = QString::fromStdString(game.creator_info().name());
+    const CreatorStatus status{userListProxy->isUserBuddy(creatorName), userListProxy->isUserIgnored(creatorName)};
+    creatorStatus.insert(game.game_id(), status);
+    return status;
+}
+
 void GamesProxyModel::refresh()
 {
+    creatorStatus.clear();
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 10, 0))
     endFilterChange(QSortFilterProxyModel::Direction::Rows);
 #else
     invalidateFilter();
 #endif
 }
+
+void GamesProxyModel::setSourceModel(QAbstractItemModel *newSourceModel)
+{
+    if (sourceModel()) {
+        disconnect(sourceModel(), &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                   &GamesProxyModel::sourceRowsAboutToBeRemoved);
+    }
+    creatorStatus.clear();
+    QSortFilterProxyModel::setSourceModel(newSourceModel);
+    if (newSourceModel) {
+        connect(newSourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                &GamesProxyModel::sourceRowsAboutToBeRemoved);
+    }
+}
+
+void GamesProxyModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    auto *model = qobject_cast<GamesModel *>(sourceModel());
+    if (!model || parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; ++row) {
+        creatorStatus.remove(model->getGame(row).game_id());
+    }
+}
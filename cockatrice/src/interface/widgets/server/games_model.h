@@ -4,6 +4,7 @@
 #include "game_filter_configs.h"
 #include "game_type_map.h"
 
+#include <QHash>
 #include <QList>
 #include <QSet>
 #include <QSortFilterProxyModel>
@@ -25,9 +26,17 @@ class GamesModel : public QAbstractTableModel
     Q_OBJECT
 private:
     QList<ServerInfo_Game> gameList;  /**< List of games currently displayed. */
+    QHash<int, int> gameRows;         /**< Map of game IDs to their row, including the games pending insertion. */
     QMap<int, QString> rooms;         /**< Map of room IDs to room names. */
     QMap<int, GameTypeMap> gameTypes; /**< Map of room IDs to available game types. */
 
+    // changes collected until the outermost endGameListUpdate()
+    int updateDepth = 0;
+    QList<ServerInfo_Game> pendingGames; /**< New games, inserted at the end of the list. */
+    QList<int> closedRows;               /**< Rows of closed games, removed at the end of the update. */
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
+
     static const int NUM_COLS = 8; /**< Number of columns in the table. */
 
 public:
@@ -72,10 +81,21 @@ public:
 
     /**
      * @brief Updates the game list with a new or updated game.
+     *
+     * Within a beginGameListUpdate() / endGameListUpdate() pair the change is only applied to the view when the
+     * update ends.
+     *
      * @param game The ServerInfo_Game object to add or update.
      */
     void updateGameList(const ServerInfo_Game &game);
 
+    /**
+     * @brief Collects the games passed to updateGameList() until the matching endGameListUpdate(), which inserts,
+     * updates and removes them with one signal per kind of change. Calls may be nested.
+     */
+    void beginGameListUpdate();
+    void endGameListUpdate();
+
     /**
      * @brief Returns the index of the room column.
      */
@@ -115,6 +135,17 @@ class GamesProxyModel : public QSortFilterProxyModel
 private:
     const UserListProxy *userListProxy; /**< Proxy for checking user ignore/buddy lists. */
 
+    struct CreatorStatus
+    {
+        bool isBuddy;
+        bool isIgnored;
+    };
+    /**
+     * Buddy and ignore status of the creator by game ID, cleared by refresh() when the lists change. Entries are
+     * dropped with the rows of their games.
+     */
+    mutable QHash<int, CreatorStatus> creatorStatus;
+
     // If adding any additional filters, make sure to update:
     // - GamesProxyModel()
     // - resetFilterParameters()
@@ -178,9 +209,17 @@ public:
      */
     void refresh();
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 protected:
     [[nodiscard]] bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
     [[nodiscard]] bool filterAcceptsRow(int sourceRow) const;
+
+private:
+    [[nodiscard]] CreatorStatus getCreatorStatus(const ServerInfo_Game &game) const;
+
+private slots:
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include <libcockatrice/protocol/pending_command.h>
 
 const int RemoteReplayList_TreeModel::numberOfColumns = 6;
+const int RemoteReplayList_TreeModel::replayListPageSize = 100;
 
 RemoteReplayList_TreeModel::MatchNode::MatchNode(const ServerInfo_ReplayMatch &_matchInfo)
     : RemoteReplayList_TreeModel::Node(QString::fromStdString(_matchInfo.game_name())), matchInfo(_matchInfo)
@@ -270,8 +271,31 @@ void RemoteReplayList_TreeModel::clearAll()
 
 void RemoteReplayList_TreeModel::refreshTree()
 {
-    PendingCommand *pend = client->prepareSessionCommand(Command_ReplayList());
-    connect(pend, &PendingCommand::finished, this, &RemoteReplayList_TreeModel::replayListFinished);
+    requestReplayListPage(++refreshGeneration, QString());
+}
+
+/**
+ * Requests a page of matches, newest first. Servers without the "replay_list_paging" feature are asked for all matches
+ * at once.
+ */
+void RemoteReplayList_TreeModel::requestReplayListPage(int generation, const QString &pageToken)
+{
+    Command_ReplayList cmd;
+    if (client->getServerSupportsFeature("replay_list_paging")) {
+        cmd.set_page_size(replayListPageSize);
+        if (!pageToken.isEmpty()) {
+            cmd.set_page_token(pageToken.toStdString());
+        }
+    }
+
+    const bool firstPage = pageToken.isEmpty();
+    PendingCommand *pend = client->prepareSessionCommand(cmd);
+    connect(pend, &PendingCommand::finished, this, [this, generation, firstPage](const Response &r) {
+        // drop pages of a refresh that has been superseded by a newer one
+        if (generation == refreshGeneration) {
+            replayListPageFinished(r, generation, firstPage);
+        }
+    });
 
     client->sendCommand(pend);
 }
@@ -316,19 +340,32 @@ void RemoteReplayList_TreeModel::removeMatchInfo(int gameId)
     }
 }
 
-void RemoteReplayList_TreeModel::replayListFinished(const Response &r)
+void RemoteReplayList_TreeModel::replayListPageFinished(const Response &r, int generation, bool firstPage)
 {
     const Response_ReplayList &resp = r.GetExtension(Response_ReplayList::ext);
 
-    beginResetModel();
-    clearAll();
+    // the list is shown as soon as the first page arrives and grows with every following page
+    if (firstPage) {
+        beginResetModel();
+        clearAll();
+    } else if (resp.match_list_size() > 0) {
+        beginInsertRows(QModelIndex(), replayMatches.size(), replayMatches.size() + resp.match_list_size() - 1);
+    }
 
     for (int i = 0; i < resp.match_list_size(); ++i) {
         replayMatches.append(new MatchNode(resp.match_list(i)));
     }
 
-    endResetModel();
+    if (firstPage) {
+        endResetModel();
+    } else if (resp.match_list_size() > 0) {
+        endInsertRows();
+    }
     emit treeRefreshed();
+
+    if (resp.has_next_page_token()) {
+        requestReplayListPage(generation, QString::fromStdString(resp.next_page_token()));
+    }
 }
 
 RemoteReplayList_TreeWidget::RemoteReplayList_TreeWidget(AbstractClient *_client, QWidget *parent) : QTreeView(parent)
@@ -77,15 +77,17 @@ private:
 
     AbstractClient *client;
     QList<MatchNode *> replayMatches;
+    int refreshGeneration = 0;
 
     QIcon dirIcon, fileIcon, lockIcon;
     void clearAll();
+    void requestReplayListPage(int generation, const QString &pageToken);
+    void replayListPageFinished(const Response &r, int generation, bool firstPage);
 
     static const int numberOfColumns;
+    static const int replayListPageSize;
 signals:
     void treeRefreshed();
-private slots:
-    void replayListFinished(const Response &r);
 
 public:
     explicit RemoteReplayList_TreeModel(AbstractClient *_client, QObject *parent = nullptr);
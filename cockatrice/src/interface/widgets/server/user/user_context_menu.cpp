@@ -111,9 +111,11 @@ void UserContextMenu::gamesOfUserReceived(const Response &resp, const CommandCon
     auto *selector = new GameSelector(client, tabSupervisor, nullptr, roomMap, gameTypeMap, false, false);
     selector->setParent(static_cast<QWidget *>(parent()), Qt::Window);
     const int gameListSize = response.game_list_size();
+    selector->beginGameListUpdate();
     for (int i = 0; i < gameListSize; ++i) {
         selector->processGameInfo(response.game_list(i));
     }
+    selector->endGameListUpdate();
 
     selector->setWindowTitle(tr("%1's games").arg(QString::fromStdString(cmd.user_name())));
     selector->setMinimumWidth(800);
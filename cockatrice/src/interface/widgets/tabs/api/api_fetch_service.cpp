@@ -0,0 +1,19 @@
+#include "api_fetch_service.h"
+
+#include "../../../../client/settings/cache_settings.h"
+
+#include <QCoreApplication>
+#include <version_string.h>
+
+HttpFetchService &ApiFetchService::instance()
+{
+    // parented to the application, so the network manager is gone before the application is
+    static HttpFetchService *service = [] {
+        auto *fetchService =
+            new HttpFetchService(SettingsCache::instance().getCachePath() + "/api", HttpFetchService::defaultMaxCacheSize,
+                                 QCoreApplication::instance());
+        fetchService->setUserAgent(QString("Cockatrice %1").arg(VERSION_STRING).toUtf8());
+        return fetchService;
+    }();
+    return *service;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file api_fetch_service.h
+ * @ingroup Tabs
+ * @brief The fetch service shared by the EDHREC and Archidekt tabs.
+ */
+
+#ifndef API_FETCH_SERVICE_H
+#define API_FETCH_SERVICE_H
+
+#include <libcockatrice/network/http/http_fetch_service.h>
+
+namespace ApiFetchService
+{
+/** How long a fetched EDHREC or Archidekt page is shown again without asking the site if it changed. */
+constexpr qint64 pageMaxAgeSecs = 6 * 60 * 60;
+
+/** How long Archidekt search results and decks are shown again, shorter since decks are edited by their owners. */
+constexpr qint64 searchMaxAgeSecs = 10 * 60;
+
+/** How long a fetched preview image is shown again without asking the site if it changed. */
+constexpr qint64 imageMaxAgeSecs = 7 * 24 * 60 * 60;
+
+/**
+ * @return The service all API tabs fetch through, caching its responses in the "api" directory of the cache path.
+ */
+HttpFetchService &instance();
+} // namespace ApiFetchService
+
+#endif // API_FETCH_SERVICE_H
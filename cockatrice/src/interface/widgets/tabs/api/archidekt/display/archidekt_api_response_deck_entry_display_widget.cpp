@@ -4,15 +4,13 @@
 #include "../../../../cards/card_info_picture_with_text_overlay_widget.h"
 #include "../../../../general/display/background_plate_widget.h"
 #include "../../../../general/display/charts/bars/color_bar.h"
+#include "../../api_fetch_service.h"
 #include "archidekt_deck_preview_image_display_widget.h"
 
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QPixmap>
 #include <QWidget>
-#include <version_string.h>
 
 #define ARCHIDEKT_DEFAULT_IMAGE "https://storage.googleapis.com/topdekt-user/images/archidekt_deck_card_shadow.jpg"
 
@@ -47,9 +45,8 @@ static QString timeAgo(const QString &timestamp)
 
 ArchidektApiResponseDeckEntryDisplayWidget::ArchidektApiResponseDeckEntryDisplayWidget(
     QWidget *parent,
-    ArchidektApiResponseDeckListingContainer _response,
-    QNetworkAccessManager *_imageNetworkManager)
-    : QWidget(parent), response(_response), imageNetworkManager(_imageNetworkManager)
+    ArchidektApiResponseDeckListingContainer _response)
+    : QWidget(parent), response(_response)
 {
     layout = new QVBoxLayout(this);
     setLayout(layout);
@@ -88,16 +85,10 @@ ArchidektApiResponseDeckEntryDisplayWidget::ArchidektApiResponseDeckEntryDisplay
 
     imageUrl = response.getFeatured().isEmpty() ? QUrl(ARCHIDEKT_DEFAULT_IMAGE) : QUrl(response.getFeatured());
 
-    QNetworkRequest req(imageUrl);
-    req.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    QNetworkReply *reply = imageNetworkManager->get(req);
-
-    // tag the reply with "this" so we know it belongs to us later
-    reply->setProperty("deckWidget", QVariant::fromValue<void *>(this));
-    reply->setProperty("requestedUrl", imageUrl);
-
-    connect(imageNetworkManager, &QNetworkAccessManager::finished, this,
-            &ArchidektApiResponseDeckEntryDisplayWidget::onPreviewImageLoadFinished);
+    // Many decks share the default image, the fetch service downloads it once for all of them
+    ApiFetchService::instance().fetch(
+        imageUrl, this, [this](const HttpFetchService::Response &reply) { onPreviewImageLoadFinished(reply); },
+        ApiFetchService::imageMaxAgeSecs);
 
     headerLayout->addWidget(previewWidget);
 
@@ -159,24 +150,11 @@ void ArchidektApiResponseDeckEntryDisplayWidget::setScaleFactor(int scale)
     updateScaledPreview();
 }
 
-void ArchidektApiResponseDeckEntryDisplayWidget::onPreviewImageLoadFinished(QNetworkReply *reply)
+void ArchidektApiResponseDeckEntryDisplayWidget::onPreviewImageLoadFinished(const HttpFetchService::Response &reply)
 {
-    // Check if this is our reply
-    void *owner = reply->property("deckWidget").value<void *>();
-    if (owner != this) {
-        return; // not our reply
-    }
-
-    // Check that the requested URL matches what we asked
-    QUrl requestedUrl = reply->property("requestedUrl").toUrl();
-    if (requestedUrl != imageUrl) {
-        reply->deleteLater();
-        return;
-    }
-
     QPixmap loaded;
 
-    if (reply->error() != QNetworkReply::NoError || !loaded.loadFromData(reply->readAll())) {
+    if (!reply.isOk() || !loaded.loadFromData(reply.body)) {
         CardPictureLoader::getCardBackLoadingFailedPixmap(loaded, QSize(400, 400));
     }
 
@@ -188,8 +166,6 @@ void ArchidektApiResponseDeckEntryDisplayWidget::onPreviewImageLoadFinished(QNet
 
     // Initial scaling
     updateScaledPreview();
-
-    reply->deleteLater();
 }
 
 void ArchidektApiResponseDeckEntryDisplayWidget::updateScaledPreview()
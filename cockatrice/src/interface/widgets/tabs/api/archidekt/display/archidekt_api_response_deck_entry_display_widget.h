@@ -3,10 +3,10 @@
 
 #include "../../../../cards/card_info_picture_with_text_overlay_widget.h"
 #include "../api_response/deck_listings/archidekt_api_response_deck_listing_container.h"
+#include "../../api_fetch_service.h"
 #include "archidekt_deck_preview_image_display_widget.h"
 
 #include <QLabel>
-#include <QNetworkAccessManager>
 #include <QResizeEvent>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -18,7 +18,7 @@ class BackgroundPlateWidget;
  * @brief Displays a single Archidekt deck listing as a preview card with metadata.
  *
  * This widget renders a deck entry received from an Archidekt API response. It includes:
- *  - A scaled deck preview image loaded asynchronously via QNetworkAccessManager.
+ *  - A scaled deck preview image loaded asynchronously via the shared ApiFetchService.
  *  - Elided deck name in the top-left corner.
  *  - Deck size, EDH bracket, and view count labels.
  *  - A color distribution bar summarizing deck colors.
@@ -58,19 +58,17 @@ public:
      * @brief Constructs a deck entry display widget.
      * @param parent Parent widget.
      * @param response API container holding deck listing data.
-     * @param imageNetworkManager Shared network manager for fetching preview images.
      */
     explicit ArchidektApiResponseDeckEntryDisplayWidget(QWidget *parent,
-                                                        ArchidektApiResponseDeckListingContainer response,
-                                                        QNetworkAccessManager *imageNetworkManager);
+                                                        ArchidektApiResponseDeckListingContainer response);
 
     /**
-     * @brief Handles finished network replies for preview images.
-     * @param reply QNetworkReply containing image data.
+     * @brief Handles the fetched preview image.
+     * @param reply Response containing the image data.
      *
-     * Validates that the reply corresponds to this widget and updates the preview image.
+     * Only called with the response to this widget's own request, updates the preview image.
      */
-    void onPreviewImageLoadFinished(QNetworkReply *reply);
+    void onPreviewImageLoadFinished(const HttpFetchService::Response &reply);
 
     /**
      * @brief Updates the scaled preview image and adjusts layout accordingly.
@@ -109,7 +107,6 @@ private:
     QVBoxLayout *layout;                                   ///< Main vertical layout
     ArchidektApiResponseDeckListingContainer response;     ///< Deck data
     QUrl imageUrl;                                         ///< URL of the deck's preview image
-    QNetworkAccessManager *imageNetworkManager;            ///< Shared network manager
     ArchidektDeckPreviewImageDisplayWidget *previewWidget; ///< Widget showing the deck preview
     QLabel *picture;                                       ///< QLabel displaying the scaled pixmap
     QPixmap originalPixmap;                                ///< Original image for scaling (avoids degradation)
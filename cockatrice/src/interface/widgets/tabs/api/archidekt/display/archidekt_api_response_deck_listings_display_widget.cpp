@@ -15,15 +15,10 @@ ArchidektApiResponseDeckListingsDisplayWidget::ArchidektApiResponseDeckListingsD
 
     flowWidget = new FlowWidget(this, Qt::Horizontal, Qt::ScrollBarAlwaysOff, Qt::ScrollBarAsNeeded);
 
-    imageNetworkManager = new QNetworkAccessManager(this);
-    imageNetworkManager->setTransferTimeout(); // Use Qt's default timeout
-    imageNetworkManager->setRedirectPolicy(QNetworkRequest::ManualRedirectPolicy);
-
     // Add widgets for deck listings
     auto deckListings = response.results;
     for (const auto &deckListing : deckListings) {
-        auto cardListDisplayWidget =
-            new ArchidektApiResponseDeckEntryDisplayWidget(this, deckListing, imageNetworkManager);
+        auto cardListDisplayWidget = new ArchidektApiResponseDeckEntryDisplayWidget(this, deckListing);
         cardListDisplayWidget->setScaleFactor(cardSizeSlider->getSlider()->value());
         connect(cardListDisplayWidget, &ArchidektApiResponseDeckEntryDisplayWidget::requestNavigation, this,
                 &ArchidektApiResponseDeckListingsDisplayWidget::requestNavigation);
@@ -38,8 +33,7 @@ ArchidektApiResponseDeckListingsDisplayWidget::ArchidektApiResponseDeckListingsD
 void ArchidektApiResponseDeckListingsDisplayWidget::append(const ArchidektDeckListingApiResponse &data)
 {
     for (const auto &deckListing : data.results) {
-        auto cardListDisplayWidget =
-            new ArchidektApiResponseDeckEntryDisplayWidget(this, deckListing, imageNetworkManager);
+        auto cardListDisplayWidget = new ArchidektApiResponseDeckEntryDisplayWidget(this, deckListing);
         cardListDisplayWidget->setScaleFactor(cardSizeSlider->getSlider()->value());
         connect(cardListDisplayWidget, &ArchidektApiResponseDeckEntryDisplayWidget::requestNavigation, this,
                 &ArchidektApiResponseDeckListingsDisplayWidget::requestNavigation);
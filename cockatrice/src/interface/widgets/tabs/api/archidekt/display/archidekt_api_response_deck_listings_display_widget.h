@@ -5,7 +5,6 @@
 #include "../../../../general/layout_containers/flow_widget.h"
 #include "../api_response/archidekt_deck_listing_api_response.h"
 
-#include <QNetworkAccessManager>
 #include <QResizeEvent>
 #include <QScrollArea>
 #include <QVBoxLayout>
@@ -21,7 +20,6 @@
  *
  * ### Responsibilities
  * - Creates a **FlowWidget** that arranges deck entries horizontally with wrapping.
- * - Creates a shared **QNetworkAccessManager** for entry widgets to fetch card thumbnails.
  * - Connects a **CardSizeWidget** slider to all deck entries to dynamically rescale their preview cards.
  * - Propagates deck-navigation requests (`requestNavigation`) from children to the parent.
  *
@@ -39,8 +37,8 @@
  *   navigation to a deck or related Archidekt page.
  *
  * ### Performance Notes
- * - All entry widgets share a single QNetworkAccessManager instance to reuse connections
- *   and avoid redundant session creation.
+ * - Entry widgets fetch their preview images through the shared ApiFetchService, which downloads
+ *   an image used by several decks once and keeps it in the disk cache.
  * - `resizeEvent()` forces layout invalidation to ensure the flow layout responds properly
  *   to container resizing.
  */
@@ -90,9 +88,6 @@ private:
 
     /** @brief Container providing scrollable multi-row flow layout of deck entries. */
     FlowWidget *flowWidget;
-
-    /** @brief Shared network manager used to download card images for all child entry widgets. */
-    QNetworkAccessManager *imageNetworkManager;
 };
 
 #endif // COCKATRICE_ARCHIDEKT_API_RESPONSE_DECK_LISTINGS_DISPLAY_WIDGET_H
\ No newline at end of file
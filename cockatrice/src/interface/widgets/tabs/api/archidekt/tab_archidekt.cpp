@@ -3,6 +3,7 @@
 #include "../../../../../client/settings/cache_settings.h"
 #include "../../../cards/additional_info/mana_symbol_widget.h"
 #include "../../tab_supervisor.h"
+#include "../api_fetch_service.h"
 #include "api_response/archidekt_deck_listing_api_response.h"
 #include "display/archidekt_api_response_deck_display_widget.h"
 #include "display/archidekt_api_response_deck_listings_display_widget.h"
@@ -16,8 +17,6 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QResizeEvent>
@@ -28,17 +27,10 @@
 #include <libcockatrice/models/database/card/card_completer_proxy_model.h>
 #include <libcockatrice/models/database/card/card_search_model.h>
 #include <libcockatrice/settings/visual_deck_storage_settings.h>
-#include <version_string.h>
 
 TabArchidekt::TabArchidekt(TabSupervisor *_tabSupervisor)
     : Tab(_tabSupervisor), currentPage(1), isLoadingMore(false), isListMode(true)
 {
-    // Initialize network
-    networkManager = new QNetworkAccessManager(this);
-    networkManager->setTransferTimeout();
-    networkManager->setRedirectPolicy(QNetworkRequest::ManualRedirectPolicy);
-    connect(networkManager, &QNetworkAccessManager::finished, this, &TabArchidekt::processApiJson);
-
     // Initialize debounce timer
     searchDebounceTimer = new QTimer(this);
     searchDebounceTimer->setSingleShot(true);
@@ -528,10 +520,7 @@ void TabArchidekt::doSearch()
 
 void TabArchidekt::doSearchImmediate()
 {
-    QString url = buildSearchUrl();
-    QNetworkRequest req{QUrl(url)};
-    req.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    networkManager->get(req);
+    fetchPage(QUrl(buildSearchUrl()));
 }
 
 void TabArchidekt::loadNextPage()
@@ -543,46 +532,43 @@ void TabArchidekt::loadNextPage()
     isLoadingMore = true;
     currentPage++;
 
-    QString url = buildSearchUrl();
-    QNetworkRequest req{QUrl(url)};
-    req.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    networkManager->get(req);
+    fetchPage(QUrl(buildSearchUrl()));
 }
 
 void TabArchidekt::actNavigatePage(QString url)
 {
-    QNetworkRequest request{QUrl(url)};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    networkManager->get(request);
+    fetchPage(QUrl(url));
 }
 
 void TabArchidekt::getTopDecks()
 {
     currentPage = 1;
-    QNetworkRequest request{QUrl(buildSearchUrl())};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    networkManager->get(request);
+    fetchPage(QUrl(buildSearchUrl()));
+}
+
+void TabArchidekt::fetchPage(const QUrl &url)
+{
+    ApiFetchService::instance().fetch(
+        url, this, [this](const HttpFetchService::Response &response) { processApiJson(response); },
+        ApiFetchService::searchMaxAgeSecs);
 }
 
-void TabArchidekt::processApiJson(QNetworkReply *reply)
+void TabArchidekt::processApiJson(const HttpFetchService::Response &response)
 {
-    if (reply->error() != QNetworkReply::NoError) {
+    if (!response.isOk()) {
         isLoadingMore = false;
-        reply->deleteLater();
         return;
     }
 
-    QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(response.body);
 
     if (!jsonDoc.isObject()) {
         isLoadingMore = false;
-        reply->deleteLater();
         return;
     }
 
     QJsonObject jsonObj = jsonDoc.object();
-    QString responseUrl = reply->url().toString();
+    QString responseUrl = response.url.toString();
 
     if (responseUrl.startsWith("https://archidekt.com/api/decks/v3/")) {
         processTopDecksResponse(jsonObj);
@@ -593,7 +579,6 @@ void TabArchidekt::processApiJson(QNetworkReply *reply)
     }
 
     isLoadingMore = false;
-    reply->deleteLater();
 }
 
 void TabArchidekt::processTopDecksResponse(QJsonObject reply)
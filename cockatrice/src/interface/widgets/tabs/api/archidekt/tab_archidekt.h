@@ -4,6 +4,7 @@
 #include "../../interface/widgets/cards/card_size_widget.h"
 #include "../../interface/widgets/quick_settings/settings_button_widget.h"
 #include "../../tab.h"
+#include "../api_fetch_service.h"
 #include "display/archidekt_api_response_deck_listings_display_widget.h"
 
 #include <QCheckBox>
@@ -11,7 +12,6 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
-#include <QNetworkAccessManager>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QSet>
@@ -125,13 +125,13 @@ public slots:
     void loadNextPage();
 
     /**
-     * @brief Process a network reply containing JSON data
-     * @param reply QNetworkReply object with the API response
+     * @brief Process a fetched response containing JSON data
+     * @param response The API response, possibly served from the fetch service's cache
      *
      * Determines whether the response corresponds to a deck listing or a single deck,
      * and dispatches it to the appropriate handler.
      */
-    void processApiJson(QNetworkReply *reply);
+    void processApiJson(const HttpFetchService::Response &response);
 
     /**
      * @brief Handle a JSON response containing multiple decks
@@ -209,6 +209,12 @@ private:
      */
     void connectSignals();
 
+    /**
+     * @brief Fetch an API page through the shared fetch service and process it once it arrives
+     * @param url Archidekt API URL
+     */
+    void fetchPage(const QUrl &url);
+
     /**
      * @brief Update UI state when package mode is toggled
      * @param isPackageMode Whether package mode is currently enabled
@@ -222,10 +228,9 @@ private:
     // Network & Timing
     // ---------------------------------------------------------------------
 
-    QNetworkAccessManager *networkManager; ///< Network manager for handling API requests
-    QTimer *searchDebounceTimer;           ///< Timer to debounce search requests
-    int currentPage;                       ///< Current page number for infinite scroll
-    bool isLoadingMore;                    ///< Flag to prevent multiple simultaneous page loads
+    QTimer *searchDebounceTimer; ///< Timer to debounce search requests
+    int currentPage;             ///< Current page number for infinite scroll
+    bool isLoadingMore;          ///< Flag to prevent multiple simultaneous page loads
     bool isListMode;
     ArchidektApiResponseDeckListingsDisplayWidget *listingsWidget = nullptr;
 
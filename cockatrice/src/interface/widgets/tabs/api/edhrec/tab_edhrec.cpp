@@ -1,5 +1,6 @@
 #include "tab_edhrec.h"
 
+#include "../api_fetch_service.h"
 #include "api_response/commander/edhrec_commander_api_response.h"
 #include "display/commander/edhrec_commander_api_response_display_widget.h"
 
@@ -7,17 +8,11 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QRegularExpression>
 #include <QResizeEvent>
 
 TabEdhRec::TabEdhRec(TabSupervisor *_tabSupervisor) : Tab(_tabSupervisor)
 {
-    networkManager = new QNetworkAccessManager(this);
-    networkManager->setTransferTimeout(); // Use Qt's default timeout
-    networkManager->setRedirectPolicy(QNetworkRequest::ManualRedirectPolicy);
-    connect(networkManager, &QNetworkAccessManager::finished, this, &TabEdhRec::processApiJson);
 }
 
 void TabEdhRec::retranslateUi()
@@ -43,25 +38,22 @@ void TabEdhRec::setCard(CardInfoPtr _cardToQuery, bool isCommander)
         url = QString("https://json.edhrec.com/pages/card/%1.json").arg(formattedName);
     }
 
-    QNetworkRequest request{QUrl(url)};
-
-    networkManager->get(request);
+    ApiFetchService::instance().fetch(
+        QUrl(url), this, [this](const HttpFetchService::Response &response) { processApiJson(response); },
+        ApiFetchService::pageMaxAgeSecs);
 }
 
-void TabEdhRec::processApiJson(QNetworkReply *reply)
+void TabEdhRec::processApiJson(const HttpFetchService::Response &response)
 {
-    if (reply->error() != QNetworkReply::NoError) {
-        qDebug() << "Network error occurred:" << reply->errorString();
-        reply->deleteLater();
+    if (!response.isOk()) {
+        qDebug() << "Network error occurred:" << response.errorString;
         return;
     }
 
-    QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(response.body);
 
     if (!jsonDoc.isObject()) {
         qDebug() << "Invalid JSON response received.";
-        reply->deleteLater();
         return;
     }
 
@@ -72,11 +64,10 @@ void TabEdhRec::processApiJson(QNetworkReply *reply)
     EdhrecCommanderApiResponse deckData;
     deckData.fromJson(jsonObj);
 
-    displayWidget = new EdhrecCommanderApiResponseDisplayWidget(this, deckData, reply->url().toString());
+    displayWidget = new EdhrecCommanderApiResponseDisplayWidget(this, deckData, response.url.toString());
     // flowWidget->addWidget(displayWidget);
     setCentralWidget(displayWidget);
 
-    reply->deleteLater();
     update();
 }
 
@@ -8,9 +8,9 @@
 #define TAB_EDHREC_H
 
 #include "../../tab.h"
+#include "../api_fetch_service.h"
 #include "display/commander/edhrec_commander_api_response_display_widget.h"
 
-#include <QNetworkAccessManager>
 #include <libcockatrice/card/card_info.h>
 
 class TabEdhRec : public Tab
@@ -26,10 +26,8 @@ public:
         return tr("EDHREC: ") + cardName;
     }
 
-    QNetworkAccessManager *networkManager;
-
 public slots:
-    void processApiJson(QNetworkReply *reply);
+    void processApiJson(const HttpFetchService::Response &response);
     void prettyPrintJson(const QJsonValue &value, int indentLevel);
     void setCard(CardInfoPtr _cardToQuery, bool isCommander = false);
 
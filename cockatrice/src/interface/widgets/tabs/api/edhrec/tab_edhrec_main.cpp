@@ -2,6 +2,7 @@
 
 #include "../../../../../client/settings/cache_settings.h"
 #include "../../tab_supervisor.h"
+#include "../api_fetch_service.h"
 #include "api_response/average_deck/edhrec_average_deck_api_response.h"
 #include "api_response/commander/edhrec_commander_api_response.h"
 #include "api_response/top_cards/edhrec_top_cards_api_response.h"
@@ -18,15 +19,12 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QPushButton>
 #include <QRegularExpression>
 #include <libcockatrice/card/database/card_database_manager.h>
 #include <libcockatrice/models/database/card/card_completer_proxy_model.h>
 #include <libcockatrice/models/database/card/card_search_model.h>
 #include <libcockatrice/settings/visual_deck_storage_settings.h>
-#include <version_string.h>
 
 static bool canBeCommander(const CardInfoPtr &cardInfo)
 {
@@ -37,11 +35,6 @@ static bool canBeCommander(const CardInfoPtr &cardInfo)
 
 TabEdhRecMain::TabEdhRecMain(TabSupervisor *_tabSupervisor) : Tab(_tabSupervisor)
 {
-    networkManager = new QNetworkAccessManager(this);
-    networkManager->setTransferTimeout(); // Use Qt's default timeout
-    networkManager->setRedirectPolicy(QNetworkRequest::ManualRedirectPolicy);
-    connect(networkManager, SIGNAL(finished(QNetworkReply *)), this, SLOT(processApiJson(QNetworkReply *)));
-
     container = new QWidget(this);
     mainLayout = new QVBoxLayout(container);
     container->setLayout(mainLayout);
@@ -165,64 +158,54 @@ void TabEdhRecMain::setCard(CardInfoPtr _cardToQuery, bool isCommander)
         url = QString("https://json.edhrec.com/pages/cards/%1.json").arg(formattedName);
     }
 
-    QNetworkRequest request{QUrl(url)};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-
-    networkManager->get(request);
+    fetchPage(QUrl(url));
 }
 
 void TabEdhRecMain::actNavigatePage(QString url)
 {
-    QNetworkRequest request{QUrl("https://json.edhrec.com/pages" + url + ".json")};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-
-    networkManager->get(request);
+    fetchPage(QUrl("https://json.edhrec.com/pages" + url + ".json"));
 }
 
 void TabEdhRecMain::getTopCards()
 {
-    QNetworkRequest request{QUrl("https://json.edhrec.com/pages/top/year.json")};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-
-    networkManager->get(request);
+    fetchPage(QUrl("https://json.edhrec.com/pages/top/year.json"));
 }
 
 void TabEdhRecMain::getTopCommanders()
 {
-    QNetworkRequest request{QUrl("https://json.edhrec.com/pages/commanders/year.json")};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-
-    networkManager->get(request);
+    fetchPage(QUrl("https://json.edhrec.com/pages/commanders/year.json"));
 }
 
 void TabEdhRecMain::getTopTags()
 {
-    QNetworkRequest request{QUrl("https://json.edhrec.com/pages/tags.json")};
-    request.setHeader(QNetworkRequest::UserAgentHeader, QString("Cockatrice %1").arg(VERSION_STRING));
-    networkManager->get(request);
+    fetchPage(QUrl("https://json.edhrec.com/pages/tags.json"));
 }
 
-void TabEdhRecMain::processApiJson(QNetworkReply *reply)
+void TabEdhRecMain::fetchPage(const QUrl &url)
 {
-    if (reply->error() != QNetworkReply::NoError) {
-        qDebug() << "Network error occurred:" << reply->errorString();
-        reply->deleteLater();
+    ApiFetchService::instance().fetch(
+        url, this, [this](const HttpFetchService::Response &response) { processApiJson(response); },
+        ApiFetchService::pageMaxAgeSecs);
+}
+
+void TabEdhRecMain::processApiJson(const HttpFetchService::Response &response)
+{
+    if (!response.isOk()) {
+        qDebug() << "Network error occurred:" << response.errorString;
         return;
     }
 
-    QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(response.body);
 
     if (!jsonDoc.isObject()) {
         qDebug() << "Invalid JSON response received.";
-        reply->deleteLater();
         return;
     }
 
     QJsonObject jsonObj = jsonDoc.object();
 
-    // Get the actual URL from the reply
-    QString responseUrl = reply->url().toString();
+    // Routed by the requested URL, the page may have been served from the cache
+    QString responseUrl = response.url.toString();
 
     // Check if the response URL matches a commander request
     if (responseUrl.startsWith("https://json.edhrec.com/pages/commanders/year.json")) {
@@ -246,8 +229,6 @@ void TabEdhRecMain::processApiJson(QNetworkReply *reply)
     } else {
         prettyPrintJson(jsonObj, 4);
     }
-
-    reply->deleteLater();
 }
 
 void TabEdhRecMain::processTopCardsResponse(QJsonObject reply)
@@ -10,11 +10,11 @@
 #include "../../interface/widgets/cards/card_size_widget.h"
 #include "../../interface/widgets/quick_settings/settings_button_widget.h"
 #include "../../tab.h"
+#include "../api_fetch_service.h"
 #include "display/commander/edhrec_commander_api_response_display_widget.h"
 
 #include <QHBoxLayout>
 #include <QLineEdit>
-#include <QNetworkAccessManager>
 #include <QPushButton>
 #include <libcockatrice/card/database/card_database.h>
 
@@ -37,10 +37,8 @@ public:
         return cardSizeSlider;
     }
 
-    QNetworkAccessManager *networkManager;
-
 public slots:
-    void processApiJson(QNetworkReply *reply);
+    void processApiJson(const HttpFetchService::Response &response);
     void processCommanderResponse(QJsonObject reply, QString responseUrl = "");
     void processTopCardsResponse(QJsonObject reply);
     void processTopTagsResponse(QJsonObject reply);
@@ -69,6 +67,8 @@ private:
     CardSizeWidget *cardSizeSlider;
     CardInfoPtr cardToQuery;
     EdhrecCommanderApiResponseDisplayWidget *displayWidget;
+
+    void fetchPage(const QUrl &url);
 };
 
 #endif // TAB_EDHREC_MAIN_H
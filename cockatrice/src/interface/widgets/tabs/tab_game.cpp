@@ -17,6 +17,7 @@
 #include "../game_graphics/player/menu/player_menu.h"
 #include "../game_graphics/player/player_graphics_item.h"
 #include "../game_graphics/player/player_list_widget.h"
+#include "../game_graphics/zones/zone_layout_scheduler.h"
 #include "../interface/card_picture_loader/card_picture_loader.h"
 #include "../interface/widgets/cards/card_info_frame_widget.h"
 #include "../interface/widgets/dialogs/dlg_create_game.h"
@@ -173,6 +174,9 @@ void TabGame::connectToGameEventHandler()
             &TabGame::processRemotePlayerDeckSelect);
     connect(game->getGameEventHandler(), &GameEventHandler::remotePlayersDecksSelected, this,
             &TabGame::processMultipleRemotePlayerDeckSelect);
+    // lay out the zones touched by a container once, after all of its events were applied
+    connect(game->getGameEventHandler(), &GameEventHandler::containerProcessingDone, &ZoneLayoutScheduler::instance(),
+            &ZoneLayoutScheduler::flush);
 }
 
 void TabGame::connectMessageLogToGameEventHandler()
@@ -1181,6 +1185,8 @@ void TabGame::createReplayDock(GameReplay *replay)
     replayDock->setFloating(false);
 
     connect(replayWidget, &ReplayWidget::rewound, this, &TabGame::resetChatAndPhase);
+    connect(replayWidget, &ReplayWidget::skipStarted, messageLog, &MessageLogWidget::beginBulkAppend);
+    connect(replayWidget, &ReplayWidget::skipFinished, messageLog, &MessageLogWidget::endBulkAppend);
     connect(replayWidget, &ReplayWidget::eventReplayed, game->getGameEventHandler(),
             [this](const auto &event, auto options) {
                 game->getGameEventHandler()->processGameEventContainer(event, nullptr, options);
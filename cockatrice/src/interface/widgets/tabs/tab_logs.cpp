@@ -87,6 +87,20 @@ void TabLog::getClicked()
         maximumResults->setValue(1000);
     }
 
+    requestLogs(QString());
+}
+
+void TabLog::loadMoreClicked()
+{
+    requestLogs(nextPageToken);
+}
+
+/**
+ * Requests a page of the log messages matching the current filters. An empty page token requests the first page and
+ * replaces the shown messages, later pages are appended to them.
+ */
+void TabLog::requestLogs(const QString &pageToken)
+{
     int dateRange = 0;
     if (lastHour->isChecked()) {
         dateRange = 1;
@@ -117,8 +131,15 @@ void TabLog::getClicked()
     };
     cmd.set_date_range(dateRange);
     cmd.set_maximum_results(maximumResults->value());
+    if (!pageToken.isEmpty()) {
+        cmd.set_page_token(pageToken.toStdString());
+    }
+
+    const bool firstPage = pageToken.isEmpty();
+    loadMoreButton->setEnabled(false);
     PendingCommand *pend = client->prepareModeratorCommand(cmd);
-    connect(pend, &PendingCommand::finished, this, &TabLog::viewLogHistory_processResponse);
+    connect(pend, &PendingCommand::finished, this,
+            [this, firstPage](const Response &resp) { viewLogHistory_processResponse(resp, firstPage); });
     client->sendCommand(pend);
 }
 
@@ -193,6 +214,11 @@ void TabLog::createDock()
     clearButton->setAutoDefault(true);
     connect(clearButton, &QPushButton::clicked, this, &TabLog::clearClicked);
 
+    loadMoreButton = new QPushButton(tr("Load More"));
+    loadMoreButton->setAutoDefault(true);
+    loadMoreButton->setEnabled(false);
+    connect(loadMoreButton, &QPushButton::clicked, this, &TabLog::loadMoreClicked);
+
     criteriaGrid = new QGridLayout;
     criteriaGrid->addWidget(labelFindUserName, 0, 0);
     criteriaGrid->addWidget(findUsername, 0, 1);
@@ -243,6 +269,7 @@ void TabLog::createDock()
     buttonGrid = new QGridLayout;
     buttonGrid->addWidget(getButton, 0, 0);
     buttonGrid->addWidget(clearButton, 0, 1);
+    buttonGrid->addWidget(loadMoreButton, 1, 0, 1, 2);
 
     buttonGroupBox = new QGroupBox(tr(""));
     buttonGroupBox->setLayout(buttonGrid);
@@ -264,7 +291,7 @@ void TabLog::createDock()
     searchDock->setWidget(searchDockContents);
 }
 
-void TabLog::viewLogHistory_processResponse(const Response &resp)
+void TabLog::viewLogHistory_processResponse(const Response &resp, bool firstPage)
 {
     const Response_ViewLogHistory &response = resp.GetExtension(Response_ViewLogHistory::ext);
     if (resp.response_code() != Response::RespOk) {
@@ -273,16 +300,27 @@ void TabLog::viewLogHistory_processResponse(const Response &resp)
         return;
     }
 
+    nextPageToken = QString::fromStdString(response.next_page_token());
+    loadMoreButton->setEnabled(!nextPageToken.isEmpty());
+
     if (response.log_message_size() == 0) {
-        QMessageBox::information(static_cast<QWidget *>(parent()), tr("Message History"),
-                                 tr("There are no messages for the selected filters."));
+        if (firstPage) {
+            QMessageBox::information(static_cast<QWidget *>(parent()), tr("Message History"),
+                                     tr("There are no messages for the selected filters."));
+        }
         return;
     }
 
     int roomCounter = 0, gameCounter = 0, chatCounter = 0;
-    roomTable->setRowCount(roomCounter);
-    gameTable->setRowCount(gameCounter);
-    chatTable->setRowCount(chatCounter);
+    if (firstPage) {
+        roomTable->setRowCount(roomCounter);
+        gameTable->setRowCount(gameCounter);
+        chatTable->setRowCount(chatCounter);
+    } else {
+        roomCounter = roomTable->rowCount();
+        gameCounter = gameTable->rowCount();
+        chatCounter = chatTable->rowCount();
+    }
 
     for (int i = 0; i < response.log_message_size(); ++i) {
         ServerInfo_ChatMessage message = response.log_message(i);
@@ -41,20 +41,23 @@ private:
     QSpinBox *maximumResults, *pastXDays;
     QDockWidget *searchDock;
     QWidget *searchDockContents;
-    QPushButton *getButton, *clearButton;
+    QPushButton *getButton, *clearButton, *loadMoreButton;
     QGridLayout *criteriaGrid, *locationGrid, *rangeGrid, *maxResultsGrid, *descriptionGrid, *buttonGrid;
     QGroupBox *criteriaGroupBox, *locationGroupBox, *rangeGroupBox, *maxResultsGroupBox, *descriptionGroupBox,
         *buttonGroupBox;
     QVBoxLayout *mainLayout;
     QTableWidget *roomTable, *gameTable, *chatTable;
+    QString nextPageToken;
 
     void createDock();
+    void requestLogs(const QString &pageToken);
 signals:
 
 private slots:
     void getClicked();
     void clearClicked();
-    void viewLogHistory_processResponse(const Response &resp);
+    void loadMoreClicked();
+    void viewLogHistory_processResponse(const Response &resp, bool firstPage);
     void restartLayout();
 
 public:
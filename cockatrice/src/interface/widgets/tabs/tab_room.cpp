@@ -133,9 +133,11 @@ TabRoom::TabRoom(TabSupervisor *_tabSupervisor,
     }
 
     const int gameListSize = info.game_list_size();
+    gameSelector->beginGameListUpdate();
     for (int i = 0; i < gameListSize; ++i) {
         gameSelector->processGameInfo(info.game_list(i));
     }
+    gameSelector->endGameListUpdate();
 
     completer = new QCompleter(autocompleteUserList, sayEdit);
     completer->setCaseSensitivity(Qt::CaseInsensitive);
@@ -277,9 +279,11 @@ void TabRoom::processRoomEvent(const RoomEvent &event)
 void TabRoom::processListGamesEvent(const Event_ListGames &event)
 {
     const int gameListSize = event.game_list_size();
+    gameSelector->beginGameListUpdate();
     for (int i = 0; i < gameListSize; ++i) {
         gameSelector->processGameInfo(event.game_list(i));
     }
+    gameSelector->endGameListUpdate();
 }
 
 void TabRoom::processJoinRoomEvent(const Event_JoinRoom &event)
@@ -4,7 +4,6 @@
 #include "../../../filters/filter_tree_model.h"
 #include "../../../filters/syntax_help.h"
 #include "../../pixel_map_generator.h"
-#include "../cards/card_info_picture_with_text_overlay_widget.h"
 #include "../deck_editor/card_database_view.h"
 #include "../utility/custom_line_edit.h"
 #include "visual_database_display_color_filter_widget.h"
@@ -15,9 +14,7 @@
 #include "visual_database_display_sub_type_filter_widget.h"
 
 #include <QHeaderView>
-#include <QScrollBar>
 #include <QStyledItemDelegate>
-#include <libcockatrice/card/card_info_comparator.h>
 #include <libcockatrice/card/database/card_database.h>
 #include <libcockatrice/card/database/card_database_manager.h>
 #include <libcockatrice/settings/visual_deck_storage_settings.h>
@@ -39,7 +36,6 @@ VisualDatabaseDisplayWidget::VisualDatabaseDisplayWidget(QWidget *parent,
     databaseDisplayModel->setSourceModel(database_model);
     databaseDisplayModel->setFilterKeyColumn(0);
 
-    cards = new QList<ExactCard>;
     connect(databaseDisplayModel, &CardDatabaseDisplayModel::modelDirty, this,
             &VisualDatabaseDisplayWidget::modelDirty);
 
@@ -51,9 +47,14 @@ VisualDatabaseDisplayWidget::VisualDatabaseDisplayWidget(QWidget *parent,
     mainLayout->setSpacing(1);
     mainLayout->setContentsMargins(0, 0, 0, 0);
 
-    flowWidget = new FlowWidget(this, Qt::Horizontal, Qt::ScrollBarAlwaysOff, Qt::ScrollBarPolicy::ScrollBarAsNeeded);
-    cardSizeWidget = new CardSizeWidget(
-        this, flowWidget, SettingsCache::instance().visualDeckStorage().getVisualDatabaseDisplayCardSize());
+    const int cardSize = SettingsCache::instance().visualDeckStorage().getVisualDatabaseDisplayCardSize();
+    cardGridView = new CardGridView(this, cardSize);
+    cardGridView->setModel(databaseDisplayModel);
+    connect(cardGridView, &CardGridView::cardClicked, this, &VisualDatabaseDisplayWidget::onClick);
+    connect(cardGridView, &CardGridView::hoveredOnCard, this, &VisualDatabaseDisplayWidget::onHover);
+
+    cardSizeWidget = new CardSizeWidget(this, nullptr, cardSize);
+    connect(cardSizeWidget->getSlider(), &QSlider::valueChanged, cardGridView, &CardGridView::setScaleFactor);
     connect(cardSizeWidget, &CardSizeWidget::cardSizeSettingUpdated, &SettingsCache::instance().visualDeckStorage(),
             &VisualDeckStorageSettings::setVisualDatabaseDisplayCardSize);
 
@@ -131,8 +132,6 @@ VisualDatabaseDisplayWidget::VisualDatabaseDisplayWidget(QWidget *parent,
         databaseLoadIndicator->setVisible(false);
     }
 
-    QScrollBar *scrollBar = flowWidget->scrollArea->verticalScrollBar();
-    connect(scrollBar, &QScrollBar::valueChanged, [this](int /*value*/) { loadCurrentPage(); });
     retranslateUi();
 }
 
@@ -154,20 +153,15 @@ void VisualDatabaseDisplayWidget::initialize()
 
     mainLayout->addWidget(databaseView);
 
-    mainLayout->addWidget(flowWidget);
+    mainLayout->addWidget(cardGridView);
 
     mainLayout->addWidget(cardSizeWidget);
 
     databaseDisplayModel->setFilterTree(filterModel->filterTree());
+    cardGridView->setCardResolver([this](const QModelIndex &index) { return cardForIndex(index); });
 
     connect(filterModel, &FilterTreeModel::layoutChanged, this, &VisualDatabaseDisplayWidget::onSearchModelChanged);
 
-    loadCardsTimer = new QTimer(this);
-    loadCardsTimer->setSingleShot(true); // Ensure it only fires once after the timeout
-
-    connect(loadCardsTimer, &QTimer::timeout, this, [this]() { loadCurrentPage(); });
-    loadCardsTimer->start(5000);
-
     retranslateUi();
 }
 
@@ -182,28 +176,21 @@ void VisualDatabaseDisplayWidget::highlightAllSearchEdit()
     searchEdit->setSelection(0, searchEdit->text().length());
 }
 
-void VisualDatabaseDisplayWidget::resizeEvent(QResizeEvent *event)
-{
-    QWidget::resizeEvent(event);
-    loadCurrentPage();
-}
-
 void VisualDatabaseDisplayWidget::onDisplayModeChanged(bool checked)
 {
     if (checked) {
         // Table mode
         displayModeButton->setText(tr("Table"));
-        flowWidget->setVisible(false);
+        cardGridView->setVisible(false);
         cardSizeWidget->setVisible(false);
         databaseView->setItemDelegate(new QStyledItemDelegate(databaseView));
         databaseView->setVisible(true);
     } else {
         // Visual mode
         displayModeButton->setText(tr("Visual"));
-        flowWidget->setVisible(true);
+        cardGridView->setVisible(true);
         cardSizeWidget->setVisible(true);
         databaseView->setVisible(false);
-        populateCards();
     }
 }
 
@@ -217,18 +204,6 @@ void VisualDatabaseDisplayWidget::onHover(const ExactCard &hoveredCard)
     emit cardHoveredDatabaseDisplay(hoveredCard);
 }
 
-void VisualDatabaseDisplayWidget::addCardToDisplay(const ExactCard &cardToAdd)
-{
-    cards->append(cardToAdd);
-    auto *display = new CardInfoPictureWithTextOverlayWidget(flowWidget, false);
-    display->setScaleFactor(cardSizeWidget->getSlider()->value());
-    display->setCard(cardToAdd);
-    flowWidget->addWidget(display);
-    connect(display, &CardInfoPictureWithTextOverlayWidget::cardClicked, this, &VisualDatabaseDisplayWidget::onClick);
-    connect(display, &CardInfoPictureWithTextOverlayWidget::hoveredOnCard, this, &VisualDatabaseDisplayWidget::onHover);
-    connect(cardSizeWidget->getSlider(), &QSlider::valueChanged, display, &CardInfoPictureWidget::setScaleFactor);
-}
-
 bool VisualDatabaseDisplayWidget::isVisualDisplayMode() const
 {
     return !displayModeButton->isChecked();
@@ -236,18 +211,9 @@ bool VisualDatabaseDisplayWidget::isVisualDisplayMode() const
 
 void VisualDatabaseDisplayWidget::onSearchModelChanged()
 {
-    if (flowWidget->isVisible()) {
-        // Clear the current page and prepare for new data
-        flowWidget->clearLayout(); // Clear existing cards
-        cards->clear();            // Clear the card list
-        // Reset scrollbar position to the top after loading new cards
-        QScrollBar *scrollBar = flowWidget->scrollArea->verticalScrollBar();
-        scrollBar->setValue(0); // Reset scrollbar to top
-
-        currentPage = 0;
-        loadCurrentPage();
-        qCDebug(VisualDatabaseDisplayLog) << "Search model changed";
-    }
+    // The grid follows the model by itself, only show the new results from the start
+    cardGridView->scrollToTop();
+    qCDebug(VisualDatabaseDisplayLog) << "Search model changed";
 }
 
 void VisualDatabaseDisplayWidget::onSelectedCardChanged(const QString &cardName)
@@ -274,84 +240,32 @@ void VisualDatabaseDisplayWidget::onRelatedCardClicked(const QString &relatedCar
     emit cardInfoRequested(exactCard);
 }
 
-bool VisualDatabaseDisplayWidget::nearEndOfPage() const
-{
-    if (!flowWidget->isVisible()) {
-        return false;
-    }
-
-    QScrollBar *scrollBar = flowWidget->scrollArea->verticalScrollBar();
-    if (scrollBar->value() + scrollBar->pageStep() * 2 < scrollBar->maximum()) {
-        return false; // there is at least two pages of space to scroll remaining
-    }
-
-    return true;
-}
-
-void VisualDatabaseDisplayWidget::loadCurrentPage()
-{
-    // Ensure only the initial page is loaded
-    if (currentPage == 0) {
-        // Only load the first page initially
-        qCDebug(VisualDatabaseDisplayLog) << "Loading the first page";
-        populateCards();
-    } else if (nearEndOfPage()) {
-        // If not the first page, just load the next page and append to the flow widget
-        loadNextPage();
-    }
-}
-
-void VisualDatabaseDisplayWidget::populateCards()
-{
-    cards->clear();
-    loadNextPage();
-}
-
-void VisualDatabaseDisplayWidget::loadNextPage()
+/**
+ * @brief Decides which printing the grid shows for a row of the display model.
+ *
+ * With set filters active, this is the first printing of the card in a filtered set, otherwise the preferred one.
+ */
+ExactCard VisualDatabaseDisplayWidget::cardForIndex(const QModelIndex &index) const
 {
-    // Calculate the start and end indices for the next page
-    int rowCount = databaseDisplayModel->rowCount();
-    int start = currentPage * cardsPerPage;
-    int end = qMin(start + cardsPerPage, rowCount);
-
-    // Load more cards if we are at the end of the current list and can fetch more
-    if (end >= rowCount && databaseDisplayModel->canFetchMore(QModelIndex())) {
-        databaseDisplayModel->fetchMore(QModelIndex());
+    const QString name = index.sibling(index.row(), CardDatabaseModel::NameColumn).data(Qt::DisplayRole).toString();
+    CardInfoPtr info = CardDatabaseManager::query()->getCardInfo(name);
+    if (!info) {
+        qCDebug(VisualDatabaseDisplayLog) << "Card not found in database!" << name;
+        return {};
     }
 
-    // Load the next page of cards and add them to the flow widget
-    flowWidget->setUpdatesEnabled(false);
-    loadPage(start, end);
-    flowWidget->setUpdatesEnabled(true);
-}
-
-void VisualDatabaseDisplayWidget::loadPage(int start, int end)
-{
-    QList<const CardFilter *> setFilters = filterModel->getFiltersOfType(CardFilter::AttrSet);
-    for (int row = start; row < end; ++row) {
-        qCDebug(VisualDatabaseDisplayLog) << "Adding " << row;
-        QModelIndex index = databaseDisplayModel->index(row, CardDatabaseModel::NameColumn);
-        QVariant name = databaseDisplayModel->data(index, Qt::DisplayRole);
-        qCDebug(VisualDatabaseDisplayLog) << name.toString();
-
-        if (CardInfoPtr info = CardDatabaseManager::query()->getCardInfo(name.toString())) {
-            if (!setFilters.empty()) {
-                SetToPrintingsMap setMap = info->getSets();
-                for (const CardFilter *setFilter : setFilters) {
-                    if (setMap.contains(setFilter->term())) {
-                        for (PrintingInfo printing : setMap[setFilter->term()]) {
-                            addCardToDisplay(ExactCard(info, printing));
-                        }
-                    }
-                }
-            } else {
-                addCardToDisplay(CardDatabaseManager::query()->getPreferredCard(info));
+    const QList<const CardFilter *> setFilters = filterModel->getFiltersOfType(CardFilter::AttrSet);
+    if (!setFilters.empty()) {
+        const SetToPrintingsMap setMap = info->getSets();
+        for (const CardFilter *setFilter : setFilters) {
+            const auto printings = setMap.constFind(setFilter->term());
+            if (printings != setMap.constEnd() && !printings->isEmpty()) {
+                return ExactCard(info, printings->first());
             }
-        } else {
-            qCDebug(VisualDatabaseDisplayLog) << "Card not found in database!";
         }
     }
-    currentPage++;
+
+    return CardDatabaseManager::query()->getPreferredCard(info);
 }
 
 void VisualDatabaseDisplayWidget::modelDirty() const
@@ -359,15 +273,6 @@ void VisualDatabaseDisplayWidget::modelDirty() const
     debounceTimer->start(debounceTime);
 }
 
-void VisualDatabaseDisplayWidget::sortCardList(const QStringList &properties,
-                                               Qt::SortOrder order = Qt::AscendingOrder) const
-{
-    CardInfoComparator comparator(properties, order);
-    std::sort(cards->begin(), cards->end(), [comparator](const ExactCard &a, const ExactCard &b) {
-        return comparator(a.getCardPtr(), b.getCardPtr());
-    });
-}
-
 void VisualDatabaseDisplayWidget::databaseDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
     (void)topLeft;
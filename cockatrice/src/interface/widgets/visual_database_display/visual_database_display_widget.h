@@ -10,7 +10,7 @@
 #include "../../../filters/filter_tree_model.h"
 #include "../../../interface/widgets/tabs/abstract_tab_deck_editor.h"
 #include "../../key_signals.h"
-#include "../cards/card_info_picture_with_text_overlay_widget.h"
+#include "../cards/card_grid_view.h"
 #include "../cards/card_size_widget.h"
 #include "../general/layout_containers/flow_widget.h"
 #include "../general/layout_containers/overlap_control_widget.h"
@@ -24,7 +24,6 @@
 #include <QWidget>
 #include <libcockatrice/models/database/card_database_model.h>
 #include <libcockatrice/models/deck_list/deck_list_model.h>
-#include <qscrollarea.h>
 
 inline Q_LOGGING_CATEGORY(VisualDatabaseDisplayLog, "visual_database_display");
 
@@ -38,12 +37,6 @@ public:
                                          DeckListModel *deckListModel = nullptr);
     void retranslateUi();
 
-    void adjustCardsPerPage();
-    void populateCards();
-    void loadPage(int start, int end);
-    void loadNextPage();
-    void loadCurrentPage();
-    void sortCardList(const QStringList &properties, Qt::SortOrder order) const;
     void setDeckList(const DeckList &new_deck_list_model);
 
     CardDatabaseDisplayModel *getDatabaseDisplayModel()
@@ -83,7 +76,6 @@ protected slots:
     void initialize();
     void onClick(QMouseEvent *event, const ExactCard &card);
     void onHover(const ExactCard &hoveredCard);
-    void addCardToDisplay(const ExactCard &cardToAdd);
     void databaseDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
     void modelDirty() const;
     void onDisplayModeChanged(bool checked);
@@ -106,26 +98,18 @@ private:
     VisualDatabaseDisplayFilterToolbarWidget *filterContainer;
     CardDatabaseDisplayModel *databaseDisplayModel;
     CardDatabaseView *databaseView;
-    QList<ExactCard> *cards;
     QVBoxLayout *mainLayout;
-    QScrollArea *scrollArea;
-    FlowWidget *flowWidget;
+    CardGridView *cardGridView;
     QWidget *overlapCategories;
     QVBoxLayout *overlapCategoriesLayout;
     OverlapControlWidget *overlapControlWidget;
     CardSizeWidget *cardSizeWidget;
     QTimer *debounceTimer;
-    QTimer *loadCardsTimer;
 
     int debounceTime = 300; // in Ms
-    int currentPage = 0;    // Current page index
-    int cardsPerPage = 100; // Number of cards per page
 
     void highlightAllSearchEdit();
-    bool nearEndOfPage() const;
-
-protected:
-    void resizeEvent(QResizeEvent *event) override;
+    [[nodiscard]] ExactCard cardForIndex(const QModelIndex &index) const;
 };
 
 #endif // VISUAL_DATABASE_DISPLAY_WIDGET_H
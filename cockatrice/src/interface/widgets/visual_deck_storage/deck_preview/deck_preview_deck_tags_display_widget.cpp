@@ -1,6 +1,7 @@
 #include "deck_preview_deck_tags_display_widget.h"
 
 #include "../../../../client/settings/cache_settings.h"
+#include "../../../../interface/deck_loader/deck_metadata_service.h"
 #include "../../../../interface/widgets/dialogs/dlg_convert_deck_to_cod_format.h"
 #include "../../../../interface/widgets/tabs/tab_deck_editor.h"
 #include "../../general/layout_containers/flow_widget.h"
@@ -126,8 +127,12 @@ static bool confirmOverwriteIfExists(QWidget *parent, const QString &filePath)
 
 static void convertFileToCockatriceFormat(DeckPreviewWidget *deckPreviewWidget)
 {
-    DeckLoader::convertToCockatriceFormat(deckPreviewWidget->deckLoader->getDeck());
-    deckPreviewWidget->filePath = deckPreviewWidget->deckLoader->getDeck().lastLoadInfo.fileName;
+    std::optional<LoadedDeck> deck = deckPreviewWidget->loadDeck();
+    if (!deck || !DeckLoader::convertToCockatriceFormat(*deck)) {
+        return;
+    }
+    deckPreviewWidget->setFilePath(deck->lastLoadInfo.fileName);
+    deckPreviewWidget->metadata = DeckMetadataService::instance().update(*deck);
     deckPreviewWidget->refreshBannerCardText();
 }
 
@@ -1,6 +1,7 @@
 #include "deck_preview_widget.h"
 
 #include "../../../../client/settings/cache_settings.h"
+#include "../../../deck_loader/deck_metadata_service.h"
 #include "../../cards/additional_info/color_identity_widget.h"
 #include "../../cards/deck_preview_card_picture_widget.h"
 #include "deck_preview_deck_tags_display_widget.h"
@@ -27,14 +28,6 @@ DeckPreviewWidget::DeckPreviewWidget(QWidget *_parent,
     layout = new QVBoxLayout(this);
     setLayout(layout);
 
-    deckLoader = new DeckLoader(this);
-    connect(deckLoader, &DeckLoader::loadFinished, this, &DeckPreviewWidget::initializeUi);
-    //! \todo Batch tag refresh: count finished deck loads and refresh tags once all decks are loaded.
-    // Currently expensive: refreshes on each individual deck load instead of once at the end.
-    connect(deckLoader, &DeckLoader::loadFinished, visualDeckStorageWidget->tagFilterWidget,
-            &VisualDeckStorageTagFilterWidget::refreshTags);
-    deckLoader->loadFromFileAsync(filePath, DeckFileFormat::getFormatFromName(filePath), false);
-
     bannerCardDisplayWidget =
         new DeckPreviewCardPictureWidget(this, false, visualDeckStorageWidget->deckPreviewSelectionAnimationEnabled);
 
@@ -56,6 +49,15 @@ DeckPreviewWidget::DeckPreviewWidget(QWidget *_parent,
             &DeckPreviewWidget::refreshBannerCardToolTip);
 
     layout->addWidget(bannerCardDisplayWidget);
+
+    connect(&DeckMetadataService::instance(), &DeckMetadataService::metadataChanged, this,
+            &DeckPreviewWidget::onMetadataChanged);
+    if (const DeckMetadata *indexed = DeckMetadataService::instance().find(filePath)) {
+        metadata = *indexed;
+        initializeUi();
+    } else {
+        DeckMetadataService::instance().refresh(filePath);
+    }
 }
 
 void DeckPreviewWidget::retranslateUi()
@@ -90,34 +92,56 @@ void DeckPreviewWidget::enterEvent(QEvent *event)
 }
 
 /**
- * @brief Sets the lastModifiedTime to the value given by the file.
+ * @brief Parses the deck file, for the actions that need the whole deck rather than its metadata.
  */
-void DeckPreviewWidget::updateLastModifiedTime()
+std::optional<LoadedDeck> DeckPreviewWidget::loadDeck() const
 {
-    QFileInfo fileInfo(filePath);
-    lastModifiedTime = fileInfo.lastModified();
+    return DeckLoader::loadFromFile(filePath, DeckFileFormat::getFormatFromName(filePath), false);
 }
 
 /**
- * @brief Writes the current contents of the deck to file. Updates the lastModifiedTime afterward.
+ * @brief Applies the modification to the deck in the file and writes it back, then updates the metadata.
+ * @return Whether the deck could be read and written.
  */
-void DeckPreviewWidget::writeDeckToFile()
+bool DeckPreviewWidget::modifyDeck(const std::function<void(DeckList &)> &modification)
 {
-    DeckLoader::saveToFile(deckLoader->getDeck());
-    updateLastModifiedTime();
+    std::optional<LoadedDeck> deck = loadDeck();
+    if (!deck) {
+        return false;
+    }
+
+    modification(deck->deckList);
+    if (!DeckLoader::saveToFile(*deck)) {
+        return false;
+    }
+
+    metadata = DeckMetadataService::instance().update(*deck);
+    return true;
 }
 
-void DeckPreviewWidget::initializeUi(const bool deckLoadSuccess)
+void DeckPreviewWidget::onMetadataChanged(const QString &changedFilePath)
 {
-    if (!deckLoadSuccess) {
+    if (changedFilePath != QFileInfo(filePath).absoluteFilePath()) {
         return;
     }
 
-    QFileInfo fileInfo(filePath);
-    lastModifiedTime = fileInfo.lastModified();
+    const DeckMetadata *indexed = DeckMetadataService::instance().find(filePath);
+    if (!indexed) {
+        return;
+    }
+    metadata = *indexed;
+
+    if (bannerCardComboBox == nullptr) {
+        initializeUi();
+        visualDeckStorageWidget->tagFilterWidget->scheduleRefreshTags();
+    } else {
+        resyncWidgets();
+    }
+}
 
+void DeckPreviewWidget::initializeUi()
+{
     bannerCardDisplayWidget->setFontSize(24);
-    setFilePath(deckLoader->getDeck().lastLoadInfo.fileName);
 
     colorIdentityWidget = new ColorIdentityWidget(this);
     deckTagsDisplayWidget = new DeckPreviewDeckTagsDisplayWidget(this);
@@ -152,34 +176,23 @@ void DeckPreviewWidget::initializeUi(const bool deckLoadSuccess)
  */
 void DeckPreviewWidget::resyncWidgets()
 {
-    auto bannerCardRef = deckLoader->getDeck().deckList.getBannerCard();
+    auto bannerCardRef = metadata.bannerCard;
     auto bannerCard = bannerCardRef.name.isEmpty() ? ExactCard() : CardDatabaseManager::query()->getCard(bannerCardRef);
 
     bannerCardDisplayWidget->setCard(bannerCard);
     refreshBannerCardText();
     updateBannerCardComboBox(bannerCardRef.name);
     colorIdentityWidget->setColorIdentity(getColorIdentity());
-    deckTagsDisplayWidget->setTags(deckLoader->getDeck().deckList.getTags());
+    deckTagsDisplayWidget->setTags(metadata.tags);
 }
 
 /**
- * @brief Reloads the deck if the file's last modified time has increased since we last checked.
+ * @brief Reindexes the deck if the file changed since it was indexed. The widgets are resynced once that is done.
  */
 void DeckPreviewWidget::reloadIfModified()
 {
-    QFileInfo fileInfo(filePath);
-    QDateTime newLastModifiedTime = fileInfo.lastModified();
-
-    if (!newLastModifiedTime.isValid() || newLastModifiedTime <= lastModifiedTime) {
-        return;
-    }
-
-    bool success = deckLoader->reload();
-
-    if (success) {
-        fileInfo.refresh();
-        lastModifiedTime = fileInfo.lastModified();
-        resyncWidgets();
+    if (QFileInfo::exists(filePath) && !DeckMetadataService::instance().find(filePath)) {
+        DeckMetadataService::instance().refresh(filePath);
     }
 }
 
@@ -233,35 +246,9 @@ void DeckPreviewWidget::updateTagsVisibility(bool visible)
     }
 }
 
-QString DeckPreviewWidget::getColorIdentity()
+QString DeckPreviewWidget::getColorIdentity() const
 {
-    QStringList cardList = deckLoader->getDeck().deckList.getCardList({DECK_ZONE_MAIN, DECK_ZONE_SIDE});
-    if (cardList.isEmpty()) {
-        return {};
-    }
-
-    QSet<QChar> colorSet; // A set to collect unique color symbols (e.g., W, U, B, R, G)
-
-    for (const QString &cardName : cardList) {
-        CardInfoPtr currentCard = CardDatabaseManager::query()->getCardInfo(cardName);
-        if (currentCard) {
-            QString colors = currentCard->getColors(); // Assuming this returns something like "WUB"
-            for (const QChar &color : colors) {
-                colorSet.insert(color);
-            }
-        }
-    }
-
-    // Ensure the color identity is in WUBRG order
-    QString colorIdentity;
-    const QString wubrgOrder = "WUBRG";
-    for (const QChar &color : wubrgOrder) {
-        if (colorSet.contains(color)) {
-            colorIdentity.append(color);
-        }
-    }
-
-    return colorIdentity;
+    return metadata.colorIdentity;
 }
 
 /**
@@ -269,8 +256,7 @@ QString DeckPreviewWidget::getColorIdentity()
  */
 QString DeckPreviewWidget::getDisplayName() const
 {
-    QString deckName = deckLoader->getDeck().deckList.getName();
-    return !deckName.isEmpty() ? deckName : QFileInfo(deckLoader->getDeck().lastLoadInfo.fileName).fileName();
+    return !metadata.name.isEmpty() ? metadata.name : QFileInfo(filePath).fileName();
 }
 
 void DeckPreviewWidget::setFilePath(const QString &_filePath)
@@ -314,11 +300,9 @@ void DeckPreviewWidget::updateBannerCardComboBox(const QString &currentText)
     // Prepare the new items with deduplication
     QSet<QPair<QString, QString>> bannerCardSet;
 
-    QList<const DecklistCardNode *> cardsInDeck = deckLoader->getDeck().deckList.getCardNodes();
-
-    for (auto currentCard : cardsInDeck) {
-        for (int k = 0; k < currentCard->getNumber(); ++k) {
-            bannerCardSet.insert(QPair<QString, QString>(currentCard->getName(), currentCard->getCardProviderId()));
+    for (const DeckMetadata::Card &currentCard : metadata.cards) {
+        if (currentCard.count > 0) {
+            bannerCardSet.insert(QPair<QString, QString>(currentCard.name, currentCard.providerId));
         }
     }
 
@@ -348,7 +332,7 @@ void DeckPreviewWidget::updateBannerCardComboBox(const QString &currentText)
         bannerCardComboBox->setCurrentIndex(restoredIndex);
     } else {
         // Add a placeholder "-" and set it as the current selection
-        int bannerIndex = bannerCardComboBox->findText(deckLoader->getDeck().deckList.getBannerCard().name);
+        int bannerIndex = bannerCardComboBox->findText(metadata.bannerCard.name);
         if (bannerIndex != -1) {
             bannerCardComboBox->setCurrentIndex(bannerIndex);
         } else {
@@ -366,8 +350,7 @@ void DeckPreviewWidget::setBannerCard(int /* changedIndex */)
 {
     auto [name, id] = bannerCardComboBox->currentData().value<QPair<QString, QString>>();
     CardRef cardRef = {name, id};
-    deckLoader->getDeck().deckList.setBannerCard(cardRef);
-    writeDeckToFile();
+    modifyDeck([&cardRef](DeckList &deckList) { deckList.setBannerCard(cardRef); });
     bannerCardDisplayWidget->setCard(CardDatabaseManager::query()->getCard(cardRef));
 }
 
@@ -389,8 +372,7 @@ void DeckPreviewWidget::imageDoubleClickedEvent(QMouseEvent *event, DeckPreviewC
 
 void DeckPreviewWidget::setTags(const QStringList &tags)
 {
-    deckLoader->getDeck().deckList.setTags(tags);
-    writeDeckToFile();
+    modifyDeck([&tags](DeckList &deckList) { deckList.setTags(tags); });
 }
 
 QMenu *DeckPreviewWidget::createRightClickMenu()
@@ -399,7 +381,11 @@ QMenu *DeckPreviewWidget::createRightClickMenu()
     menu->setAttribute(Qt::WA_DeleteOnClose);
 
     connect(menu->addAction(tr("Open in deck editor")), &QAction::triggered, this,
-            [this] { emit openDeckEditor(deckLoader->getDeck()); });
+            [this] {
+                if (std::optional<LoadedDeck> deck = loadDeck()) {
+                    emit openDeckEditor(*deck);
+                }
+            });
 
     connect(menu->addAction(tr("Edit Tags")), &QAction::triggered, deckTagsDisplayWidget,
             &DeckPreviewDeckTagsDisplayWidget::openTagEditDlg);
@@ -411,15 +397,20 @@ QMenu *DeckPreviewWidget::createRightClickMenu()
     connect(menu->addAction(tr("Rename Deck")), &QAction::triggered, this, &DeckPreviewWidget::actRenameDeck);
 
     auto saveToClipboardMenu = menu->addMenu(tr("Save Deck to Clipboard"));
+    auto saveToClipboard = [this](bool addComments, bool addSetNameAndNumber) {
+        if (std::optional<LoadedDeck> deck = loadDeck()) {
+            DeckLoader::saveToClipboard(deck->deckList, addComments, addSetNameAndNumber);
+        }
+    };
 
     connect(saveToClipboardMenu->addAction(tr("Annotated")), &QAction::triggered, this,
-            [this] { DeckLoader::saveToClipboard(deckLoader->getDeck().deckList, true, true); });
+            [saveToClipboard] { saveToClipboard(true, true); });
     connect(saveToClipboardMenu->addAction(tr("Annotated (No set info)")), &QAction::triggered, this,
-            [this] { DeckLoader::saveToClipboard(deckLoader->getDeck().deckList, true, false); });
+            [saveToClipboard] { saveToClipboard(true, false); });
     connect(saveToClipboardMenu->addAction(tr("Not Annotated")), &QAction::triggered, this,
-            [this] { DeckLoader::saveToClipboard(deckLoader->getDeck().deckList, false, true); });
+            [saveToClipboard] { saveToClipboard(false, true); });
     connect(saveToClipboardMenu->addAction(tr("Not Annotated (No set info)")), &QAction::triggered, this,
-            [this] { DeckLoader::saveToClipboard(deckLoader->getDeck().deckList, false, false); });
+            [saveToClipboard] { saveToClipboard(false, false); });
 
     menu->addSeparator();
 
@@ -455,7 +446,7 @@ void DeckPreviewWidget::addSetBannerCardMenu(QMenu *menu)
 void DeckPreviewWidget::actRenameDeck()
 {
     // read input
-    const QString oldName = deckLoader->getDeck().deckList.getName();
+    const QString oldName = metadata.name;
 
     bool ok;
     QString newName = QInputDialog::getText(this, "Rename deck", tr("New name:"), QLineEdit::Normal, oldName, &ok);
@@ -464,8 +455,10 @@ void DeckPreviewWidget::actRenameDeck()
     }
 
     // write change
-    deckLoader->getDeck().deckList.setName(newName);
-    writeDeckToFile();
+    if (!modifyDeck([&newName](DeckList &deckList) { deckList.setName(newName); })) {
+        QMessageBox::critical(this, tr("Error"), tr("Rename failed"));
+        return;
+    }
 
     // update VDS
     refreshBannerCardText();
@@ -495,11 +488,10 @@ void DeckPreviewWidget::actRenameFile()
         return;
     }
 
-    deckLoader->getDeck().lastLoadInfo.fileName = newFilePath;
     setFilePath(newFilePath);
 
     // update VDS
-    updateLastModifiedTime();
+    DeckMetadataService::instance().refresh(newFilePath);
     refreshBannerCardText();
 }
 
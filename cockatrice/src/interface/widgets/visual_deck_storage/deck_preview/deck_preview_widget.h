@@ -19,6 +19,9 @@
 #include <QEvent>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <functional>
+#include <libcockatrice/deck_list/deck_metadata_index.h>
+#include <optional>
 
 class QMenu;
 class VisualDeckStorageWidget;
@@ -32,14 +35,14 @@ public:
                                VisualDeckStorageWidget *_visualDeckStorageWidget,
                                const QString &_filePath);
     void retranslateUi();
-    QString getColorIdentity();
+    [[nodiscard]] QString getColorIdentity() const;
     [[nodiscard]] QString getDisplayName() const;
+    [[nodiscard]] std::optional<LoadedDeck> loadDeck() const;
 
     VisualDeckStorageWidget *visualDeckStorageWidget;
     QVBoxLayout *layout;
     QString filePath;
-    QDateTime lastModifiedTime;
-    DeckLoader *deckLoader;
+    DeckMetadata metadata; ///< From the deck metadata index, the deck file is only parsed when its content is needed
     DeckPreviewCardPictureWidget *bannerCardDisplayWidget = nullptr;
     ColorIdentityWidget *colorIdentityWidget = nullptr;
     DeckPreviewDeckTagsDisplayWidget *deckTagsDisplayWidget = nullptr;
@@ -62,7 +65,7 @@ public slots:
     void setBannerCard(int);
     void imageClickedEvent(QMouseEvent *event, DeckPreviewCardPictureWidget *instance);
     void imageDoubleClickedEvent(QMouseEvent *event, DeckPreviewCardPictureWidget *instance);
-    void initializeUi(bool deckLoadSuccess);
+    void initializeUi();
     void resyncWidgets();
     void reloadIfModified();
     void updateVisibility();
@@ -79,12 +82,12 @@ protected:
 #endif
 
 private:
-    void updateLastModifiedTime();
-    void writeDeckToFile();
+    bool modifyDeck(const std::function<void(DeckList &)> &modification);
     QMenu *createRightClickMenu();
     void addSetBannerCardMenu(QMenu *menu);
 
 private slots:
+    void onMetadataChanged(const QString &changedFilePath);
     void setTags(const QStringList &tags);
 
     void actRenameDeck();
@@ -82,20 +82,25 @@ static QStringList getAllFiles(const QString &filePath, bool recursive)
     return allFiles;
 }
 
+DeckPreviewWidget *VisualDeckStorageFolderDisplayWidget::createDeckPreview(const QString &file)
+{
+    auto *display = new DeckPreviewWidget(flowWidget, visualDeckStorageWidget, file);
+
+    connect(display, &DeckPreviewWidget::deckLoadRequested, visualDeckStorageWidget,
+            &VisualDeckStorageWidget::deckLoadRequested);
+    connect(display, &DeckPreviewWidget::openDeckEditor, visualDeckStorageWidget,
+            &VisualDeckStorageWidget::openDeckEditor);
+    connect(visualDeckStorageWidget->settings(), &VisualDeckStorageQuickSettingsWidget::cardSizeChanged,
+            display->bannerCardDisplayWidget, &CardInfoPictureWidget::setScaleFactor);
+    display->bannerCardDisplayWidget->setScaleFactor(visualDeckStorageWidget->settings()->getCardSize());
+    return display;
+}
+
 void VisualDeckStorageFolderDisplayWidget::createWidgetsForFiles()
 {
     QList<DeckPreviewWidget *> allDecks;
     for (const QString &file : getAllFiles(filePath, !showFolders)) {
-        auto *display = new DeckPreviewWidget(flowWidget, visualDeckStorageWidget, file);
-
-        connect(display, &DeckPreviewWidget::deckLoadRequested, visualDeckStorageWidget,
-                &VisualDeckStorageWidget::deckLoadRequested);
-        connect(display, &DeckPreviewWidget::openDeckEditor, visualDeckStorageWidget,
-                &VisualDeckStorageWidget::openDeckEditor);
-        connect(visualDeckStorageWidget->settings(), &VisualDeckStorageQuickSettingsWidget::cardSizeChanged,
-                display->bannerCardDisplayWidget, &CardInfoPictureWidget::setScaleFactor);
-        display->bannerCardDisplayWidget->setScaleFactor(visualDeckStorageWidget->settings()->getCardSize());
-        allDecks.append(display);
+        allDecks.append(createDeckPreview(file));
     }
 
     flowWidget->clearLayout(); // Clear existing widgets in the flow layout
@@ -105,6 +110,16 @@ void VisualDeckStorageFolderDisplayWidget::createWidgetsForFiles()
     }
 }
 
+/**
+ * Adds previews for decks that appeared in this folder after it was created, without touching the existing ones.
+ */
+void VisualDeckStorageFolderDisplayWidget::addDecks(const QStringList &filePaths)
+{
+    for (const QString &file : filePaths) {
+        flowWidget->addWidget(createDeckPreview(file));
+    }
+}
+
 /**
  * Updates the visibility of this folder and all its DeckPreviewWidgets
  *
@@ -212,7 +227,7 @@ QStringList VisualDeckStorageFolderDisplayWidget::gatherAllTagsFromFlowWidget()
         // Iterate through all DeckPreviewWidgets
         for (DeckPreviewWidget *display : flowWidget->findChildren<DeckPreviewWidget *>()) {
             // Get tags from each DeckPreviewWidget
-            QStringList tags = display->deckLoader->getDeck().deckList.getTags();
+            QStringList tags = display->metadata.tags;
 
             // Add tags to the list while avoiding duplicates
             allTags.append(tags);
@@ -10,6 +10,7 @@
 #include "../general/display/banner_widget.h"
 #include "../general/layout_containers/flow_widget.h"
 
+class DeckPreviewWidget;
 class VisualDeckStorageWidget;
 class VisualDeckStorageFolderDisplayWidget : public QWidget
 {
@@ -23,12 +24,17 @@ public:
     void refreshUi();
     void createWidgetsForFiles();
     void createWidgetsForFolders();
+    void addDecks(const QStringList &filePaths);
     void flattenFolderStructure();
     [[nodiscard]] QStringList gatherAllTagsFromFlowWidget() const;
     [[nodiscard]] FlowWidget *getFlowWidget() const
     {
         return flowWidget;
     }
+    [[nodiscard]] const QString &getFilePath() const
+    {
+        return filePath;
+    }
 
 public slots:
     void updateVisibility(bool recursive = true);
@@ -44,6 +50,8 @@ private:
     QWidget *container;
     QVBoxLayout *containerLayout;
     FlowWidget *flowWidget;
+
+    DeckPreviewWidget *createDeckPreview(const QString &file);
 };
 
 #endif // VISUAL_DECK_STORAGE_FOLDER_DISPLAY_WIDGET_H
@@ -96,17 +96,14 @@ QList<DeckPreviewWidget *> VisualDeckStorageSortWidget::filterFiles(QList<DeckPr
 
         switch (sortOrder) {
             case ByName:
-                return widget1->deckLoader->getDeck().deckList.getName() <
-                       widget2->deckLoader->getDeck().deckList.getName();
+                return widget1->metadata.name < widget2->metadata.name;
             case Alphabetical:
                 return QString::localeAwareCompare(info1.fileName(), info2.fileName()) <= 0;
             case ByLastModified:
                 return info1.lastModified() > info2.lastModified();
             case ByLastLoaded: {
-                QDateTime time1 =
-                    QDateTime::fromString(widget1->deckLoader->getDeck().deckList.getLastLoadedTimestamp());
-                QDateTime time2 =
-                    QDateTime::fromString(widget2->deckLoader->getDeck().deckList.getLastLoadedTimestamp());
+                QDateTime time1 = QDateTime::fromString(widget1->metadata.lastLoadedTimestamp);
+                QDateTime time2 = QDateTime::fromString(widget2->metadata.lastLoadedTimestamp);
                 return time1 > time2;
             }
         }
@@ -5,6 +5,7 @@
 #include "visual_deck_storage_widget.h"
 
 #include <QHBoxLayout>
+#include <QTimer>
 
 VisualDeckStorageTagFilterWidget::VisualDeckStorageTagFilterWidget(VisualDeckStorageWidget *_parent)
     : QWidget(_parent), parent(_parent)
@@ -21,6 +22,12 @@ VisualDeckStorageTagFilterWidget::VisualDeckStorageTagFilterWidget(VisualDeckSto
     auto *flowWidget = new FlowWidget(this, Qt::Horizontal, Qt::ScrollBarAlwaysOff, Qt::ScrollBarAsNeeded);
 
     layout->addWidget(flowWidget);
+
+    // decks parsed in the background arrive one by one, each of them would gather the tags of all decks again
+    refreshTimer = new QTimer(this);
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(100);
+    connect(refreshTimer, &QTimer::timeout, this, &VisualDeckStorageTagFilterWidget::refreshTags);
 }
 
 void VisualDeckStorageTagFilterWidget::showEvent(QShowEvent *event)
@@ -57,7 +64,7 @@ void VisualDeckStorageTagFilterWidget::filterDecksBySelectedTags(const QList<Dec
     }
 
     for (DeckPreviewWidget *deckPreview : deckPreviews) {
-        QStringList deckTags = deckPreview->deckLoader->getDeck().deckList.getTags();
+        const QStringList &deckTags = deckPreview->metadata.tags;
 
         bool hasAllSelected = std::all_of(selectedTags.begin(), selectedTags.end(),
                                           [&deckTags](const QString &tag) { return deckTags.contains(tag); });
@@ -70,8 +77,16 @@ void VisualDeckStorageTagFilterWidget::filterDecksBySelectedTags(const QList<Dec
     }
 }
 
+void VisualDeckStorageTagFilterWidget::scheduleRefreshTags()
+{
+    if (!refreshTimer->isActive()) {
+        refreshTimer->start();
+    }
+}
+
 void VisualDeckStorageTagFilterWidget::refreshTags()
 {
+    refreshTimer->stop();
     QSet<QString> allTags = gatherAllTags();
     removeTagsNotInList(allTags);
     addTagsIfNotPresent(allTags);
@@ -154,7 +169,7 @@ QSet<QString> VisualDeckStorageTagFilterWidget::gatherAllTags() const
 
     for (DeckPreviewWidget *widget : deckWidgets) {
         if (widget->checkVisibility()) {
-            for (const QString &tag : widget->deckLoader->getDeck().deckList.getTags()) {
+            for (const QString &tag : widget->metadata.tags) {
                 allTags.insert(tag);
             }
         }
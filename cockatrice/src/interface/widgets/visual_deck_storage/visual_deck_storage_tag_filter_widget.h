@@ -11,12 +11,14 @@
 
 #include <QWidget>
 
+class QTimer;
 class VisualDeckStorageWidget;
 class VisualDeckStorageTagFilterWidget : public QWidget
 {
     Q_OBJECT
 
     VisualDeckStorageWidget *parent;
+    QTimer *refreshTimer;
 
     [[nodiscard]] QSet<QString> gatherAllTags() const;
     void removeTagsNotInList(const QSet<QString> &tags);
@@ -31,6 +33,8 @@ public:
 
 public slots:
     void refreshTags();
+    /** Refreshes the tags shortly, once for all the decks that change in the meantime. */
+    void scheduleRefreshTags();
     void showEvent(QShowEvent *event) override;
 };
 
@@ -1,6 +1,7 @@
 #include "visual_deck_storage_widget.h"
 
 #include "../../../client/settings/cache_settings.h"
+#include "../../deck_loader/deck_metadata_service.h"
 #include "../quick_settings/settings_button_widget.h"
 #include "deck_preview/deck_preview_widget.h"
 #include "visual_deck_storage_folder_display_widget.h"
@@ -10,7 +11,9 @@
 
 #include <QComboBox>
 #include <QDirIterator>
+#include <QFileInfo>
 #include <QMouseEvent>
+#include <QSet>
 #include <QVBoxLayout>
 #include <libcockatrice/card/database/card_database_manager.h>
 #include <libcockatrice/settings/paths_settings.h>
@@ -78,6 +81,17 @@ VisualDeckStorageWidget::VisualDeckStorageWidget(QWidget *parent) : QWidget(pare
     connect(CardDatabaseManager::getInstance(), &CardDatabase::cardDatabaseLoadingFinished, this,
             &VisualDeckStorageWidget::createRootFolderWidget);
 
+    // keep the previews in sync with decks added or removed outside of this widget
+    connect(&DeckMetadataService::instance(), &DeckMetadataService::filesAdded, this,
+            &VisualDeckStorageWidget::addDeckFiles);
+    connect(&DeckMetadataService::instance(), &DeckMetadataService::fileRemoved, this,
+            &VisualDeckStorageWidget::removeDeckFile);
+    connect(&DeckMetadataService::instance(), &DeckMetadataService::directoryAdded, this, [this] {
+        if (folderWidget && quickSettingsWidget->getShowFolders()) {
+            QTimer::singleShot(0, this, &VisualDeckStorageWidget::createRootFolderWidget);
+        }
+    });
+
     databaseLoadIndicator = new QLabel(this);
     databaseLoadIndicator->setAlignment(Qt::AlignCenter);
 
@@ -138,6 +152,7 @@ const VisualDeckStorageQuickSettingsWidget *VisualDeckStorageWidget::settings()
  */
 void VisualDeckStorageWidget::reapplySortAndFilters()
 {
+    tagFilterWidget->refreshTags();
     updateSortOrder();
     updateTagFilter();
     updateColorFilter();
@@ -146,6 +161,9 @@ void VisualDeckStorageWidget::reapplySortAndFilters()
 
 void VisualDeckStorageWidget::createRootFolderWidget()
 {
+    // previews are drawn from the deck metadata index, decks missing from it are parsed as they come up
+    DeckMetadataService::instance().watch(SettingsCache::instance().paths().getDeckPath());
+
     folderWidget = new VisualDeckStorageFolderDisplayWidget(this, this, SettingsCache::instance().paths().getDeckPath(),
                                                             false, quickSettingsWidget->getShowFolders());
 
@@ -159,6 +177,70 @@ void VisualDeckStorageWidget::createRootFolderWidget()
     QTimer::singleShot(0, this, &VisualDeckStorageWidget::reapplySortAndFilters);
 }
 
+/**
+ * Adds previews for deck files that appeared in the deck folder, unless a preview already shows them, e.g. because it
+ * was renamed through this widget.
+ */
+void VisualDeckStorageWidget::addDeckFiles(const QString &directory, const QStringList &filePaths)
+{
+    if (!folderWidget) {
+        return;
+    }
+
+    QSet<QString> shownFiles;
+    for (DeckPreviewWidget *preview : folderWidget->findChildren<DeckPreviewWidget *>()) {
+        shownFiles.insert(QFileInfo(preview->filePath).absoluteFilePath());
+    }
+
+    QStringList newFiles;
+    for (const QString &file : filePaths) {
+        if (!shownFiles.contains(file)) {
+            newFiles << file;
+        }
+    }
+    if (newFiles.isEmpty()) {
+        return;
+    }
+
+    VisualDeckStorageFolderDisplayWidget *targetFolder = nullptr;
+    if (quickSettingsWidget->getShowFolders()) {
+        QList<VisualDeckStorageFolderDisplayWidget *> folders =
+            folderWidget->findChildren<VisualDeckStorageFolderDisplayWidget *>();
+        folders.prepend(folderWidget);
+        for (VisualDeckStorageFolderDisplayWidget *folder : folders) {
+            if (QFileInfo(folder->getFilePath()).absoluteFilePath() == directory) {
+                targetFolder = folder;
+            }
+        }
+    } else if (directory.startsWith(QFileInfo(folderWidget->getFilePath()).absoluteFilePath())) {
+        targetFolder = folderWidget;
+    }
+
+    // a folder that is not shown yet gets its previews when the folders are recreated
+    if (!targetFolder) {
+        return;
+    }
+
+    targetFolder->addDecks(newFiles);
+    QTimer::singleShot(0, this, &VisualDeckStorageWidget::reapplySortAndFilters);
+}
+
+void VisualDeckStorageWidget::removeDeckFile(const QString &filePath)
+{
+    if (!folderWidget) {
+        return;
+    }
+
+    for (DeckPreviewWidget *preview : folderWidget->findChildren<DeckPreviewWidget *>()) {
+        if (QFileInfo(preview->filePath).absoluteFilePath() == filePath) {
+            delete preview;
+        }
+    }
+
+    tagFilterWidget->refreshTags();
+    folderWidget->updateVisibility();
+}
+
 void VisualDeckStorageWidget::updateShowFolders(bool enabled)
 {
     if (folderWidget) {
@@ -70,6 +70,8 @@ private:
     VisualDeckStorageFolderDisplayWidget *folderWidget;
 
     void reapplySortAndFilters();
+    void addDeckFiles(const QString &directory, const QStringList &filePaths);
+    void removeDeckFile(const QString &filePath);
 };
 
 #endif // VISUAL_DECK_STORAGE_WIDGET_H
@@ -7,6 +7,7 @@
 
 #include <QDataStream>
 #include <QDir>
+#include <QMetaMethod>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QRegularExpression>
@@ -61,6 +62,10 @@ void CardInfo::setProperty(const QString &_name, const QString &_value)
     }
     propertiesCache.insert(_name, _value);
     propertiesBlob = serializeProperties(propertiesCache);
+    if (_name.startsWith("format-")) {
+        legalities.set(FormatIds::intern(_name.mid(QStringLiteral("format-").size())),
+                       CardLegalities::legalityFromString(_value));
+    }
     emit cardInfoChanged(smartThis);
 }
 
@@ -78,6 +83,7 @@ CardInfo::CardInfo(const QString &_name,
     propertiesCache = std::move(_properties);
     propertiesBlob = serializeProperties(propertiesCache);
     propertiesLoaded = true;
+    legalities = CardLegalities::fromProperties(propertiesCache);
 
     simpleName = CardInfo::simplifyName(name);
 
@@ -93,9 +99,10 @@ CardInfo::CardInfo(const QString &_name,
                    SetToPrintingsMap _sets,
                    const UiAttributes _uiAttributes,
                    QString _simpleName,
-                   QSet<QString> _altNames)
+                   QSet<QString> _altNames,
+                   CardLegalities _legalities)
     : name(_name), simpleName(std::move(_simpleName)), text(_text), isToken(_isToken),
-      propertiesBlob(std::move(_propertiesBlob)), relatedCards(_relatedCards),
+      propertiesBlob(std::move(_propertiesBlob)), legalities(_legalities), relatedCards(_relatedCards),
       reverseRelatedCards(_reverseRelatedCards), setsToPrintings(std::move(_sets)), uiAttributes(_uiAttributes),
       altNames(std::move(_altNames))
 {
@@ -143,11 +150,12 @@ CardInfoPtr CardInfo::newInstance(const QString &_name,
                                   const UiAttributes _uiAttributes,
                                   QString _simpleName,
                                   QSet<QString> _altNames,
+                                  CardLegalities _legalities,
                                   bool _appendToSets)
 {
     CardInfoPtr ptr(new CardInfo(_name, _text, _isToken, std::move(_propertiesBlob), _relatedCards,
                                  _reverseRelatedCards, _sets, _uiAttributes, std::move(_simpleName),
-                                 std::move(_altNames)));
+                                 std::move(_altNames), _legalities));
     ptr->setSmartPointer(ptr);
 
     if (_appendToSets) {
@@ -176,6 +184,11 @@ QString CardInfo::getCorrectedName() const
 
 QString CardInfo::getLegalityProp(const QString &format) const
 {
+    const CardLegalities::Legality legality = legalities.legality(FormatIds::find(format));
+    if (legality != CardLegalities::NotListed) {
+        return CardLegalities::legalityToString(legality);
+    }
+    // values other than legal, restricted and banned are not in the bitsets
     return getProperty("format-" + format);
 }
 
@@ -185,8 +198,13 @@ bool CardInfo::isLegalInFormat(const QString &format) const
         return true;
     }
 
-    QString formatLegality = getLegalityProp(format);
-    return formatLegality == "legal" || formatLegality == "restricted";
+    const int formatId = FormatIds::find(format);
+    if (formatId >= 0) {
+        return legalities.isLegal(formatId);
+    }
+    // formats past the id cap have no bits
+    const CardLegalities::Legality legality = CardLegalities::legalityFromString(getProperty("format-" + format));
+    return legality == CardLegalities::Legal || legality == CardLegalities::Restricted;
 }
 
 void CardInfo::addToSet(const CardSetPtr &_set, const PrintingInfo &_info)
@@ -212,9 +230,16 @@ void CardInfo::combineLegalities(const QHash<QString, QString> &props)
         }
     }
     propertiesBlob = serializeProperties(propertiesCache);
+    legalities = CardLegalities::fromProperties(propertiesCache);
     emit cardInfoChanged(smartThis);
 }
 
+bool CardInfo::hasPixmapListeners() const
+{
+    static const QMetaMethod pixmapUpdatedSignal = QMetaMethod::fromSignal(&CardInfo::pixmapUpdated);
+    return isSignalConnected(pixmapUpdatedSignal);
+}
+
 void CardInfo::refreshCachedSets()
 {
     refreshCachedSetNames();
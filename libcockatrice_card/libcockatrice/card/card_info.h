@@ -1,6 +1,7 @@
 #ifndef CARD_INFO_H
 #define CARD_INFO_H
 
+#include "format/card_legalities.h"
 #include "format/format_legality_rules.h"
 #include "printing/printing_info.h"
 
@@ -89,6 +90,8 @@ private:
      */
     void ensurePropertiesLoaded() const;
 
+    CardLegalities legalities; ///< Legality per format, kept in sync with the "format-<name>" properties.
+
     QList<CardRelation *> relatedCards;            ///< Forward references to related cards.
     QList<CardRelation *> reverseRelatedCards;     ///< Cards that refer back to this card.
     QList<CardRelation *> reverseRelatedCardsToMe; ///< Cards that consider this card as related.
@@ -140,6 +143,7 @@ public:
      * @param _uiAttributes Attributes that affect display and game logic.
      * @param _simpleName Precomputed simplified name.
      * @param _altNames Precomputed alternate names.
+     * @param _legalities Precomputed legalities, matching the format properties in @p _propertiesBlob.
      */
     explicit CardInfo(const QString &_name,
                       const QString &_text,
@@ -150,7 +154,8 @@ public:
                       SetToPrintingsMap _sets,
                       UiAttributes _uiAttributes,
                       QString _simpleName,
-                      QSet<QString> _altNames);
+                      QSet<QString> _altNames,
+                      CardLegalities _legalities);
 
     /**
      * @brief Copy constructor for CardInfo.
@@ -161,7 +166,8 @@ public:
      */
     CardInfo(const CardInfo &other)
         : QObject(other.parent()), name(other.name), simpleName(other.simpleName), text(other.text),
-          isToken(other.isToken), propertiesBlob(other.propertiesBlob), relatedCards(other.relatedCards),
+          isToken(other.isToken), propertiesBlob(other.propertiesBlob), legalities(other.legalities),
+          relatedCards(other.relatedCards),
           reverseRelatedCards(other.reverseRelatedCards), reverseRelatedCardsToMe(other.reverseRelatedCardsToMe),
           setsToPrintings(other.setsToPrintings), uiAttributes(other.uiAttributes), setsNames(other.setsNames),
           altNames(other.altNames)
@@ -214,6 +220,7 @@ public:
      * @param _uiAttributes Attributes that affect display and game logic.
      * @param _simpleName Precomputed simplified name.
      * @param _altNames Precomputed alternate names.
+     * @param _legalities Precomputed legalities, matching the format properties in @p _propertiesBlob.
      * @param _appendToSets When true (default), the card is appended to each of
      *        its CardSets. Pass false when building cards in parallel so the
      *        (non-thread-safe) set membership is populated in a later
@@ -230,6 +237,7 @@ public:
                                    UiAttributes _uiAttributes,
                                    QString _simpleName,
                                    QSet<QString> _altNames,
+                                   CardLegalities _legalities,
                                    bool _appendToSets = true);
 
     /**
@@ -384,6 +392,14 @@ public:
      */
     [[nodiscard]] bool isLegalInFormat(const QString &format) const;
 
+    /**
+     * @brief The legality of the card in every format, for checks that resolve the format id once and test bits.
+     */
+    [[nodiscard]] const CardLegalities &getLegalities() const
+    {
+        return legalities;
+    }
+
     /**
      * @brief Adds a printing to a specific set.
      *
@@ -410,6 +426,13 @@ public:
      */
     void refreshCachedSets();
 
+    /**
+     * @brief Checks whether anything is connected to pixmapUpdated, i.e. whether a widget currently shows the card.
+     *
+     * Used by the picture loader to drop queued downloads nobody waits for anymore. Safe to call from any thread.
+     */
+    [[nodiscard]] bool hasPixmapListeners() const;
+
     /**
      * @brief Simplifies a name for fuzzy matching.
      *
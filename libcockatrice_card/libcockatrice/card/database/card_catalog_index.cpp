@@ -0,0 +1,131 @@
+#include "card_catalog_index.h"
+
+#include <libcockatrice/card/format/card_legalities.h>
+
+QStringList CardCatalogIndex::subTypesOf(const QString &cardType)
+{
+    const QStringList parts = cardType.split(" — ");
+    if (parts.size() < 2) {
+        return {};
+    }
+    return parts[1].split(" ", Qt::SkipEmptyParts);
+}
+
+void CardCatalogIndex::addCard(const CardInfoPtr &card)
+{
+    if (!card) {
+        return;
+    }
+    removeCard(card);
+
+    Keys keys;
+    keys.mainType = card->getMainCardType();
+    keys.subTypes = subTypesOf(card->getCardType());
+    for (quint64 formats = card->getLegalities().listedFormats(); formats != 0; formats &= formats - 1) {
+        keys.formats << FormatIds::name(qCountTrailingZeroBits(formats));
+    }
+    insert(card->getName(), keys);
+}
+
+void CardCatalogIndex::insert(const QString &cardName, const Keys &keys)
+{
+    byMainType[keys.mainType].insert(cardName);
+    for (const QString &subType : keys.subTypes) {
+        bySubType[subType].insert(cardName);
+    }
+    for (const QString &format : keys.formats) {
+        byFormat[format].insert(cardName);
+    }
+    keysByCard.insert(cardName, keys);
+}
+
+static void removeFrom(QHash<QString, CardCatalogIndex::CardNames> &index, const QString &key, const QString &cardName)
+{
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return;
+    }
+    it->remove(cardName);
+    if (it->isEmpty()) {
+        // a type or format without cards is not offered by the filters
+        index.erase(it);
+    }
+}
+
+void CardCatalogIndex::removeCard(const CardInfoPtr &card)
+{
+    if (!card) {
+        return;
+    }
+
+    const QString cardName = card->getName();
+    auto it = keysByCard.find(cardName);
+    if (it == keysByCard.end()) {
+        return;
+    }
+
+    removeFrom(byMainType, it->mainType, cardName);
+    for (const QString &subType : it->subTypes) {
+        removeFrom(bySubType, subType, cardName);
+    }
+    for (const QString &format : it->formats) {
+        removeFrom(byFormat, format, cardName);
+    }
+    keysByCard.erase(it);
+}
+
+void CardCatalogIndex::clear()
+{
+    byMainType.clear();
+    bySubType.clear();
+    byFormat.clear();
+    keysByCard.clear();
+}
+
+void CardCatalogIndex::rebuild(const CardNameMap &cards)
+{
+    clear();
+    keysByCard.reserve(cards.size());
+    for (const CardInfoPtr &card : cards) {
+        addCard(card);
+    }
+}
+
+QMap<QString, int> CardCatalogIndex::countsOf(const QHash<QString, CardNames> &index)
+{
+    QMap<QString, int> counts;
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        counts.insert(it.key(), it->size());
+    }
+    return counts;
+}
+
+void CardCatalogIndex::write(QDataStream &out) const
+{
+    // format names rather than ids, the ids are assigned anew on every start
+    out << quint32(keysByCard.size());
+    for (auto it = keysByCard.constBegin(); it != keysByCard.constEnd(); ++it) {
+        out << it.key() << it->mainType << it->subTypes << it->formats;
+    }
+}
+
+bool CardCatalogIndex::read(QDataStream &in)
+{
+    clear();
+
+    quint32 count;
+    in >> count;
+    keysByCard.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString cardName;
+        Keys keys;
+        in >> cardName >> keys.mainType >> keys.subTypes >> keys.formats;
+        insert(cardName, keys);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef CARD_CATALOG_INDEX_H
+#define CARD_CATALOG_INDEX_H
+
+#include <QDataStream>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <libcockatrice/card/card_info.h>
+
+/**
+ * @class CardCatalogIndex
+ * @ingroup CardDatabase
+ * @brief Card names by main type, subtype and format, kept up to date as cards are added and removed.
+ *
+ * The filter panels of the visual database display list every type and format together with the number of cards
+ * that have it. The index answers those queries without looking at a single card, and is stored in the binary cache
+ * so a warm start does not have to build it either.
+ */
+class CardCatalogIndex
+{
+public:
+    using CardNames = QSet<QString>;
+
+    void addCard(const CardInfoPtr &card);
+    void removeCard(const CardInfoPtr &card);
+    void clear();
+
+    /** @brief Replaces the index with one over the given cards. */
+    void rebuild(const CardNameMap &cards);
+
+    [[nodiscard]] QStringList mainTypes() const
+    {
+        return byMainType.keys();
+    }
+    [[nodiscard]] QMap<QString, int> mainTypeCounts() const
+    {
+        return countsOf(byMainType);
+    }
+    [[nodiscard]] QMap<QString, int> subTypeCounts() const
+    {
+        return countsOf(bySubType);
+    }
+    [[nodiscard]] QMap<QString, int> formatCounts() const
+    {
+        return countsOf(byFormat);
+    }
+    [[nodiscard]] CardNames cardsWithMainType(const QString &mainType) const
+    {
+        return byMainType.value(mainType);
+    }
+    [[nodiscard]] CardNames cardsWithSubType(const QString &subType) const
+    {
+        return bySubType.value(subType);
+    }
+    /** @brief Cards listed in the format with any legality. */
+    [[nodiscard]] CardNames cardsInFormat(const QString &formatName) const
+    {
+        return byFormat.value(formatName);
+    }
+
+    void write(QDataStream &out) const;
+    bool read(QDataStream &in);
+
+    /**
+     * @return The subtypes in a type line, the words after the dash, e.g. "Elf Warrior" for "Creature — Elf Warrior".
+     */
+    static QStringList subTypesOf(const QString &cardType);
+
+private:
+    /** @brief What a card was indexed under, so it can be removed even if its properties changed since. */
+    struct Keys
+    {
+        QString mainType;
+        QStringList subTypes;
+        QStringList formats;
+    };
+
+    QHash<QString, CardNames> byMainType;
+    QHash<QString, CardNames> bySubType;
+    QHash<QString, CardNames> byFormat;
+    QHash<QString, Keys> keysByCard;
+
+    void insert(const QString &cardName, const Keys &keys);
+    static QMap<QString, int> countsOf(const QHash<QString, CardNames> &index);
+};
+
+#endif // CARD_CATALOG_INDEX_H
@@ -54,6 +54,7 @@ void CardDatabase::clear()
 
     cards.clear();
     simpleNameCards.clear();
+    catalog.clear();
 
     sets.clear();
     ICardDatabaseParser::clearSetlist();
@@ -130,6 +131,7 @@ void CardDatabase::addCard(const CardInfoPtr &card)
     QMutexLocker locker(addCardMutex);
     cards.insert(name, card);
     simpleNameCards.insert(card->getSimpleName(), card);
+    catalog.addCard(card);
 
     emit cardAdded(card);
 }
@@ -156,6 +158,7 @@ void CardDatabase::removeCard(const CardInfoPtr &card)
     QMutexLocker locker(removeCardMutex);
     cards.remove(card->getName());
     simpleNameCards.remove(card->getSimpleName());
+    catalog.removeCard(card);
     emit cardRemoved(card);
 }
 
@@ -258,6 +261,7 @@ void CardDatabase::swapInDatabaseData(CardDatabaseData data)
     simpleNameCards = std::move(data.simpleNameCards);
     sets = std::move(data.sets);
     formats = std::move(data.formats);
+    catalog = std::move(data.catalog);
 
     loadStatus = cards.isEmpty() ? NotLoaded : Ok;
 
@@ -45,6 +45,9 @@ protected:
 
     FormatRulesNameMap formats;
 
+    /** @brief Card names by type and format, for the filters that list them with counts. */
+    CardCatalogIndex catalog;
+
     /** @brief Loader responsible for file discovery and parsing. */
     CardDatabaseLoader *loader;
 
@@ -17,7 +17,7 @@
 namespace
 {
 constexpr quint32 CACHE_MAGIC = 0x43445243; // "CDRC"
-constexpr quint32 CACHE_VERSION = 2;
+constexpr quint32 CACHE_VERSION = 4;
 
 // ---- Primitives -----------------------------------------------------------
 
@@ -153,6 +153,8 @@ void writeCard(QDataStream &out, const CardInfoPtr &card)
     writeString(out, card->getText());
     out << card->getIsToken();
     writeHashBlob(out, card->getPropertiesHash());
+    const CardLegalities &legalities = card->getLegalities();
+    out << legalities.legalMask() << legalities.restrictedMask() << legalities.bannedMask();
 
     CardInfo::UiAttributes ui = card->getUiAttributes();
     out << ui.cipt;
@@ -195,15 +197,31 @@ void writeCard(QDataStream &out, const CardInfoPtr &card)
     for (const CardRelation *rel : reverse) {
         writeRelation(out, rel);
     }
+
+    // the relations other cards declared towards this one, resolved by the loader before the cache is written
+    const QList<CardRelation *> reverse2Me = card->getReverseRelatedCards2Me();
+    out << static_cast<quint32>(reverse2Me.size());
+    for (const CardRelation *rel : reverse2Me) {
+        writeRelation(out, rel);
+    }
 }
 
-CardInfoPtr readCard(QDataStream &in, const SetNameMap &sets)
+// formatIds maps the format ids the cache was written with to the ids of this process, empty if they are the same
+CardInfoPtr readCard(QDataStream &in, const SetNameMap &sets, const QList<int> &formatIds)
 {
     QString name = readString(in);
     QString text = readString(in);
     bool isToken = false;
     in >> isToken;
     QByteArray propertiesBlob = readHashBlob(in);
+    quint64 legal = 0;
+    quint64 restricted = 0;
+    quint64 banned = 0;
+    in >> legal >> restricted >> banned;
+    CardLegalities legalities(legal, restricted, banned);
+    if (!formatIds.isEmpty()) {
+        legalities = legalities.remapped(formatIds);
+    }
 
     CardInfo::UiAttributes ui;
     in >> ui.cipt;
@@ -268,8 +286,18 @@ CardInfoPtr readCard(QDataStream &in, const SetNameMap &sets)
         reverse.append(readRelation(in));
     }
 
-    return CardInfo::newInstance(name, text, isToken, propertiesBlob, related, reverse, cardSets, ui, simpleName,
-                                 altNames, false);
+    quint32 reverse2MeCount = 0;
+    in >> reverse2MeCount;
+    if (in.status() != QDataStream::Ok) {
+        return nullptr;
+    }
+
+    CardInfoPtr card = CardInfo::newInstance(name, text, isToken, propertiesBlob, related, reverse, cardSets, ui,
+                                             simpleName, altNames, legalities, false);
+    for (quint32 i = 0; i < reverse2MeCount; ++i) {
+        card->addReverseRelatedCards2Me(readRelation(in));
+    }
+    return card;
 }
 
 // ---- FormatRules -----------------------------------------------------------
@@ -361,6 +389,13 @@ bool CardDatabaseCache::write(const QString &cachePath, const CardDatabaseData &
     out << CACHE_VERSION;
     out << sourceHash;
 
+    // Format names in id order, the legality masks of the cards refer to them
+    const QStringList formatNames = FormatIds::names();
+    out << static_cast<quint32>(formatNames.size());
+    for (const QString &formatName : formatNames) {
+        writeString(out, formatName);
+    }
+
     // Sets
     out << static_cast<quint32>(data.sets.size());
     for (const CardSetPtr &set : data.sets) {
@@ -380,6 +415,9 @@ bool CardDatabaseCache::write(const QString &cachePath, const CardDatabaseData &
         writeFormat(out, format);
     }
 
+    // Type and format index of the filters
+    data.catalog.write(out);
+
     return file.commit();
 }
 
@@ -416,6 +454,23 @@ bool CardDatabaseCache::read(const QString &cachePath,
     QElapsedTimer deserializeTimer;
     deserializeTimer.start();
 
+    // Format names, interned in the order they were written, which gives the same ids in a fresh process
+    quint32 formatNameCount = 0;
+    in >> formatNameCount;
+    if (in.status() != QDataStream::Ok || formatNameCount > static_cast<quint32>(FormatIds::maxFormats)) {
+        return false;
+    }
+    QList<int> formatIds;
+    bool sameFormatIds = true;
+    for (quint32 i = 0; i < formatNameCount; ++i) {
+        const int formatId = FormatIds::intern(readString(in));
+        formatIds.append(formatId);
+        sameFormatIds &= formatId == static_cast<int>(i);
+    }
+    if (sameFormatIds) {
+        formatIds.clear();
+    }
+
     // Sets
     quint32 setCount = 0;
     in >> setCount;
@@ -436,7 +491,7 @@ bool CardDatabaseCache::read(const QString &cachePath,
     if (cardCount > 0) {
         data.cards.reserve(static_cast<int>(cardCount));
         for (quint32 i = 0; i < cardCount; ++i) {
-            CardInfoPtr card = readCard(in, data.sets);
+            CardInfoPtr card = readCard(in, data.sets, formatIds);
             if (card == nullptr) {
                 return false;
             }
@@ -470,6 +525,11 @@ bool CardDatabaseCache::read(const QString &cachePath,
         data.formats.insert(format->formatName.toLower(), format);
     }
 
+    // Type and format index of the filters
+    if (!data.catalog.read(in)) {
+        return false;
+    }
+
     qCInfo(CardDatabaseLoadingLog) << "[cache] read + deserialize" << deserializeTimer.elapsed() << "ms for"
                                    << cardCount << "cards";
 
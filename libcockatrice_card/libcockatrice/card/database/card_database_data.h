@@ -1,6 +1,8 @@
 #ifndef CARDDATABASE_DATA_H
 #define CARDDATABASE_DATA_H
 
+#include "card_catalog_index.h"
+
 #include <libcockatrice/card/card_info.h>
 
 /**
@@ -19,6 +21,7 @@ struct CardDatabaseData
     CardNameMap simpleNameCards;
     SetNameMap sets;
     FormatRulesNameMap formats;
+    CardCatalogIndex catalog;
 };
 
 #endif // CARDDATABASE_DATA_H
@@ -118,17 +118,18 @@ LoadStatus CardDatabaseLoader::doLoadCardDatabases()
                 loadCardDatabase(p, data);
             }
 
+            // AFTER all the cards have been loaded: resolve the reverse-related tags against the fully-built
+            // snapshot, and index it for the filters. Both are stored in the cache, so a cache hit skips this.
+            database->refreshCachedReverseRelatedCards(data.cards);
+            data.catalog.rebuild(data.cards);
+
             if (!saveToCache(data, sourceHash)) {
                 qCWarning(CardDatabaseLoadingLog) << "Failed to write binary cache to" << cachePath();
             }
         }
     }
 
-    // AFTER all the cards have been loaded: resolve the reverse-related tags
-    // against the fully-built snapshot.
     if (loadStatus == Ok) {
-        database->refreshCachedReverseRelatedCards(data.cards);
-
         qCInfo(CardDatabaseLoadingSuccessOrFailureLog) << "Card Database Loading Success";
         emit databaseDataReady(std::move(data));
         emit loadingFinished();
@@ -188,7 +189,12 @@ bool CardDatabaseLoader::loadFromCache(CardDatabaseData &data, const QByteArray
     if (sourceHash.isEmpty()) {
         return false;
     }
-    return CardDatabaseCache::read(cachePath(), data, sourceHash, priorityController);
+    if (!CardDatabaseCache::read(cachePath(), data, sourceHash, priorityController)) {
+        // whatever was read before the cache turned out unusable must not end up next to the parsed cards
+        data = CardDatabaseData();
+        return false;
+    }
+    return true;
 }
 
 bool CardDatabaseLoader::saveToCache(const CardDatabaseData &data, const QByteArray &sourceHash)
@@ -304,44 +304,17 @@ QString CardDatabaseQuerier::getPreferredPrintingProviderId(const QString &cardN
 
 QStringList CardDatabaseQuerier::getAllMainCardTypes() const
 {
-    QSet<QString> types;
-    for (const auto &card : db->cards.values()) {
-        types.insert(card->getMainCardType());
-    }
-    return types.values();
+    return db->catalog.mainTypes();
 }
 
 QMap<QString, int> CardDatabaseQuerier::getAllMainCardTypesWithCount() const
 {
-    QMap<QString, int> typeCounts;
-
-    for (const auto &card : db->cards.values()) {
-        QString type = card->getMainCardType();
-        typeCounts[type]++;
-    }
-
-    return typeCounts;
+    return db->catalog.mainTypeCounts();
 }
 
 QMap<QString, int> CardDatabaseQuerier::getAllSubCardTypesWithCount() const
 {
-    QMap<QString, int> typeCounts;
-
-    for (const auto &card : db->cards.values()) {
-        QString type = card->getCardType();
-
-        QStringList parts = type.split(" — ");
-
-        if (parts.size() > 1) { // Ensure there are subtypes
-            QStringList subtypes = parts[1].split(" ", Qt::SkipEmptyParts);
-
-            for (const QString &subtype : subtypes) {
-                typeCounts[subtype]++;
-            }
-        }
-    }
-
-    return typeCounts;
+    return db->catalog.subTypeCounts();
 }
 
 FormatRulesPtr CardDatabaseQuerier::getFormat(const QString &formatName) const
@@ -351,18 +324,10 @@ FormatRulesPtr CardDatabaseQuerier::getFormat(const QString &formatName) const
 
 QMap<QString, int> CardDatabaseQuerier::getAllFormatsWithCount() const
 {
-    QMap<QString, int> formatCounts;
-
-    for (const auto &card : db->cards.values()) {
-        QStringList allProps = card->getProperties();
-
-        for (const QString &prop : allProps) {
-            if (prop.startsWith("format-")) {
-                QString formatName = prop.mid(QStringLiteral("format-").size());
-                formatCounts[formatName]++;
-            }
-        }
-    }
+    return db->catalog.formatCounts();
+}
 
-    return formatCounts;
+const CardCatalogIndex &CardDatabaseQuerier::getCatalog() const
+{
+    return db->catalog;
 }
@@ -3,6 +3,7 @@
 
 #include "../card_info.h"
 #include "../printing/exact_card.h"
+#include "card_catalog_index.h"
 
 #include <QObject>
 #include <libcockatrice/interfaces/interface_card_preference_provider.h>
@@ -217,6 +218,12 @@ public:
     FormatRulesPtr getFormat(const QString &formatName) const;
     QMap<QString, int> getAllFormatsWithCount() const;
 
+    /**
+     * @brief Returns the names of the cards of each main type, subtype and format, kept up to date as cards are added
+     * and removed.
+     */
+    [[nodiscard]] const CardCatalogIndex &getCatalog() const;
+
 private:
     const CardDatabase *db;               //!< Card database used for all lookups.
     const ICardPreferenceProvider *prefs; //!< Preference provider for preferred printings.
@@ -0,0 +1,148 @@
+#include "card_legalities.h"
+
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QWriteLocker>
+
+namespace
+{
+const QString FORMAT_PROPERTY_PREFIX = QStringLiteral("format-");
+
+struct FormatRegistry
+{
+    QReadWriteLock lock;
+    QHash<QString, int> ids;
+    QStringList names;
+    bool capReported = false;
+};
+
+FormatRegistry &registry()
+{
+    static FormatRegistry formatRegistry;
+    return formatRegistry;
+}
+} // namespace
+
+int FormatIds::intern(const QString &formatName)
+{
+    FormatRegistry &formats = registry();
+    {
+        QReadLocker locker(&formats.lock);
+        const auto it = formats.ids.constFind(formatName);
+        if (it != formats.ids.constEnd()) {
+            return *it;
+        }
+    }
+
+    QWriteLocker locker(&formats.lock);
+    const auto it = formats.ids.constFind(formatName);
+    if (it != formats.ids.constEnd()) {
+        return *it;
+    }
+    if (formats.names.size() >= maxFormats) {
+        if (!formats.capReported) {
+            formats.capReported = true;
+            qCWarning(CardLegalitiesLog) << "More than" << maxFormats << "formats, the legalities of" << formatName
+                                         << "and later formats are looked up in the card properties";
+        }
+        return -1;
+    }
+    const int id = static_cast<int>(formats.names.size());
+    formats.ids.insert(formatName, id);
+    formats.names.append(formatName);
+    return id;
+}
+
+int FormatIds::find(const QString &formatName)
+{
+    FormatRegistry &formats = registry();
+    QReadLocker locker(&formats.lock);
+    return formats.ids.value(formatName, -1);
+}
+
+QString FormatIds::name(int formatId)
+{
+    FormatRegistry &formats = registry();
+    QReadLocker locker(&formats.lock);
+    return formats.names.value(formatId);
+}
+
+QStringList FormatIds::names()
+{
+    FormatRegistry &formats = registry();
+    QReadLocker locker(&formats.lock);
+    return formats.names;
+}
+
+CardLegalities CardLegalities::fromProperties(const QHash<QString, QString> &properties)
+{
+    CardLegalities result;
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        if (it.key().startsWith(FORMAT_PROPERTY_PREFIX)) {
+            result.set(FormatIds::intern(it.key().mid(FORMAT_PROPERTY_PREFIX.size())),
+                       legalityFromString(it.value()));
+        }
+    }
+    return result;
+}
+
+CardLegalities::Legality CardLegalities::legalityFromString(const QString &legality)
+{
+    if (legality == "legal") {
+        return Legal;
+    }
+    if (legality == "restricted") {
+        return Restricted;
+    }
+    if (legality == "banned") {
+        return Banned;
+    }
+    return NotListed;
+}
+
+QString CardLegalities::legalityToString(Legality legality)
+{
+    switch (legality) {
+        case Legal:
+            return "legal";
+        case Restricted:
+            return "restricted";
+        case Banned:
+            return "banned";
+        default:
+            return QString();
+    }
+}
+
+void CardLegalities::set(int formatId, Legality legality)
+{
+    if (formatId < 0 || formatId >= FormatIds::maxFormats) {
+        return;
+    }
+    const quint64 bit = quint64(1) << formatId;
+    legal &= ~bit;
+    restricted &= ~bit;
+    banned &= ~bit;
+    switch (legality) {
+        case Legal:
+            legal |= bit;
+            break;
+        case Restricted:
+            restricted |= bit;
+            break;
+        case Banned:
+            banned |= bit;
+            break;
+        default:
+            break;
+    }
+}
+
+CardLegalities CardLegalities::remapped(const QList<int> &newIds) const
+{
+    CardLegalities result;
+    for (int oldId = 0; oldId < newIds.size() && oldId < FormatIds::maxFormats; ++oldId) {
+        result.set(newIds[oldId], legality(oldId));
+    }
+    return result;
+}
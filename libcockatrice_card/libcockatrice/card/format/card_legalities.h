@@ -0,0 +1,130 @@
+#ifndef COCKATRICE_CARD_LEGALITIES_H
+#define COCKATRICE_CARD_LEGALITIES_H
+
+#include <QHash>
+#include <QList>
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+
+inline Q_LOGGING_CATEGORY(CardLegalitiesLog, "card_legalities");
+
+/**
+ * Small integer ids for format names, so the legalities of a card can be kept as bit masks.
+ *
+ * Ids are handed out in the order the formats are first seen and are only valid in the running process; the binary
+ * card cache stores the names with it and maps them back when it is read. The functions are thread-safe, cards are
+ * built in parallel while the database loads.
+ */
+namespace FormatIds
+{
+constexpr int maxFormats = 64;
+
+/**
+ * @return The id of the format, assigning one if the format is new. -1 if all ids are taken, the legalities of such
+ * formats are only in the "format-<name>" properties of the cards.
+ */
+int intern(const QString &formatName);
+
+/**
+ * @return The id of the format, -1 if no card or rule has mentioned the format yet.
+ */
+int find(const QString &formatName);
+
+QString name(int formatId);
+
+/**
+ * @return All known format names, the index of a name is its id.
+ */
+QStringList names();
+} // namespace FormatIds
+
+/**
+ * The legality of a card in every format, one bit per format id for each of legal, restricted and banned.
+ *
+ * Built from the "format-<name>" properties of the card when it is loaded, so legality checks and filters over the
+ * whole database are bit tests instead of property lookups.
+ */
+class CardLegalities
+{
+public:
+    enum Legality : quint8
+    {
+        NotListed,
+        Legal,
+        Restricted,
+        Banned
+    };
+
+    CardLegalities() = default;
+    CardLegalities(quint64 _legal, quint64 _restricted, quint64 _banned)
+        : legal(_legal), restricted(_restricted), banned(_banned)
+    {
+    }
+
+    /**
+     * @brief Collects the legalities from the "format-<name>" entries of a card's properties.
+     */
+    static CardLegalities fromProperties(const QHash<QString, QString> &properties);
+    static Legality legalityFromString(const QString &legality);
+    static QString legalityToString(Legality legality);
+
+    [[nodiscard]] Legality legality(int formatId) const
+    {
+        if (formatId < 0) {
+            return NotListed;
+        }
+        const quint64 bit = quint64(1) << formatId;
+        if (legal & bit) {
+            return Legal;
+        }
+        if (restricted & bit) {
+            return Restricted;
+        }
+        return banned & bit ? Banned : NotListed;
+    }
+
+    /**
+     * @return Whether the card may be played in the format, which is the case if it is legal or restricted there.
+     */
+    [[nodiscard]] bool isLegal(int formatId) const
+    {
+        return formatId >= 0 && ((legal | restricted) >> formatId) & 1;
+    }
+
+    /**
+     * @return The formats the card is listed in with any legality, as a bit mask over the format ids.
+     */
+    [[nodiscard]] quint64 listedFormats() const
+    {
+        return legal | restricted | banned;
+    }
+
+    void set(int formatId, Legality legality);
+
+    /**
+     * @brief Moves every format to another id, used when reading masks that were written with other ids.
+     * @param newIds The new id of each old id, -1 to drop the format.
+     */
+    [[nodiscard]] CardLegalities remapped(const QList<int> &newIds) const;
+
+    [[nodiscard]] quint64 legalMask() const
+    {
+        return legal;
+    }
+    [[nodiscard]] quint64 restrictedMask() const
+    {
+        return restricted;
+    }
+    [[nodiscard]] quint64 bannedMask() const
+    {
+        return banned;
+    }
+
+private:
+    quint64 legal = 0;
+    quint64 restricted = 0;
+    quint64 banned = 0;
+};
+
+#endif // COCKATRICE_CARD_LEGALITIES_H
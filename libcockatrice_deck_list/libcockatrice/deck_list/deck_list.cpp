@@ -514,3 +514,39 @@ void DeckList::restoreMemento(const DeckListMemento &m)
     cleanList();
     loadFromString_Native(m.getMemento());
 }
+
+DeckListEditableMetadata DeckList::getEditableMetadata() const
+{
+    return {metadata.name, metadata.comments, metadata.gameFormat, metadata.bannerCard, metadata.tags};
+}
+
+void DeckList::setEditableMetadata(const DeckListEditableMetadata &editableMetadata)
+{
+    metadata.name = editableMetadata.name;
+    metadata.comments = editableMetadata.comments;
+    metadata.gameFormat = editableMetadata.gameFormat;
+    metadata.bannerCard = editableMetadata.bannerCard;
+    metadata.tags = editableMetadata.tags;
+}
+
+DecklistCardNode *DeckList::applyCardChange(const DeckListCardChange &change)
+{
+    auto node = tree.applyCardChange(change);
+    refreshDeckHash();
+    return node;
+}
+
+void DeckList::applyChange(const DeckListMemento &change)
+{
+    if (change.isSnapshot()) {
+        restoreMemento(change);
+        return;
+    }
+
+    for (const auto &cardChange : change.getCardChanges()) {
+        applyCardChange(cardChange);
+    }
+    if (const auto &metadataChange = change.getMetadataChange()) {
+        setEditableMetadata(metadataChange->after);
+    }
+}
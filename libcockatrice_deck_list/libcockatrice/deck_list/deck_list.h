@@ -252,8 +252,25 @@ public:
      * @param func Function taking (zone node, card node).
      */
     void forEachCard(const std::function<void(InnerDecklistNode *, DecklistCardNode *)> &func) const;
+    /** @name Edit history */
+    ///@{
     DeckListMemento createMemento(const QString &reason) const;
     void restoreMemento(const DeckListMemento &m);
+
+    DeckListEditableMetadata getEditableMetadata() const;
+    void setEditableMetadata(const DeckListEditableMetadata &editableMetadata);
+
+    /**
+     * @brief Applies a single card change to the deck tree.
+     * @return The changed card node, or nullptr if it was deleted or there was nothing to remove.
+     */
+    DecklistCardNode *applyCardChange(const DeckListCardChange &change);
+
+    /**
+     * @brief Applies the card and metadata changes of a history entry. Snapshot entries are restored instead.
+     */
+    void applyChange(const DeckListMemento &change);
+    ///@}
 };
 
 #endif
@@ -1,55 +1,149 @@
 #include "deck_list_history_manager.h"
 
+// restoring a checkpoint means parsing the whole deck, only worth it when it saves inverting a few changes
+static constexpr int minCheckpointJump = DeckListHistoryManager::checkpointInterval / 4;
+
 void DeckListHistoryManager::save(const DeckListMemento &memento)
 {
-    undoStack.push(memento);
-    redoStack.clear();
+    push(undoStack, memento);
+    clearRedo();
+    trim();
     emit undoRedoStateChanged();
 }
 
+void DeckListHistoryManager::saveChange(const DeckListMemento &change, const DeckList &deck)
+{
+    DeckListMemento entry = change;
+
+    int changesSinceCheckpoint = 0;
+    for (auto it = undoStack.crbegin(); it != undoStack.crend() && it->isChange() && !it->hasCheckpoint(); ++it) {
+        ++changesSinceCheckpoint;
+    }
+    if (changesSinceCheckpoint + 1 >= checkpointInterval) {
+        entry.setCheckpoint(deck.writeToString_Native());
+    }
+
+    save(entry);
+}
+
 void DeckListHistoryManager::clear()
 {
     undoStack.clear();
     redoStack.clear();
+    historyBytes = 0;
     emit undoRedoStateChanged();
 }
 
-void DeckListHistoryManager::undo(DeckList *deck)
+bool DeckListHistoryManager::undo(DeckList *deck, int steps, const ChangeApplier &applyChange)
 {
-    if (undoStack.isEmpty()) {
-        return;
+    if (undoStack.isEmpty() || steps <= 0) {
+        return false;
     }
 
-    // Peek at the memento we are going to restore
-    const DeckListMemento &mementoToRestore = undoStack.top();
+    const int target = undoStack.size() - qMin(steps, static_cast<int>(undoStack.size()));
 
-    // Save current state for redo
-    DeckListMemento currentState = deck->createMemento(mementoToRestore.getReason());
-    redoStack.push(currentState);
+    bool restored = false;
 
-    // Pop the last state from undo stack and restore it
-    DeckListMemento memento = undoStack.pop();
-    deck->restoreMemento(memento);
+    // Jump to the lowest checkpoint in range. Only change entries can be skipped, the redo entry of a snapshot
+    // entry has to be taken from the deck as it was at that point.
+    int checkpointIndex = -1;
+    for (int i = undoStack.size() - 1; i >= target && undoStack[i].isChange(); --i) {
+        if (undoStack[i].hasCheckpoint() && undoStack.size() - 1 - i >= minCheckpointJump) {
+            checkpointIndex = i;
+        }
+    }
+    if (checkpointIndex != -1) {
+        deck->restoreMemento(DeckListMemento(undoStack[checkpointIndex].getCheckpoint()));
+        while (undoStack.size() - 1 > checkpointIndex) {
+            push(redoStack, pop(undoStack));
+        }
+        restored = true;
+    }
+
+    while (undoStack.size() > target) {
+        DeckListMemento entry = pop(undoStack);
+        if (entry.isSnapshot()) {
+            // Save current state for redo
+            push(redoStack, deck->createMemento(entry.getReason()));
+            deck->restoreMemento(entry);
+            restored = true;
+        } else {
+            if (applyChange && !restored) {
+                applyChange(entry.inverted());
+            } else {
+                deck->applyChange(entry.inverted());
+            }
+            push(redoStack, entry);
+        }
+    }
 
     emit undoRedoStateChanged();
+    return restored;
 }
 
-void DeckListHistoryManager::redo(DeckList *deck)
+bool DeckListHistoryManager::redo(DeckList *deck, int steps, const ChangeApplier &applyChange)
 {
-    if (redoStack.isEmpty()) {
-        return;
+    if (redoStack.isEmpty() || steps <= 0) {
+        return false;
     }
 
-    // Peek at the memento we are going to restore
-    const DeckListMemento &mementoToRestore = redoStack.top();
+    bool restored = false;
 
-    // Save current state for undo
-    DeckListMemento currentState = deck->createMemento(mementoToRestore.getReason());
-    undoStack.push(currentState);
-
-    // Pop the next state from redo stack and restore it
-    DeckListMemento memento = redoStack.pop();
-    deck->restoreMemento(memento);
+    for (int i = 0; i < steps && !redoStack.isEmpty(); ++i) {
+        DeckListMemento entry = pop(redoStack);
+        if (entry.isSnapshot()) {
+            // Save current state for undo
+            push(undoStack, deck->createMemento(entry.getReason()));
+            deck->restoreMemento(entry);
+            restored = true;
+        } else {
+            if (applyChange && !restored) {
+                applyChange(entry);
+            } else {
+                deck->applyChange(entry);
+            }
+            push(undoStack, entry);
+        }
+    }
 
     emit undoRedoStateChanged();
+    return restored;
+}
+
+void DeckListHistoryManager::setMaxHistoryBytes(qsizetype _maxHistoryBytes)
+{
+    maxHistoryBytes = _maxHistoryBytes;
+    trim();
+}
+
+void DeckListHistoryManager::push(QStack<DeckListMemento> &stack, const DeckListMemento &memento)
+{
+    historyBytes += memento.byteSize();
+    stack.push(memento);
+}
+
+DeckListMemento DeckListHistoryManager::pop(QStack<DeckListMemento> &stack)
+{
+    DeckListMemento memento = stack.pop();
+    historyBytes -= memento.byteSize();
+    return memento;
+}
+
+void DeckListHistoryManager::clearRedo()
+{
+    for (const auto &memento : redoStack) {
+        historyBytes -= memento.byteSize();
+    }
+    redoStack.clear();
+}
+
+/**
+ * Drops the oldest undo steps until the history fits into its byte limit. The latest step is always kept.
+ */
+void DeckListHistoryManager::trim()
+{
+    while (historyBytes > maxHistoryBytes && undoStack.size() > 1) {
+        historyBytes -= undoStack.first().byteSize();
+        undoStack.removeFirst();
+    }
 }
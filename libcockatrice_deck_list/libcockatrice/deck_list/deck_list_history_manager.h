@@ -6,7 +6,15 @@
 
 #include <QObject>
 #include <QStack>
+#include <functional>
 
+/**
+ * @brief Undo and redo history of a deck.
+ *
+ * The history holds snapshot and change entries (see DeckListMemento). Every checkpointInterval consecutive change
+ * entries, a checkpoint of the deck is attached, so that undoing many steps at once can restore the checkpoint
+ * instead of inverting every change. The oldest entries are dropped once the history grows beyond its byte limit.
+ */
 class DeckListHistoryManager : public QObject
 {
     Q_OBJECT
@@ -15,12 +23,31 @@ signals:
     void undoRedoStateChanged();
 
 public:
+    /**
+     * Applies the card and metadata changes of a change entry to the deck, e.g. through a model of the deck so that
+     * views get fine grained updates.
+     */
+    using ChangeApplier = std::function<void(const DeckListMemento &change)>;
+
+    static constexpr int checkpointInterval = 32;
+    static constexpr qsizetype defaultMaxHistoryBytes = 16 * 1024 * 1024;
+
     explicit DeckListHistoryManager(QObject *parent = nullptr) : QObject(parent)
     {
     }
 
+    /**
+     * @brief Records a snapshot of the deck as it was before an edit.
+     */
     void save(const DeckListMemento &memento);
 
+    /**
+     * @brief Records the changes an edit made.
+     * @param change The change entry
+     * @param deck The deck after the edit, used to take a checkpoint
+     */
+    void saveChange(const DeckListMemento &change, const DeckList &deck);
+
     void clear();
 
     [[nodiscard]] bool canUndo() const
@@ -33,9 +60,20 @@ public:
         return !redoStack.isEmpty();
     }
 
-    void undo(DeckList *deck);
+    /**
+     * @brief Undoes up to the given number of steps.
+     * @param deck The deck
+     * @param steps The number of steps
+     * @param applyChange Applies the inverted change entries instead of applying them to the deck directly
+     * @return Whether (part of) the deck was restored from a snapshot or checkpoint, in which case anything built
+     * from the deck has to be rebuilt.
+     */
+    bool undo(DeckList *deck, int steps = 1, const ChangeApplier &applyChange = {});
 
-    void redo(DeckList *deck);
+    /**
+     * @brief Redoes up to the given number of steps. See undo().
+     */
+    bool redo(DeckList *deck, int steps = 1, const ChangeApplier &applyChange = {});
 
     [[nodiscard]] QStack<DeckListMemento> getRedoStack() const
     {
@@ -46,9 +84,26 @@ public:
         return undoStack;
     }
 
+    [[nodiscard]] qsizetype getHistoryBytes() const
+    {
+        return historyBytes;
+    }
+    [[nodiscard]] qsizetype getMaxHistoryBytes() const
+    {
+        return maxHistoryBytes;
+    }
+    void setMaxHistoryBytes(qsizetype _maxHistoryBytes);
+
 private:
     QStack<DeckListMemento> undoStack;
     QStack<DeckListMemento> redoStack;
+    qsizetype historyBytes = 0;
+    qsizetype maxHistoryBytes = defaultMaxHistoryBytes;
+
+    void push(QStack<DeckListMemento> &stack, const DeckListMemento &memento);
+    DeckListMemento pop(QStack<DeckListMemento> &stack);
+    void clearRedo();
+    void trim();
 };
 
 #endif // COCKATRICE_DECK_LIST_HISTORY_MANAGER_H
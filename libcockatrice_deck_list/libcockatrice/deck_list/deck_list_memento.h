@@ -1,7 +1,76 @@
 #ifndef COCKATRICE_DECK_LIST_MEMENTO_H
 #define COCKATRICE_DECK_LIST_MEMENTO_H
+#include <QList>
 #include <QString>
+#include <QStringList>
+#include <libcockatrice/utility/card_ref.h>
+#include <optional>
 
+/**
+ * @brief Adds (positive amount) or removes (negative amount) copies of one printing of a card in a zone.
+ * Setting the count of a card is recorded as the difference to the previous count, moving a card to another zone as a
+ * removal from the old zone and an addition to the new one.
+ */
+struct DeckListCardChange
+{
+    QString zoneName;
+    QString cardName;
+    QString cardSetShortName;
+    QString cardCollectorNumber;
+    QString cardProviderId;
+    int amount = 0;
+
+    [[nodiscard]] DeckListCardChange inverted() const
+    {
+        DeckListCardChange result = *this;
+        result.amount = -amount;
+        return result;
+    }
+};
+
+/**
+ * @brief The part of the deck metadata that can be edited in the deck editor.
+ */
+struct DeckListEditableMetadata
+{
+    QString name;
+    QString comments;
+    QString gameFormat;
+    CardRef bannerCard;
+    QStringList tags;
+
+    bool operator==(const DeckListEditableMetadata &other) const
+    {
+        return name == other.name && comments == other.comments && gameFormat == other.gameFormat &&
+               bannerCard == other.bannerCard && tags == other.tags;
+    }
+};
+
+/**
+ * @brief Replaces the editable metadata of a deck.
+ */
+struct DeckListMetadataChange
+{
+    DeckListEditableMetadata before;
+    DeckListEditableMetadata after;
+
+    [[nodiscard]] DeckListMetadataChange inverted() const
+    {
+        return {after, before};
+    }
+};
+
+/**
+ * @brief An entry of the deck edit history.
+ *
+ * An entry is either a snapshot, holding the whole serialized deck as it was before the edit, or a change, holding
+ * only the card and metadata changes the edit made. Changes are applied forwards for redo and inverted for undo,
+ * which keeps single card edits cheap on large decks. Edits that can't be described as a change (e.g. sorting or
+ * importing) are recorded as snapshots.
+ *
+ * A change may additionally carry a checkpoint, the serialized deck as it was after the edit, which lets the history
+ * jump back over many changes at once instead of inverting them one by one.
+ */
 class DeckListMemento
 {
 public:
@@ -10,6 +79,14 @@ public:
         : memento(memento), reason(reason)
     {
     }
+    DeckListMemento(const QList<DeckListCardChange> &cardChanges, const QString &reason)
+        : reason(reason), cardChanges(cardChanges)
+    {
+    }
+    DeckListMemento(const DeckListMetadataChange &metadataChange, const QString &reason)
+        : reason(reason), metadataChange(metadataChange)
+    {
+    }
 
     [[nodiscard]] QString getMemento() const
     {
@@ -20,9 +97,81 @@ public:
         return reason;
     }
 
+    [[nodiscard]] bool isSnapshot() const
+    {
+        return !isChange();
+    }
+    [[nodiscard]] bool isChange() const
+    {
+        return !cardChanges.isEmpty() || metadataChange.has_value();
+    }
+    [[nodiscard]] const QList<DeckListCardChange> &getCardChanges() const
+    {
+        return cardChanges;
+    }
+    [[nodiscard]] const std::optional<DeckListMetadataChange> &getMetadataChange() const
+    {
+        return metadataChange;
+    }
+
+    /**
+     * @brief Returns the change that reverts this one. The card changes are reverted in reverse order.
+     */
+    [[nodiscard]] DeckListMemento inverted() const
+    {
+        DeckListMemento result;
+        result.reason = reason;
+        for (auto it = cardChanges.crbegin(); it != cardChanges.crend(); ++it) {
+            result.cardChanges.append(it->inverted());
+        }
+        if (metadataChange) {
+            result.metadataChange = metadataChange->inverted();
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool hasCheckpoint() const
+    {
+        return !checkpoint.isEmpty();
+    }
+    [[nodiscard]] QString getCheckpoint() const
+    {
+        return checkpoint;
+    }
+    void setCheckpoint(const QString &_checkpoint)
+    {
+        checkpoint = _checkpoint;
+    }
+
+    /**
+     * @brief Approximate memory used by the entry, used to cap the size of the history.
+     */
+    [[nodiscard]] qsizetype byteSize() const
+    {
+        qsizetype size = sizeof(DeckListMemento) + (memento.size() + reason.size() + checkpoint.size()) * 2;
+        for (const auto &change : cardChanges) {
+            size += sizeof(DeckListCardChange) + (change.zoneName.size() + change.cardName.size() +
+                                                  change.cardSetShortName.size() + change.cardCollectorNumber.size() +
+                                                  change.cardProviderId.size()) *
+                                                     2;
+        }
+        if (metadataChange) {
+            for (const auto &metadata : {metadataChange->before, metadataChange->after}) {
+                size += (metadata.name.size() + metadata.comments.size() + metadata.gameFormat.size() +
+                         metadata.bannerCard.name.size() + metadata.bannerCard.providerId.size() +
+                         metadata.tags.join(QString()).size()) *
+                        2;
+            }
+        }
+        return size;
+    }
+
 private:
     QString memento;
     QString reason;
+    QList<DeckListCardChange> cardChanges;
+    std::optional<DeckListMetadataChange> metadataChange;
+    QString checkpoint;
 };
 
 #endif // COCKATRICE_DECK_LIST_MEMENTO_H
@@ -158,6 +158,33 @@ bool DecklistNodeTree::deleteNode(AbstractDecklistNode *node, InnerDecklistNode
     return false;
 }
 
+DecklistCardNode *DecklistNodeTree::applyCardChange(const DeckListCardChange &change)
+{
+    auto *zoneNode = dynamic_cast<InnerDecklistNode *>(root->findChild(change.zoneName));
+    DecklistCardNode *cardNode = nullptr;
+    if (zoneNode) {
+        cardNode = dynamic_cast<DecklistCardNode *>(zoneNode->findCardChildByNameProviderIdAndNumber(
+            change.cardName, change.cardProviderId, change.cardCollectorNumber));
+    }
+
+    if (!cardNode) {
+        if (change.amount <= 0) {
+            return nullptr;
+        }
+        return addCard(change.cardName, change.amount, change.zoneName, -1, change.cardSetShortName,
+                       change.cardCollectorNumber, change.cardProviderId);
+    }
+
+    const int newAmount = cardNode->getNumber() + change.amount;
+    if (newAmount <= 0) {
+        deleteNode(cardNode);
+        return nullptr;
+    }
+
+    cardNode->setNumber(newAmount);
+    return cardNode;
+}
+
 void DecklistNodeTree::forEachCard(const std::function<void(InnerDecklistNode *, DecklistCardNode *)> &func) const
 {
     // Support for this is only possible if the internal structure
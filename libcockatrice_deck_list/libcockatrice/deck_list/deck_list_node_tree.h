@@ -1,6 +1,7 @@
 #ifndef COCKATRICE_DECKLIST_NODE_TREE_H
 #define COCKATRICE_DECKLIST_NODE_TREE_H
 
+#include "deck_list_memento.h"
 #include "libcockatrice/utility/card_ref.h"
 #include "tree/deck_list_card_node.h"
 #include "tree/inner_deck_list_node.h"
@@ -77,6 +78,13 @@ public:
                               const bool formatLegal = true);
     bool deleteNode(AbstractDecklistNode *node, InnerDecklistNode *rootNode = nullptr);
 
+    /**
+     * @brief Applies a card change. Creates the card node if the card isn't in the zone yet and deletes it once its
+     * amount drops to zero.
+     * @return The changed card node, or nullptr if it was deleted or there was nothing to remove.
+     */
+    DecklistCardNode *applyCardChange(const DeckListCardChange &change);
+
     /**
      * @brief Apply a function to every card in the deck tree. This can modify the cards.
      *
@@ -0,0 +1,181 @@
+#include "deck_metadata_index.h"
+
+#include "tree/deck_list_card_node.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+
+static constexpr quint32 INDEX_FILE_MAGIC = 0x43444d49; // "CDMI"
+static constexpr quint32 INDEX_FILE_VERSION = 2;
+
+DeckMetadata DeckMetadata::fromDeckList(const DeckList &deckList)
+{
+    DeckMetadata metadata;
+    const DeckList::Metadata &deckMetadata = deckList.getMetadata();
+    metadata.name = deckMetadata.name;
+    metadata.comments = deckMetadata.comments;
+    metadata.gameFormat = deckMetadata.gameFormat;
+    metadata.bannerCard = deckMetadata.bannerCard;
+    metadata.tags = deckMetadata.tags;
+    metadata.lastLoadedTimestamp = deckMetadata.lastLoadedTimestamp;
+    metadata.deckHash = deckList.getDeckHash();
+
+    for (const DecklistCardNode *node : deckList.getCardNodes()) {
+        metadata.cards.append({node->getName(), node->getCardProviderId(), node->getNumber()});
+    }
+    for (const DecklistCardNode *node : deckList.getCardNodes({DECK_ZONE_MAIN, DECK_ZONE_SIDE})) {
+        metadata.cardCount += node->getNumber();
+    }
+
+    return metadata;
+}
+
+void DeckMetadata::setFile(const QFileInfo &file)
+{
+    fileSize = file.size();
+    lastModified = file.lastModified().toMSecsSinceEpoch();
+    metadataChanged = file.metadataChangeTime().toMSecsSinceEpoch();
+}
+
+bool DeckMetadata::matchesFile(const QFileInfo &file) const
+{
+    return file.exists() && fileSize == file.size() && lastModified == file.lastModified().toMSecsSinceEpoch() &&
+           metadataChanged == file.metadataChangeTime().toMSecsSinceEpoch();
+}
+
+static QDataStream &operator<<(QDataStream &out, const DeckMetadata &metadata)
+{
+    out << metadata.fileSize << metadata.lastModified << metadata.metadataChanged << metadata.name
+        << metadata.comments << metadata.gameFormat << metadata.bannerCard.name << metadata.bannerCard.providerId
+        << metadata.tags << metadata.lastLoadedTimestamp << metadata.colorIdentity << metadata.colorIdentityPending
+        << qint32(metadata.cardCount) << metadata.deckHash << quint32(metadata.cards.size());
+    for (const DeckMetadata::Card &card : metadata.cards) {
+        out << card.name << card.providerId << qint32(card.count);
+    }
+    return out;
+}
+
+static QDataStream &operator>>(QDataStream &in, DeckMetadata &metadata)
+{
+    qint32 cardCount;
+    quint32 cards;
+    in >> metadata.fileSize >> metadata.lastModified >> metadata.metadataChanged >> metadata.name >>
+        metadata.comments >> metadata.gameFormat >> metadata.bannerCard.name >> metadata.bannerCard.providerId >>
+        metadata.tags >> metadata.lastLoadedTimestamp >> metadata.colorIdentity >> metadata.colorIdentityPending >>
+        cardCount >> metadata.deckHash >> cards;
+    metadata.cardCount = cardCount;
+    for (quint32 i = 0; i < cards && in.status() == QDataStream::Ok; ++i) {
+        DeckMetadata::Card card;
+        qint32 count;
+        in >> card.name >> card.providerId >> count;
+        card.count = count;
+        metadata.cards.append(card);
+    }
+    return in;
+}
+
+DeckMetadataIndex::DeckMetadataIndex(const QString &_indexFilePath) : indexFilePath(_indexFilePath)
+{
+}
+
+bool DeckMetadataIndex::load()
+{
+    entries.clear();
+    dirty = false;
+
+    QFile file(indexFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    quint32 magic, version, count;
+    in >> magic >> version;
+    if (magic != INDEX_FILE_MAGIC || version != INDEX_FILE_VERSION) {
+        return false;
+    }
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString filePath;
+        DeckMetadata metadata;
+        in >> filePath >> metadata;
+        entries.insert(filePath, metadata);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        // a truncated index is as good as none, every deck gets parsed again
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DeckMetadataIndex::save()
+{
+    if (!dirty) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(indexFilePath).absolutePath());
+    QSaveFile file(indexFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << INDEX_FILE_MAGIC << INDEX_FILE_VERSION << quint32(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        out << it.key() << it.value();
+    }
+
+    if (!file.commit()) {
+        return false;
+    }
+    dirty = false;
+    return true;
+}
+
+const DeckMetadata *DeckMetadataIndex::find(const QFileInfo &file) const
+{
+    auto it = entries.constFind(file.absoluteFilePath());
+    if (it == entries.constEnd() || !it->matchesFile(file)) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+void DeckMetadataIndex::insert(const QString &filePath, const DeckMetadata &metadata)
+{
+    entries.insert(QFileInfo(filePath).absoluteFilePath(), metadata);
+    dirty = true;
+}
+
+void DeckMetadataIndex::remove(const QString &filePath)
+{
+    if (entries.remove(QFileInfo(filePath).absoluteFilePath()) > 0) {
+        dirty = true;
+    }
+}
+
+void DeckMetadataIndex::removeMissing(const QString &directory, const QStringList &existingFiles)
+{
+    const QString absoluteDirectory = QFileInfo(directory).absoluteFilePath();
+    QSet<QString> existing;
+    for (const QString &file : existingFiles) {
+        existing.insert(QFileInfo(file).absoluteFilePath());
+    }
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (QFileInfo(it.key()).absolutePath() == absoluteDirectory && !existing.contains(it.key())) {
+            it = entries.erase(it);
+            dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
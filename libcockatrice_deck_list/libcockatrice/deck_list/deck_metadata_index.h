@@ -0,0 +1,127 @@
+/**
+ * @file deck_metadata_index.h
+ * @ingroup Decks
+ * @brief Persistent summaries of deck files, so deck browsers can show decks without parsing their files.
+ */
+
+#ifndef DECK_METADATA_INDEX_H
+#define DECK_METADATA_INDEX_H
+
+#include "deck_list.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <libcockatrice/utility/card_ref.h>
+
+/**
+ * @struct DeckMetadata
+ * @ingroup Decks
+ * @brief Everything a deck browser shows or filters by, taken from one deck file.
+ *
+ * The entry remembers the size and times of the file it was read from, and is only valid for as long as the file still
+ * has them.
+ */
+struct DeckMetadata
+{
+    struct Card
+    {
+        QString name;
+        QString providerId;
+        int count = 0;
+    };
+
+    qint64 fileSize = -1;
+    qint64 lastModified = 0;    ///< Msecs since the epoch
+    qint64 metadataChanged = 0; ///< Msecs since the epoch, also changes on writes that restore lastModified
+
+    QString name;
+    QString comments;
+    QString gameFormat;
+    CardRef bannerCard;
+    QStringList tags;
+    QString lastLoadedTimestamp;
+    QString colorIdentity; ///< In WUBRG order, over the main deck and sideboard. Needs the card database to compute.
+    int cardCount = 0;     ///< Cards in the main deck and sideboard
+    QString deckHash;
+    QList<Card> cards; ///< Every card node of the deck, in every zone
+
+    /// The color identity was computed before the card database was loaded, and has to be computed again once it is
+    bool colorIdentityPending = false;
+
+    /**
+     * @brief Reads the metadata of a deck. Leaves the file identity and the color identity empty.
+     */
+    static DeckMetadata fromDeckList(const DeckList &deckList);
+
+    /**
+     * @brief Remembers the size and times of the file, making the entry valid for it.
+     */
+    void setFile(const QFileInfo &file);
+    [[nodiscard]] bool matchesFile(const QFileInfo &file) const;
+};
+
+/**
+ * @class DeckMetadataIndex
+ * @ingroup Decks
+ * @brief DeckMetadata by absolute file path, kept in a single file.
+ *
+ * Lookups compare the entry with the size and times of the file on disk, so an entry of a file that was changed by
+ * another program is never returned. Callers are expected to reparse such files and insert the new entry.
+ */
+class DeckMetadataIndex
+{
+public:
+    explicit DeckMetadataIndex(const QString &indexFilePath);
+
+    /**
+     * @brief Replaces the entries with those in the index file.
+     * @return false if the file is missing, unreadable or from another version, in which case the index is empty.
+     */
+    bool load();
+
+    /**
+     * @brief Writes the entries to the index file, if they changed since the last load or save.
+     */
+    bool save();
+
+    /**
+     * @return The entry of the file, or nullptr if there is none or the file changed since it was made.
+     */
+    [[nodiscard]] const DeckMetadata *find(const QFileInfo &file) const;
+
+    void insert(const QString &filePath, const DeckMetadata &metadata);
+    void remove(const QString &filePath);
+
+    /**
+     * @brief Removes the entries of files in the directory that are not in the list, e.g. files deleted while the
+     * client was not running. Entries in subdirectories are left alone.
+     */
+    void removeMissing(const QString &directory, const QStringList &existingFiles);
+
+    /**
+     * @return The files that have an entry, whether or not it is still valid.
+     */
+    [[nodiscard]] QStringList filePaths() const
+    {
+        return entries.keys();
+    }
+
+    [[nodiscard]] int size() const
+    {
+        return entries.size();
+    }
+    [[nodiscard]] bool isDirty() const
+    {
+        return dirty;
+    }
+
+private:
+    QString indexFilePath;
+    QHash<QString, DeckMetadata> entries;
+    bool dirty = false;
+};
+
+#endif // DECK_METADATA_INDEX_H
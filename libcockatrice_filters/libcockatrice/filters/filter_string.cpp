@@ -141,14 +141,20 @@ static void setupParserRules()
     };
 
     search["FormatQuery"] = [](const peg::SemanticValues &sv) -> Filter {
-        if (sv.choice() == 0) {
-            const auto format = std::any_cast<QString>(sv[0]);
-            return [=](const CardData &x) -> bool { return x->getLegalityProp(format) == "legal"; };
-        }
+        const auto format = std::any_cast<QString>(sv.choice() == 0 ? sv[0] : sv[1]);
+        const auto legality = sv.choice() == 0 ? CardLegalities::Legal
+                                               : CardLegalities::legalityFromString(std::any_cast<QString>(sv[0]));
 
-        const auto format = std::any_cast<QString>(sv[1]);
-        const auto legality = std::any_cast<QString>(sv[0]);
-        return [=](const CardData &x) -> bool { return x->getLegalityProp(format) == legality; };
+        // formats are only unknown before the database is loaded, look the id up again then
+        const int formatId = FormatIds::find(format);
+        return [=](const CardData &x) -> bool {
+            const int id = formatId >= 0 ? formatId : FormatIds::find(format);
+            if (id >= 0) {
+                return x->getLegalities().legality(id) == legality;
+            }
+            // formats past the id cap have no bits
+            return CardLegalities::legalityFromString(x->getLegalityProp(format)) == legality;
+        };
     };
     search["Legality"] = [](const peg::SemanticValues &sv) -> QString {
         switch (tolower(std::string(sv.sv())[0])) {
@@ -276,7 +276,13 @@ bool FilterItem::acceptCmc(const CardInfoPtr info) const
 
 bool FilterItem::acceptFormat(const CardInfoPtr info) const
 {
-    return info->getLegalityProp(term.toLower()) == "legal";
+    // formats are only unknown before the database is loaded, look the id up again then
+    const int id = formatId >= 0 ? formatId : FormatIds::find(term.toLower());
+    if (id >= 0) {
+        return info->getLegalities().legality(id) == CardLegalities::Legal;
+    }
+    // formats past the id cap have no bits
+    return CardLegalities::legalityFromString(info->getLegalityProp(term.toLower())) == CardLegalities::Legal;
 }
 
 bool FilterItem::acceptLoyalty(const CardInfoPtr info) const
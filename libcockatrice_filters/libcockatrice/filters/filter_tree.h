@@ -180,8 +180,10 @@ private:
 
 public:
     const QString term;
+    const int formatId; ///< id of the term as a format name, -1 if it is none
 
-    FilterItem(QString trm, FilterItemList *parent) : p(parent), term(std::move(trm))
+    FilterItem(QString trm, FilterItemList *parent)
+        : p(parent), term(std::move(trm)), formatId(FormatIds::find(term.toLower()))
     {
     }
     virtual ~FilterItem() = default;
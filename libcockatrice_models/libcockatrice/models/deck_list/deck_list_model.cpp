@@ -291,10 +291,11 @@ bool DeckListModel::setData(const QModelIndex &index, const QVariant &value, con
     switch (index.column()) {
         case DeckListModelColumns::CARD_AMOUNT:
             node->setNumber(value.toInt());
-            refreshCardFormatLegalities();
+            refreshCardFormatLegality(node);
             break;
         case DeckListModelColumns::CARD_NAME:
             node->setName(value.toString());
+            refreshCardFormatLegality(node);
             break;
         case DeckListModelColumns::CARD_SET:
             node->setCardSetShortName(value.toString());
@@ -460,7 +461,7 @@ QModelIndex DeckListModel::addCard(const ExactCard &card, const QString &zoneNam
         emit dataChanged(amountIndex, amountIndex, {Qt::EditRole});
     }
     sort(lastKnownColumn, lastKnownOrder);
-    refreshCardFormatLegalities();
+    refreshCardFormatLegality(zoneNode, cardNode);
     emitRecursiveUpdates(parentIndex);
 
     deckList->refreshDeckHash();
@@ -714,66 +715,195 @@ static int maxAllowedForLegality(const FormatRules &format, const QString &legal
     return -1; // unknown legality → treat as illegal
 }
 
-static bool isCardQuantityLegalForFormat(const QString &format, const CardInfo &cardInfo, int quantity)
+namespace
 {
-    if (format.isEmpty()) {
-        return true;
+/**
+ * The legality rules of one format, resolved once so that checking a card only tests the bits of its legalities and
+ * compares its amount against the allowed count.
+ */
+class FormatLegalityChecker
+{
+public:
+    explicit FormatLegalityChecker(const QString &_format)
+        : format(_format), formatId(FormatIds::find(_format)),
+          rules(_format.isEmpty() ? nullptr : CardDatabaseManager::query()->getFormat(_format))
+    {
+        if (rules) {
+            for (int legality = CardLegalities::Legal; legality <= CardLegalities::Banned; ++legality) {
+                maxAllowed[legality] = maxAllowedForLegality(
+                    *rules, CardLegalities::legalityToString(static_cast<CardLegalities::Legality>(legality)));
+            }
+        }
     }
 
-    auto formatRules = CardDatabaseManager::query()->getFormat(format);
+    [[nodiscard]] bool isCardNodeLegal(const InnerDecklistNode *zone, const DecklistCardNode *card) const
+    {
+        // Don't check legality for tokens
+        if (zone->getName() == DECK_ZONE_TOKENS) {
+            return true;
+        }
 
-    // if format has no custom rules, then just do the default check
-    if (!formatRules) {
-        return cardInfo.isLegalInFormat(format);
+        // unknown cards are not legal
+        ExactCard exactCard = CardDatabaseManager::query()->getCard(card->toCardRef());
+        if (!exactCard) {
+            return false;
+        }
+
+        // actual check
+        return isCardQuantityLegal(exactCard.getInfo(), card->getNumber());
     }
 
-    // Exceptions always win
-    if (cardHasAnyException(cardInfo, *formatRules)) {
-        return true;
+private:
+    QString format;
+    int formatId;
+    FormatRulesPtr rules;
+    int maxAllowed[CardLegalities::Banned + 1] = {-1, -1, -1, -1};
+
+    [[nodiscard]] bool isCardQuantityLegal(const CardInfo &cardInfo, int quantity) const
+    {
+        if (format.isEmpty()) {
+            return true;
+        }
+
+        // if format has no custom rules, then just do the default check
+        if (!rules) {
+            return formatId >= 0 ? cardInfo.getLegalities().isLegal(formatId) : cardInfo.isLegalInFormat(format);
+        }
+
+        // Exceptions always win
+        if (cardHasAnyException(cardInfo, *rules)) {
+            return true;
+        }
+
+        // check legality, values other than legal, restricted and banned are only found in the properties
+        const CardLegalities::Legality legality = cardInfo.getLegalities().legality(formatId);
+        int allowed;
+        if (legality != CardLegalities::NotListed) {
+            allowed = maxAllowed[legality];
+        } else {
+            const QString legalityProp = cardInfo.getLegalityProp(format);
+            if (legalityProp.isEmpty()) {
+                return false;
+            }
+            allowed = maxAllowedForLegality(*rules, legalityProp);
+        }
+
+        if (allowed == -1) {
+            return false;
+        }
+
+        if (allowed < 0) { // unlimited
+            return true;
+        }
+
+        return quantity <= allowed;
     }
+};
+} // namespace
 
-    // check legality prop
-    const QString legality = cardInfo.getLegalityProp(format);
-    if (legality.isEmpty()) {
-        return false;
+void DeckListModel::refreshCardFormatLegalities()
+{
+    const FormatLegalityChecker checker(deckList->getGameFormat());
+
+    deckList->forEachCard([&checker](const InnerDecklistNode *zone, DecklistCardNode *card) {
+        card->setFormatLegality(checker.isCardNodeLegal(zone, card));
+    });
+}
+
+/**
+ * Only the legality of the given card can change when its amount changes, so there is no need to check every card.
+ */
+void DeckListModel::refreshCardFormatLegality(const InnerDecklistNode *zoneNode, DecklistModelCardNode *cardNode)
+{
+    DecklistCardNode *card = cardNode->getDataNode();
+    card->setFormatLegality(FormatLegalityChecker(deckList->getGameFormat()).isCardNodeLegal(zoneNode, card));
+}
+
+void DeckListModel::refreshCardFormatLegality(DecklistModelCardNode *cardNode)
+{
+    if (cardNode->getParent() && cardNode->getParent()->getParent()) {
+        refreshCardFormatLegality(cardNode->getParent()->getParent(), cardNode);
     }
+}
 
-    int maxAllowed = maxAllowedForLegality(*formatRules, legality);
+QModelIndex DeckListModel::applyCardChange(const DeckListCardChange &change)
+{
+    if (change.amount == 0) {
+        return {};
+    }
 
-    if (maxAllowed == -1) {
-        return false;
+    CardInfoPtr cardInfo = CardDatabaseManager::query()->getCardInfo(change.cardName);
+    QString groupCriteria = extractGroupCriteriaValue(cardInfo, activeGroupCriteria);
+
+    auto *zoneNode = dynamic_cast<InnerDecklistNode *>(root->findChild(change.zoneName));
+    auto *groupNode = zoneNode ? dynamic_cast<InnerDecklistNode *>(zoneNode->findChild(groupCriteria)) : nullptr;
+    DecklistModelCardNode *cardNode = nullptr;
+    if (groupNode) {
+        cardNode = dynamic_cast<DecklistModelCardNode *>(groupNode->findCardChildByNameProviderIdAndNumber(
+            change.cardName, change.cardProviderId, change.cardCollectorNumber));
     }
 
-    if (maxAllowed < 0) { // unlimited
-        return true;
+    if (!cardNode && change.amount < 0) {
+        return {};
     }
 
-    return quantity <= maxAllowed;
-}
+    if (cardNode && cardNode->getNumber() + change.amount <= 0) {
+        const QModelIndex idx = nodeToIndex(cardNode);
+        removeRow(idx.row(), idx.parent());
+        emit cardNodeRemoved();
+        emit cardRemoved();
+        return {};
+    }
 
-static bool isCardNodeLegalForFormat(const QString &format, const InnerDecklistNode *zone, const DecklistCardNode *card)
-{
-    // Don't check legality for tokens
-    if (zone->getName() == DECK_ZONE_TOKENS) {
-        return true;
+    bool cardNodeAdded = false;
+    if (!cardNode) {
+        zoneNode = createNodeIfNeeded(change.zoneName, root);
+        groupNode = createNodeIfNeeded(groupCriteria, zoneNode);
+
+        int insertRow = findSortedInsertRow(groupNode, cardInfo);
+        auto *decklistCard = deckList->applyCardChange(change);
+
+        beginInsertRows(nodeToIndex(groupNode), insertRow, insertRow);
+        cardNode = new DecklistModelCardNode(decklistCard, groupNode, insertRow);
+        endInsertRows();
+
+        cardNodeAdded = true;
+    } else {
+        cardNode->setNumber(cardNode->getNumber() + change.amount);
+        deckList->refreshDeckHash();
     }
 
-    // unknown cards are not legal
-    ExactCard exactCard = CardDatabaseManager::query()->getCard(card->toCardRef());
-    if (!exactCard) {
-        return false;
+    refreshCardFormatLegality(zoneNode, cardNode);
+
+    const QModelIndex index = nodeToIndex(cardNode);
+    emit dataChanged(index, index.siblingAtColumn(columnCount() - 1));
+    emitRecursiveUpdates(index.parent());
+    emit deckHashChanged();
+
+    if (cardNodeAdded) {
+        emit cardNodeAddedAt(index);
+    }
+    if (change.amount > 0) {
+        emit cardAddedAt(index);
+    } else {
+        emit cardRemoved();
     }
 
-    // actual check
-    return isCardQuantityLegalForFormat(format, exactCard.getInfo(), card->getNumber());
+    return index;
 }
 
-void DeckListModel::refreshCardFormatLegalities()
+std::optional<DeckListCardChange> DeckListModel::getCardChange(const QModelIndex &idx, int amount) const
 {
-    QString format = deckList->getGameFormat();
+    auto *card = idx.isValid() ? getNode<DecklistModelCardNode *>(idx) : nullptr;
+    if (!card || !card->getParent() || !card->getParent()->getParent()) {
+        return std::nullopt;
+    }
 
-    deckList->forEachCard([&format](const InnerDecklistNode *zone, DecklistCardNode *card) {
-        bool legal = isCardNodeLegalForFormat(format, zone, card);
-        card->setFormatLegality(legal);
-    });
+    const InnerDecklistNode *zoneNode = card->getParent()->getParent();
+    return DeckListCardChange{zoneNode->getName(),
+                              card->getName(),
+                              card->getCardSetShortName(),
+                              card->getCardCollectorNumber(),
+                              card->getCardProviderId(),
+                              qMax(amount, -card->getNumber())};
 }
@@ -7,6 +7,7 @@
 #include <QList>
 #include <libcockatrice/card/printing/exact_card.h>
 #include <libcockatrice/deck_list/deck_list.h>
+#include <optional>
 
 class CardDatabase;
 class QPrinter;
@@ -354,6 +355,21 @@ public:
      */
     bool removeCardAtIndex(const QModelIndex &idx);
 
+    /**
+     * @brief Applies a card change from the edit history, inserting, updating or removing only the affected card node.
+     * @param change The change. The card node is matched by zone, name, provider id and collector number.
+     * @return The index of the changed card node, or an invalid index if the node was removed.
+     */
+    QModelIndex applyCardChange(const DeckListCardChange &change);
+
+    /**
+     * @brief Describes changing the amount of the card at the index, for the edit history.
+     * @param idx The index of a card node.
+     * @param amount The amount to change by. Clamped so that the amount of the card doesn't drop below zero.
+     * @return The change, or nothing if the index is invalid or not a card node.
+     */
+    [[nodiscard]] std::optional<DeckListCardChange> getCardChange(const QModelIndex &idx, int amount) const;
+
     /**
      * @brief Removes all cards and resets the model.
      */
@@ -437,6 +453,8 @@ private:
     }
 
     void refreshCardFormatLegalities();
+    void refreshCardFormatLegality(const InnerDecklistNode *zoneNode, DecklistModelCardNode *cardNode);
+    void refreshCardFormatLegality(DecklistModelCardNode *cardNode);
 };
 
 #endif
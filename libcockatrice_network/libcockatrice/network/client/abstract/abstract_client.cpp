@@ -1,5 +1,6 @@
 #include "abstract_client.h"
 
+#include <QRecursiveMutex>
 #include <google/protobuf/descriptor.h>
 #include <libcockatrice/protocol/featureset.h>
 #include <libcockatrice/protocol/get_pb_extension.h>
@@ -20,8 +21,32 @@
 #include <libcockatrice/protocol/pb/server_message.pb.h>
 #include <libcockatrice/protocol/pending_command.h>
 
+class AbstractClient::EventDispatcher : public QObject
+{
+public:
+    // held while a batch is dispatched, a receiver may destroy the client from within
+    QRecursiveMutex mutex;
+    AbstractClient *client;
+
+    explicit EventDispatcher(AbstractClient *_client) : client(_client)
+    {
+    }
+
+    void dispatch(const ServerMessageBatch &batch)
+    {
+        QMutexLocker locker(&mutex);
+        for (const auto &item : batch) {
+            if (!client) {
+                return;
+            }
+            client->dispatchEvent(*item);
+        }
+    }
+};
+
 AbstractClient::AbstractClient(QObject *parent)
-    : QObject(parent), nextCmdId(0), status(StatusDisconnected), serverSupportsPasswordHash(false)
+    : QObject(parent), nextCmdId(0), status(StatusDisconnected), eventDispatcher(new EventDispatcher(this)),
+      serverSupportsPasswordHash(false)
 {
     qRegisterMetaType<QVariant>("QVariant");
     qRegisterMetaType<CommandContainer>("CommandContainer");
@@ -56,25 +81,75 @@ AbstractClient::AbstractClient(QObject *parent)
 
 AbstractClient::~AbstractClient()
 {
+    stopEventDispatch();
+    // the dispatcher may belong to another thread, let its own event loop dispose of it and the batches posted to it
+    eventDispatcher->deleteLater();
 }
 
-void AbstractClient::processProtocolItem(const ServerMessage &item)
+void AbstractClient::stopEventDispatch()
 {
-    switch (item.message_type()) {
-        case ServerMessage::RESPONSE: {
-            const Response &response = item.response();
-            const int cmdId = response.cmd_id();
+    QMutexLocker locker(&eventDispatcher->mutex);
+    eventDispatcher->client = nullptr;
+}
 
-            PendingCommand *pend = pendingCommands.value(cmdId, 0);
-            if (!pend) {
-                return;
-            }
-            pendingCommands.remove(cmdId);
+void AbstractClient::processProtocolItem(const ServerMessage &item)
+{
+    flushEventBatch();
+    if (item.message_type() == ServerMessage::RESPONSE) {
+        processResponse(item.response());
+    } else {
+        if (item.message_type() == ServerMessage::SESSION_EVENT) {
+            processSessionEvent(item.session_event());
+        }
+        dispatchEvent(item);
+    }
+}
 
-            pend->processResponse(response);
-            pend->deleteLater();
-            break;
+void AbstractClient::queueProtocolItem(std::shared_ptr<const ServerMessage> item)
+{
+    if (item->message_type() == ServerMessage::RESPONSE) {
+        // keep responses ordered after the events that preceded them
+        flushEventBatch();
+        processResponse(item->response());
+    } else {
+        if (item->message_type() == ServerMessage::SESSION_EVENT) {
+            processSessionEvent(item->session_event());
         }
+        eventBatch.append(std::move(item));
+    }
+}
+
+void AbstractClient::flushEventBatch()
+{
+    if (eventBatch.isEmpty()) {
+        return;
+    }
+
+    ServerMessageBatch batch;
+    batch.swap(eventBatch);
+
+    // the functor only runs while the dispatcher exists, and the dispatcher knows whether the client still does
+    EventDispatcher *dispatcher = eventDispatcher;
+    QMetaObject::invokeMethod(dispatcher, [dispatcher, batch] { dispatcher->dispatch(batch); }, Qt::AutoConnection);
+}
+
+void AbstractClient::processResponse(const Response &response)
+{
+    const int cmdId = response.cmd_id();
+
+    PendingCommand *pend = pendingCommands.value(cmdId, 0);
+    if (!pend) {
+        return;
+    }
+    pendingCommands.remove(cmdId);
+
+    pend->processResponse(response);
+    pend->deleteLater();
+}
+
+void AbstractClient::dispatchEvent(const ServerMessage &item)
+{
+    switch (item.message_type()) {
         case ServerMessage::SESSION_EVENT: {
             const SessionEvent &event = item.session_event();
             switch ((SessionEvent::SessionEventType)getPbExtension(event)) {
@@ -130,6 +205,8 @@ void AbstractClient::processProtocolItem(const ServerMessage &item)
             emit roomEventReceived(item.room_event());
             break;
         }
+        default:
+            break;
     }
 }
 
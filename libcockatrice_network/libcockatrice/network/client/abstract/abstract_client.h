@@ -7,8 +7,11 @@
 #ifndef ABSTRACTCLIENT_H
 #define ABSTRACTCLIENT_H
 
+#include <QList>
 #include <QMutex>
+#include <QSet>
 #include <QVariant>
+#include <memory>
 #include <libcockatrice/protocol/pb/response.pb.h>
 #include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
 
@@ -17,6 +20,7 @@ class CommandContainer;
 class RoomEvent;
 class GameEventContainer;
 class ServerMessage;
+class SessionEvent;
 class Event_ServerIdentification;
 class Event_AddToList;
 class Event_RemoveFromList;
@@ -32,6 +36,12 @@ class Event_ServerShutdown;
 class Event_ReplayAdded;
 class FeatureSet;
 
+/**
+ * Events parsed from a single network read, shared between the client thread and the thread the events are
+ * dispatched on. The messages are never copied after parsing; only the reference counts are touched.
+ */
+using ServerMessageBatch = QList<std::shared_ptr<const ServerMessage>>;
+
 enum ClientStatus
 {
     StatusDisconnected,
@@ -85,6 +95,18 @@ private:
     int nextCmdId;
     mutable QMutex clientMutex;
     ClientStatus status;
+
+    class EventDispatcher;
+    /**
+     * Lives in the thread that created the client, so that the event signals are emitted there and reach their
+     * receivers through direct calls instead of one queued copy per message. It is owned by that thread and outlives
+     * the client, which detaches from it before it is destroyed.
+     */
+    EventDispatcher *eventDispatcher;
+    ServerMessageBatch eventBatch;
+
+    void processResponse(const Response &response);
+    void dispatchEvent(const ServerMessage &item);
 private slots:
     void queuePendingCommand(PendingCommand *pend);
 protected slots:
@@ -94,7 +116,28 @@ protected:
     QMap<int, PendingCommand *> pendingCommands;
     QString userName, password, email, country, realName, token;
     bool serverSupportsPasswordHash;
+    // sent with the login, guarded by clientMutex
+    QSet<QString> serverFeatures;
     void setStatus(ClientStatus _status);
+    /**
+     * Called in the client thread for every session event before it is queued for dispatching, so that the client's
+     * own state, such as the status checked after each message of a network read, is updated in order.
+     */
+    virtual void processSessionEvent(const SessionEvent & /*event*/)
+    {
+    }
+    /**
+     * Takes ownership of a parsed message. Responses are processed right away, events are collected until
+     * flushEventBatch() hands them to the dispatching thread in a single posted event.
+     */
+    void queueProtocolItem(std::shared_ptr<const ServerMessage> item);
+    void flushEventBatch();
+    /**
+     * Stops dispatching the batches that are still queued, waiting for one that is being dispatched. Clients living
+     * in another thread than the dispatcher call this first thing in their destructor, so event handlers must not
+     * wait for the client thread.
+     */
+    void stopEventDispatch();
     int getNewCmdId()
     {
         return nextCmdId++;
@@ -117,6 +160,15 @@ public:
     {
         return serverSupportsPasswordHash;
     }
+    /**
+     * @return whether the server the client is logged in to has the feature; servers older than the feature list in
+     * the login response have none
+     */
+    bool getServerSupportsFeature(const QString &feature) const
+    {
+        QMutexLocker locker(&clientMutex);
+        return serverFeatures.contains(feature);
+    }
     const QString &getUserName() const
     {
         return userName;
@@ -12,6 +12,8 @@
 #include <QWebSocket>
 #include <libcockatrice/interfaces/interface_network_settings_provider.h>
 #include <libcockatrice/protocol/debug_pb_message.h>
+#include <libcockatrice/protocol/get_pb_extension.h>
+#include <libcockatrice/protocol/pb/event_connection_closed.pb.h>
 #include <libcockatrice/protocol/pb/event_server_identification.pb.h>
 #include <libcockatrice/protocol/pb/response_activate.pb.h>
 #include <libcockatrice/protocol/pb/response_forgotpasswordrequest.pb.h>
@@ -55,9 +57,6 @@ RemoteClient::RemoteClient(QObject *parent, INetworkSettingsProvider *_networkSe
             &RemoteClient::slotWebSocketError);
 #endif
 
-    connect(this, &RemoteClient::serverIdentificationEventReceived, this,
-            &RemoteClient::processServerIdentificationEvent);
-    connect(this, &RemoteClient::connectionClosedEventReceived, this, &RemoteClient::processConnectionClosedEvent);
     connect(this, &RemoteClient::sigConnectToServer, this, &RemoteClient::doConnectToServer);
     connect(this, &RemoteClient::sigDisconnectFromServer, this, &RemoteClient::doDisconnectFromServer);
     connect(this, &RemoteClient::sigRegisterToServer, this, &RemoteClient::doRegisterToServer);
@@ -72,6 +71,8 @@ RemoteClient::RemoteClient(QObject *parent, INetworkSettingsProvider *_networkSe
 
 RemoteClient::~RemoteClient()
 {
+    // the events are dispatched in the thread that created the client, which may be in the middle of a batch
+    stopEventDispatch();
     doDisconnectFromServer();
     thread()->quit();
 }
@@ -106,6 +107,23 @@ void RemoteClient::slotConnected()
     }
 }
 
+void RemoteClient::processSessionEvent(const SessionEvent &event)
+{
+    // handled right away, so that readData() sees the status they set before it processes the next message
+    switch ((SessionEvent::SessionEventType)getPbExtension(event)) {
+        case SessionEvent::SERVER_IDENTIFICATION:
+            flushEventBatch();
+            processServerIdentificationEvent(event.GetExtension(Event_ServerIdentification::ext));
+            break;
+        case SessionEvent::CONNECTION_CLOSED:
+            flushEventBatch();
+            processConnectionClosedEvent(event.GetExtension(Event_ConnectionClosed::ext));
+            break;
+        default:
+            break;
+    }
+}
+
 void RemoteClient::processServerIdentificationEvent(const Event_ServerIdentification &event)
 {
     if (event.protocol_version() != protocolVersion) {
@@ -114,6 +132,10 @@ void RemoteClient::processServerIdentificationEvent(const Event_ServerIdentifica
         return;
     }
     serverSupportsPasswordHash = event.server_options() & Event_ServerIdentification::SupportsPasswordHash;
+    {
+        QMutexLocker locker(&clientMutex);
+        serverFeatures.clear();
+    }
 
     if (getStatus() == StatusRequestingForgotPassword) {
         Command_ForgotPasswordRequest cmdForgotPasswordRequest;
@@ -291,6 +313,13 @@ void RemoteClient::loginResponse(const Response &response)
     }
 
     if (response.response_code() == Response::RespOk) {
+        {
+            QMutexLocker locker(&clientMutex);
+            serverFeatures.clear();
+            for (int i = 0; i < resp.server_features_size(); ++i) {
+                serverFeatures.insert(QString::fromStdString(resp.server_features(i)));
+            }
+        }
         setStatus(StatusLoggedIn);
         emit userInfoChanged(resp.user_info());
 
@@ -389,41 +418,45 @@ void RemoteClient::readData()
                     messageInProgress = true;
                 }
             } else {
-                return;
+                break;
             }
         }
         if (inputBuffer.size() < messageLength) {
-            return;
+            break;
         }
 
-        ServerMessage newServerMessage;
-        bool ok = newServerMessage.ParseFromArray(inputBuffer.data(), messageLength);
+        auto newServerMessage = std::make_shared<ServerMessage>();
+        bool ok = newServerMessage->ParseFromArray(inputBuffer.data(), messageLength);
 
         inputBuffer.remove(0, messageLength);
         messageInProgress = false;
 
         if (ok) {
-            qCDebug(RemoteClientLog).noquote() << "IN" << getSafeDebugString(newServerMessage);
+            qCDebug(RemoteClientLog).noquote() << "IN" << getSafeDebugString(*newServerMessage);
 
-            processProtocolItem(newServerMessage);
+            queueProtocolItem(std::move(newServerMessage));
         } else {
             qCDebug(RemoteClientLog) << "parsing error!";
         }
 
         if (getStatus() == StatusDisconnecting) { // use thread-safe getter
+            flushEventBatch();
             doDisconnectFromServer();
         }
     } while (!inputBuffer.isEmpty());
+
+    flushEventBatch();
 }
 
 void RemoteClient::websocketMessageReceived(const QByteArray &message)
 {
     lastDataReceived = timeRunning;
-    ServerMessage newServerMessage;
-    if (newServerMessage.ParseFromArray(message.data(), message.length())) {
-        qCDebug(RemoteClientLog).noquote() << "IN" << getSafeDebugString(newServerMessage);
+    auto newServerMessage = std::make_shared<ServerMessage>();
+    if (newServerMessage->ParseFromArray(message.data(), message.length())) {
+        qCDebug(RemoteClientLog).noquote() << "IN" << getSafeDebugString(*newServerMessage);
 
-        processProtocolItem(newServerMessage);
+        queueProtocolItem(std::move(newServerMessage));
+        flushEventBatch();
     } else {
         qCDebug(RemoteClientLog) << "parsing error!";
     }
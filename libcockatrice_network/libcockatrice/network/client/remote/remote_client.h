@@ -61,8 +61,6 @@ private slots:
     void slotSocketError(QAbstractSocket::SocketError error);
     void slotWebSocketError(QAbstractSocket::SocketError error);
     void ping();
-    void processServerIdentificationEvent(const Event_ServerIdentification &event);
-    void processConnectionClosedEvent(const Event_ConnectionClosed &event);
     void passwordSaltResponse(const Response &response);
     void loginResponse(const Response &response);
     void registerResponse(const Response &response);
@@ -116,6 +114,11 @@ private:
     bool newMissingFeatureFound(const QString &_serversMissingFeatures);
     void clearNewClientFeatures();
     void connectToHost(const QString &hostname, unsigned int port);
+    void processServerIdentificationEvent(const Event_ServerIdentification &event);
+    void processConnectionClosedEvent(const Event_ConnectionClosed &event);
+
+protected:
+    void processSessionEvent(const SessionEvent &event) override;
 
 protected slots:
     void sendCommandContainer(const CommandContainer &cont) override;
@@ -0,0 +1,221 @@
+#include "http_fetch_service.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QSaveFile>
+#include <QTimer>
+#include <algorithm>
+
+static constexpr quint32 CACHE_FILE_MAGIC = 0x43484643; // "CHFC"
+static constexpr quint32 CACHE_FILE_VERSION = 1;
+
+HttpFetchService::HttpFetchService(const QString &_cacheDirectory, qint64 maxCacheSize, QObject *parent)
+    : QObject(parent), cacheDirectory(_cacheDirectory)
+{
+    networkManager = new QNetworkAccessManager(this);
+    networkManager->setTransferTimeout(); // Use Qt's default timeout
+    networkManager->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
+
+    if (!cacheDirectory.isEmpty()) {
+        QDir().mkpath(cacheDirectory);
+        pruneCache(maxCacheSize);
+    }
+}
+
+void HttpFetchService::setMaxConcurrentRequests(int max)
+{
+    maxConcurrentRequests = std::max(1, max);
+    startQueued();
+}
+
+void HttpFetchService::fetch(const QUrl &url, const QObject *context, Callback callback, qint64 maxAgeSecs)
+{
+    auto existing = pending.find(url);
+    if (existing != pending.end()) {
+        existing->waiters.append({context, std::move(callback)});
+        return;
+    }
+
+    CacheEntry cached = readCache(url);
+    if (cached.valid && QDateTime::currentSecsSinceEpoch() - cached.fetchedAt < maxAgeSecs) {
+        Response response;
+        response.url = url;
+        response.body = cached.body;
+        response.fromCache = true;
+        QTimer::singleShot(0, context, [callback = std::move(callback), response] { callback(response); });
+        return;
+    }
+
+    PendingFetch fetch;
+    fetch.waiters.append({context, std::move(callback)});
+    fetch.cached = cached;
+    pending.insert(url, fetch);
+    queue.append(url);
+    startQueued();
+}
+
+void HttpFetchService::startQueued()
+{
+    while (running < maxConcurrentRequests && !queue.isEmpty()) {
+        const QUrl url = queue.takeFirst();
+        auto fetch = pending.find(url);
+        if (fetch == pending.end()) {
+            continue;
+        }
+
+        // nobody to deliver to anymore, e.g. the tab that asked was closed while the fetch was queued
+        auto &waiters = fetch->waiters;
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                     [](const Waiter &waiter) { return waiter.context.isNull(); }),
+                      waiters.end());
+        if (waiters.isEmpty()) {
+            pending.erase(fetch);
+            continue;
+        }
+
+        QNetworkRequest request(url);
+        if (!userAgent.isEmpty()) {
+            request.setRawHeader("User-Agent", userAgent);
+        }
+        if (fetch->cached.valid) {
+            if (!fetch->cached.etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", fetch->cached.etag);
+            }
+            if (!fetch->cached.lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", fetch->cached.lastModified);
+            }
+        }
+
+        QNetworkReply *reply = networkManager->get(request);
+        ++running;
+        connect(reply, &QNetworkReply::finished, this, [this, url, reply] { handleReply(url, reply); });
+    }
+}
+
+void HttpFetchService::handleReply(const QUrl &url, QNetworkReply *reply)
+{
+    --running;
+    reply->deleteLater();
+
+    PendingFetch fetch = pending.take(url);
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    Response response;
+    response.url = url;
+    if (status == 304 && fetch.cached.valid) {
+        fetch.cached.fetchedAt = QDateTime::currentSecsSinceEpoch();
+        writeCache(url, fetch.cached);
+        response.body = fetch.cached.body;
+        response.fromCache = true;
+    } else if (reply->error() == QNetworkReply::NoError) {
+        CacheEntry entry;
+        entry.etag = reply->rawHeader("ETag");
+        entry.lastModified = reply->rawHeader("Last-Modified");
+        entry.fetchedAt = QDateTime::currentSecsSinceEpoch();
+        entry.body = reply->readAll();
+        entry.valid = true;
+        writeCache(url, entry);
+        response.body = entry.body;
+    } else if (fetch.cached.valid && (status == 0 || status >= 500)) {
+        // the server could not be reached or failed, an outdated response is better than none
+        response.body = fetch.cached.body;
+        response.fromCache = true;
+    } else {
+        response.error = reply->error();
+        response.errorString = reply->errorString();
+    }
+
+    deliver(fetch.waiters, response);
+    startQueued();
+}
+
+void HttpFetchService::deliver(const QList<Waiter> &waiters, const Response &response)
+{
+    for (const Waiter &waiter : waiters) {
+        // checked on every call, an earlier callback may have destroyed a later context
+        if (waiter.context) {
+            waiter.callback(response);
+        }
+    }
+}
+
+QString HttpFetchService::cacheFilePath(const QUrl &url) const
+{
+    const QByteArray hash = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+    return cacheDirectory + "/" + QString::fromLatin1(hash) + ".cache";
+}
+
+HttpFetchService::CacheEntry HttpFetchService::readCache(const QUrl &url) const
+{
+    CacheEntry entry;
+    if (cacheDirectory.isEmpty()) {
+        return entry;
+    }
+
+    QFile file(cacheFilePath(url));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entry;
+    }
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    QByteArray storedUrl;
+    in >> magic >> version;
+    if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION) {
+        return entry;
+    }
+    in >> storedUrl >> entry.etag >> entry.lastModified >> entry.fetchedAt >> entry.body;
+    entry.valid = in.status() == QDataStream::Ok && storedUrl == url.toEncoded();
+    return entry;
+}
+
+void HttpFetchService::writeCache(const QUrl &url, const CacheEntry &entry) const
+{
+    if (cacheDirectory.isEmpty()) {
+        return;
+    }
+
+    QSaveFile file(cacheFilePath(url));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << url.toEncoded() << entry.etag << entry.lastModified
+        << entry.fetchedAt << entry.body;
+    file.commit();
+}
+
+void HttpFetchService::pruneCache(qint64 maxCacheSize) const
+{
+    QFileInfoList files =
+        QDir(cacheDirectory).entryInfoList({"*.cache"}, QDir::Files, QDir::Time | QDir::Reversed); // oldest first
+
+    qint64 totalSize = 0;
+    for (const QFileInfo &file : files) {
+        totalSize += file.size();
+    }
+    for (const QFileInfo &file : files) {
+        if (totalSize <= maxCacheSize) {
+            break;
+        }
+        totalSize -= file.size();
+        QFile::remove(file.absoluteFilePath());
+    }
+}
+
+void HttpFetchService::clearCache()
+{
+    if (cacheDirectory.isEmpty()) {
+        return;
+    }
+
+    const QFileInfoList files = QDir(cacheDirectory).entryInfoList({"*.cache"}, QDir::Files);
+    for (const QFileInfo &file : files) {
+        QFile::remove(file.absoluteFilePath());
+    }
+}
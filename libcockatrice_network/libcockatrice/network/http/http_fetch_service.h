@@ -0,0 +1,127 @@
+/**
+ * @file http_fetch_service.h
+ * @ingroup Network
+ * @brief Shared HTTP GET client with request deduplication and a persistent response cache.
+ */
+
+#ifndef HTTP_FETCH_SERVICE_H
+#define HTTP_FETCH_SERVICE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QNetworkReply>
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+#include <functional>
+
+class QNetworkAccessManager;
+
+/**
+ * @class HttpFetchService
+ * @brief Fetches urls for many widgets through one network manager.
+ *
+ * - Fetches of a url that is already being fetched share one request, every caller gets its own callback.
+ * - At most maxConcurrentRequests requests run at once, further fetches wait in order.
+ * - Successful responses are kept on disk together with their ETag and Last-Modified headers. A response younger than
+ *   the maxAge of a fetch is served from disk without touching the network. An older one is revalidated with a
+ *   conditional request, and served again if the server answers 304 or cannot be reached.
+ *
+ * Callbacks are bound to a context object and dropped if it is destroyed first, so widgets can fetch without
+ * tracking their requests. Callbacks always run from the event loop, never from within fetch().
+ */
+class HttpFetchService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Response
+    {
+        QUrl url; ///< The url that was fetched, before any redirects
+        QByteArray body;
+        QNetworkReply::NetworkError error = QNetworkReply::NoError;
+        QString errorString;
+        bool fromCache = false; ///< Whether the body was read from disk, fresh or after revalidation
+
+        [[nodiscard]] bool isOk() const
+        {
+            return error == QNetworkReply::NoError;
+        }
+    };
+
+    using Callback = std::function<void(const Response &response)>;
+
+    static constexpr int defaultMaxConcurrentRequests = 6;
+    static constexpr qint64 defaultMaxCacheSize = 64 * 1024 * 1024;
+
+    /**
+     * @param cacheDirectory Directory the responses are kept in, created if it does not exist. Responses are not
+     * kept if it is empty.
+     * @param maxCacheSize The oldest responses are removed on startup until the cache fits.
+     */
+    explicit HttpFetchService(const QString &cacheDirectory,
+                              qint64 maxCacheSize = defaultMaxCacheSize,
+                              QObject *parent = nullptr);
+
+    void setMaxConcurrentRequests(int max);
+    void setUserAgent(const QByteArray &_userAgent)
+    {
+        userAgent = _userAgent;
+    }
+
+    /**
+     * @brief Fetches the url and calls the callback with the response, unless the context is destroyed first.
+     * @param maxAgeSecs How old a cached response may be to be used without asking the server. 0 always revalidates.
+     */
+    void fetch(const QUrl &url, const QObject *context, Callback callback, qint64 maxAgeSecs);
+
+    /** @brief Removes all responses from the disk cache. */
+    void clearCache();
+
+    [[nodiscard]] int runningCount() const
+    {
+        return running;
+    }
+
+private:
+    struct Waiter
+    {
+        QPointer<const QObject> context;
+        Callback callback;
+    };
+
+    struct CacheEntry
+    {
+        QByteArray etag;
+        QByteArray lastModified;
+        qint64 fetchedAt = 0; ///< Seconds since the epoch
+        QByteArray body;
+        bool valid = false;
+    };
+
+    struct PendingFetch
+    {
+        QList<Waiter> waiters;
+        CacheEntry cached;
+    };
+
+    QNetworkAccessManager *networkManager;
+    QString cacheDirectory;
+    QByteArray userAgent;
+    int maxConcurrentRequests = defaultMaxConcurrentRequests;
+    int running = 0;
+    QHash<QUrl, PendingFetch> pending; ///< Fetches that are queued or running, by url
+    QList<QUrl> queue;                 ///< Urls of the pending fetches that have not been started yet
+
+    [[nodiscard]] QString cacheFilePath(const QUrl &url) const;
+    [[nodiscard]] CacheEntry readCache(const QUrl &url) const;
+    void writeCache(const QUrl &url, const CacheEntry &entry) const;
+    void pruneCache(qint64 maxCacheSize) const;
+
+    void startQueued();
+    void handleReply(const QUrl &url, QNetworkReply *reply);
+    static void deliver(const QList<Waiter> &waiters, const Response &response);
+};
+
+#endif // HTTP_FETCH_SERVICE_H
@@ -539,6 +539,15 @@ void Server_AbstractParticipant::sendGameEvent(const GameEventContainer &cont)
     }
 }
 
+void Server_AbstractParticipant::sendSessionEvent(const SessionEvent &event)
+{
+    QMutexLocker locker(&playerMutex);
+
+    if (userInterface) {
+        userInterface->sendProtocolItem(event);
+    }
+}
+
 void Server_AbstractParticipant::setUserInterface(Server_AbstractUserInterface *_userInterface)
 {
     playerMutex.lock();
@@ -5,6 +5,7 @@
 #include "server_arrowtarget.h"
 
 #include <QMutex>
+#include <QObject>
 #include <libcockatrice/protocol/pb/card_attributes.pb.h>
 #include <libcockatrice/protocol/pb/response.pb.h>
 
@@ -14,6 +15,7 @@ class ServerInfo_User;
 class ServerInfo_Player;
 class ServerInfo_PlayerProperties;
 class GameEventContainer;
+class SessionEvent;
 class GameEventStorage;
 class ResponseContainer;
 class GameCommand;
@@ -53,7 +55,7 @@ class Command_DeckSelect;
 class Command_SetSideboardLock;
 class Command_ChangeZoneProperties;
 
-class Server_AbstractParticipant : public Server_ArrowTarget, public ServerInfo_User_Container
+class Server_AbstractParticipant : public QObject, public Server_ArrowTarget, public ServerInfo_User_Container
 {
     Q_OBJECT
 protected:
@@ -175,6 +177,7 @@ public:
 
     Response::ResponseCode processGameCommand(const GameCommand &command, ResponseContainer &rc, GameEventStorage &ges);
     void sendGameEvent(const GameEventContainer &event);
+    void sendSessionEvent(const SessionEvent &event);
 
     virtual void
     getInfo(ServerInfo_Player *info, Server_AbstractParticipant *recipient, bool omniscient, bool withUserInfo);
@@ -404,10 +404,10 @@ void Server_AbstractPlayer::processMoveCard(GameEventStorage &ges,
         if (Server_Card *stashedCard = card->takeStashedCard()) {
             stashedCard->setId(newCardId());
             ges.enqueueGameEvent(makeCreateTokenEvent(startzone, stashedCard, card->getX(), card->getY()), playerId);
-            card->deleteLater();
+            delete card;
             card = stashedCard;
         } else {
-            card->deleteLater();
+            delete card;
             card = nullptr;
         }
     }
@@ -912,7 +912,7 @@ Server_AbstractPlayer::cmdAttachCard(const Command_AttachCard &cmd, ResponseCont
         QList<Server_Arrow *> _arrows = player->getArrows().values();
         QList<Server_Arrow *> toDelete;
         for (auto a : _arrows) {
-            auto *tCard = qobject_cast<Server_Card *>(a->getTargetItem());
+            auto *tCard = a->getTargetItem()->asCard();
             if ((tCard == card) || (a->getStartCard() == card)) {
                 toDelete.append(a);
             }
@@ -1018,8 +1018,7 @@ Server_AbstractPlayer::cmdCreateToken(const Command_CreateToken &cmd, ResponseCo
         yCoord = 0;
     }
 
-    auto *card = new Server_Card({cardName, cardProviderId}, newCardId(), xCoord, yCoord);
-    card->moveToThread(thread());
+    auto *card = new Server_Card(game->internCardRef({cardName, cardProviderId}), newCardId(), xCoord, yCoord);
     // Client should already prevent face-down tokens from having attributes; this just an extra server-side check
     if (!cmd.face_down()) {
         card->setColor(nameFromStdString(cmd.color()));
@@ -1077,15 +1076,12 @@ Server_AbstractPlayer::cmdCreateToken(const Command_CreateToken &cmd, ResponseCo
             }
 
             // Copy counters
-            QMapIterator<int, int> i(targetCard->getCounters());
-            while (i.hasNext()) {
-                i.next();
-
+            for (const auto &[counterId, value] : targetCard->getCounters()) {
                 Event_SetCardCounter _event;
                 _event.set_zone_name(card->getZone()->getName().toStdString());
                 _event.set_card_id(card->getId());
 
-                if (card->setCounter(i.key(), i.value(), &_event)) {
+                if (card->setCounter(counterId, value, &_event)) {
                     ges.enqueueGameEvent(_event, playerId);
                 }
             }
@@ -1140,11 +1136,11 @@ Server_AbstractPlayer::cmdCreateToken(const Command_CreateToken &cmd, ResponseCo
                         arrowInfo->set_start_player_id(player->getPlayerId());
                         arrowInfo->set_start_zone(startCard->getZone()->getName().toStdString());
                         arrowInfo->set_start_card_id(startCard->getId());
-                        const auto *arrowTargetPlayer = qobject_cast<const Server_AbstractPlayer *>(targetItem);
-                        if (arrowTargetPlayer != nullptr) {
+                        const auto *arrowTargetCard = targetItem->asCard();
+                        if (arrowTargetCard == nullptr) {
+                            const auto *arrowTargetPlayer = static_cast<const Server_AbstractPlayer *>(targetItem);
                             arrowInfo->set_target_player_id(arrowTargetPlayer->getPlayerId());
                         } else {
-                            const auto *arrowTargetCard = qobject_cast<const Server_Card *>(targetItem);
                             arrowInfo->set_target_player_id(arrowTargetCard->getZone()->getPlayer()->getPlayerId());
                             arrowInfo->set_target_zone(arrowTargetCard->getZone()->getName().toStdString());
                             arrowInfo->set_target_card_id(arrowTargetCard->getId());
@@ -1434,12 +1430,10 @@ Server_AbstractPlayer::cmdDumpZone(const Command_DumpZone &cmd, ResponseContaine
             cardInfo->set_destroy_on_zone_change(card->getDestroyOnZoneChange());
             cardInfo->set_doesnt_untap(card->getDoesntUntap());
 
-            QMapIterator<int, int> cardCounterIterator(card->getCounters());
-            while (cardCounterIterator.hasNext()) {
-                cardCounterIterator.next();
+            for (const auto &[counterId, value] : card->getCounters()) {
                 ServerInfo_CardCounter *counterInfo = cardInfo->add_counter_list();
-                counterInfo->set_id(cardCounterIterator.key());
-                counterInfo->set_value(cardCounterIterator.value());
+                counterInfo->set_id(counterId);
+                counterInfo->set_value(value);
             }
 
             if (card->getParentCard()) {
@@ -1546,12 +1540,10 @@ Server_AbstractPlayer::cmdRevealCards(const Command_RevealCards &cmd, ResponseCo
         cardInfo->set_destroy_on_zone_change(card->getDestroyOnZoneChange());
         cardInfo->set_doesnt_untap(card->getDoesntUntap());
 
-        QMapIterator<int, int> cardCounterIterator(card->getCounters());
-        while (cardCounterIterator.hasNext()) {
-            cardCounterIterator.next();
+        for (const auto &[counterId, value] : card->getCounters()) {
             ServerInfo_CardCounter *counterInfo = cardInfo->add_counter_list();
-            counterInfo->set_id(cardCounterIterator.key());
-            counterInfo->set_value(cardCounterIterator.value());
+            counterInfo->set_id(counterId);
+            counterInfo->set_value(value);
         }
 
         if (card->getParentCard()) {
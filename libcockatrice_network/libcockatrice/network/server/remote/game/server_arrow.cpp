@@ -25,7 +25,7 @@ void Server_Arrow::getInfo(ServerInfo_Arrow *info)
     info->set_start_card_id(startCard->getId());
     info->mutable_arrow_color()->CopyFrom(arrowColor);
 
-    auto *targetCard = qobject_cast<Server_Card *>(targetItem);
+    auto *targetCard = targetItem->asCard();
     if (targetCard) {
         info->set_target_player_id(targetCard->getZone()->getPlayer()->getPlayerId());
         info->set_target_zone(targetCard->getZone()->getName().toStdString());
@@ -1,11 +1,27 @@
 #ifndef SERVER_ARROWTARGET_H
 #define SERVER_ARROWTARGET_H
 
-#include <QObject>
+class Server_Card;
 
-class Server_ArrowTarget : public QObject
+/**
+ * Something an arrow can point at, either a card or a player.
+ */
+class Server_ArrowTarget
 {
-    Q_OBJECT
+public:
+    virtual ~Server_ArrowTarget() = default;
+
+    /**
+     * Returns the target as a card, or nullptr if the target is a player.
+     */
+    virtual Server_Card *asCard()
+    {
+        return nullptr;
+    }
+    virtual const Server_Card *asCard() const
+    {
+        return nullptr;
+    }
 };
 
 #endif
@@ -31,8 +31,7 @@
 #include <limits>
 
 Server_Card::Server_Card(const CardRef &cardRef, int _id, int _coord_x, int _coord_y, Server_CardZone *_zone)
-    : zone(_zone), id(_id), coord_x(_coord_x), coord_y(_coord_y), cardRef(cardRef), tapped(false), attacking(false),
-      facedown(false), destroyOnZoneChange(false), doesntUntap(false), parentCard(0), stashedCard(nullptr)
+    : zone(_zone), cardRef(cardRef), id(_id), coord_x(_coord_x), coord_y(_coord_y)
 {
 }
 
@@ -47,21 +46,23 @@ Server_Card::~Server_Card()
         parentCard->removeAttachedCard(this);
     }
 
-    if (stashedCard) {
-        stashedCard->deleteLater();
-        stashedCard = nullptr;
-    }
+    delete stashedCard;
 }
 
 void Server_Card::resetState(bool keepAnnotations)
 {
-    counters.clear();
+    if (extra) {
+        extra->counters.clear();
+        extra->ptString.clear();
+        if (!keepAnnotations) {
+            extra->annotation.clear();
+        }
+        if (extra->color.isEmpty() && extra->annotation.isEmpty()) {
+            extra.reset();
+        }
+    }
     setTapped(false);
     setAttacking(false);
-    setPT(QString());
-    if (!keepAnnotations) {
-        setAnnotation(QString());
-    }
     setDoesntUntap(false);
 }
 
@@ -118,15 +119,15 @@ bool Server_Card::setCounter(int _id, int value, Event_SetCardCounter *event)
     // Clamp to valid card counter range [0, MAX_COUNTER_VALUE]
     value = qBound(0, value, MAX_COUNTER_VALUE);
 
-    const int oldValue = counters.value(_id, 0);
+    const int oldValue = getCounter(_id);
     if (value == oldValue) {
         return false;
     }
 
     if (value) {
-        counters.insert(_id, value);
+        extraState().counters.insert(_id, value);
     } else {
-        counters.remove(_id);
+        extra->counters.remove(_id);
     }
 
     if (event) {
@@ -139,7 +140,7 @@ bool Server_Card::setCounter(int _id, int value, Event_SetCardCounter *event)
 
 bool Server_Card::incrementCounter(int counterId, int delta, Event_SetCardCounter *event)
 {
-    const int oldValue = counters.value(counterId, 0);
+    const int oldValue = getCounter(counterId);
     // Clamp to [0, MAX_COUNTER_VALUE] for card counters
     const int newValue = addClamped(oldValue, delta, 0, MAX_COUNTER_VALUE);
 
@@ -148,9 +149,9 @@ bool Server_Card::incrementCounter(int counterId, int delta, Event_SetCardCounte
     }
 
     if (newValue) {
-        counters.insert(counterId, newValue);
+        extraState().counters.insert(counterId, newValue);
     } else {
-        counters.remove(counterId);
+        extra->counters.remove(counterId);
     }
 
     if (event) {
@@ -188,14 +189,14 @@ void Server_Card::getInfo(ServerInfo_Card *info)
     if (attacking) {
         info->set_attacking(true);
     }
-    if (!color.isEmpty()) {
-        info->set_color(color.toStdString());
+    if (extra && !extra->color.isEmpty()) {
+        info->set_color(extra->color.toStdString());
     }
-    if (!ptString.isEmpty()) {
-        info->set_pt(ptString.toStdString());
+    if (extra && !extra->ptString.isEmpty()) {
+        info->set_pt(extra->ptString.toStdString());
     }
-    if (!annotation.isEmpty()) {
-        info->set_annotation(annotation.toStdString());
+    if (extra && !extra->annotation.isEmpty()) {
+        info->set_annotation(extra->annotation.toStdString());
     }
     if (destroyOnZoneChange) {
         info->set_destroy_on_zone_change(true);
@@ -204,12 +205,10 @@ void Server_Card::getInfo(ServerInfo_Card *info)
         info->set_doesnt_untap(true);
     }
 
-    QMapIterator<int, int> cardCounterIterator(counters);
-    while (cardCounterIterator.hasNext()) {
-        cardCounterIterator.next();
+    for (const auto &[counterId, value] : getCounters()) {
         ServerInfo_CardCounter *counterInfo = info->add_counter_list();
-        counterInfo->set_id(cardCounterIterator.key());
-        counterInfo->set_value(cardCounterIterator.value());
+        counterInfo->set_id(counterId);
+        counterInfo->set_value(value);
     }
 
     if (parentCard) {
@@ -21,42 +21,70 @@
 #define SERVER_CARD_H
 
 #include "server_arrowtarget.h"
+#include "server_card_counters.h"
 
-#include <QMap>
+#include <QList>
 #include <QString>
 #include <libcockatrice/protocol/pb/card_attributes.pb.h>
 #include <libcockatrice/protocol/pb/serverinfo_card.pb.h>
 #include <libcockatrice/utility/card_ref.h>
+#include <memory>
 
 class Server_CardZone;
 class Event_SetCardCounter;
 class Event_SetCardAttr;
 
+/**
+ * A card in a game. Games hold every card of every deck at once, so this is a plain object rather than a QObject,
+ * and the state most cards never get (color, P/T, annotation, counters) is only allocated once it is set.
+ */
 class Server_Card : public Server_ArrowTarget
 {
-    Q_OBJECT
 private:
+    struct ExtraState
+    {
+        QString color;
+        QString ptString;
+        QString annotation;
+        Server_CardCounters counters;
+    };
+
     Server_CardZone *zone;
+    Server_Card *parentCard = nullptr;
+    Server_Card *stashedCard = nullptr;
+    std::unique_ptr<ExtraState> extra;
+    CardRef cardRef;
+    QList<Server_Card *> attachedCards;
     int id;
     int coord_x, coord_y;
-    CardRef cardRef;
-    QMap<int, int> counters;
-    bool tapped;
-    bool attacking;
-    bool facedown;
-    QString color;
-    QString ptString;
-    QString annotation;
-    bool destroyOnZoneChange;
-    bool doesntUntap;
+    bool tapped = false;
+    bool attacking = false;
+    bool facedown = false;
+    bool destroyOnZoneChange = false;
+    bool doesntUntap = false;
 
-    Server_Card *parentCard;
-    QList<Server_Card *> attachedCards;
-    Server_Card *stashedCard;
+    ExtraState &extraState()
+    {
+        if (!extra) {
+            extra = std::make_unique<ExtraState>();
+        }
+        return *extra;
+    }
 
 public:
     Server_Card(const CardRef &cardRef, int _id, int _coord_x, int _coord_y, Server_CardZone *_zone = nullptr);
     ~Server_Card() override;
+    Server_Card(const Server_Card &) = delete;
+    Server_Card &operator=(const Server_Card &) = delete;
+
+    Server_Card *asCard() override
+    {
+        return this;
+    }
+    const Server_Card *asCard() const override
+    {
+        return this;
+    }
 
     Server_CardZone *getZone() const
     {
@@ -91,13 +119,14 @@ public:
     {
         return cardRef.name;
     }
-    const QMap<int, int> &getCounters() const
+    const Server_CardCounters &getCounters() const
     {
-        return counters;
+        static const Server_CardCounters noCounters;
+        return extra ? extra->counters : noCounters;
     }
     int getCounter(int counter_id) const
     {
-        return counters.value(counter_id, 0);
+        return getCounters().value(counter_id, 0);
     }
     bool getTapped() const
     {
@@ -113,15 +142,15 @@ public:
     }
     QString getColor() const
     {
-        return color;
+        return extra ? extra->color : QString();
     }
     QString getPT() const
     {
-        return ptString;
+        return extra ? extra->ptString : QString();
     }
     QString getAnnotation() const
     {
-        return annotation;
+        return extra ? extra->annotation : QString();
     }
     bool getDoesntUntap() const
     {
@@ -185,15 +214,21 @@ public:
     }
     void setColor(const QString &_color)
     {
-        color = _color;
+        if (extra || !_color.isEmpty()) {
+            extraState().color = _color;
+        }
     }
     void setPT(const QString &_pt)
     {
-        ptString = _pt;
+        if (extra || !_pt.isEmpty()) {
+            extraState().ptString = _pt;
+        }
     }
     void setAnnotation(const QString &_annotation)
     {
-        annotation = _annotation;
+        if (extra || !_annotation.isEmpty()) {
+            extraState().annotation = _annotation;
+        }
     }
     void setDestroyOnZoneChange(bool _destroy)
     {
@@ -222,7 +257,7 @@ public:
         // be stashed.
         if (card->stashedCard || card->getDestroyOnZoneChange()) {
             stashedCard = card->takeStashedCard();
-            card->deleteLater();
+            delete card;
         } else {
             stashedCard = card;
         }
@@ -0,0 +1,77 @@
+#ifndef SERVER_CARD_COUNTERS_H
+#define SERVER_CARD_COUNTERS_H
+
+#include <QVarLengthArray>
+#include <algorithm>
+#include <utility>
+
+/**
+ * The counters on a card, as (counter id, value) pairs sorted by id.
+ *
+ * A card rarely carries more than a couple of counters, so they are kept in a small inline array instead of a map
+ * with one heap node per counter. Counters with a value of 0 are not stored.
+ */
+class Server_CardCounters
+{
+public:
+    using Counter = std::pair<int, int>;
+
+    int value(int id, int defaultValue = 0) const
+    {
+        const Counter *it = find(id);
+        return it != end() && it->first == id ? it->second : defaultValue;
+    }
+    bool contains(int id) const
+    {
+        const Counter *it = find(id);
+        return it != end() && it->first == id;
+    }
+    void insert(int id, int value)
+    {
+        const Counter *it = find(id);
+        if (it != end() && it->first == id) {
+            counters[it - begin()].second = value;
+        } else {
+            counters.insert(it - begin(), Counter(id, value));
+        }
+    }
+    void remove(int id)
+    {
+        const Counter *it = find(id);
+        if (it != end() && it->first == id) {
+            counters.remove(it - begin());
+        }
+    }
+    void clear()
+    {
+        counters.clear();
+    }
+
+    qsizetype size() const
+    {
+        return counters.size();
+    }
+    bool isEmpty() const
+    {
+        return counters.isEmpty();
+    }
+    const Counter *begin() const
+    {
+        return counters.constData();
+    }
+    const Counter *end() const
+    {
+        return counters.constData() + counters.size();
+    }
+
+private:
+    QVarLengthArray<Counter, 2> counters;
+
+    const Counter *find(int id) const
+    {
+        return std::lower_bound(begin(), end(), id,
+                                [](const Counter &counter, int _id) { return counter.first < _id; });
+    }
+};
+
+#endif
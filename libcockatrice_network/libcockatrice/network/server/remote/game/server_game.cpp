@@ -30,10 +30,10 @@
 #include "server_cardzone.h"
 #include "server_player.h"
 #include "server_spectator.h"
+#include "server_spectator_channel.h"
 
 #include <QDebug>
 #include <QRegularExpression>
-#include <QTimer>
 #include <google/protobuf/descriptor.h>
 #include <libcockatrice/deck_list/deck_list.h>
 #include <libcockatrice/protocol/pb/context_connection_state_changed.pb.h>
@@ -52,6 +52,16 @@
 #include <libcockatrice/protocol/pb/event_set_active_player.pb.h>
 #include <libcockatrice/protocol/pb/game_replay.pb.h>
 #include <libcockatrice/utility/zone_names.h>
+#include <optional>
+
+/**
+ * Spectators that are not judges all see the game the same way, they are sent game events through the spectator
+ * channel instead of one by one.
+ */
+static bool isBroadcastSpectator(const Server_AbstractParticipant *participant)
+{
+    return participant->isSpectator() && !participant->isJudge();
+}
 
 Server_Game::Server_Game(const ServerInfo_User &_creatorInfo,
                          int _gameId,
@@ -75,8 +85,8 @@ Server_Game::Server_Game(const ServerInfo_User &_creatorInfo,
       spectatorsNeedPassword(_spectatorsNeedPassword), spectatorsCanTalk(_spectatorsCanTalk),
       spectatorsSeeEverything(_spectatorsSeeEverything), startingLifeTotal(_startingLifeTotal),
       shareDecklistsOnLoad(_shareDecklistsOnLoad), inactivityCounter(0), startTimeOfThisGame(0), secondsElapsed(0),
-      firstGameStarted(false), turnOrderReversed(false), startTime(QDateTime::currentDateTime()), pingClock(nullptr),
-      gameMutex()
+      firstGameStarted(false), turnOrderReversed(false), startTime(QDateTime::currentDateTime()),
+      pingTimer([this] { pingClockTimeout(); }), gameMutex()
 {
     currentReplay = new GameReplay;
     currentReplay->set_replay_id(room->getServer()->getDatabaseInterface()->getNextReplayId());
@@ -86,20 +96,31 @@ Server_Game::Server_Game(const ServerInfo_User &_creatorInfo,
 
     getInfo(*currentReplay->mutable_game_info());
 
-    if (room->getServer()->getGameShouldPing()) {
-        pingClock = new QTimer(this);
-        connect(pingClock, &QTimer::timeout, this, &Server_Game::pingClockTimeout);
-        pingClock->start(1000);
+    Server *server = room->getServer();
+    spectatorChannel = new Server_SpectatorChannel(server->getSpectatorBroadcaster(),
+                                                   server->getSpectatorDelay() * 1000,
+                                                   server->getSpectatorCoalescingInterval());
+
+    if (server->getGameShouldPing()) {
+        Server_TimerWheel::forCurrentThread()->scheduleIn(pingTimer, 1);
     }
 }
 
 Server_Game::~Server_Game()
 {
+    // before taking any lock, a running ping may be waiting for the game mutex
+    pingTimer.cancel();
+
     room->gamesLock.lockForWrite();
     gameMutex.lock();
 
-    gameClosed = true;
-    sendGameEventContainer(prepareGameEvent(Event_GameClosed(), -1));
+    if (!gameClosed) {
+        gameClosed = true;
+        sendGameEventContainer(prepareGameEvent(Event_GameClosed(), -1));
+    }
+    // Usually done by the broadcaster already, see closeGame(). Games deleted directly, such as at shutdown, send
+    // everything up to their closing to the spectators here, before the spectators are removed.
+    spectatorChannel->close();
     for (auto *participant : participants.values()) {
         participant->prepareDestroy();
     }
@@ -119,16 +140,13 @@ Server_Game::~Server_Game()
         delete replay;
     }
     replayList.clear();
+    delete spectatorChannel;
+    spectatorChannel = nullptr;
 
     room = nullptr;
     currentReplay = nullptr;
     creatorInfo = nullptr;
 
-    if (pingClock) {
-        delete pingClock;
-        pingClock = nullptr;
-    }
-
     qDebug() << "Server_Game destructor: gameId=" << gameId;
     deleteLater();
 }
@@ -180,13 +198,26 @@ void Server_Game::storeGameInformation()
     }
 }
 
+void Server_Game::closeGame()
+{
+    QMutexLocker locker(&gameMutex);
+    if (gameClosed) {
+        return;
+    }
+
+    gameClosed = true;
+    sendGameEventContainer(prepareGameEvent(Event_GameClosed(), -1));
+    spectatorChannel->close([this] { deleteLater(); });
+}
+
 void Server_Game::pingClockTimeout()
 {
     QMutexLocker locker(&gameMutex);
     ++secondsElapsed;
+    Server_TimerWheel::forCurrentThread()->scheduleIn(pingTimer, 1);
 
-    GameEventStorage ges;
-    ges.setGameEventContext(Context_PingChanged());
+    // most seconds no ping changes, and then nothing is built or sent
+    std::optional<GameEventStorage> ges;
 
     bool allPlayersInactive = true;
     int playerCount = 0;
@@ -200,9 +231,13 @@ void Server_Game::pingClockTimeout()
         }
 
         if (participant->updatePingTime()) {
+            if (!ges) {
+                ges.emplace();
+                ges->setGameEventContext(Context_PingChanged());
+            }
             Event_PlayerPropertiesChanged event;
             event.mutable_player_properties()->set_ping_seconds(participant->getPingTime());
-            ges.enqueueGameEvent(event, participant->getPlayerId());
+            ges->enqueueGameEvent(event, participant->getPlayerId());
         }
 
         if ((participant->getPingTime() != -1) &&
@@ -210,12 +245,14 @@ void Server_Game::pingClockTimeout()
             allPlayersInactive = false;
         }
     }
-    ges.sendToGame(this);
+    if (ges) {
+        ges->sendToGame(this);
+    }
 
     const int maxTime = room->getServer()->getMaxGameInactivityTime();
     if (allPlayersInactive) {
         if (((maxTime > 0) && (++inactivityCounter >= maxTime)) || (playerCount < maxPlayers)) {
-            deleteLater();
+            closeGame();
         }
     } else {
         inactivityCounter = 0;
@@ -300,8 +337,21 @@ void Server_Game::sendGameStateToPlayers()
     Event_GameStateChanged spectatorNormalEvent;
     createGameStateChangedEvent(&spectatorNormalEvent, nullptr, false, false);
 
-    // send game state info to clients according to their role in the game
+    // all spectators that are not judges get the same state through the spectator channel
+    if (spectatorChannel->hasSubscribers()) {
+        std::shared_ptr<GameEventContainer> spectatorCont(
+            prepareGameEvent(spectatorsSeeEverything ? omniscientEvent : spectatorNormalEvent, -1));
+        spectatorChannel->publish(spectatorCont,
+                                  GameEventStorageItem::SendToPrivate | GameEventStorageItem::SendToOthers, -1,
+                                  spectatorsSeeEverything);
+    }
+
+    // send game state info to the other clients according to their role in the game
     for (auto *participant : participants.values()) {
+        if (isBroadcastSpectator(participant)) {
+            continue;
+        }
+
         GameEventContainer *gec;
         if (participant->isSpectator()) {
             if (spectatorsSeeEverything || participant->isJudge()) {
@@ -434,6 +484,11 @@ Response::ResponseCode Server_Game::checkJoin(ServerInfo_User *user,
                                               bool overrideRestrictions,
                                               bool asJudge)
 {
+    // a closed game only waits for the spectator channel before it is deleted, as good as gone
+    if (gameClosed) {
+        return Response::RespNameNotFound;
+    }
+
     Server_DatabaseInterface *databaseInterface = room->getServer()->getDatabaseInterface();
     for (auto *participant : participants.values()) {
         if (participant->getUserInfo()->name() == user->name()) {
@@ -547,6 +602,7 @@ void Server_Game::removeParticipant(Server_AbstractParticipant *participant, Eve
     room->getServer()->removePersistentPlayer(QString::fromStdString(participant->getUserInfo()->name()), room->getId(),
                                               gameId, participant->getPlayerId());
     participants.remove(participant->getPlayerId());
+    spectatorChannel->unsubscribe(participant);
 
     bool spectator = participant->isSpectator();
     GameEventStorage ges;
@@ -575,8 +631,7 @@ void Server_Game::removeParticipant(Server_AbstractParticipant *participant, Eve
             hostId = newHostId;
             sendGameEventContainer(prepareGameEvent(Event_GameHostChanged(), hostId));
         } else {
-            gameClosed = true;
-            deleteLater();
+            closeGame();
             return;
         }
     }
@@ -605,7 +660,7 @@ void Server_Game::removeArrowsRelatedToPlayer(GameEventStorage &ges, Server_Abst
     for (Server_AbstractPlayer *anyPlayer : getPlayers().values()) {
         QList<Server_Arrow *> toDelete;
         for (auto *arrow : anyPlayer->getArrows().values()) {
-            auto *targetCard = qobject_cast<Server_Card *>(arrow->getTargetItem());
+            auto *targetCard = arrow->getTargetItem()->asCard();
             if (targetCard) {
                 if (targetCard->getZone() != nullptr && targetCard->getZone()->getPlayer() == player) {
                     toDelete.append(arrow);
@@ -702,6 +757,11 @@ qint64 Server_Game::generateArrowId()
     return nextArrowId++;
 }
 
+CardRef Server_Game::internCardRef(const CardRef &cardRef)
+{
+    return {*cardStrings.insert(cardRef.name), *cardStrings.insert(cardRef.providerId)};
+}
+
 void Server_Game::removeArrows(int newPhase, bool force)
 {
     QMutexLocker locker(&gameMutex);
@@ -770,7 +830,7 @@ void Server_Game::createGameJoinedEvent(Server_AbstractParticipant *joiningParti
             newGameType->set_description(allGameTypes[i].toStdString());
         }
     }
-    rc.enqueuePostResponseItem(ServerMessage::SESSION_EVENT, Server_AbstractUserInterface::prepareSessionEvent(event1));
+    SessionEvent *joinedEvent = Server_AbstractUserInterface::prepareSessionEvent(event1);
 
     Event_GameStateChanged event2;
     event2.set_seconds_elapsed(secondsElapsed);
@@ -782,8 +842,16 @@ void Server_Game::createGameJoinedEvent(Server_AbstractParticipant *joiningParti
     for (auto *participant : participants.values()) {
         participant->getInfo(event2.add_player_list(), joiningParticipant, omniscient, true);
     }
+    GameEventContainer *joinedState = prepareGameEvent(event2, -1);
 
-    rc.enqueuePostResponseItem(ServerMessage::GAME_EVENT_CONTAINER, prepareGameEvent(event2, -1));
+    if (!resuming && isBroadcastSpectator(joiningParticipant)) {
+        // the spectator sees the game from its joining on through the spectator channel, held back by its delay
+        spectatorChannel->subscribe(joiningParticipant, std::shared_ptr<SessionEvent>(joinedEvent),
+                                    std::shared_ptr<GameEventContainer>(joinedState));
+    } else {
+        rc.enqueuePostResponseItem(ServerMessage::SESSION_EVENT, joinedEvent);
+        rc.enqueuePostResponseItem(ServerMessage::GAME_EVENT_CONTAINER, joinedState);
+    }
 }
 
 void Server_Game::sendGameEventContainer(GameEventContainer *cont,
@@ -794,6 +862,9 @@ void Server_Game::sendGameEventContainer(GameEventContainer *cont,
 
     cont->set_game_id(gameId);
     for (auto *participant : participants.values()) {
+        if (isBroadcastSpectator(participant)) {
+            continue;
+        }
         const bool playerPrivate = (participant->getPlayerId() == privatePlayerId) || participant->isJudge() ||
                                    (participant->isSpectator() && spectatorsSeeEverything);
         if ((recipients.testFlag(GameEventStorageItem::SendToPrivate) && playerPrivate) ||
@@ -802,12 +873,19 @@ void Server_Game::sendGameEventContainer(GameEventContainer *cont,
         }
     }
     if (recipients.testFlag(GameEventStorageItem::SendToPrivate)) {
-        cont->set_seconds_elapsed(secondsElapsed - startTimeOfThisGame);
-        cont->clear_game_id();
-        currentReplay->add_event_list()->CopyFrom(*cont);
+        GameEventContainer *replayCont = currentReplay->add_event_list();
+        replayCont->CopyFrom(*cont);
+        replayCont->set_seconds_elapsed(secondsElapsed - startTimeOfThisGame);
+        replayCont->clear_game_id();
     }
 
-    delete cont;
+    if (spectatorChannel->hasSubscribers()) {
+        // published once and sent to each spectator in the background
+        spectatorChannel->publish(std::shared_ptr<GameEventContainer>(cont), recipients, privatePlayerId,
+                                  spectatorsSeeEverything);
+    } else {
+        delete cont;
+    }
 }
 
 GameEventContainer *
@@ -21,6 +21,7 @@
 #define SERVERGAME_H
 
 #include "../server_response_containers.h"
+#include "../server_timer_wheel.h"
 
 #include <QDateTime>
 #include <QMap>
@@ -31,13 +32,14 @@
 #include <libcockatrice/protocol/pb/event_leave.pb.h>
 #include <libcockatrice/protocol/pb/response.pb.h>
 #include <libcockatrice/protocol/pb/serverinfo_game.pb.h>
+#include <libcockatrice/utility/card_ref.h>
 
-class QTimer;
 class GameEventContainer;
 class GameReplay;
 class Server_Room;
 class Server_AbstractPlayer;
 class Server_AbstractParticipant;
+class Server_SpectatorChannel;
 class ServerInfo_User;
 class ServerInfo_Game;
 class Server_AbstractUserInterface;
@@ -74,20 +76,34 @@ private:
     bool firstGameStarted;
     bool turnOrderReversed;
     QDateTime startTime;
-    QTimer *pingClock;
+    /**
+     * Fires every second while the server wants pings, on the timer wheel of the thread the game was created in.
+     */
+    Server_TimerWheel::Timer pingTimer;
     QList<GameReplay *> replayList;
     GameReplay *currentReplay;
+    QSet<QString> cardStrings;
+    /**
+     * Delivers game events to the spectators that are not judges, so the number of spectators does not slow down
+     * the commands of the players.
+     */
+    Server_SpectatorChannel *spectatorChannel;
 
     void createGameStateChangedEvent(Event_GameStateChanged *event,
                                      Server_AbstractParticipant *recipient,
                                      bool omniscient,
                                      bool withUserInfo);
     void storeGameInformation();
+    void pingClockTimeout();
+    /**
+     * Tells everyone the game is closed and deletes it once the spectator channel has sent its last events, so the
+     * spectators stay reachable until then without the game thread sending to them.
+     */
+    void closeGame();
 signals:
     void sigStartGameIfReady(bool override);
     void gameInfoChanged(ServerInfo_Game gameInfo);
 private slots:
-    void pingClockTimeout();
     void doStartGameIfReady(bool forceStartGame = false);
 
 public:
@@ -198,6 +214,12 @@ public:
     void setActivePlayer(int newPlayer);
     void setActivePhase(int newPhase);
     qint64 generateArrowId();
+    /**
+     * Returns the card reference with its strings shared with every other card of the game of the same name and
+     * printing, so the decks of all players and repeatedly created tokens only hold each card name once.
+     * The game mutex must be held.
+     */
+    CardRef internCardRef(const CardRef &cardRef);
     void removeArrows(int newPhase, bool force = false);
     void nextTurn();
     int getSecondsElapsed() const
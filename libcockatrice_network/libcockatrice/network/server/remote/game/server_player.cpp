@@ -106,8 +106,9 @@ void Server_Player::setupZones()
     // Assign card ids and create deck from deck list
     auto insertCardsIntoZone = [this](auto cards, auto *zone) {
         for (auto card : cards) {
+            const CardRef cardRef = game->internCardRef(card->toCardRef());
             for (int k = 0; k < card->getNumber(); ++k) {
-                zone->insertCard(new Server_Card(card->toCardRef(), nextCardId++, 0, 0, zone), -1, 0);
+                zone->insertCard(new Server_Card(cardRef, nextCardId++, 0, 0, zone), -1, 0);
             }
         }
     };
@@ -0,0 +1,378 @@
+#include "server_spectator_channel.h"
+
+#include "server_abstract_participant.h"
+
+#include <QList>
+#include <QMutex>
+#include <QTimer>
+#include <QWaitCondition>
+#include <atomic>
+#include <chrono>
+#include <libcockatrice/protocol/pb/game_event_container.pb.h>
+#include <libcockatrice/protocol/pb/session_event.pb.h>
+
+static qint64 monotonicMsecs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+Server_SpectatorBroadcaster::Server_SpectatorBroadcaster(QObject *parent) : QObject(parent)
+{
+}
+
+Server_SpectatorBroadcaster::~Server_SpectatorBroadcaster()
+{
+    pool.waitForDone();
+}
+
+void Server_SpectatorBroadcaster::setMaxThreadCount(int threads)
+{
+    pool.setMaxThreadCount(qMax(1, threads));
+}
+
+void Server_SpectatorBroadcaster::schedule(std::function<void()> task, int delayMsecs)
+{
+    if (delayMsecs <= 0) {
+        pool.start(std::move(task));
+        return;
+    }
+
+    // timers can only be started in the thread of their receiver
+    QMetaObject::invokeMethod(
+        this,
+        [this, task = std::move(task), delayMsecs] {
+            QTimer::singleShot(delayMsecs, this, [this, task] { pool.start(task); });
+        },
+        Qt::QueuedConnection);
+}
+
+struct Server_SpectatorChannel::State
+{
+    struct Item
+    {
+        qint64 sequence;
+        qint64 dueTime;
+        std::shared_ptr<const GameEventContainer> cont;
+        GameEventStorageItem::EventRecipients recipients;
+        int privatePlayerId;
+        bool spectatorsSeeEverything;
+        bool subscriptionAfter; // a spectator subscribed after this item was published
+        // set for the events of a spectator joining, which only go to that spectator
+        Server_AbstractParticipant *joiningSpectator = nullptr;
+        std::shared_ptr<const SessionEvent> joinedEvent;
+    };
+
+    struct Subscriber
+    {
+        Server_AbstractParticipant *spectator;
+        qint64 firstSequence;
+    };
+
+    int delayMsecs;
+    int coalescingMsecs;
+
+    // Held for a whole drain, so a drain running late on the pool cannot overtake the next one.
+    QMutex drainMutex;
+
+    QMutex queueMutex;
+    QList<Item> queue;
+    qint64 nextSequence = 0;
+    bool drainScheduled = false;
+    bool closed = false;
+    std::function<void()> onClosed;
+
+    // Only held to change the subscribers or look them up, never while sending to one of them.
+    QMutex deliveryMutex;
+    QList<Subscriber> subscribers;
+    std::atomic<int> subscriberCount = 0;
+    // the spectator a drain is sending to, whom unsubscribing has to wait for
+    Server_AbstractParticipant *deliveringTo = nullptr;
+    QWaitCondition deliveryFinished;
+
+    const Subscriber *findSubscriber(const Server_AbstractParticipant *spectator) const
+    {
+        for (const auto &subscriber : subscribers) {
+            if (subscriber.spectator == spectator) {
+                return &subscriber;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Sends the items to the subscriber that are meant for it.
+     */
+    static void deliver(const Subscriber &subscriber, const QList<Item> &items)
+    {
+        for (const auto &item : items) {
+            if (item.sequence < subscriber.firstSequence) {
+                continue;
+            }
+            if (item.joiningSpectator) {
+                if (subscriber.spectator == item.joiningSpectator) {
+                    if (item.joinedEvent) {
+                        subscriber.spectator->sendSessionEvent(*item.joinedEvent);
+                    }
+                    if (item.cont) {
+                        subscriber.spectator->sendGameEvent(*item.cont);
+                    }
+                }
+                continue;
+            }
+            const bool playerPrivate =
+                subscriber.spectator->getPlayerId() == item.privatePlayerId || item.spectatorsSeeEverything;
+            if ((item.recipients.testFlag(GameEventStorageItem::SendToPrivate) && playerPrivate) ||
+                (item.recipients.testFlag(GameEventStorageItem::SendToOthers) && !playerPrivate)) {
+                subscriber.spectator->sendGameEvent(*item.cont);
+            }
+        }
+    }
+
+    static bool canMerge(const Item &first, const Item &second)
+    {
+        return !first.subscriptionAfter && !first.joiningSpectator && !second.joiningSpectator &&
+               first.recipients == second.recipients &&
+               first.privatePlayerId == second.privatePlayerId &&
+               first.spectatorsSeeEverything == second.spectatorsSeeEverything && !first.cont->has_context() &&
+               !second.cont->has_context() && first.cont->forced_by_judge() == second.cont->forced_by_judge();
+    }
+
+    /**
+     * Merges runs of containers that go to the same spectators and carry no context into single containers.
+     */
+    static QList<Item> coalesced(const QList<Item> &items)
+    {
+        QList<Item> result;
+        std::shared_ptr<GameEventContainer> merged;
+        for (const auto &item : items) {
+            if (result.isEmpty() || !canMerge(result.last(), item)) {
+                result.append(item);
+                merged.reset();
+                continue;
+            }
+            if (!merged) {
+                merged = std::make_shared<GameEventContainer>(*result.last().cont);
+                result.last().cont = merged;
+            }
+            for (const GameEvent &event : item.cont->event_list()) {
+                merged->add_event_list()->CopyFrom(event);
+            }
+            result.last().subscriptionAfter = item.subscriptionAfter;
+        }
+        return result;
+    }
+};
+
+Server_SpectatorChannel::Server_SpectatorChannel(Server_SpectatorBroadcaster *_broadcaster,
+                                                 int delayMsecs,
+                                                 int coalescingMsecs)
+    : state(std::make_shared<State>()), broadcaster(_broadcaster)
+{
+    state->delayMsecs = qMax(0, delayMsecs);
+    state->coalescingMsecs = qMax(0, coalescingMsecs);
+}
+
+Server_SpectatorChannel::~Server_SpectatorChannel()
+{
+    close();
+}
+
+void Server_SpectatorChannel::subscribe(Server_AbstractParticipant *spectator,
+                                        std::shared_ptr<const SessionEvent> joinedEvent,
+                                        std::shared_ptr<const GameEventContainer> joinedState)
+{
+    QMutexLocker deliveryLocker(&state->deliveryMutex);
+    QMutexLocker queueLocker(&state->queueMutex);
+    if (state->closed) {
+        return;
+    }
+
+    if (!state->queue.isEmpty()) {
+        state->queue.last().subscriptionAfter = true;
+    }
+    state->subscribers.append({spectator, state->nextSequence});
+    ++state->subscriberCount;
+    if (!joinedEvent && !joinedState) {
+        return;
+    }
+
+    State::Item joined{state->nextSequence++,
+                       monotonicMsecs() + state->delayMsecs,
+                       std::move(joinedState),
+                       GameEventStorageItem::SendToPrivate | GameEventStorageItem::SendToOthers,
+                       -1,
+                       false,
+                       false};
+    joined.joiningSpectator = spectator;
+    joined.joinedEvent = std::move(joinedEvent);
+    state->queue.append(std::move(joined));
+    if (state->drainScheduled) {
+        return;
+    }
+    state->drainScheduled = true;
+    const int delay = state->delayMsecs + state->coalescingMsecs;
+    queueLocker.unlock();
+    deliveryLocker.unlock();
+
+    broadcaster->schedule(
+        [channelState = state, channelBroadcaster = broadcaster] { drain(channelState, channelBroadcaster); }, delay);
+}
+
+void Server_SpectatorChannel::unsubscribe(Server_AbstractParticipant *spectator)
+{
+    QMutexLocker locker(&state->deliveryMutex);
+    for (int i = 0; i < state->subscribers.size(); ++i) {
+        if (state->subscribers[i].spectator == spectator) {
+            state->subscribers.removeAt(i);
+            --state->subscriberCount;
+            break;
+        }
+    }
+    // a drain looks the subscriber up again before each delivery, so only the one running can still reach it
+    while (state->deliveringTo == spectator) {
+        state->deliveryFinished.wait(&state->deliveryMutex);
+    }
+}
+
+bool Server_SpectatorChannel::hasSubscribers() const
+{
+    return state->subscriberCount > 0;
+}
+
+void Server_SpectatorChannel::publish(std::shared_ptr<const GameEventContainer> cont,
+                                      GameEventStorageItem::EventRecipients recipients,
+                                      int privatePlayerId,
+                                      bool spectatorsSeeEverything)
+{
+    QMutexLocker locker(&state->queueMutex);
+    if (state->closed) {
+        return;
+    }
+
+    state->queue.append({state->nextSequence++, monotonicMsecs() + state->delayMsecs, std::move(cont), recipients,
+                         privatePlayerId, spectatorsSeeEverything, false});
+    if (state->drainScheduled) {
+        return;
+    }
+    state->drainScheduled = true;
+    const int delay = state->delayMsecs + state->coalescingMsecs;
+    locker.unlock();
+
+    broadcaster->schedule(
+        [channelState = state, channelBroadcaster = broadcaster] { drain(channelState, channelBroadcaster); }, delay);
+}
+
+void Server_SpectatorChannel::close(std::function<void()> onClosed)
+{
+    {
+        QMutexLocker locker(&state->queueMutex);
+        if (state->closed) {
+            return;
+        }
+        state->closed = true;
+        state->onClosed = std::move(onClosed);
+        for (auto &item : state->queue) {
+            item.dueTime = 0;
+        }
+    }
+
+    broadcaster->schedule([channelState = state] { finishClose(channelState); }, 0);
+}
+
+void Server_SpectatorChannel::close()
+{
+    {
+        QMutexLocker locker(&state->queueMutex);
+        state->closed = true;
+        state->onClosed = nullptr;
+        for (auto &item : state->queue) {
+            item.dueTime = 0;
+        }
+    }
+
+    finishClose(state);
+}
+
+void Server_SpectatorChannel::finishClose(const std::shared_ptr<State> &state)
+{
+    drain(state, nullptr);
+
+    // onClosed is called with the subscribers locked, so a synchronous close() waits for it to return
+    QMutexLocker deliveryLocker(&state->deliveryMutex);
+    state->subscribers.clear();
+    state->subscriberCount = 0;
+
+    std::function<void()> onClosed;
+    {
+        QMutexLocker queueLocker(&state->queueMutex);
+        onClosed.swap(state->onClosed);
+    }
+    if (onClosed) {
+        onClosed();
+    }
+}
+
+void Server_SpectatorChannel::drain(const std::shared_ptr<State> &state, Server_SpectatorBroadcaster *broadcaster)
+{
+    QMutexLocker drainLocker(&state->drainMutex);
+
+    QList<State::Item> items;
+    {
+        QMutexLocker locker(&state->queueMutex);
+        const qint64 now = monotonicMsecs();
+        int dueCount = 0;
+        while (dueCount < state->queue.size() && state->queue[dueCount].dueTime <= now) {
+            ++dueCount;
+        }
+        items = state->queue.mid(0, dueCount);
+        state->queue.erase(state->queue.begin(), state->queue.begin() + dueCount);
+    }
+    if (state->coalescingMsecs > 0) {
+        items = State::coalesced(items);
+    }
+
+    if (!items.isEmpty()) {
+        QList<Server_AbstractParticipant *> spectators;
+        {
+            QMutexLocker locker(&state->deliveryMutex);
+            for (const auto &subscriber : state->subscribers) {
+                spectators.append(subscriber.spectator);
+            }
+        }
+
+        // the subscribers are only locked between the spectators, so subscribing and unsubscribing don't wait for
+        // the whole batch to be sent
+        for (auto *spectator : spectators) {
+            QMutexLocker locker(&state->deliveryMutex);
+            const State::Subscriber *current = state->findSubscriber(spectator);
+            if (!current) {
+                continue;
+            }
+            const State::Subscriber subscriber = *current;
+            state->deliveringTo = spectator;
+            locker.unlock();
+
+            State::deliver(subscriber, items);
+
+            locker.relock();
+            state->deliveringTo = nullptr;
+            state->deliveryFinished.wakeAll();
+        }
+    }
+
+    if (!broadcaster) {
+        return;
+    }
+
+    QMutexLocker locker(&state->queueMutex);
+    if (state->queue.isEmpty() || state->closed) {
+        state->drainScheduled = false;
+        return;
+    }
+    const int delay = static_cast<int>(qMax<qint64>(0, state->queue.first().dueTime - monotonicMsecs())) +
+                      state->coalescingMsecs;
+    locker.unlock();
+
+    broadcaster->schedule([state, broadcaster] { drain(state, broadcaster); }, delay);
+}
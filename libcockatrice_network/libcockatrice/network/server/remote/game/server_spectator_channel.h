@@ -0,0 +1,98 @@
+#ifndef SERVER_SPECTATOR_CHANNEL_H
+#define SERVER_SPECTATOR_CHANNEL_H
+
+#include "../server_response_containers.h"
+
+#include <QObject>
+#include <QThreadPool>
+#include <functional>
+#include <memory>
+
+class GameEventContainer;
+class SessionEvent;
+class Server_AbstractParticipant;
+
+/**
+ * Runs the deliveries of the spectator channels of all games on a thread pool of its own, so sending game events to
+ * spectators never happens while a command is being processed. Delayed deliveries are timed in the thread of the
+ * broadcaster, which has to run an event loop.
+ */
+class Server_SpectatorBroadcaster : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Server_SpectatorBroadcaster(QObject *parent = nullptr);
+    ~Server_SpectatorBroadcaster() override;
+
+    void setMaxThreadCount(int threads);
+
+    /**
+     * Runs the task on the thread pool once the delay has passed. Can be called from any thread.
+     */
+    void schedule(std::function<void()> task, int delayMsecs);
+
+private:
+    QThreadPool pool;
+};
+
+/**
+ * Sends the game events of one game to its spectators, judges excepted. The game publishes each container once,
+ * however many spectators are watching, and the broadcaster sends it to every subscribed spectator in the
+ * background.
+ *
+ * Containers reach each spectator in the order they were published. They can be held back by a fixed delay, and
+ * containers published within the coalescing interval of each other can be merged into one. A spectator only
+ * receives the containers published after it subscribed, preceded by the events of its joining, which are held back
+ * by the same delay.
+ */
+class Server_SpectatorChannel
+{
+public:
+    Server_SpectatorChannel(Server_SpectatorBroadcaster *_broadcaster, int delayMsecs, int coalescingMsecs);
+    ~Server_SpectatorChannel();
+
+    /**
+     * @param joinedEvent session event opening the game for the spectator, sent to it first
+     * @param joinedState the state of the game as the spectator joined, sent to it right after
+     */
+    void subscribe(Server_AbstractParticipant *spectator,
+                   std::shared_ptr<const SessionEvent> joinedEvent = nullptr,
+                   std::shared_ptr<const GameEventContainer> joinedState = nullptr);
+    /**
+     * Nothing is sent to the spectator anymore once this returns. Only waits for a delivery to this spectator that is
+     * running, not for the deliveries to the other spectators.
+     */
+    void unsubscribe(Server_AbstractParticipant *spectator);
+    bool hasSubscribers() const;
+
+    /**
+     * Queues the container for the spectators it is meant for, following the same rules as
+     * Server_Game::sendGameEventContainer.
+     */
+    void publish(std::shared_ptr<const GameEventContainer> cont,
+                 GameEventStorageItem::EventRecipients recipients,
+                 int privatePlayerId,
+                 bool spectatorsSeeEverything);
+
+    /**
+     * Has the broadcaster send everything published so far, ignoring the delay, then drops the subscribers and calls
+     * onClosed from the thread pool. Containers published afterwards are discarded. The subscribers have to stay
+     * valid until onClosed is called or the channel is destroyed.
+     */
+    void close(std::function<void()> onClosed);
+    /**
+     * Same, but sends everything in the calling thread and returns once it is sent. A close running on the
+     * broadcaster is finished here instead and its onClosed is dropped.
+     */
+    void close();
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+    Server_SpectatorBroadcaster *broadcaster;
+
+    static void drain(const std::shared_ptr<State> &state, Server_SpectatorBroadcaster *broadcaster);
+    static void finishClose(const std::shared_ptr<State> &state);
+};
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "game/server_game.h"
 #include "game/server_player.h"
+#include "game/server_spectator_channel.h"
 #include "server_database_interface.h"
 #include "server_protocolhandler.h"
 #include "server_remoteuserinterface.h"
@@ -37,7 +38,9 @@
 #include <libcockatrice/protocol/pb/isl_message.pb.h>
 #include <libcockatrice/protocol/pb/session_event.pb.h>
 
-Server::Server(QObject *parent) : QObject(parent), nextLocalGameId(0), tcpUserCount(0), webSocketUserCount(0)
+Server::Server(QObject *parent)
+    : QObject(parent), nextLocalGameId(0), tcpUserCount(0), webSocketUserCount(0), metrics(nullptr),
+      spectatorBroadcaster(new Server_SpectatorBroadcaster(this))
 {
     qRegisterMetaType<ServerInfo_Ban>("ServerInfo_Ban");
     qRegisterMetaType<ServerInfo_Game>("ServerInfo_Game");
@@ -167,6 +170,7 @@ AuthenticationResult Server::loginUser(Server_ProtocolHandler *session,
 
     Event_UserJoined event;
     event.mutable_user_info()->CopyFrom(session->copyUserInfo(false));
+    userListSnapshot.insert(name, event.user_info());
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
     for (auto &client : clients) {
         if (client->getAcceptsUserListChanges()) {
@@ -194,6 +198,13 @@ void Server::broadcastUserInfoUpdate(Server_ProtocolHandler *source)
 {
     Event_UserJoined event;
     event.mutable_user_info()->CopyFrom(source->copyUserInfo(false));
+    userListSnapshot.update(QString::fromStdString(event.user_info().name()), event.user_info());
+
+    roomsLock.lockForRead();
+    for (Server_Room *room : rooms) {
+        room->updateClientInfo(source);
+    }
+    roomsLock.unlock();
 
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
 
@@ -285,6 +296,7 @@ void Server::removeClient(Server_ProtocolHandler *client)
         delete se;
 
         users.remove(QString::fromStdString(data->name()));
+        userListSnapshot.remove(QString::fromStdString(data->name()));
         qDebug() << "Server::removeClient: name=" << QString::fromStdString(data->name());
 
         if (data->has_session_id()) {
@@ -322,6 +334,7 @@ void Server::externalUserJoined(const ServerInfo_User &userInfo)
     Server_RemoteUserInterface *newUser = new Server_RemoteUserInterface(this, ServerInfo_User_Container(userInfo));
     externalUsers.insert(QString::fromStdString(userInfo.name()), newUser);
     externalUsersBySessionId.insert(userInfo.session_id(), newUser);
+    externalUserListSnapshot.insert(QString::fromStdString(userInfo.name()), newUser->copyUserInfo(false));
 
     Event_UserJoined event;
     event.mutable_user_info()->CopyFrom(userInfo);
@@ -346,6 +359,7 @@ void Server::externalUserLeft(const QString &userName)
 
     clientsLock.lockForWrite();
     Server_AbstractUserInterface *user = externalUsers.take(userName);
+    externalUserListSnapshot.remove(userName);
     externalUsersBySessionId.remove(user->getUserInfo()->session_id());
     clientsLock.unlock();
 
@@ -1,6 +1,7 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include "server_list_snapshot.h"
 #include "server_player_reference.h"
 
 #include <QMultiMap>
@@ -12,6 +13,8 @@
 #include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
 
 class Server_DatabaseInterface;
+class Server_Metrics;
+class Server_SpectatorBroadcaster;
 class Server_Game;
 class Server_Room;
 class Server_ProtocolHandler;
@@ -45,7 +48,6 @@ class Server : public QObject
 {
     Q_OBJECT
 signals:
-    void pingClockTimeout();
     void sigSendIslMessage(const IslMessage &message, int serverId);
     void endSession(qint64 sessionId);
 private slots:
@@ -175,8 +177,33 @@ public:
     {
         return false;
     }
+    /**
+     * @return how many seconds game events are held back before they are sent to spectators
+     */
+    virtual int getSpectatorDelay() const
+    {
+        return 0;
+    }
+    /**
+     * @return the interval in milliseconds within which game events for spectators are merged into one container
+     */
+    virtual int getSpectatorCoalescingInterval() const
+    {
+        return 0;
+    }
 
     Server_DatabaseInterface *getDatabaseInterface() const;
+    /**
+     * @return the metrics collector, or nullptr when metrics are disabled
+     */
+    Server_Metrics *getMetrics() const
+    {
+        return metrics;
+    }
+    Server_SpectatorBroadcaster *getSpectatorBroadcaster() const
+    {
+        return spectatorBroadcaster;
+    }
     int getNextLocalGameId()
     {
         QMutexLocker locker(&nextLocalGameIdMutex);
@@ -194,6 +221,18 @@ public:
     {
         return externalUsers;
     }
+    using UserListSnapshot = Server_ListSnapshot<QString, ServerInfo_User>;
+    /**
+     * Public user info of the logged in users, maintained alongside users and externalUsers.
+     */
+    std::shared_ptr<const UserListSnapshot::Snapshot> getUserListSnapshot() const
+    {
+        return userListSnapshot.get();
+    }
+    std::shared_ptr<const UserListSnapshot::Snapshot> getExternalUserListSnapshot() const
+    {
+        return externalUserListSnapshot.get();
+    }
 
     void addPersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
     void removePersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
@@ -214,6 +253,10 @@ private:
     mutable QReadWriteLock persistentPlayersLock;
     int nextLocalGameId, tcpUserCount, webSocketUserCount;
     QMutex nextLocalGameIdMutex;
+    Server_Metrics *metrics;
+    Server_SpectatorBroadcaster *spectatorBroadcaster;
+    UserListSnapshot userListSnapshot;
+    UserListSnapshot externalUserListSnapshot;
 
 protected slots:
     void externalUserJoined(const ServerInfo_User &userInfo);
@@ -237,6 +280,13 @@ protected slots:
 protected:
     void prepareDestroy();
     void setDatabaseInterface(Server_DatabaseInterface *_databaseInterface);
+    /**
+     * Must be called before any client connects; the server does not take ownership.
+     */
+    void setMetrics(Server_Metrics *_metrics)
+    {
+        metrics = _metrics;
+    }
     QList<Server_ProtocolHandler *> clients;
     QMap<qint64, Server_ProtocolHandler *> usersBySessionId;
     QMap<QString, Server_ProtocolHandler *> users;
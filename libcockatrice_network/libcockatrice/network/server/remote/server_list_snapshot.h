@@ -0,0 +1,93 @@
+#ifndef SERVER_LIST_SNAPSHOT_H
+#define SERVER_LIST_SNAPSHOT_H
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <memory>
+
+/**
+ * Keyed list of protobuf info messages (games of a room, users of a room or of the server) that is kept up to date
+ * by the add/remove/update hooks of its owner and handed out to readers as an immutable, versioned snapshot.
+ *
+ * Readers only hold the internal mutex long enough to grab the shared snapshot, so building a room or user list
+ * response no longer locks every game or copies every user while the owner's lock is held. The snapshot is rebuilt
+ * lazily by the first reader after a change. The internal mutex is a leaf lock and may be taken with any of the
+ * server locks held.
+ */
+template <typename Key, typename Info> class Server_ListSnapshot
+{
+public:
+    struct Snapshot
+    {
+        quint64 version;
+        QList<Info> items;
+    };
+
+    void insert(const Key &key, const Info &info)
+    {
+        QMutexLocker locker(&mutex);
+        entries.insert(key, info);
+        invalidate();
+    }
+    /**
+     * Replaces the entry if it is still present, updates for already removed entries are dropped.
+     */
+    void update(const Key &key, const Info &info)
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            *it = info;
+            invalidate();
+        }
+    }
+    /**
+     * Merges a partial update (only the changed fields set) into the entry if it is still present.
+     */
+    void merge(const Key &key, const Info &delta)
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->MergeFrom(delta);
+            invalidate();
+        }
+    }
+    void remove(const Key &key)
+    {
+        QMutexLocker locker(&mutex);
+        if (entries.remove(key)) {
+            invalidate();
+        }
+    }
+
+    quint64 getVersion() const
+    {
+        QMutexLocker locker(&mutex);
+        return version;
+    }
+    std::shared_ptr<const Snapshot> get() const
+    {
+        QMutexLocker locker(&mutex);
+        if (!published) {
+            published = std::make_shared<const Snapshot>(Snapshot{version, entries.values()});
+        }
+        return published;
+    }
+
+private:
+    mutable QMutex mutex;
+    QMap<Key, Info> entries;
+    quint64 version = 0;
+    mutable std::shared_ptr<const Snapshot> published;
+
+    void invalidate()
+    {
+        ++version;
+        published.reset();
+    }
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include "server_metrics.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <google/protobuf/descriptor.h>
+#include <libcockatrice/protocol/pb/admin_commands.pb.h>
+#include <libcockatrice/protocol/pb/game_commands.pb.h>
+#include <libcockatrice/protocol/pb/moderator_commands.pb.h>
+#include <libcockatrice/protocol/pb/room_commands.pb.h>
+#include <libcockatrice/protocol/pb/session_commands.pb.h>
+
+void Server_LatencyHistogram::observe(qint64 microseconds)
+{
+    int bucket = 0;
+    while (bucket < BucketCount && microseconds > bucketBounds[bucket]) {
+        ++bucket;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sumMicroseconds.fetch_add(static_cast<quint64>(qMax<qint64>(microseconds, 0)), std::memory_order_relaxed);
+}
+
+void Server_LatencyHistogram::appendPrometheus(QString &out, const QString &name, const QString &labels) const
+{
+    const QString separator = labels.isEmpty() ? QString() : QString(",");
+    quint64 cumulative = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out += QString("%1_bucket{%2%3le=\"%4\"} %5\n")
+                   .arg(name, labels, separator, QString::number(bucketBounds[i] / 1000000.0))
+                   .arg(cumulative);
+    }
+    cumulative += buckets[BucketCount].load(std::memory_order_relaxed);
+    out += QString("%1_bucket{%2%3le=\"+Inf\"} %4\n").arg(name, labels, separator).arg(cumulative);
+
+    const QString braces = labels.isEmpty() ? QString() : QString("{%1}").arg(labels);
+    out += QString("%1_sum%2 %3\n")
+               .arg(name, braces, QString::number(sumMicroseconds.load(std::memory_order_relaxed) / 1000000.0));
+    out += QString("%1_count%2 %3\n").arg(name, braces).arg(count.load(std::memory_order_relaxed));
+}
+
+Server_Metrics::Server_Metrics() = default;
+
+Server_Metrics::~Server_Metrics()
+{
+    for (auto &category : commandHistograms) {
+        for (auto &histogram : category) {
+            delete histogram.load();
+        }
+    }
+}
+
+void Server_Metrics::observeCommand(CommandCategory category, int commandType, qint64 microseconds)
+{
+    const int slot = commandType - CommandTypeBase;
+    if (slot < 0 || slot >= CommandTypeSlots) {
+        return;
+    }
+
+    std::atomic<Server_LatencyHistogram *> &entry = commandHistograms[category][slot];
+    Server_LatencyHistogram *histogram = entry.load(std::memory_order_acquire);
+    if (!histogram) {
+        // first observation of this command type, publish a histogram unless another thread was faster
+        auto *newHistogram = new Server_LatencyHistogram;
+        if (entry.compare_exchange_strong(histogram, newHistogram, std::memory_order_acq_rel)) {
+            histogram = newHistogram;
+        } else {
+            delete newHistogram;
+        }
+    }
+    histogram->observe(microseconds);
+}
+
+void Server_Metrics::observeLockWait(Lock lock, qint64 microseconds)
+{
+    lockWaitHistograms[lock].observe(microseconds);
+}
+
+Server_Metrics::ThreadBusyTime *Server_Metrics::busyTimeForCurrentThread()
+{
+    thread_local const Server_Metrics *cachedOwner = nullptr;
+    thread_local ThreadBusyTime *cachedBusyTime = nullptr;
+    if (cachedOwner == this) {
+        return cachedBusyTime;
+    }
+
+    auto busyTime = std::make_shared<ThreadBusyTime>();
+    busyTime->threadName = QThread::currentThread()->objectName();
+    if (busyTime->threadName.isEmpty()) {
+        busyTime->threadName = "main";
+    }
+
+    QMutexLocker locker(&threadBusyTimesMutex);
+    threadBusyTimes.append(busyTime);
+    cachedOwner = this;
+    cachedBusyTime = busyTime.get();
+    return cachedBusyTime;
+}
+
+void Server_Metrics::addBusyTime(qint64 microseconds)
+{
+    busyTimeForCurrentThread()->microseconds.fetch_add(static_cast<quint64>(qMax<qint64>(microseconds, 0)),
+                                                       std::memory_order_relaxed);
+}
+
+QString Server_Metrics::escapeLabelValue(const QString &value)
+{
+    QString result = value;
+    result.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    return result;
+}
+
+QString Server_Metrics::commandTypeName(CommandCategory category, int commandType)
+{
+    const google::protobuf::EnumDescriptor *descriptor = nullptr;
+    switch (category) {
+        case SessionCommandCategory:
+            descriptor = SessionCommand::SessionCommandType_descriptor();
+            break;
+        case RoomCommandCategory:
+            descriptor = RoomCommand::RoomCommandType_descriptor();
+            break;
+        case GameCommandCategory:
+            descriptor = GameCommand::GameCommandType_descriptor();
+            break;
+        case ModeratorCommandCategory:
+            descriptor = ModeratorCommand::ModeratorCommandType_descriptor();
+            break;
+        case AdminCommandCategory:
+            descriptor = AdminCommand::AdminCommandType_descriptor();
+            break;
+        default:
+            break;
+    }
+
+    const google::protobuf::EnumValueDescriptor *value =
+        descriptor ? descriptor->FindValueByNumber(commandType) : nullptr;
+    return value ? QString::fromStdString(std::string(value->name())) : QString::number(commandType);
+}
+
+void Server_Metrics::appendPrometheus(QString &out) const
+{
+    static const QStringList categoryNames = {"session", "room", "game", "moderator", "admin"};
+    static const QStringList lockNames = {"rooms", "clients", "games", "game"};
+
+    out += "# HELP servatrice_command_duration_seconds Time spent processing a single command.\n";
+    out += "# TYPE servatrice_command_duration_seconds histogram\n";
+    for (int category = 0; category < CommandCategoryCount; ++category) {
+        for (int slot = 0; slot < CommandTypeSlots; ++slot) {
+            const Server_LatencyHistogram *histogram = commandHistograms[category][slot].load();
+            if (!histogram) {
+                continue;
+            }
+            const QString labels =
+                QString("category=\"%1\",command=\"%2\"")
+                    .arg(categoryNames.at(category),
+                         commandTypeName(static_cast<CommandCategory>(category), slot + CommandTypeBase));
+            histogram->appendPrometheus(out, "servatrice_command_duration_seconds", labels);
+        }
+    }
+
+    out += "# HELP servatrice_lock_wait_seconds Time spent waiting to acquire a lock on the command path.\n";
+    out += "# TYPE servatrice_lock_wait_seconds histogram\n";
+    for (int lock = 0; lock < LockCount; ++lock) {
+        lockWaitHistograms[lock].appendPrometheus(out, "servatrice_lock_wait_seconds",
+                                                  QString("lock=\"%1\"").arg(lockNames.at(lock)));
+    }
+
+    out += "# HELP servatrice_thread_busy_seconds_total Time spent processing commands, per thread.\n";
+    out += "# TYPE servatrice_thread_busy_seconds_total counter\n";
+    QMutexLocker locker(&threadBusyTimesMutex);
+    for (const auto &busyTime : threadBusyTimes) {
+        out += QString("servatrice_thread_busy_seconds_total{thread=\"%1\"} %2\n")
+                   .arg(escapeLabelValue(busyTime->threadName),
+                        QString::number(busyTime->microseconds.load(std::memory_order_relaxed) / 1000000.0));
+    }
+}
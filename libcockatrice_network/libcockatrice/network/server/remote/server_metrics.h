@@ -0,0 +1,131 @@
+#ifndef SERVER_METRICS_H
+#define SERVER_METRICS_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <memory>
+
+/**
+ * Latency histogram with fixed, exponentially growing buckets.
+ * Observations only touch relaxed atomics, so it can be fed from any thread without locking.
+ */
+class Server_LatencyHistogram
+{
+public:
+    static constexpr int BucketCount = 16;
+    // upper bounds of the buckets, in microseconds
+    static constexpr std::array<qint64, BucketCount> bucketBounds = {
+        50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000};
+
+    void observe(qint64 microseconds);
+
+    /**
+     * Appends the histogram in the Prometheus text format.
+     * @param labels comma separated label pairs without braces, may be empty
+     */
+    void appendPrometheus(QString &out, const QString &name, const QString &labels) const;
+
+private:
+    std::array<std::atomic<quint64>, BucketCount + 1> buckets{};
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> sumMicroseconds{0};
+};
+
+/**
+ * Measures the elapsed time only when metrics are being collected.
+ */
+class Server_MetricsStopwatch
+{
+public:
+    explicit Server_MetricsStopwatch(bool enabled)
+    {
+        if (enabled) {
+            timer.start();
+        }
+    }
+    qint64 elapsedMicroseconds() const
+    {
+        return timer.isValid() ? timer.nsecsElapsed() / 1000 : 0;
+    }
+    qint64 restartMicroseconds()
+    {
+        if (!timer.isValid()) {
+            return 0;
+        }
+        const qint64 elapsed = timer.nsecsElapsed() / 1000;
+        timer.start();
+        return elapsed;
+    }
+
+private:
+    QElapsedTimer timer;
+};
+
+/**
+ * Runtime instrumentation of the command processing path.
+ * A server only owns an instance when metrics are enabled; callers check Server::getMetrics() for nullptr
+ * before measuring anything, so disabled metrics cost a single pointer comparison.
+ */
+class Server_Metrics
+{
+public:
+    enum CommandCategory
+    {
+        SessionCommandCategory,
+        RoomCommandCategory,
+        GameCommandCategory,
+        ModeratorCommandCategory,
+        AdminCommandCategory,
+        CommandCategoryCount
+    };
+    enum Lock
+    {
+        RoomsLock,
+        ClientsLock,
+        GamesLock,
+        GameMutex,
+        LockCount
+    };
+
+    Server_Metrics();
+    virtual ~Server_Metrics();
+
+    void observeCommand(CommandCategory category, int commandType, qint64 microseconds);
+    void observeLockWait(Lock lock, qint64 microseconds);
+    /**
+     * Accounts time spent processing a command container to the current thread.
+     */
+    void addBusyTime(qint64 microseconds);
+
+    virtual void appendPrometheus(QString &out) const;
+
+protected:
+    static QString escapeLabelValue(const QString &value);
+
+private:
+    // command types are protobuf extension numbers starting at 1000
+    static constexpr int CommandTypeBase = 1000;
+    static constexpr int CommandTypeSlots = 256;
+
+    struct ThreadBusyTime
+    {
+        QString threadName;
+        std::atomic<quint64> microseconds{0};
+    };
+
+    std::array<std::array<std::atomic<Server_LatencyHistogram *>, CommandTypeSlots>, CommandCategoryCount>
+        commandHistograms{};
+    std::array<Server_LatencyHistogram, LockCount> lockWaitHistograms;
+
+    mutable QMutex threadBusyTimesMutex;
+    QList<std::shared_ptr<ThreadBusyTime>> threadBusyTimes;
+    ThreadBusyTime *busyTimeForCurrentThread();
+
+    static QString commandTypeName(CommandCategory category, int commandType);
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "game/server_game.h"
 #include "game/server_player.h"
 #include "server_database_interface.h"
+#include "server_metrics.h"
 #include "server_room.h"
 
 #include <QDateTime>
@@ -33,14 +34,29 @@ Server_ProtocolHandler::Server_ProtocolHandler(Server *_server,
                                                QObject *parent)
     : QObject(parent), Server_AbstractUserInterface(_server), deleted(false), databaseInterface(_databaseInterface),
       authState(NotLoggedIn), usingRealPassword(false), acceptsUserListChanges(false), acceptsRoomListChanges(false),
-      idleClientWarningSent(false), timeRunning(0), lastDataReceived(0), lastActionReceived(0)
-
+      idleClientWarningSent(false), clockInterval(qMax(0, _server->getClientKeepAlive())),
+      deadlineTimer([this] { checkDeadlines(); })
 {
-    connect(server, &Server::pingClockTimeout, this, &Server_ProtocolHandler::pingClockTimeout);
+    lastDataReceived = lastActionReceived = clockTime();
+    if (clockInterval > 0) {
+        // queued, so the deadline lands on the wheel of the thread the connection is moved to
+        QMetaObject::invokeMethod(this, [this] { checkDeadlines(); }, Qt::QueuedConnection);
+    }
 }
 
 Server_ProtocolHandler::~Server_ProtocolHandler()
 {
+    deadlineTimer.cancel();
+}
+
+int Server_ProtocolHandler::clockTime() const
+{
+    return clockInterval > 0 ? static_cast<int>(Server_TimerWheel::clockSeconds() / clockInterval) : 0;
+}
+
+int Server_ProtocolHandler::countingSlots(int interval) const
+{
+    return clockInterval > 0 ? interval / clockInterval : 1;
 }
 
 // This function must only be called from the thread this object lives in.
@@ -133,8 +149,10 @@ void Server_ProtocolHandler::sendProtocolItem(const RoomEvent &item)
 Response::ResponseCode Server_ProtocolHandler::processSessionCommandContainer(const CommandContainer &cont,
                                                                               ResponseContainer &rc)
 {
+    Server_Metrics *metrics = server->getMetrics();
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.session_command_size() - 1; i >= 0; --i) {
+        Server_MetricsStopwatch commandTimer(metrics);
         Response::ResponseCode resp = Response::RespInvalidCommand;
         const SessionCommand &sc = cont.session_command(i);
         const int num = getPbExtension(sc);
@@ -169,6 +187,9 @@ Response::ResponseCode Server_ProtocolHandler::processSessionCommandContainer(co
             default:
                 resp = processExtendedSessionCommand(num, sc, rc);
         }
+        if (metrics) {
+            metrics->observeCommand(Server_Metrics::SessionCommandCategory, num, commandTimer.elapsedMicroseconds());
+        }
         if (resp != Response::RespOk) {
             finalResponseCode = resp;
         }
@@ -183,7 +204,12 @@ Response::ResponseCode Server_ProtocolHandler::processRoomCommandContainer(const
         return Response::RespLoginNeeded;
     }
 
+    Server_Metrics *metrics = server->getMetrics();
+    Server_MetricsStopwatch lockTimer(metrics);
     QReadLocker locker(&server->roomsLock);
+    if (metrics) {
+        metrics->observeLockWait(Server_Metrics::RoomsLock, lockTimer.elapsedMicroseconds());
+    }
     Server_Room *room = rooms.value(cont.room_id(), 0);
     if (!room) {
         return Response::RespNotInRoom;
@@ -193,6 +219,7 @@ Response::ResponseCode Server_ProtocolHandler::processRoomCommandContainer(const
 
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.room_command_size() - 1; i >= 0; --i) {
+        Server_MetricsStopwatch commandTimer(metrics);
         Response::ResponseCode resp = Response::RespInvalidCommand;
         const RoomCommand &sc = cont.room_command(i);
         const int num = getPbExtension(sc);
@@ -211,6 +238,9 @@ Response::ResponseCode Server_ProtocolHandler::processRoomCommandContainer(const
                 resp = cmdJoinGame(sc.GetExtension(Command_JoinGame::ext), room, rc);
                 break;
         }
+        if (metrics) {
+            metrics->observeCommand(Server_Metrics::RoomCommandCategory, num, commandTimer.elapsedMicroseconds());
+        }
         if (resp != Response::RespOk) {
             finalResponseCode = resp;
         }
@@ -248,13 +278,21 @@ Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const
     }
     const QPair<int, int> roomIdAndPlayerId = gameMap.value(cont.game_id());
 
+    Server_Metrics *metrics = server->getMetrics();
+    Server_MetricsStopwatch lockTimer(metrics);
     QReadLocker roomsLocker(&server->roomsLock);
+    if (metrics) {
+        metrics->observeLockWait(Server_Metrics::RoomsLock, lockTimer.restartMicroseconds());
+    }
     Server_Room *room = server->getRooms().value(roomIdAndPlayerId.first);
     if (!room) {
         return Response::RespNotInRoom;
     }
 
     QReadLocker roomGamesLocker(&room->gamesLock);
+    if (metrics) {
+        metrics->observeLockWait(Server_Metrics::GamesLock, lockTimer.restartMicroseconds());
+    }
     Server_Game *game = room->getGames().value(cont.game_id());
     if (!game) {
         if (room->getExternalGames().contains(cont.game_id())) {
@@ -266,6 +304,9 @@ Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const
     }
 
     QMutexLocker gameLocker(&game->gameMutex);
+    if (metrics) {
+        metrics->observeLockWait(Server_Metrics::GameMutex, lockTimer.restartMicroseconds());
+    }
     auto *participant = game->getParticipants().value(roomIdAndPlayerId.second);
     if (!participant) {
         return Response::RespNotInRoom;
@@ -278,23 +319,16 @@ Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const
     GameEventStorage ges;
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.game_command_size() - 1; i >= 0; --i) {
+        Server_MetricsStopwatch commandTimer(metrics);
         const GameCommand &sc = cont.game_command(i);
         logDebugMessage(QString("game %1 player %2: ").arg(cont.game_id()).arg(roomIdAndPlayerId.second) +
                         getSafeDebugString(sc));
 
         if (commandCountingInterval > 0) {
-            int totalCount = 0;
-            if (commandCountOverTime.isEmpty()) {
-                commandCountOverTime.prepend(0);
-            }
-
-            if (!antifloodCommandsWhiteList.contains((GameCommand::GameCommandType)getPbExtension(sc))) {
-                ++commandCountOverTime[0];
-            }
-
-            for (int count : commandCountOverTime) {
-                totalCount += count;
-            }
+            commandCountOverTime.setSlotCount(countingSlots(commandCountingInterval));
+            const bool counted =
+                !antifloodCommandsWhiteList.contains((GameCommand::GameCommandType)getPbExtension(sc));
+            const int totalCount = commandCountOverTime.add(clockTime(), counted ? 1 : 0);
 
             if (maxCommandCountPerInterval > 0 && totalCount > maxCommandCountPerInterval) {
                 return Response::RespChatFlood;
@@ -302,6 +336,10 @@ Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const
         }
 
         Response::ResponseCode resp = participant->processGameCommand(sc, rc, ges);
+        if (metrics) {
+            metrics->observeCommand(Server_Metrics::GameCommandCategory, getPbExtension(sc),
+                                    commandTimer.elapsedMicroseconds());
+        }
 
         if (resp != Response::RespOk) {
             finalResponseCode = resp;
@@ -324,14 +362,19 @@ Response::ResponseCode Server_ProtocolHandler::processModeratorCommandContainer(
 
     resetIdleTimer();
 
+    Server_Metrics *metrics = server->getMetrics();
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.moderator_command_size() - 1; i >= 0; --i) {
+        Server_MetricsStopwatch commandTimer(metrics);
         Response::ResponseCode resp = Response::RespInvalidCommand;
         const ModeratorCommand &sc = cont.moderator_command(i);
         const int num = getPbExtension(sc);
         logDebugMessage(getSafeDebugString(sc));
 
         resp = processExtendedModeratorCommand(num, sc, rc);
+        if (metrics) {
+            metrics->observeCommand(Server_Metrics::ModeratorCommandCategory, num, commandTimer.elapsedMicroseconds());
+        }
         if (resp != Response::RespOk) {
             finalResponseCode = resp;
         }
@@ -351,14 +394,19 @@ Response::ResponseCode Server_ProtocolHandler::processAdminCommandContainer(cons
 
     resetIdleTimer();
 
+    Server_Metrics *metrics = server->getMetrics();
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.admin_command_size() - 1; i >= 0; --i) {
+        Server_MetricsStopwatch commandTimer(metrics);
         Response::ResponseCode resp = Response::RespInvalidCommand;
         const AdminCommand &sc = cont.admin_command(i);
         const int num = getPbExtension(sc);
         logDebugMessage(getSafeDebugString(sc));
 
         resp = processExtendedAdminCommand(num, sc, rc);
+        if (metrics) {
+            metrics->observeCommand(Server_Metrics::AdminCommandCategory, num, commandTimer.elapsedMicroseconds());
+        }
         if (resp != Response::RespOk) {
             finalResponseCode = resp;
         }
@@ -373,8 +421,10 @@ void Server_ProtocolHandler::processCommandContainer(const CommandContainer &con
         return;
     }
 
-    lastDataReceived = timeRunning;
+    lastDataReceived = clockTime();
 
+    Server_Metrics *metrics = server->getMetrics();
+    Server_MetricsStopwatch containerTimer(metrics);
     ResponseContainer responseContainer(cont.has_cmd_id() ? cont.cmd_id() : -1);
     Response::ResponseCode finalResponseCode;
 
@@ -395,56 +445,39 @@ void Server_ProtocolHandler::processCommandContainer(const CommandContainer &con
     if ((finalResponseCode != Response::RespNothing)) {
         sendResponseContainer(responseContainer, finalResponseCode);
     }
-}
-
-void Server_ProtocolHandler::pingClockTimeout()
-{
 
-    int cmdcountinterval = server->getCommandCountingInterval();
-    int msgcountinterval = server->getMessageCountingInterval();
-    int pingclockinterval = server->getClientKeepAlive();
-
-    int interval = server->getMessageCountingInterval();
-    if (interval > 0) {
-        if (pingclockinterval > 0) {
-            messageSizeOverTime.prepend(0);
-            if (messageSizeOverTime.size() > (msgcountinterval / pingclockinterval)) {
-                messageSizeOverTime.removeLast();
-            }
-            messageCountOverTime.prepend(0);
-            if (messageCountOverTime.size() > (msgcountinterval / pingclockinterval)) {
-                messageCountOverTime.removeLast();
-            }
-        }
+    if (metrics) {
+        metrics->addBusyTime(containerTimer.elapsedMicroseconds());
     }
+}
 
-    interval = server->getCommandCountingInterval();
-    if (interval > 0) {
-        if (pingclockinterval > 0) {
-            commandCountOverTime.prepend(0);
-            if (commandCountOverTime.size() > (cmdcountinterval / pingclockinterval)) {
-                commandCountOverTime.removeLast();
-            }
-        }
+void Server_ProtocolHandler::checkDeadlines()
+{
+    if (deleted) {
+        return;
     }
 
-    if (timeRunning - lastDataReceived > server->getMaxPlayerInactivityTime()) {
+    const int now = clockTime();
+    const int maxInactivityTime = server->getMaxPlayerInactivityTime();
+    if (now - lastDataReceived > maxInactivityTime) {
         prepareDestroy();
+        return;
     }
+    qint64 nextDeadline = qint64(lastDataReceived) + maxInactivityTime + 1;
 
     // PrivLevel users, Moderators, and Admins are not subject to the server idle timeout policy
     const bool hasPrivLevel = userInfo && QString::fromStdString(userInfo->privlevel()).toLower() != "none";
     const bool isModOrAdmin =
         userInfo && (userInfo->user_level() & (ServerInfo_User::IsModerator | ServerInfo_User::IsAdmin));
-    if (!hasPrivLevel && !isModOrAdmin) {
-        if ((server->getIdleClientTimeout() > 0) && (idleClientWarningSent)) {
-            if (timeRunning - lastActionReceived > server->getIdleClientTimeout()) {
-                prepareDestroy();
-            }
+    const int idleClientTimeout = server->getIdleClientTimeout();
+    if (!hasPrivLevel && !isModOrAdmin && idleClientTimeout > 0) {
+        if (idleClientWarningSent && now - lastActionReceived > idleClientTimeout) {
+            prepareDestroy();
+            return;
         }
 
-        if (((timeRunning - lastActionReceived) >= qCeil(server->getIdleClientTimeout() * .9)) &&
-            (!idleClientWarningSent) && (server->getIdleClientTimeout() > 0)) {
+        const int warningTime = qCeil(idleClientTimeout * .9);
+        if (!idleClientWarningSent && now - lastActionReceived >= warningTime) {
             Event_NotifyUser event;
             event.set_type(Event_NotifyUser::IDLEWARNING);
             SessionEvent *se = prepareSessionEvent(event);
@@ -452,9 +485,15 @@ void Server_ProtocolHandler::pingClockTimeout()
             delete se;
             idleClientWarningSent = true;
         }
+
+        if (idleClientWarningSent) {
+            nextDeadline = qMin(nextDeadline, qint64(lastActionReceived) + idleClientTimeout + 1);
+        } else {
+            nextDeadline = qMin(nextDeadline, qint64(lastActionReceived) + warningTime);
+        }
     }
 
-    ++timeRunning;
+    Server_TimerWheel::forCurrentThread()->schedule(deadlineTimer, nextDeadline * clockInterval);
 }
 
 Response::ResponseCode Server_ProtocolHandler::cmdPing(const Command_Ping & /*cmd*/, ResponseContainer & /*rc*/)
@@ -585,6 +624,10 @@ Response::ResponseCode Server_ProtocolHandler::cmdLogin(const Command_Login &cmd
         }
     }
 
+    for (const QString &feature : server->getServerRequiredFeatureList().keys()) {
+        re->add_server_features(feature.toStdString());
+    }
+
     joinPersistentGames(rc);
     databaseInterface->removeForgotPassword(userName);
     rc.setResponseExtension(re);
@@ -746,16 +789,8 @@ Response::ResponseCode Server_ProtocolHandler::cmdJoinRoom(const Command_JoinRoo
     room->addClient(this);
     rooms.insert(room->getId(), room);
 
-    QReadLocker chatHistoryLocker(&room->historyLock);
-    QList<ServerInfo_ChatMessage> chatHistory = room->getChatHistory();
-    ServerInfo_ChatMessage chatMessage;
-    for (int i = 0; i < chatHistory.size(); ++i) {
-        chatMessage = chatHistory.at(i);
-        Event_RoomSay roomChatHistory;
-        roomChatHistory.set_message(chatMessage.sender_name() + ": " + chatMessage.message());
-        roomChatHistory.set_message_type(Event_RoomSay::ChatHistory);
-        roomChatHistory.set_time_of(
-            QDateTime::fromString(QString::fromStdString(chatMessage.time())).toMSecsSinceEpoch());
+    const QList<Event_RoomSay> chatHistory = room->getChatHistoryEvents();
+    for (const Event_RoomSay &roomChatHistory : chatHistory) {
         rc.enqueuePostResponseItem(ServerMessage::ROOM_EVENT, room->prepareRoomEvent(roomChatHistory));
     }
 
@@ -777,20 +812,26 @@ Response::ResponseCode Server_ProtocolHandler::cmdListUsers(const Command_ListUs
         return Response::RespLoginNeeded;
     }
 
-    auto *re = new Response_ListUsers;
+    Server_Metrics *metrics = server->getMetrics();
+    Server_MetricsStopwatch lockTimer(metrics);
     server->clientsLock.lockForRead();
-    QMapIterator<QString, Server_ProtocolHandler *> userIterator = server->getUsers();
-    while (userIterator.hasNext()) {
-        re->add_user_list()->CopyFrom(userIterator.next().value()->copyUserInfo(false));
-    }
-    QMapIterator<QString, Server_AbstractUserInterface *> extIterator = server->getExternalUsers();
-    while (extIterator.hasNext()) {
-        re->add_user_list()->CopyFrom(extIterator.next().value()->copyUserInfo(false));
+    if (metrics) {
+        metrics->observeLockWait(Server_Metrics::ClientsLock, lockTimer.elapsedMicroseconds());
     }
-
+    // the snapshots are taken under clientsLock so no user list change can slip in before the flag is set
+    const auto userList = server->getUserListSnapshot();
+    const auto externalUserList = server->getExternalUserListSnapshot();
     acceptsUserListChanges = true;
     server->clientsLock.unlock();
 
+    auto *re = new Response_ListUsers;
+    for (const ServerInfo_User &user : userList->items) {
+        re->add_user_list()->CopyFrom(user);
+    }
+    for (const ServerInfo_User &user : externalUserList->items) {
+        re->add_user_list()->CopyFrom(user);
+    }
+
     rc.setResponseExtension(re);
     return Response::RespOk;
 }
@@ -809,24 +850,12 @@ bool Server_ProtocolHandler::addSaidMessageSize(int size)
         return true;
     }
 
-    int totalSize = 0, totalCount = 0;
-    if (messageSizeOverTime.isEmpty()) {
-        messageSizeOverTime.prepend(0);
-    }
-
-    messageSizeOverTime[0] += size;
-    for (int messageSize : messageSizeOverTime) {
-        totalSize += messageSize;
-    }
-
-    if (messageCountOverTime.isEmpty()) {
-        messageCountOverTime.prepend(0);
-    }
-
-    messageCountOverTime[0] += 1;
-    for (int messageCount : messageCountOverTime) {
-        totalCount += messageCount;
-    }
+    const int slotCount = countingSlots(server->getMessageCountingInterval());
+    messageSizeOverTime.setSlotCount(slotCount);
+    messageCountOverTime.setSlotCount(slotCount);
+    const int now = clockTime();
+    const int totalSize = messageSizeOverTime.add(now, size);
+    const int totalCount = messageCountOverTime.add(now, 1);
 
     return totalSize <= server->getMaxMessageSizePerInterval() && totalCount <= server->getMaxMessageCountPerInterval();
 }
@@ -917,6 +946,6 @@ Server_ProtocolHandler::cmdJoinGame(const Command_JoinGame &cmd, Server_Room *ro
 
 void Server_ProtocolHandler::resetIdleTimer()
 {
-    lastActionReceived = timeRunning;
+    lastActionReceived = clockTime();
     idleClientWarningSent = false;
 }
@@ -3,6 +3,8 @@
 
 #include "server.h"
 #include "server_abstractuserinterface.h"
+#include "server_ring_counter.h"
+#include "server_timer_wheel.h"
 
 #include <QObject>
 #include <libcockatrice/protocol/pb/response.pb.h>
@@ -60,8 +62,21 @@ protected:
     }
 
 private:
-    QList<int> messageSizeOverTime, messageCountOverTime, commandCountOverTime;
-    int timeRunning, lastDataReceived, lastActionReceived;
+    Server_RingCounter messageSizeOverTime, messageCountOverTime, commandCountOverTime;
+    int clockInterval;
+    int lastDataReceived, lastActionReceived;
+    /**
+     * Fires at the next inactivity or idle deadline of the connection. Data arriving in between does not touch it,
+     * the deadlines are checked again and pushed back when it fires.
+     */
+    Server_TimerWheel::Timer deadlineTimer;
+
+    /**
+     * @return the time in keepalive intervals, the unit of all inactivity and flood settings
+     */
+    int clockTime() const;
+    int countingSlots(int interval) const;
+    void checkDeadlines();
 
     virtual void transmitProtocolItem(const ServerMessage &item) = 0;
 
@@ -100,8 +115,6 @@ private:
     }
 
     void resetIdleTimer();
-private slots:
-    void pingClockTimeout();
 public slots:
     void prepareDestroy();
 
@@ -126,7 +139,7 @@ public:
 
     int getLastCommandTime() const
     {
-        return timeRunning - lastDataReceived;
+        return clockTime() - lastDataReceived;
     }
     bool addSaidMessageSize(int size);
     void processCommandContainer(const CommandContainer &cont);
@@ -0,0 +1,79 @@
+#ifndef SERVER_RING_COUNTER_H
+#define SERVER_RING_COUNTER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Sum of the amounts added during the last few time slots, used for the flood limits of a connection.
+ *
+ * The slots form a fixed ring indexed by the time they are added at, so the window moves forward lazily when the
+ * counter is used and nothing has to happen while the connection is quiet. Not thread safe.
+ */
+class Server_RingCounter
+{
+public:
+    explicit Server_RingCounter(int slotCount = 1) : counts(qMax(1, slotCount), 0)
+    {
+    }
+
+    /**
+     * Changes the length of the window, dropping what was counted so far if it differs from the current one.
+     */
+    void setSlotCount(int slotCount)
+    {
+        slotCount = qMax(1, slotCount);
+        if (slotCount != counts.size()) {
+            counts = QVector<int>(slotCount, 0);
+            head = 0;
+            sum = 0;
+        }
+    }
+
+    /**
+     * Adds the amount to the slot of the given time.
+     * @return the total of the window ending at that time
+     */
+    int add(qint64 time, int amount)
+    {
+        advanceTo(time);
+        counts[head] += amount;
+        sum += amount;
+        return sum;
+    }
+
+    /**
+     * @return the total of the window ending at the given time
+     */
+    int total(qint64 time)
+    {
+        advanceTo(time);
+        return sum;
+    }
+
+private:
+    QVector<int> counts;
+    qint64 headTime = 0;
+    int head = 0;
+    int sum = 0;
+
+    void advanceTo(qint64 time)
+    {
+        if (time <= headTime) {
+            return;
+        }
+        if (time - headTime >= counts.size()) {
+            counts.fill(0);
+            sum = 0;
+        } else {
+            for (qint64 slot = headTime; slot < time; ++slot) {
+                head = (head + 1) % counts.size();
+                sum -= counts[head];
+                counts[head] = 0;
+            }
+        }
+        headTime = time;
+    }
+};
+
+#endif
@@ -93,13 +93,15 @@ Server_Room::getInfo(ServerInfo_Room &result, bool complete, bool showGameTypes,
     result.set_permissionlevel(permissionLevel.toStdString());
     result.set_privilegelevel(privilegeLevel.toStdString());
 
+    if (complete) {
+        for (const ServerInfo_Game &gameInfo : gameListSnapshot.get()->items) {
+            result.add_game_list()->CopyFrom(gameInfo);
+        }
+    }
+
     gamesLock.lockForRead();
     result.set_game_count(games.size() + externalGames.size());
     if (complete) {
-        QMapIterator<int, Server_Game *> gameIterator(games);
-        while (gameIterator.hasNext()) {
-            gameIterator.next().value()->getInfo(*result.add_game_list());
-        }
         if (includeExternalData) {
             QMapIterator<int, ServerInfo_Game> externalGameIterator(externalGames);
             while (externalGameIterator.hasNext()) {
@@ -109,13 +111,15 @@ Server_Room::getInfo(ServerInfo_Room &result, bool complete, bool showGameTypes,
     }
     gamesLock.unlock();
 
+    if (complete) {
+        for (const ServerInfo_User &userInfo : userListSnapshot.get()->items) {
+            result.add_user_list()->CopyFrom(userInfo);
+        }
+    }
+
     usersLock.lockForRead();
     result.set_player_count(users.size() + externalUsers.size());
     if (complete) {
-        QMapIterator<QString, Server_ProtocolHandler *> userIterator(users);
-        while (userIterator.hasNext()) {
-            result.add_user_list()->CopyFrom(userIterator.next().value()->copyUserInfo(false));
-        }
         if (includeExternalData) {
             QMapIterator<QString, ServerInfo_User_Container> externalUserIterator(externalUsers);
             while (externalUserIterator.hasNext()) {
@@ -155,8 +159,10 @@ void Server_Room::addClient(Server_ProtocolHandler *client)
     ServerInfo_Room roomInfo;
     roomInfo.set_room_id(id);
 
+    const QString userName = QString::fromStdString(client->getUserInfo()->name());
     usersLock.lockForWrite();
-    users.insert(QString::fromStdString(client->getUserInfo()->name()), client);
+    users.insert(userName, client);
+    userListSnapshot.insert(userName, event.user_info());
     roomInfo.set_player_count(users.size() + externalUsers.size());
     usersLock.unlock();
 
@@ -171,8 +177,10 @@ void Server_Room::addClient(Server_ProtocolHandler *client)
 
 void Server_Room::removeClient(Server_ProtocolHandler *client)
 {
+    const QString userName = QString::fromStdString(client->getUserInfo()->name());
     usersLock.lockForWrite();
-    users.remove(QString::fromStdString(client->getUserInfo()->name()));
+    users.remove(userName);
+    userListSnapshot.remove(userName);
 
     ServerInfo_Room roomInfo;
     roomInfo.set_room_id(id);
@@ -192,6 +200,11 @@ void Server_Room::removeClient(Server_ProtocolHandler *client)
     emit roomInfoChanged(roomInfo);
 }
 
+void Server_Room::updateClientInfo(Server_ProtocolHandler *client)
+{
+    userListSnapshot.update(QString::fromStdString(client->getUserInfo()->name()), client->copyUserInfo(false));
+}
+
 void Server_Room::addExternalUser(const ServerInfo_User &userInfo)
 {
     // This function is always called from the Server thread with server->roomsMutex locked.
@@ -306,12 +319,19 @@ void Server_Room::say(const QString &userName, const QString &userMessage, bool
         chatMessage.set_sender_name(userName.toStdString());
         chatMessage.set_message(userMessage.simplified().toStdString());
 
+        Event_RoomSay historyEvent;
+        historyEvent.set_message(chatMessage.sender_name() + ": " + chatMessage.message());
+        historyEvent.set_message_type(Event_RoomSay::ChatHistory);
+        historyEvent.set_time_of(dateTime.toMSecsSinceEpoch());
+
         historyLock.lockForWrite();
         if (chatHistory.size() >= chatHistorySize) {
             chatHistory.removeAt(0);
+            chatHistoryEvents.removeAt(0);
         }
 
         chatHistory.push_back(std::move(chatMessage));
+        chatHistoryEvents.push_back(std::move(historyEvent));
         historyLock.unlock();
     }
 }
@@ -328,9 +348,11 @@ void Server_Room::removeSaidMessages(const QString &userName, int amount, bool s
         int removed = 0;
         historyLock.lockForWrite();
         // redact [amount] of the most recent messages from this user from history
-        for (auto message = chatHistory.rbegin(); message != chatHistory.rend() && removed != amount; ++message) {
-            if (message->sender_name() == stdStringUserName) {
-                message->clear_message();
+        for (int i = chatHistory.size() - 1; i >= 0 && removed != amount; --i) {
+            ServerInfo_ChatMessage &message = chatHistory[i];
+            if (message.sender_name() == stdStringUserName) {
+                message.clear_message();
+                chatHistoryEvents[i].set_message(stdStringUserName + ": ");
                 ++removed;
             }
         }
@@ -338,6 +360,13 @@ void Server_Room::removeSaidMessages(const QString &userName, int amount, bool s
     }
 }
 
+QList<Event_RoomSay> Server_Room::getChatHistoryEvents() const
+{
+    // implicitly shared, the copy is cheap and detaches only when the history changes afterwards
+    QReadLocker locker(&historyLock);
+    return chatHistoryEvents;
+}
+
 void Server_Room::sendRoomEvent(RoomEvent *event, bool sendToIsl)
 {
     usersLock.lockForRead();
@@ -356,6 +385,12 @@ void Server_Room::sendRoomEvent(RoomEvent *event, bool sendToIsl)
     delete event;
 }
 
+void Server_Room::updateGameListSnapshot(const ServerInfo_Game &gameInfo)
+{
+    // Server_Game only sends the changed fields
+    gameListSnapshot.merge(gameInfo.game_id(), gameInfo);
+}
+
 void Server_Room::broadcastGameListUpdate(const ServerInfo_Game &gameInfo, bool sendToIsl)
 {
     Event_ListGames event;
@@ -369,12 +404,16 @@ void Server_Room::addGame(Server_Game *game)
     roomInfo.set_room_id(id);
 
     gamesLock.lockForWrite();
-    connect(game, &Server_Game::gameInfoChanged, this, [this](auto gameInfo) { broadcastGameListUpdate(gameInfo); });
+    connect(game, &Server_Game::gameInfoChanged, this, [this](auto gameInfo) {
+        updateGameListSnapshot(gameInfo);
+        broadcastGameListUpdate(gameInfo);
+    });
 
     game->gameMutex.lock();
     games.insert(game->getGameId(), game);
     ServerInfo_Game gameInfo;
     game->getInfo(gameInfo);
+    gameListSnapshot.insert(game->getGameId(), gameInfo);
     roomInfo.set_game_count(games.size() + externalGames.size());
     game->gameMutex.unlock();
     gamesLock.unlock();
@@ -401,6 +440,7 @@ void Server_Room::removeGame(Server_Game *game)
     emit gameListChanged(gameInfo);
 
     games.remove(game->getGameId());
+    gameListSnapshot.remove(game->getGameId());
 
     ServerInfo_Room roomInfo;
     roomInfo.set_room_id(id);
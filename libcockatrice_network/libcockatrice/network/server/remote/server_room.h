@@ -1,21 +1,23 @@
 #ifndef SERVER_ROOM_H
 #define SERVER_ROOM_H
 
+#include "server_list_snapshot.h"
 #include "serverinfo_user_container.h"
 
 #include <QMap>
 #include <QMutex>
 #include <QObject>
 #include <QReadWriteLock>
+#include <libcockatrice/protocol/pb/event_room_say.pb.h>
 #include <libcockatrice/protocol/pb/response.pb.h>
 #include <libcockatrice/protocol/pb/serverinfo_chat_message.pb.h>
+#include <libcockatrice/protocol/pb/serverinfo_game.pb.h>
+#include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
 
 class Server_DatabaseInterface;
 class Server_ProtocolHandler;
 class RoomEvent;
-class ServerInfo_User;
 class ServerInfo_Room;
-class ServerInfo_Game;
 class Server_Game;
 class Server;
 
@@ -45,6 +47,11 @@ private:
     QMap<QString, Server_ProtocolHandler *> users;
     QMap<QString, ServerInfo_User_Container> externalUsers;
     QList<ServerInfo_ChatMessage> chatHistory;
+    // chat history as sent to joining users, kept in step with chatHistory
+    QList<Event_RoomSay> chatHistoryEvents;
+    Server_ListSnapshot<int, ServerInfo_Game> gameListSnapshot;
+    Server_ListSnapshot<QString, ServerInfo_User> userListSnapshot;
+    void updateGameListSnapshot(const ServerInfo_Game &gameInfo);
 private slots:
     void broadcastGameListUpdate(const ServerInfo_Game &gameInfo, bool sendToIsl = true);
 
@@ -113,9 +120,14 @@ public:
     {
         return chatHistory;
     }
+    /**
+     * Returns the chat history ready to be sent to a joining user. Locks historyLock.
+     */
+    QList<Event_RoomSay> getChatHistoryEvents() const;
 
     void addClient(Server_ProtocolHandler *client);
     void removeClient(Server_ProtocolHandler *client);
+    void updateClientInfo(Server_ProtocolHandler *client);
 
     void addExternalUser(const ServerInfo_User &userInfo);
     void removeExternalUser(const QString &_name);
@@ -0,0 +1,194 @@
+#include "server_timer_wheel.h"
+
+#include <QThread>
+#include <QTimer>
+#include <chrono>
+
+void Server_TimerWheel::Timer::cancel()
+{
+    if (owner) {
+        owner->cancel(*this);
+    }
+}
+
+bool Server_TimerWheel::Timer::isScheduled() const
+{
+    if (!owner) {
+        return false;
+    }
+    QMutexLocker locker(&owner->mutex);
+    return linked;
+}
+
+Server_TimerWheel::Server_TimerWheel(qint64 startTime) : currentTime(startTime)
+{
+}
+
+Server_TimerWheel::~Server_TimerWheel()
+{
+    QMutexLocker locker(&mutex);
+    for (auto &level : buckets) {
+        for (Timer *&head : level) {
+            while (head) {
+                Timer *timer = head;
+                head = timer->next;
+                timer->linked = false;
+                timer->owner = nullptr;
+                timer->prev = timer->next = nullptr;
+            }
+        }
+    }
+}
+
+void Server_TimerWheel::schedule(Timer &timer, qint64 expiry)
+{
+    QMutexLocker locker(&mutex);
+    Q_ASSERT(!timer.owner || timer.owner == this);
+    timer.owner = this;
+    if (timer.linked) {
+        unlink(timer);
+    }
+    timer.expiry = qMax(expiry, currentTime + 1);
+    link(timer);
+}
+
+void Server_TimerWheel::cancel(Timer &timer)
+{
+    QMutexLocker locker(&mutex);
+    while (firing == &timer && firingThread != QThread::currentThread()) {
+        firingDone.wait(&mutex);
+    }
+    if (timer.linked) {
+        unlink(timer);
+    }
+}
+
+void Server_TimerWheel::link(Timer &timer)
+{
+    // the level is picked by how far away the timer is, the slot by the bits of its expiry at that level
+    const qint64 delay = qBound<qint64>(0, timer.expiry - currentTime, MaxDelay);
+    const qint64 placement = currentTime + delay;
+    int level = 0;
+    while (level < LevelCount - 1 && delay >= (qint64(1) << (SlotBits * (level + 1)))) {
+        ++level;
+    }
+    timer.level = level;
+    timer.slot = static_cast<int>((placement >> (SlotBits * level)) & (SlotCount - 1));
+
+    Timer *&head = buckets[timer.level][timer.slot];
+    timer.prev = nullptr;
+    timer.next = head;
+    if (head) {
+        head->prev = &timer;
+    }
+    head = &timer;
+    timer.linked = true;
+    ++levelCounts[timer.level];
+    ++timerCount;
+}
+
+void Server_TimerWheel::unlink(Timer &timer)
+{
+    if (timer.prev) {
+        timer.prev->next = timer.next;
+    } else {
+        buckets[timer.level][timer.slot] = timer.next;
+    }
+    if (timer.next) {
+        timer.next->prev = timer.prev;
+    }
+    timer.prev = timer.next = nullptr;
+    timer.linked = false;
+    --levelCounts[timer.level];
+    --timerCount;
+}
+
+void Server_TimerWheel::cascade(int level)
+{
+    const int slot = static_cast<int>((currentTime >> (SlotBits * level)) & (SlotCount - 1));
+    Timer *timer = buckets[level][slot];
+    buckets[level][slot] = nullptr;
+    while (timer) {
+        Timer *next = timer->next;
+        --levelCounts[level];
+        --timerCount;
+        link(*timer);
+        timer = next;
+    }
+}
+
+void Server_TimerWheel::advanceTo(qint64 time)
+{
+    QMutexLocker locker(&mutex);
+    while (currentTime < time) {
+        if (timerCount == 0) {
+            currentTime = time;
+            break;
+        }
+
+        // nothing can fire before the next cascade of the lowest level holding timers, so skip ahead to it
+        int emptyLevels = 0;
+        while (emptyLevels < LevelCount - 1 && levelCounts[emptyLevels] == 0) {
+            ++emptyLevels;
+        }
+        if (emptyLevels > 0) {
+            const int bits = SlotBits * emptyLevels;
+            const qint64 beforeCascade = (((currentTime >> bits) + 1) << bits) - 1;
+            if (beforeCascade >= time) {
+                currentTime = time;
+                break;
+            }
+            currentTime = beforeCascade;
+        }
+
+        ++currentTime;
+        for (int level = 1; level < LevelCount; ++level) {
+            if ((currentTime & ((qint64(1) << (SlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        // the callbacks run unlocked and may schedule or cancel any timer, so the slot is emptied one by one
+        Timer *&head = buckets[0][currentTime & (SlotCount - 1)];
+        while (head) {
+            Timer *timer = head;
+            unlink(*timer);
+            if (!timer->callback) {
+                continue;
+            }
+            firing = timer;
+            firingThread = QThread::currentThread();
+            locker.unlock();
+            timer->callback();
+            locker.relock();
+            firing = nullptr;
+            firingThread = nullptr;
+            firingDone.wakeAll();
+        }
+    }
+}
+
+qint64 Server_TimerWheel::clockSeconds()
+{
+    using namespace std::chrono;
+    static const auto epoch = steady_clock::now();
+    return duration_cast<seconds>(steady_clock::now() - epoch).count();
+}
+
+Server_TimerWheel *Server_TimerWheel::forCurrentThread()
+{
+    // Never deleted: timers of objects outliving their thread, such as games destroyed at shutdown, can still cancel.
+    thread_local Server_TimerWheel *wheel = nullptr;
+    if (wheel) {
+        return wheel;
+    }
+
+    wheel = new Server_TimerWheel(clockSeconds());
+    auto *clock = new QTimer;
+    clock->setTimerType(Qt::CoarseTimer);
+    QObject::connect(clock, &QTimer::timeout, clock, [target = wheel] { target->advanceTo(clockSeconds()); });
+    QObject::connect(QThread::currentThread(), &QThread::finished, clock, &QObject::deleteLater);
+    clock->start(1000);
+    return wheel;
+}
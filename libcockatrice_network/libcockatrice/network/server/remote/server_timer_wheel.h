@@ -0,0 +1,124 @@
+#ifndef SERVER_TIMER_WHEEL_H
+#define SERVER_TIMER_WHEEL_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+
+class QThread;
+
+/**
+ * Hierarchical timer wheel with a resolution of one second, holding the deadlines of the connections and games of a
+ * thread. Scheduling and cancelling a timer take constant time, and advancing the wheel only touches the timers that
+ * are due, so thousands of idle connections cost nothing until one of their deadlines comes up.
+ *
+ * Every thread gets a wheel of its own from forCurrentThread(), driven by a single timer of that thread's event loop.
+ * Timers are scheduled, cancelled and fired under the wheel's lock, callbacks run in the thread advancing the wheel.
+ */
+class Server_TimerWheel
+{
+public:
+    static constexpr int SlotBits = 6;
+    static constexpr int SlotCount = 1 << SlotBits;
+    static constexpr int LevelCount = 4;
+    /** Timers further out than this are parked at the top level and placed again when they come closer. */
+    static constexpr qint64 MaxDelay = (qint64(1) << (SlotBits * LevelCount)) - 1;
+
+    /**
+     * A deadline on a wheel. The timer belongs to the wheel it was first scheduled on and is cancelled when it is
+     * destroyed. It must not be destroyed from its own callback.
+     */
+    class Timer
+    {
+    public:
+        explicit Timer(std::function<void()> _callback = {}) : callback(std::move(_callback))
+        {
+        }
+        ~Timer()
+        {
+            cancel();
+        }
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        void setCallback(std::function<void()> _callback)
+        {
+            callback = std::move(_callback);
+        }
+        void cancel();
+        bool isScheduled() const;
+        qint64 getExpiry() const
+        {
+            return expiry;
+        }
+
+    private:
+        friend class Server_TimerWheel;
+        std::function<void()> callback;
+        Server_TimerWheel *owner = nullptr;
+        bool linked = false;
+        qint64 expiry = 0;
+        int level = 0, slot = 0;
+        Timer *prev = nullptr, *next = nullptr;
+    };
+
+    explicit Server_TimerWheel(qint64 startTime = 0);
+    ~Server_TimerWheel();
+    Server_TimerWheel(const Server_TimerWheel &) = delete;
+    Server_TimerWheel &operator=(const Server_TimerWheel &) = delete;
+
+    /**
+     * (Re)schedules the timer to fire once the wheel reaches the given time. Times that are not in the future fire
+     * on the next tick.
+     */
+    void schedule(Timer &timer, qint64 expiry);
+    void scheduleIn(Timer &timer, qint64 delay)
+    {
+        schedule(timer, now() + delay);
+    }
+    /**
+     * Takes the timer off the wheel. If its callback is running in another thread, waits for it to return.
+     */
+    void cancel(Timer &timer);
+
+    /**
+     * Moves the wheel forward to the given time, firing every timer that is due on the way.
+     */
+    void advanceTo(qint64 time);
+    qint64 now() const
+    {
+        return currentTime;
+    }
+    int size() const
+    {
+        return timerCount;
+    }
+
+    /**
+     * @return the seconds of a monotonic clock shared by all wheels
+     */
+    static qint64 clockSeconds();
+    /**
+     * @return the wheel of the calling thread, which is created and started on first use. The thread has to run an
+     * event loop.
+     */
+    static Server_TimerWheel *forCurrentThread();
+
+private:
+    mutable QMutex mutex;
+    QWaitCondition firingDone;
+    Timer *buckets[LevelCount][SlotCount] = {};
+    int levelCounts[LevelCount] = {};
+    std::atomic<qint64> currentTime;
+    std::atomic<int> timerCount = 0;
+    Timer *firing = nullptr;
+    QThread *firingThread = nullptr;
+
+    void link(Timer &timer);
+    void unlink(Timer &timer);
+    void cascade(int level);
+};
+
+#endif
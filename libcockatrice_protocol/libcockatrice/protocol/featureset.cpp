@@ -25,6 +25,7 @@ void FeatureSet::initalizeFeatureList(QMap<QString, bool> &_featureList)
     _featureList.insert("idle_client", false);
     _featureList.insert("forgot_password", false);
     _featureList.insert("websocket", false);
+    _featureList.insert("replay_list_paging", false);
     // featureList.insert("hashed_password_login", false);
     // These are temp to force users onto a newer client
     _featureList.insert("2.7.0_min_version", false);
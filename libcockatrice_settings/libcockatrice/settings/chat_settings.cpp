@@ -134,4 +134,5 @@ void ChatSettings::setRoomHistory(bool _roomHistory)
 void ChatSettings::setHighlightWords(const QString &_highlightWords)
 {
     setValue(_highlightWords, "highlightwords");
+    emit highlightWordsChanged();
 }
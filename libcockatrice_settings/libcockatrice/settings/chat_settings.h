@@ -41,6 +41,7 @@ public:
 
 signals:
     void chatMentionCompleterChanged();
+    void highlightWordsChanged();
 
 public:
     explicit ChatSettings(const QString &settingPath, QObject *parent = nullptr);
@@ -0,0 +1,177 @@
+#include "download_scheduler.h"
+
+#include <QSet>
+
+DownloadScheduler::Bucket DownloadScheduler::makeBucket(HostLimit limit, qint64 now)
+{
+    const qint64 interval = qRound64(1000000.0 / limit.requestsPerSecond);
+    return {interval, interval * limit.burst, now * 1000};
+}
+
+void DownloadScheduler::setHostLimit(const QString &host, HostLimit limit)
+{
+    hostLimits.insert(host, limit);
+    auto it = buckets.find(host);
+    if (it != buckets.end()) {
+        const Bucket updated = makeBucket(limit, 0);
+        it->intervalUsecs = updated.intervalUsecs;
+        it->burstUsecs = updated.burstUsecs;
+    }
+}
+
+DownloadScheduler::Bucket &DownloadScheduler::bucket(const QString &host, qint64 now)
+{
+    auto it = buckets.find(host);
+    if (it == buckets.end()) {
+        it = buckets.insert(host, makeBucket(hostLimits.value(host, defaultLimit), now));
+    }
+    return *it;
+}
+
+bool DownloadScheduler::request(const QUrl &url, quintptr consumer, qint64 now)
+{
+    if (consumerUrls.value(consumer) == url) {
+        touch(consumer, now);
+        return false;
+    }
+
+    detach(consumer);
+    consumerUrls.insert(consumer, url);
+
+    auto runningIt = running.find(url);
+    if (runningIt != running.end()) {
+        runningIt->append(consumer);
+        return false;
+    }
+
+    auto queued = queue.find(url);
+    if (queued != queue.end()) {
+        queued->consumers.append(consumer);
+        queued->lastSeen = std::max(queued->lastSeen, now);
+        return false;
+    }
+
+    queue.insert(url, {{consumer}, nextSequence++, now});
+    return true;
+}
+
+void DownloadScheduler::touch(quintptr consumer, qint64 now)
+{
+    auto it = queue.find(consumerUrls.value(consumer));
+    if (it != queue.end()) {
+        it->lastSeen = std::max(it->lastSeen, now);
+    }
+}
+
+QUrl DownloadScheduler::cancel(quintptr consumer)
+{
+    return detach(consumer);
+}
+
+QUrl DownloadScheduler::detach(quintptr consumer)
+{
+    const auto url = consumerUrls.find(consumer);
+    if (url == consumerUrls.end()) {
+        return {};
+    }
+
+    auto runningIt = running.find(*url);
+    if (runningIt != running.end()) {
+        runningIt->removeAll(consumer);
+    }
+    QUrl dropped;
+    auto queued = queue.find(*url);
+    if (queued != queue.end()) {
+        queued->consumers.removeAll(consumer);
+        if (queued->consumers.isEmpty()) {
+            dropped = queued.key();
+            queue.erase(queued);
+        }
+    }
+    consumerUrls.erase(url);
+    return dropped;
+}
+
+QList<quintptr> DownloadScheduler::queuedConsumers(qint64 notSeenSince) const
+{
+    QList<quintptr> result;
+    for (const Entry &entry : queue) {
+        if (entry.lastSeen < notSeenSince) {
+            result.append(entry.consumers);
+        }
+    }
+    return result;
+}
+
+std::optional<DownloadScheduler::Download> DownloadScheduler::takeNext(qint64 now)
+{
+    QSet<QString> exhaustedHosts;
+    auto best = queue.end();
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (best != queue.end()) {
+            const qint64 period = it->lastSeen / priorityPeriodMsecs;
+            const qint64 bestPeriod = best->lastSeen / priorityPeriodMsecs;
+            if (period < bestPeriod || (period == bestPeriod && it->sequence > best->sequence)) {
+                continue;
+            }
+        }
+
+        const QString host = it.key().host();
+        if (exhaustedHosts.contains(host)) {
+            continue;
+        }
+        if (bucket(host, now).usecsUntilToken(now) > 0) {
+            exhaustedHosts.insert(host);
+            continue;
+        }
+        best = it;
+    }
+
+    if (best == queue.end()) {
+        return std::nullopt;
+    }
+
+    Bucket &hostBucket = bucket(best.key().host(), now);
+    hostBucket.fullAtUsecs = std::max(hostBucket.fullAtUsecs, now * 1000) + hostBucket.intervalUsecs;
+
+    const QUrl url = best.key();
+    QList<quintptr> consumers = best->consumers;
+    queue.erase(best);
+
+    const quintptr consumer = consumers.takeFirst();
+    consumerUrls.remove(consumer);
+    running.insert(url, consumers);
+    return Download{url, consumer};
+}
+
+qint64 DownloadScheduler::msecsUntilNext(qint64 now) const
+{
+    qint64 result = -1;
+    QSet<QString> seenHosts;
+    for (auto it = queue.constBegin(); it != queue.constEnd(); ++it) {
+        const QString host = it.key().host();
+        if (seenHosts.contains(host)) {
+            continue;
+        }
+        seenHosts.insert(host);
+
+        const auto hostBucket = buckets.constFind(host);
+        if (hostBucket == buckets.constEnd()) {
+            return 0;
+        }
+        const qint64 wait = (hostBucket->usecsUntilToken(now) + 999) / 1000;
+        if (result < 0 || wait < result) {
+            result = wait;
+        }
+    }
+    return result;
+}
+
+QList<quintptr> DownloadScheduler::finish(const QUrl &url)
+{
+    const QList<quintptr> consumers = running.take(url);
+    for (const quintptr consumer : consumers) {
+        consumerUrls.remove(consumer);
+    }
+    return consumers;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file download_scheduler.h
+ * @ingroup Core
+ * @brief Decides which queued download to start next, and when.
+ */
+
+#ifndef DOWNLOAD_SCHEDULER_H
+#define DOWNLOAD_SCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QUrl>
+#include <algorithm>
+#include <optional>
+
+/**
+ * Orders pending downloads by how recently their consumers were seen and paces them with a token bucket per host.
+ *
+ * A consumer is whatever waits for a download, identified by an opaque id, and waits for one url at a time. Consumers
+ * asking for a url that is already queued or being downloaded are attached to it instead of queueing it again. The
+ * scheduler does not do any network access nor read a clock itself: the caller passes the current time in
+ * milliseconds, starts the downloads handed out by takeNext() and reports them back with finish().
+ *
+ * Downloads whose consumers were seen in the same period of priorityPeriodMsecs are started in the order they were
+ * requested, and periods seen later come first. Seeing a consumer again (for example because the widget that shows the
+ * image is painted) moves its download up, while consumers that are no longer seen sink below everything that is.
+ */
+class DownloadScheduler
+{
+public:
+    /**
+     * A host gets requestsPerSecond tokens per second, at most burst of them are saved up while it is idle.
+     */
+    struct HostLimit
+    {
+        double requestsPerSecond;
+        int burst;
+    };
+
+    struct Download
+    {
+        QUrl url;
+        quintptr consumer;
+    };
+
+    static constexpr qint64 priorityPeriodMsecs = 1000;
+
+    explicit DownloadScheduler(HostLimit _defaultLimit) : defaultLimit(_defaultLimit)
+    {
+    }
+
+    /**
+     * Overrides the rate limit for one host, the default limit applies to every other host separately.
+     */
+    void setHostLimit(const QString &host, HostLimit limit);
+
+    /**
+     * Makes the consumer wait for the url, detaching it from the url it waited for before.
+     * @return false if the url was already queued or being downloaded and the consumer was attached to it.
+     */
+    bool request(const QUrl &url, quintptr consumer, qint64 now);
+
+    /**
+     * Marks the consumer as seen, which raises the priority of the download it waits for.
+     */
+    void touch(quintptr consumer, qint64 now);
+
+    /**
+     * Detaches the consumer. A queued download without consumers is dropped, one that was started is not.
+     * @return The url of the queued download that was dropped because of it, empty if none was.
+     */
+    QUrl cancel(quintptr consumer);
+
+    [[nodiscard]] bool isWaiting(quintptr consumer) const
+    {
+        return consumerUrls.contains(consumer);
+    }
+
+    /**
+     * @return Ids of the consumers of queued downloads that were last seen before the given time.
+     */
+    [[nodiscard]] QList<quintptr> queuedConsumers(qint64 notSeenSince) const;
+
+    /**
+     * Takes the most important queued download whose host has a token left and marks it as started. The first consumer
+     * that asked for the url is returned with it and detached; the others stay attached until finish().
+     */
+    std::optional<Download> takeNext(qint64 now);
+
+    /**
+     * @return Milliseconds until takeNext() can hand out a download, -1 if nothing is queued.
+     */
+    [[nodiscard]] qint64 msecsUntilNext(qint64 now) const;
+
+    /**
+     * Marks a started download as finished.
+     * @return The consumers that were attached to the url while it was downloading, they are detached.
+     */
+    QList<quintptr> finish(const QUrl &url);
+
+    [[nodiscard]] int queuedCount() const
+    {
+        return static_cast<int>(queue.size());
+    }
+    [[nodiscard]] int runningCount() const
+    {
+        return static_cast<int>(running.size());
+    }
+
+private:
+    struct Entry
+    {
+        QList<quintptr> consumers;
+        quint64 sequence = 0;
+        qint64 lastSeen = 0;
+    };
+
+    /**
+     * Token bucket kept as the time at which it is full again, in microseconds, so that refilling is exact instead of
+     * adding up fractions of tokens.
+     */
+    struct Bucket
+    {
+        qint64 intervalUsecs;
+        qint64 burstUsecs;
+        qint64 fullAtUsecs;
+
+        [[nodiscard]] qint64 usecsUntilToken(qint64 now) const
+        {
+            return std::max<qint64>(0, fullAtUsecs - burstUsecs + intervalUsecs - now * 1000);
+        }
+    };
+
+    HostLimit defaultLimit;
+    QHash<QString, HostLimit> hostLimits;
+    QHash<QString, Bucket> buckets;
+    QHash<QUrl, Entry> queue;
+    QHash<QUrl, QList<quintptr>> running;
+    QHash<quintptr, QUrl> consumerUrls;
+    quint64 nextSequence = 0;
+
+    Bucket &bucket(const QString &host, qint64 now);
+    static Bucket makeBucket(HostLimit limit, qint64 now);
+    QUrl detach(quintptr consumer);
+};
+
+#endif // DOWNLOAD_SCHEDULER_H
@@ -0,0 +1,128 @@
+#include "text_pattern_matcher.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+
+static char16_t foldCase(QChar c)
+{
+    return c.toCaseFolded().unicode();
+}
+
+void TextPatternMatcher::addPattern(const QString &pattern, int tag)
+{
+    if (pattern.isEmpty()) {
+        return;
+    }
+
+    int node = 0;
+    for (const QChar c : pattern) {
+        const char16_t character = foldCase(c);
+        const auto edge = edges.constFind(edgeKey(node, character));
+        if (edge != edges.constEnd()) {
+            node = *edge;
+            continue;
+        }
+
+        const int child = static_cast<int>(nodes.size());
+        Node childNode;
+        childNode.character = character;
+        nodes.append(childNode);
+        nodes[node].children.append(child);
+        edges.insert(edgeKey(node, character), child);
+        node = child;
+    }
+
+    if (nodes[node].patternLength == 0) {
+        nodes[node].patternLength = static_cast<int>(pattern.size());
+        nodes[node].tag = tag;
+    }
+}
+
+void TextPatternMatcher::build()
+{
+    // breadth first, so the fail links of all shallower nodes are known when a node is reached
+    QList<int> queue = nodes[0].children;
+    for (qsizetype i = 0; i < queue.size(); ++i) {
+        const int node = queue[i];
+        for (const int child : nodes[node].children) {
+            const int fail = step(nodes[node].fail, nodes[child].character);
+            nodes[child].fail = fail;
+            nodes[child].output = nodes[fail].patternLength ? fail : nodes[fail].output;
+            queue.append(child);
+        }
+    }
+}
+
+void TextPatternMatcher::clear()
+{
+    nodes = {Node()};
+    edges.clear();
+}
+
+int TextPatternMatcher::step(int node, char16_t character) const
+{
+    while (true) {
+        const auto edge = edges.constFind(edgeKey(node, character));
+        if (edge != edges.constEnd()) {
+            return *edge;
+        }
+        if (node == 0) {
+            return 0;
+        }
+        node = nodes[node].fail;
+    }
+}
+
+QList<TextPatternMatcher::Match> TextPatternMatcher::findAll(const QString &text) const
+{
+    QList<Match> result;
+    if (isEmpty() || text.isEmpty()) {
+        return result;
+    }
+
+    const qsizetype size = text.size();
+
+    // endsWord[i]: there is no letter or number between position i and the next space
+    QVarLengthArray<bool, 512> endsWord(size + 1);
+    endsWord[size] = true;
+    for (qsizetype i = size - 1; i >= 0; --i) {
+        const QChar c = text.at(i);
+        endsWord[i] = c == ' ' || (!c.isLetterOrNumber() && endsWord[i + 1]);
+    }
+
+    // startsWord[i]: there is no letter or number between the previous space and position i
+    QVarLengthArray<bool, 512> startsWord(size);
+    bool letterBefore = false;
+    QList<Match> candidates;
+    int state = 0;
+    for (qsizetype i = 0; i < size; ++i) {
+        const QChar c = text.at(i);
+        startsWord[i] = !letterBefore;
+        if (c == ' ') {
+            letterBefore = false;
+        } else if (c.isLetterOrNumber()) {
+            letterBefore = true;
+        }
+
+        state = step(state, foldCase(c));
+        for (int node = nodes[state].patternLength ? state : nodes[state].output; node != 0;
+             node = nodes[node].output) {
+            const qsizetype start = i + 1 - nodes[node].patternLength;
+            if (startsWord[start] && endsWord[i + 1]) {
+                candidates.append({start, nodes[node].patternLength, nodes[node].tag});
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Match &a, const Match &b) {
+        return a.start < b.start || (a.start == b.start && a.length > b.length);
+    });
+    qsizetype end = 0;
+    for (const Match &candidate : candidates) {
+        if (candidate.start >= end) {
+            result.append(candidate);
+            end = candidate.start + candidate.length;
+        }
+    }
+    return result;
+}
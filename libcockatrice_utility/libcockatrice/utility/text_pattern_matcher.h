@@ -0,0 +1,75 @@
+/**
+ * @file text_pattern_matcher.h
+ * @ingroup Core
+ * @brief Finds whole-word occurrences of many patterns in a text in a single pass.
+ */
+
+#ifndef TEXT_PATTERN_MATCHER_H
+#define TEXT_PATTERN_MATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * Aho-Corasick automaton over case-folded text, used to find the highlight words and mentions in chat messages.
+ * The patterns are compiled once with build() and every text is then scanned in one linear pass, however many
+ * patterns there are.
+ *
+ * Only whole words match: between the preceding space (or the start of the text) and the match, and between the
+ * match and the following space (or the end of the text), there may only be characters that are neither letters nor
+ * numbers. This is how the chat splits words, so "word" is found in "(word)!" but neither in "sword" nor in
+ * "word-play".
+ */
+class TextPatternMatcher
+{
+public:
+    struct Match
+    {
+        qsizetype start;
+        qsizetype length;
+        int tag;
+    };
+
+    /**
+     * Adds a pattern, its matches are reported with the given tag. Empty patterns are ignored, of patterns that only
+     * differ in case the first one added keeps its tag. build() has to be called before the next findAll().
+     */
+    void addPattern(const QString &pattern, int tag);
+    void build();
+    void clear();
+    [[nodiscard]] bool isEmpty() const
+    {
+        return nodes.size() <= 1;
+    }
+
+    /**
+     * Returns the non-overlapping whole-word matches ordered by position. Of overlapping matches the leftmost one
+     * wins, and of matches starting at the same position the longest one.
+     */
+    [[nodiscard]] QList<Match> findAll(const QString &text) const;
+
+private:
+    struct Node
+    {
+        QList<int> children;
+        char16_t character = 0;
+        int fail = 0;
+        // the nearest node on the fail chain that ends a pattern, 0 if there is none
+        int output = 0;
+        // length of the pattern ending at this node, 0 if none does
+        int patternLength = 0;
+        int tag = 0;
+    };
+
+    QList<Node> nodes{Node()};
+    QHash<quint64, int> edges;
+
+    static quint64 edgeKey(int node, char16_t character)
+    {
+        return (static_cast<quint64>(node) << 16) | character;
+    }
+    [[nodiscard]] int step(int node, char16_t character) const;
+};
+
+#endif // TEXT_PATTERN_MATCHER_H
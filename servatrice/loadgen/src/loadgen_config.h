@@ -0,0 +1,28 @@
+#ifndef LOADGEN_CONFIG_H
+#define LOADGEN_CONFIG_H
+
+#include <QString>
+
+/**
+ * Parameters of a load generation run, shared read-only by all workers.
+ */
+struct LoadGen_Config
+{
+    QString host = "127.0.0.1";
+    unsigned int port = 4747;
+    QString userPrefix = "loadgen";
+    QString password = "loadgen";
+    int clients = 100;
+    int threads = 4;
+    int durationSeconds = 60;
+    // delay between two connection attempts of the same worker
+    int rampUpMsecs = 10;
+    int roomId = 1;
+    // average delay between two game actions of a session
+    int actionIntervalMsecs = 1000;
+    // average delay between two chat messages of a session
+    int chatIntervalMsecs = 15000;
+    qint64 serverPid = 0;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#include "loadgen_lobby.h"
+
+#include <QMutexLocker>
+
+void LoadGen_Lobby::publishGame(int pairId, int gameId)
+{
+    QMutexLocker locker(&mutex);
+    games.insert(pairId, gameId);
+}
+
+void LoadGen_Lobby::withdrawGame(int pairId)
+{
+    QMutexLocker locker(&mutex);
+    games.remove(pairId);
+}
+
+int LoadGen_Lobby::getGame(int pairId) const
+{
+    QMutexLocker locker(&mutex);
+    return games.value(pairId, -1);
+}
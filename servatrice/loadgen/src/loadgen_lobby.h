@@ -0,0 +1,25 @@
+#ifndef LOADGEN_LOBBY_H
+#define LOADGEN_LOBBY_H
+
+#include <QHash>
+#include <QMutex>
+
+/**
+ * Hands the game created by the host of a session pair to its guest. Pairs may live on different worker threads.
+ */
+class LoadGen_Lobby
+{
+public:
+    void publishGame(int pairId, int gameId);
+    void withdrawGame(int pairId);
+    /**
+     * @return the game id of the pair, or -1 if the host did not create its game yet
+     */
+    int getGame(int pairId) const;
+
+private:
+    mutable QMutex mutex;
+    QHash<int, int> games;
+};
+
+#endif
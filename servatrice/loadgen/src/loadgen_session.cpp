@@ -0,0 +1,368 @@
+#include "loadgen_session.h"
+
+#include "loadgen_lobby.h"
+#include "loadgen_worker.h"
+
+#include <QTimer>
+#include <libcockatrice/network/client/remote/remote_client.h>
+#include <libcockatrice/protocol/get_pb_extension.h>
+#include <libcockatrice/protocol/pb/command_deck_select.pb.h>
+#include <libcockatrice/protocol/pb/command_draw_cards.pb.h>
+#include <libcockatrice/protocol/pb/command_move_card.pb.h>
+#include <libcockatrice/protocol/pb/command_ready_start.pb.h>
+#include <libcockatrice/protocol/pb/command_set_card_attr.pb.h>
+#include <libcockatrice/protocol/pb/command_set_card_counter.pb.h>
+#include <libcockatrice/protocol/pb/command_shuffle.pb.h>
+#include <libcockatrice/protocol/pb/event_draw_cards.pb.h>
+#include <libcockatrice/protocol/pb/event_game_joined.pb.h>
+#include <libcockatrice/protocol/pb/event_game_state_changed.pb.h>
+#include <libcockatrice/protocol/pb/event_move_card.pb.h>
+#include <libcockatrice/protocol/pb/game_event_container.pb.h>
+#include <libcockatrice/protocol/pb/room_commands.pb.h>
+#include <libcockatrice/protocol/pb/session_commands.pb.h>
+#include <libcockatrice/protocol/pending_command.h>
+
+static const int deckSize = 60;
+static const int lobbyPollInterval = 200;
+// the server does not need to know the cards, the names only have to be stable
+static const char *deckString = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                                "<cockatrice_deck version=\"1\"><deckname>loadgen</deckname><zone name=\"main\">"
+                                "<card number=\"24\" name=\"Forest\"/><card number=\"12\" name=\"Llanowar Elves\"/>"
+                                "<card number=\"12\" name=\"Grizzly Bears\"/><card number=\"12\" name=\"Giant Growth\"/>"
+                                "</zone></cockatrice_deck>";
+
+LoadGen_Session::LoadGen_Session(LoadGen_Worker *_worker,
+                                 const LoadGen_Config &_config,
+                                 LoadGen_Lobby *_lobby,
+                                 int _index)
+    : QObject(), worker(_worker), config(_config), lobby(_lobby), index(_index), failed(false), gameId(-1),
+      playerId(-1), gameRunning(false), libraryCount(0)
+{
+    client = new RemoteClient(this, worker->getNetworkSettings());
+    connect(client, &RemoteClient::statusChanged, this, &LoadGen_Session::statusChanged);
+    connect(client, &RemoteClient::socketError, this, &LoadGen_Session::connectionFailed);
+    connect(client, &RemoteClient::loginError, this, &LoadGen_Session::connectionFailed);
+    connect(client, &RemoteClient::serverTimeout, this, &LoadGen_Session::connectionFailed);
+    connect(client, &RemoteClient::protocolVersionMismatch, this, &LoadGen_Session::connectionFailed);
+    connect(client, &RemoteClient::gameJoinedEventReceived, this, &LoadGen_Session::gameJoined);
+    connect(client, &RemoteClient::gameEventContainerReceived, this, &LoadGen_Session::gameEventContainerReceived);
+
+    actionTimer = new QTimer(this);
+    actionTimer->setSingleShot(true);
+    connect(actionTimer, &QTimer::timeout, this, &LoadGen_Session::doAction);
+
+    chatTimer = new QTimer(this);
+    chatTimer->setSingleShot(true);
+    connect(chatTimer, &QTimer::timeout, this, &LoadGen_Session::doChat);
+
+    lobbyTimer = new QTimer(this);
+    lobbyTimer->setInterval(lobbyPollInterval);
+    connect(lobbyTimer, &QTimer::timeout, this, &LoadGen_Session::joinPartnerGame);
+}
+
+LoadGen_Session::~LoadGen_Session()
+{
+    if (isHost()) {
+        lobby->withdrawGame(getPairId());
+    }
+}
+
+void LoadGen_Session::start()
+{
+    client->connectToServer(config.host, config.port, config.userPrefix + QString::number(index), config.password);
+}
+
+void LoadGen_Session::stop()
+{
+    actionTimer->stop();
+    chatTimer->stop();
+    lobbyTimer->stop();
+    client->disconnectFromServer();
+}
+
+int LoadGen_Session::randomInterval(int averageMsecs)
+{
+    // spread the sessions out so they do not fire in lockstep
+    return averageMsecs / 2 + static_cast<int>(worker->getRandom().bounded(qMax(averageMsecs, 1)));
+}
+
+void LoadGen_Session::send(PendingCommand *pend)
+{
+    const qint64 sentAt = worker->getElapsedMicroseconds();
+    connect(pend, &PendingCommand::finished, this, [this, sentAt](const Response &response) {
+        worker->responseReceived(worker->getElapsedMicroseconds() - sentAt,
+                                 response.response_code() == Response::RespOk);
+    });
+    worker->commandSent();
+    client->sendCommand(pend);
+}
+
+PendingCommand *LoadGen_Session::prepareGameCommand(const ::google::protobuf::Message &cmd) const
+{
+    CommandContainer cont;
+    cont.set_game_id(static_cast<google::protobuf::uint32>(gameId));
+    GameCommand *c = cont.add_game_command();
+    c->GetReflection()->MutableMessage(c, cmd.GetDescriptor()->FindExtensionByName("ext"))->CopyFrom(cmd);
+    return new PendingCommand(cont);
+}
+
+void LoadGen_Session::statusChanged(ClientStatus status)
+{
+    if (status == StatusLoggedIn) {
+        worker->sessionLoggedIn();
+        joinRoom();
+    }
+}
+
+void LoadGen_Session::connectionFailed()
+{
+    if (failed) {
+        return;
+    }
+    failed = true;
+    worker->sessionFailed();
+    actionTimer->stop();
+    chatTimer->stop();
+    lobbyTimer->stop();
+}
+
+void LoadGen_Session::joinRoom()
+{
+    Command_JoinRoom cmd;
+    cmd.set_room_id(static_cast<google::protobuf::uint32>(config.roomId));
+
+    PendingCommand *pend = AbstractClient::prepareSessionCommand(cmd);
+    connect(pend, &PendingCommand::finished, this, [this](const Response &response) {
+        if (response.response_code() != Response::RespOk) {
+            return;
+        }
+        chatTimer->start(randomInterval(config.chatIntervalMsecs));
+        if (isHost()) {
+            createGame();
+        } else {
+            lobbyTimer->start();
+        }
+    });
+    send(pend);
+}
+
+void LoadGen_Session::createGame()
+{
+    // the last session plays alone if the number of clients is odd
+    const bool hasPartner = index + 1 < config.clients;
+
+    Command_CreateGame cmd;
+    cmd.set_description(QString("loadgen %1").arg(getPairId()).toStdString());
+    cmd.set_max_players(hasPartner ? 2 : 1);
+    cmd.set_spectators_allowed(true);
+    send(AbstractClient::prepareRoomCommand(cmd, config.roomId));
+}
+
+void LoadGen_Session::joinPartnerGame()
+{
+    const int partnerGameId = lobby->getGame(getPairId());
+    if (partnerGameId == -1) {
+        return;
+    }
+    lobbyTimer->stop();
+
+    Command_JoinGame cmd;
+    cmd.set_game_id(partnerGameId);
+    send(AbstractClient::prepareRoomCommand(cmd, config.roomId));
+}
+
+void LoadGen_Session::gameJoined(const Event_GameJoined &event)
+{
+    gameId = event.game_info().game_id();
+    playerId = event.player_id();
+    if (isHost()) {
+        lobby->publishGame(getPairId(), gameId);
+    }
+    startGame();
+}
+
+void LoadGen_Session::startGame()
+{
+    Command_DeckSelect deckSelect;
+    deckSelect.set_deck(deckString);
+    send(prepareGameCommand(deckSelect));
+
+    Command_ReadyStart readyStart;
+    readyStart.set_ready(true);
+    send(prepareGameCommand(readyStart));
+}
+
+void LoadGen_Session::gameEventContainerReceived(const GameEventContainer &cont)
+{
+    if (static_cast<int>(cont.game_id()) != gameId) {
+        return;
+    }
+
+    const int eventListSize = cont.event_list_size();
+    for (int i = 0; i < eventListSize; ++i) {
+        const GameEvent &event = cont.event_list(i);
+        switch (static_cast<GameEvent::GameEventType>(getPbExtension(event))) {
+            case GameEvent::GAME_STATE_CHANGED: {
+                const Event_GameStateChanged &stateChanged = event.GetExtension(Event_GameStateChanged::ext);
+                if (stateChanged.game_started() && !gameRunning) {
+                    gameRunning = true;
+                    libraryCount = deckSize;
+                    worker->gameStarted();
+                    actionTimer->start(randomInterval(config.actionIntervalMsecs));
+                }
+                break;
+            }
+            case GameEvent::GAME_CLOSED:
+                gameRunning = false;
+                gameId = -1;
+                actionTimer->stop();
+                return;
+            case GameEvent::DRAW_CARDS: {
+                if (event.player_id() != playerId) {
+                    break;
+                }
+                const Event_DrawCards &drawCards = event.GetExtension(Event_DrawCards::ext);
+                for (const auto &card : drawCards.cards()) {
+                    hand.append(card.id());
+                }
+                libraryCount -= drawCards.number();
+                break;
+            }
+            case GameEvent::MOVE_CARD: {
+                const Event_MoveCard &moveCard = event.GetExtension(Event_MoveCard::ext);
+                if (moveCard.start_player_id() != playerId || moveCard.target_player_id() != playerId) {
+                    break;
+                }
+                const QString startZone = QString::fromStdString(moveCard.start_zone());
+                const QString targetZone = QString::fromStdString(moveCard.target_zone());
+                if (startZone == "hand") {
+                    hand.removeOne(moveCard.card_id());
+                } else if (startZone == "table") {
+                    const int position = static_cast<int>(table.indexOf(moveCard.card_id()));
+                    if (position != -1) {
+                        table.removeAt(position);
+                        tableTapped.removeAt(position);
+                    }
+                }
+                const int newCardId = moveCard.new_card_id() != -1 ? moveCard.new_card_id() : moveCard.card_id();
+                if (targetZone == "table") {
+                    table.append(newCardId);
+                    tableTapped.append(false);
+                } else if (targetZone == "hand") {
+                    hand.append(newCardId);
+                } else if (targetZone == "deck") {
+                    ++libraryCount;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+void LoadGen_Session::doAction()
+{
+    if (!gameRunning) {
+        return;
+    }
+
+    const int roll = static_cast<int>(worker->getRandom().bounded(100));
+    if (hand.isEmpty() && libraryCount > 0) {
+        drawCard();
+    } else if (roll < 25) {
+        if (libraryCount > 0) {
+            drawCard();
+        } else {
+            returnCard();
+        }
+    } else if (roll < 45 && !hand.isEmpty()) {
+        playCard();
+    } else if (roll < 65 && !table.isEmpty()) {
+        tapCard();
+    } else if (roll < 80 && !table.isEmpty()) {
+        setCardCounter();
+    } else if (roll < 90) {
+        shuffleDeck();
+    } else {
+        returnCard();
+    }
+
+    actionTimer->start(randomInterval(config.actionIntervalMsecs));
+}
+
+void LoadGen_Session::drawCard()
+{
+    Command_DrawCards cmd;
+    cmd.set_number(1);
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::playCard()
+{
+    Command_MoveCard cmd;
+    cmd.set_start_player_id(playerId);
+    cmd.set_start_zone("hand");
+    cmd.mutable_cards_to_move()->add_card()->set_card_id(hand.at(worker->getRandom().bounded(hand.size())));
+    cmd.set_target_player_id(playerId);
+    cmd.set_target_zone("table");
+    cmd.set_x(static_cast<int>(table.size()));
+    cmd.set_y(0);
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::returnCard()
+{
+    if (table.isEmpty()) {
+        return;
+    }
+
+    Command_MoveCard cmd;
+    cmd.set_start_player_id(playerId);
+    cmd.set_start_zone("table");
+    cmd.mutable_cards_to_move()->add_card()->set_card_id(table.at(worker->getRandom().bounded(table.size())));
+    cmd.set_target_player_id(playerId);
+    cmd.set_target_zone("deck");
+    cmd.set_x(0);
+    cmd.set_y(0);
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::tapCard()
+{
+    const int position = static_cast<int>(worker->getRandom().bounded(table.size()));
+    tableTapped[position] = !tableTapped.at(position);
+
+    Command_SetCardAttr cmd;
+    cmd.set_zone("table");
+    cmd.set_card_id(table.at(position));
+    cmd.set_attribute(AttrTapped);
+    cmd.set_attr_value(tableTapped.at(position) ? "1" : "0");
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::setCardCounter()
+{
+    Command_SetCardCounter cmd;
+    cmd.set_zone("table");
+    cmd.set_card_id(table.at(worker->getRandom().bounded(table.size())));
+    cmd.set_counter_id(0);
+    cmd.set_counter_value(static_cast<int>(worker->getRandom().bounded(6)));
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::shuffleDeck()
+{
+    Command_Shuffle cmd;
+    cmd.set_zone_name("deck");
+    send(prepareGameCommand(cmd));
+}
+
+void LoadGen_Session::doChat()
+{
+    Command_RoomSay cmd;
+    cmd.set_message(QString("loadgen message from %1").arg(index).toStdString());
+    send(AbstractClient::prepareRoomCommand(cmd, config.roomId));
+
+    chatTimer->start(randomInterval(config.chatIntervalMsecs));
+}
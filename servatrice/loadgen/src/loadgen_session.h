@@ -0,0 +1,94 @@
+#ifndef LOADGEN_SESSION_H
+#define LOADGEN_SESSION_H
+
+#include "loadgen_config.h"
+
+#include <QList>
+#include <QObject>
+#include <libcockatrice/network/client/abstract/abstract_client.h>
+
+class Event_GameJoined;
+class GameEventContainer;
+class LoadGen_Lobby;
+class LoadGen_Worker;
+class PendingCommand;
+class QTimer;
+class RemoteClient;
+
+namespace google::protobuf
+{
+class Message;
+}
+
+/**
+ * One scripted user: logs in, joins the configured room, chats and plays a two player game against the session with
+ * the neighbouring index. The even session of a pair hosts the game, the odd one joins it.
+ * The game actions are synthetic (draw, play to the table, tap, counters, shuffle) and never follow the rules; they
+ * only exercise the same server paths a real client would.
+ */
+class LoadGen_Session : public QObject
+{
+    Q_OBJECT
+public:
+    LoadGen_Session(LoadGen_Worker *_worker, const LoadGen_Config &_config, LoadGen_Lobby *_lobby, int _index);
+    ~LoadGen_Session() override;
+
+    void start();
+    void stop();
+
+private slots:
+    void statusChanged(ClientStatus status);
+    void connectionFailed();
+    void gameJoined(const Event_GameJoined &event);
+    void gameEventContainerReceived(const GameEventContainer &cont);
+    void joinPartnerGame();
+    void doAction();
+    void doChat();
+
+private:
+    LoadGen_Worker *worker;
+    const LoadGen_Config &config;
+    LoadGen_Lobby *lobby;
+    int index;
+    RemoteClient *client;
+    QTimer *actionTimer;
+    QTimer *chatTimer;
+    QTimer *lobbyTimer;
+
+    bool failed;
+    int gameId;
+    int playerId;
+    bool gameRunning;
+    int libraryCount;
+    QList<int> hand;
+    QList<int> table;
+    QList<bool> tableTapped;
+
+    bool isHost() const
+    {
+        return index % 2 == 0;
+    }
+    int getPairId() const
+    {
+        return index / 2;
+    }
+    int randomInterval(int averageMsecs);
+
+    /**
+     * Sends a command and accounts its round trip time once the response arrives.
+     */
+    void send(PendingCommand *pend);
+    PendingCommand *prepareGameCommand(const ::google::protobuf::Message &cmd) const;
+
+    void joinRoom();
+    void createGame();
+    void startGame();
+    void drawCard();
+    void playCard();
+    void returnCard();
+    void tapCard();
+    void setCardCounter();
+    void shuffleDeck();
+};
+
+#endif
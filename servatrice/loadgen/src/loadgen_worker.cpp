@@ -0,0 +1,90 @@
+#include "loadgen_worker.h"
+
+#include "loadgen_session.h"
+
+#include <QMutexLocker>
+#include <QTimer>
+
+LoadGen_Worker::LoadGen_Worker(const LoadGen_Config &_config,
+                               LoadGen_Lobby *_lobby,
+                               int _firstIndex,
+                               int _sessionCount)
+    : QObject(), config(_config), lobby(_lobby), firstIndex(_firstIndex), sessionCount(_sessionCount),
+      random(static_cast<quint32>(_firstIndex + 1))
+{
+}
+
+LoadGen_Worker::~LoadGen_Worker()
+{
+    qDeleteAll(sessions);
+}
+
+void LoadGen_Worker::start()
+{
+    clock.start();
+    startNextSession();
+}
+
+void LoadGen_Worker::startNextSession()
+{
+    if (sessions.size() >= sessionCount) {
+        return;
+    }
+
+    // sessions are created on the worker thread, so their clients dispatch events here as well
+    auto *session = new LoadGen_Session(this, config, lobby, firstIndex + static_cast<int>(sessions.size()));
+    sessions.append(session);
+    session->start();
+
+    QTimer::singleShot(config.rampUpMsecs, this, &LoadGen_Worker::startNextSession);
+}
+
+void LoadGen_Worker::stop()
+{
+    // stop the ramp up before tearing down the sessions
+    sessionCount = 0;
+    for (auto *session : sessions) {
+        session->stop();
+    }
+    qDeleteAll(sessions);
+    sessions.clear();
+}
+
+void LoadGen_Worker::commandSent()
+{
+    commandsSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoadGen_Worker::responseReceived(qint64 latencyMicroseconds, bool success)
+{
+    responses.fetch_add(1, std::memory_order_relaxed);
+    if (!success) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QMutexLocker locker(&latenciesMutex);
+    latencies.append(latencyMicroseconds);
+}
+
+void LoadGen_Worker::sessionLoggedIn()
+{
+    sessionsLoggedIn.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoadGen_Worker::sessionFailed()
+{
+    sessionsFailed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoadGen_Worker::gameStarted()
+{
+    gamesStarted.fetch_add(1, std::memory_order_relaxed);
+}
+
+QVector<qint64> LoadGen_Worker::takeLatencies()
+{
+    QMutexLocker locker(&latenciesMutex);
+    QVector<qint64> result;
+    result.swap(latencies);
+    return result;
+}
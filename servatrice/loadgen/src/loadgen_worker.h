@@ -0,0 +1,133 @@
+#ifndef LOADGEN_WORKER_H
+#define LOADGEN_WORKER_H
+
+#include "loadgen_config.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QVector>
+#include <atomic>
+#include <libcockatrice/interfaces/interface_network_settings_provider.h>
+
+class LoadGen_Lobby;
+class LoadGen_Session;
+
+/**
+ * Fixed network settings for the simulated clients; nothing is persisted.
+ */
+class LoadGen_NetworkSettings : public INetworkSettingsProvider
+{
+public:
+    QString getClientID() override
+    {
+        return "loadgen";
+    }
+    [[nodiscard]] int getTimeOut() const override
+    {
+        return 60;
+    }
+    [[nodiscard]] int getKeepAlive() const override
+    {
+        return 5;
+    }
+    [[nodiscard]] bool getNotifyAboutUpdates() const override
+    {
+        return false;
+    }
+    void setKnownMissingFeatures(const QString & /* _knownMissingFeatures */) override
+    {
+    }
+    QString getKnownMissingFeatures() override
+    {
+        return QString();
+    }
+};
+
+/**
+ * Runs a slice of the simulated sessions on its own thread. The counters are read by the reporting thread while the
+ * run is in progress; the latency samples are only handed out after the worker stopped.
+ */
+class LoadGen_Worker : public QObject
+{
+    Q_OBJECT
+public:
+    LoadGen_Worker(const LoadGen_Config &_config, LoadGen_Lobby *_lobby, int _firstIndex, int _sessionCount);
+    ~LoadGen_Worker() override;
+
+    LoadGen_NetworkSettings *getNetworkSettings()
+    {
+        return &networkSettings;
+    }
+    QRandomGenerator &getRandom()
+    {
+        return random;
+    }
+    qint64 getElapsedMicroseconds() const
+    {
+        return clock.nsecsElapsed() / 1000;
+    }
+
+    void commandSent();
+    void responseReceived(qint64 latencyMicroseconds, bool success);
+    void sessionLoggedIn();
+    void sessionFailed();
+    void gameStarted();
+
+    quint64 getCommandsSent() const
+    {
+        return commandsSent.load(std::memory_order_relaxed);
+    }
+    quint64 getResponses() const
+    {
+        return responses.load(std::memory_order_relaxed);
+    }
+    quint64 getErrors() const
+    {
+        return errors.load(std::memory_order_relaxed);
+    }
+    int getSessionsLoggedIn() const
+    {
+        return sessionsLoggedIn.load(std::memory_order_relaxed);
+    }
+    int getSessionsFailed() const
+    {
+        return sessionsFailed.load(std::memory_order_relaxed);
+    }
+    int getGamesStarted() const
+    {
+        return gamesStarted.load(std::memory_order_relaxed);
+    }
+    QVector<qint64> takeLatencies();
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void startNextSession();
+
+private:
+    const LoadGen_Config &config;
+    LoadGen_Lobby *lobby;
+    int firstIndex;
+    int sessionCount;
+    LoadGen_NetworkSettings networkSettings;
+    QRandomGenerator random;
+    QElapsedTimer clock;
+    QList<LoadGen_Session *> sessions;
+
+    std::atomic<quint64> commandsSent{0};
+    std::atomic<quint64> responses{0};
+    std::atomic<quint64> errors{0};
+    std::atomic<int> sessionsLoggedIn{0};
+    std::atomic<int> sessionsFailed{0};
+    std::atomic<int> gamesStarted{0};
+
+    QMutex latenciesMutex;
+    QVector<qint64> latencies;
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "loadgen_config.h"
+#include "loadgen_lobby.h"
+#include "loadgen_worker.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <iostream>
+
+static const int reportInterval = 5000;
+
+/**
+ * Reads the resident set size of the server process from procfs.
+ * @return the size in KiB, or -1 if it is not available on this platform
+ */
+static qint64 readServerRss(qint64 pid)
+{
+    if (pid <= 0) {
+        return -1;
+    }
+    QFile status(QString("/proc/%1/status").arg(pid));
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+static QString formatRss(qint64 pid)
+{
+    const qint64 rss = readServerRss(pid);
+    return rss < 0 ? QString("n/a") : QString("%1 MiB").arg(rss / 1024.0, 0, 'f', 1);
+}
+
+static QString formatLatency(const QVector<qint64> &sorted, double quantile)
+{
+    if (sorted.isEmpty()) {
+        return QString("n/a");
+    }
+    const auto position = static_cast<qsizetype>(quantile * static_cast<double>(sorted.size() - 1));
+    return QString("%1 ms").arg(sorted.at(position) / 1000.0, 0, 'f', 2);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("servatrice_loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Drives a local servatrice with simulated clients and reports throughput and command latency.\n"
+        "The server should use authentication method \"none\" and list 127.0.0.1 in security/trusted_sources, "
+        "otherwise logins are rejected or limited by max_users_per_address.");
+    parser.addHelpOption();
+
+    LoadGen_Config config;
+    QCommandLineOption hostOpt("host", "Server address", "host", config.host);
+    QCommandLineOption portOpt("port", "Server port", "port", QString::number(config.port));
+    QCommandLineOption clientsOpt("clients", "Number of simulated clients", "n", QString::number(config.clients));
+    QCommandLineOption threadsOpt("threads", "Number of client threads", "n", QString::number(config.threads));
+    QCommandLineOption durationOpt("duration", "Run time in seconds", "seconds",
+                                   QString::number(config.durationSeconds));
+    QCommandLineOption rampUpOpt("ramp-up", "Delay between two connections of a thread", "msecs",
+                                 QString::number(config.rampUpMsecs));
+    QCommandLineOption roomOpt("room", "Room to join", "id", QString::number(config.roomId));
+    QCommandLineOption actionIntervalOpt("action-interval", "Average delay between two game actions of a client",
+                                         "msecs", QString::number(config.actionIntervalMsecs));
+    QCommandLineOption chatIntervalOpt("chat-interval", "Average delay between two chat messages of a client",
+                                       "msecs", QString::number(config.chatIntervalMsecs));
+    QCommandLineOption userPrefixOpt("user-prefix", "Prefix of the generated user names", "prefix",
+                                     config.userPrefix);
+    QCommandLineOption passwordOpt("password", "Password of the generated users", "password", config.password);
+    QCommandLineOption serverPidOpt("server-pid", "Process id of the server, to report its memory usage", "pid");
+    parser.addOptions({hostOpt, portOpt, clientsOpt, threadsOpt, durationOpt, rampUpOpt, roomOpt, actionIntervalOpt,
+                       chatIntervalOpt, userPrefixOpt, passwordOpt, serverPidOpt});
+    parser.process(app);
+
+    config.host = parser.value(hostOpt);
+    config.port = parser.value(portOpt).toUInt();
+    config.clients = qMax(parser.value(clientsOpt).toInt(), 1);
+    config.threads = qBound(1, parser.value(threadsOpt).toInt(), config.clients);
+    config.durationSeconds = qMax(parser.value(durationOpt).toInt(), 1);
+    config.rampUpMsecs = qMax(parser.value(rampUpOpt).toInt(), 0);
+    config.roomId = parser.value(roomOpt).toInt();
+    config.actionIntervalMsecs = qMax(parser.value(actionIntervalOpt).toInt(), 1);
+    config.chatIntervalMsecs = qMax(parser.value(chatIntervalOpt).toInt(), 1);
+    config.userPrefix = parser.value(userPrefixOpt);
+    config.password = parser.value(passwordOpt);
+    config.serverPid = parser.value(serverPidOpt).toLongLong();
+
+    LoadGen_Lobby lobby;
+    QList<QThread *> threads;
+    QList<LoadGen_Worker *> workers;
+
+    // keep both sessions of a pair on the same worker, so a pair is always started together
+    const int pairs = (config.clients + 1) / 2;
+    int firstPair = 0;
+    for (int i = 0; i < config.threads; ++i) {
+        const int workerPairs = pairs / config.threads + (i < pairs % config.threads ? 1 : 0);
+        const int firstIndex = firstPair * 2;
+        const int sessionCount = qMin(workerPairs * 2, config.clients - firstIndex);
+        firstPair += workerPairs;
+
+        auto *thread = new QThread;
+        thread->setObjectName(QString("loadgen_%1").arg(i));
+        auto *worker = new LoadGen_Worker(config, &lobby, firstIndex, sessionCount);
+        worker->moveToThread(thread);
+        QObject::connect(thread, &QThread::started, worker, &LoadGen_Worker::start);
+        threads.append(thread);
+        workers.append(worker);
+    }
+
+    std::cout << "Starting " << config.clients << " clients on " << config.threads << " threads against "
+              << config.host.toStdString() << ":" << config.port << " for " << config.durationSeconds << " s"
+              << std::endl;
+
+    QElapsedTimer runTime;
+    runTime.start();
+    for (auto *thread : threads) {
+        thread->start();
+    }
+
+    quint64 lastResponses = 0;
+    qint64 lastReport = 0;
+    QTimer reportTimer;
+    QObject::connect(&reportTimer, &QTimer::timeout, [&]() {
+        quint64 responses = 0, errors = 0;
+        int loggedIn = 0, failed = 0, games = 0;
+        for (const auto *worker : workers) {
+            responses += worker->getResponses();
+            errors += worker->getErrors();
+            loggedIn += worker->getSessionsLoggedIn();
+            failed += worker->getSessionsFailed();
+            games += worker->getGamesStarted();
+        }
+        const qint64 now = runTime.elapsed();
+        const double rate = static_cast<double>(responses - lastResponses) * 1000.0 / qMax<qint64>(now - lastReport, 1);
+        lastResponses = responses;
+        lastReport = now;
+
+        std::cout << "[" << now / 1000 << " s] logged in " << loggedIn << ", failed " << failed << ", games "
+                  << games << ", " << QString::number(rate, 'f', 0).toStdString() << " cmd/s, errors " << errors
+                  << ", server rss " << formatRss(config.serverPid).toStdString() << std::endl;
+    });
+    reportTimer.start(reportInterval);
+
+    QTimer::singleShot(config.durationSeconds * 1000, &app, [&]() {
+        reportTimer.stop();
+        const double seconds = runTime.elapsed() / 1000.0;
+
+        quint64 sent = 0, responses = 0, errors = 0;
+        QVector<qint64> latencies;
+        for (int i = 0; i < workers.size(); ++i) {
+            QMetaObject::invokeMethod(workers[i], &LoadGen_Worker::stop, Qt::BlockingQueuedConnection);
+            threads[i]->quit();
+            threads[i]->wait();
+
+            sent += workers[i]->getCommandsSent();
+            responses += workers[i]->getResponses();
+            errors += workers[i]->getErrors();
+            latencies += workers[i]->takeLatencies();
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << "Commands sent " << sent << ", responses " << responses << ", errors " << errors << std::endl;
+        std::cout << "Throughput " << QString::number(responses / seconds, 'f', 1).toStdString() << " cmd/s"
+                  << std::endl;
+        std::cout << "Round trip p50 " << formatLatency(latencies, 0.5).toStdString() << ", p99 "
+                  << formatLatency(latencies, 0.99).toStdString() << ", max "
+                  << formatLatency(latencies, 1.0).toStdString() << std::endl;
+        std::cout << "Server rss " << formatRss(config.serverPid).toStdString() << std::endl;
+
+        qDeleteAll(workers);
+        qDeleteAll(threads);
+        app.quit();
+    });
+
+    return app.exec();
+}
@@ -0,0 +1,10 @@
+-- Servatrice db migration from version 35 to version 36
+
+-- the log search pages over the id, every secondary index of the table ends in it
+ALTER TABLE cockatrice_log ADD COLUMN `id` bigint(20) unsigned NOT NULL AUTO_INCREMENT FIRST, ADD PRIMARY KEY (`id`);
+
+-- the game and location filters of the search compare the target type along with the target id or name
+ALTER TABLE cockatrice_log ADD KEY `target_type_id` (`target_type`, `target_id`),
+  ADD KEY `target_name_type` (`target_name`, `target_type`), DROP KEY `target_name`;
+
+UPDATE cockatrice_schema_version SET version=36 WHERE version=35;
@@ -20,7 +20,7 @@ CREATE TABLE IF NOT EXISTS `cockatrice_schema_version` (
   PRIMARY KEY  (`version`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 DEFAULT COLLATE utf8mb4_unicode_ci;
 
-INSERT INTO cockatrice_schema_version VALUES(35);
+INSERT INTO cockatrice_schema_version VALUES(36);
 
 -- users and user data tables
 CREATE TABLE IF NOT EXISTS `cockatrice_users` (
@@ -234,6 +234,7 @@ CREATE TABLE IF NOT EXISTS `cockatrice_warnings` (
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 DEFAULT COLLATE utf8mb4_unicode_ci;
 
 CREATE TABLE IF NOT EXISTS `cockatrice_log` (
+  `id` bigint(20) unsigned NOT NULL auto_increment,
   `log_time` datetime NOT NULL,
   `sender_id` int(7) unsigned NULL,
   `sender_name` varchar(35) NOT NULL,
@@ -242,10 +243,12 @@ CREATE TABLE IF NOT EXISTS `cockatrice_log` (
   `target_type` ENUM('room', 'game', 'chat'),
   `target_id` int(7) NULL,
   `target_name` varchar(50) NOT NULL,
+  PRIMARY KEY (`id`),
   KEY `sender_name` (`sender_name`),
   KEY `sender_ip` (`sender_ip`),
   KEY `target_id` (`target_id`),
-  KEY `target_name` (`target_name`),
+  KEY `target_type_id` (`target_type`, `target_id`),
+  KEY `target_name_type` (`target_name`, `target_type`),
   INDEX `idx_log_time` (`log_time`),
   FOREIGN KEY(`sender_id`) REFERENCES `cockatrice_users`(`id`)  ON DELETE CASCADE ON UPDATE CASCADE
   -- No FK on target_id, it can be zero
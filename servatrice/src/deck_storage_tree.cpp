@@ -0,0 +1,65 @@
+#include "deck_storage_tree.h"
+
+#include <libcockatrice/protocol/pb/serverinfo_deckstorage.pb.h>
+
+void DeckStorageTree::addFolder(int id, int parentId, const QString &name)
+{
+    subfolders[parentId].append({id, name});
+}
+
+void DeckStorageTree::addFile(int id, int folderId, const QString &name, qint64 creationTime)
+{
+    files[folderId].append({id, name, creationTime});
+}
+
+int DeckStorageTree::getFolderId(const QString &path) const
+{
+    const QStringList names = path.split("/");
+    if (names.first().isEmpty()) {
+        return 0;
+    }
+
+    int folderId = 0;
+    for (const QString &name : names) {
+        int childId = -1;
+        for (const Folder &child : subfolders.value(folderId)) {
+            // folder names are compared the way the case insensitive collation of the database did
+            if (child.name.compare(name, Qt::CaseInsensitive) == 0) {
+                childId = child.id;
+                break;
+            }
+        }
+        if (childId == -1) {
+            return -1;
+        }
+        folderId = childId;
+    }
+    return folderId;
+}
+
+QList<int> DeckStorageTree::getFolderIdsRecursive(int folderId) const
+{
+    QList<int> result;
+    for (const Folder &child : subfolders.value(folderId)) {
+        result.append(getFolderIdsRecursive(child.id));
+    }
+    result.append(folderId);
+    return result;
+}
+
+void DeckStorageTree::writeFolder(int folderId, ServerInfo_DeckStorage_Folder *folder) const
+{
+    for (const Folder &child : subfolders.value(folderId)) {
+        ServerInfo_DeckStorage_TreeItem *newItem = folder->add_items();
+        newItem->set_id(child.id);
+        newItem->set_name(child.name.toStdString());
+        writeFolder(child.id, newItem->mutable_folder());
+    }
+
+    for (const File &file : files.value(folderId)) {
+        ServerInfo_DeckStorage_TreeItem *newItem = folder->add_items();
+        newItem->set_id(file.id);
+        newItem->set_name(file.name.toStdString());
+        newItem->mutable_file()->set_creation_time(file.creationTime);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef DECK_STORAGE_TREE_H
+#define DECK_STORAGE_TREE_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class ServerInfo_DeckStorage_Folder;
+
+/**
+ * In memory copy of the deck storage folders and files of a user, loaded with one query for all folders and one for
+ * all files. Paths are resolved and deck list responses are built from it without further queries.
+ * Folder id 0 is the root folder.
+ */
+class DeckStorageTree
+{
+public:
+    /**
+     * Adds a folder. Folders and files have to be added in ascending id order.
+     */
+    void addFolder(int id, int parentId, const QString &name);
+    void addFile(int id, int folderId, const QString &name, qint64 creationTime);
+
+    /**
+     * @return the id of the folder at the slash separated path, 0 for an empty path and -1 if there is no such folder.
+     * Folder names match regardless of case.
+     */
+    int getFolderId(const QString &path) const;
+
+    /**
+     * @return the ids of the folder and all folders below it, deepest first
+     */
+    QList<int> getFolderIdsRecursive(int folderId) const;
+
+    /**
+     * Adds the subfolders (recursively) and files of the folder to the response folder.
+     */
+    void writeFolder(int folderId, ServerInfo_DeckStorage_Folder *folder) const;
+
+private:
+    struct Folder
+    {
+        int id;
+        QString name;
+    };
+    struct File
+    {
+        int id;
+        QString name;
+        qint64 creationTime;
+    };
+
+    QMap<int, QList<Folder>> subfolders; // by parent id
+    QMap<int, QList<File>> files;        // by folder id
+};
+
+#endif
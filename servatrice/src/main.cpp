@@ -155,6 +155,7 @@ int main(int argc, char *argv[])
     loggerThread = new QThread;
     loggerThread->setObjectName("logger");
     logger = new ServerLogger(logToConsole);
+    logger->reloadConfiguration(*settingsCache);
     logger->moveToThread(loggerThread);
 
     loggerThread->start();
@@ -24,6 +24,7 @@
 #include "main.h"
 #include "servatrice_connection_pool.h"
 #include "servatrice_database_interface.h"
+#include "servatrice_metrics.h"
 #include "server_logger.h"
 #include "serversocketinterface.h"
 #include "settingscache.h"
@@ -38,6 +39,7 @@
 #include <QStringList>
 #include <QTimer>
 #include <QUrl>
+#include <game/server_spectator_channel.h>
 #include <iostream>
 #include <libcockatrice/deck_list/deck_list.h>
 #include <libcockatrice/protocol/featureset.h>
@@ -199,15 +201,17 @@ void Servatrice_IslServer::incomingConnection(qintptr socketDescriptor)
 }
 
 Servatrice::Servatrice(QObject *parent)
-    : Server(parent), authenticationMethod(AuthenticationNone), uptime(0), txBytes(0), rxBytes(0),
-      shutdownTimer(nullptr)
+    : Server(parent), authenticationMethod(AuthenticationNone), gameServer(nullptr), websocketGameServer(nullptr),
+      servatriceMetrics(nullptr), metricsServer(nullptr), uptime(0), txBytes(0), rxBytes(0), shutdownTimer(nullptr)
 {
     qRegisterMetaType<QSqlDatabase>("QSqlDatabase");
 }
 
 Servatrice::~Servatrice()
 {
-    gameServer->close();
+    if (gameServer) {
+        gameServer->close();
+    }
 
     // we are destroying the clients outside their thread!
     for (auto *client : clients) {
@@ -220,12 +224,33 @@ Servatrice::~Servatrice()
 
     servatriceDatabaseInterface->deleteLater();
     prepareDestroy();
+
+    // the connection pools record into the metrics until the game servers have stopped their threads
+    delete gameServer;
+    gameServer = nullptr;
+    delete websocketGameServer;
+    websocketGameServer = nullptr;
+
+    setMetrics(nullptr);
+    delete metricsServer;
+    metricsServer = nullptr;
+    delete servatriceMetrics;
+    servatriceMetrics = nullptr;
 }
 
 bool Servatrice::initServer()
 {
 
     serverId = getServerID();
+
+    if (getMetricsEnabled()) {
+        // must exist before any database interface prepares its statements
+        servatriceMetrics = new Servatrice_Metrics(this);
+        setMetrics(servatriceMetrics);
+    }
+
+    getSpectatorBroadcaster()->setMaxThreadCount(settingsCache->value("game/spectator_broadcast_threads", 2).toInt());
+
     if (getAuthenticationMethodString() == "sql") {
         qDebug() << "Authenticating method: sql";
         authenticationMethod = AuthenticationSql;
@@ -286,6 +311,8 @@ bool Servatrice::initServer()
 
     if (getDBTypeString() == "mysql") {
         databaseType = DatabaseMySql;
+    } else if (getDBTypeString() == "sqlite") {
+        databaseType = DatabaseSqlite;
     } else {
         databaseType = DatabaseNone;
     }
@@ -294,8 +321,9 @@ bool Servatrice::initServer()
 
     if (databaseType != DatabaseNone) {
         dbPrefix = getDBPrefixString();
+        const QString driver = databaseType == DatabaseSqlite ? "QSQLITE" : "QMYSQL";
         bool dbOpened = servatriceDatabaseInterface->initDatabase(
-            "QMYSQL", getDBHostNameString(), getDBDatabaseNameString(), getDBUserNameString(), getDBPasswordString());
+            driver, getDBHostNameString(), getDBDatabaseNameString(), getDBUserNameString(), getDBPasswordString());
         if (!dbOpened) {
             qDebug() << "Failed to open database";
             return false;
@@ -417,10 +445,6 @@ bool Servatrice::initServer()
         return false;
     }
 
-    pingClock = new QTimer(this);
-    connect(pingClock, SIGNAL(timeout()), this, SIGNAL(pingClockTimeout()));
-    pingClock->start(getClientKeepAlive() * 1000);
-
     statusUpdateClock = new QTimer(this);
     connect(statusUpdateClock, SIGNAL(timeout()), this, SLOT(statusUpdate()));
     if (getServerStatusUpdateTime() != 0) {
@@ -459,6 +483,19 @@ bool Servatrice::initServer()
         }
     }
 
+    // METRICS ENDPOINT
+    if (servatriceMetrics) {
+        metricsServer = new Servatrice_MetricsServer(servatriceMetrics, this);
+        QHostAddress metricsHost = getMetricsHost();
+        qDebug() << "Starting metrics endpoint on host" << metricsHost.toString() << "port" << getMetricsPort();
+        if (metricsServer->listen(metricsHost, static_cast<quint16>(getMetricsPort()))) {
+            qDebug() << "Metrics endpoint listening.";
+        } else {
+            qDebug() << "metricsServer->listen(): Error:" << metricsServer->errorString();
+            return false;
+        }
+    }
+
     if (getIdleClientTimeout() > 0) {
         qDebug() << "Idle client timeout value:" << getIdleClientTimeout();
         if (getIdleClientTimeout() < 300) {
@@ -527,6 +564,22 @@ int Servatrice::getUsersWithAddress(const QHostAddress &address) const
     return result;
 }
 
+Servatrice_OutputBufferStats Servatrice::getOutputBufferStats() const
+{
+    Servatrice_OutputBufferStats stats;
+    QReadLocker locker(&clientsLock);
+    for (auto client : clients) {
+        auto *socketInterface = static_cast<AbstractServerSocketInterface *>(client);
+        const qint64 bytes = socketInterface->getOutputBufferSize();
+        ++stats.connections;
+        stats.totalMessages += socketInterface->getOutputBufferMessages();
+        stats.totalBytes += bytes;
+        stats.maxBytes = qMax(stats.maxBytes, bytes);
+        stats.maxPeakBytes = qMax(stats.maxPeakBytes, socketInterface->getPeakOutputBufferSize());
+    }
+    return stats;
+}
+
 QList<AbstractServerSocketInterface *> Servatrice::getUsersWithAddressAsList(const QHostAddress &address) const
 {
     QList<AbstractServerSocketInterface *> result;
@@ -987,6 +1040,16 @@ bool Servatrice::permitCreateGameAsJudge() const
     return settingsCache->value("game/allow_create_as_judge", false).toBool();
 }
 
+int Servatrice::getSpectatorDelay() const
+{
+    return settingsCache->value("game/spectator_delay", 0).toInt();
+}
+
+int Servatrice::getSpectatorCoalescingInterval() const
+{
+    return settingsCache->value("game/spectator_coalescing_interval", 0).toInt();
+}
+
 QHostAddress Servatrice::getServerTCPHost() const
 {
     QString host = settingsCache->value("server/host", "any").toString();
@@ -1007,6 +1070,21 @@ int Servatrice::getNumberOfWebSocketPools() const
     return settingsCache->value("server/websocket_number_pools", 1).toInt();
 }
 
+bool Servatrice::getMetricsEnabled() const
+{
+    return settingsCache->value("metrics/enabled", false).toBool();
+}
+
+QHostAddress Servatrice::getMetricsHost() const
+{
+    return QHostAddress(settingsCache->value("metrics/host", "127.0.0.1").toString());
+}
+
+int Servatrice::getMetricsPort() const
+{
+    return settingsCache->value("metrics/port", 9464).toInt();
+}
+
 QHostAddress Servatrice::getServerWebSocketHost() const
 {
     QString host = settingsCache->value("server/websocket_host", "any").toString();
@@ -41,6 +41,9 @@ class GameReplay;
 class Servatrice;
 class Servatrice_ConnectionPool;
 class Servatrice_DatabaseInterface;
+class Servatrice_Metrics;
+class Servatrice_MetricsServer;
+struct Servatrice_OutputBufferStats;
 class AbstractServerSocketInterface;
 class IslInterface;
 class FeatureSet;
@@ -148,14 +151,17 @@ private:
     enum DatabaseType
     {
         DatabaseNone,
-        DatabaseMySql
+        DatabaseMySql,
+        DatabaseSqlite
     };
     AuthenticationMethod authenticationMethod;
     DatabaseType databaseType;
-    QTimer *pingClock, *statusUpdateClock;
+    QTimer *statusUpdateClock;
     Servatrice_GameServer *gameServer;
     Servatrice_WebsocketGameServer *websocketGameServer;
     Servatrice_IslServer *islServer;
+    Servatrice_Metrics *servatriceMetrics;
+    Servatrice_MetricsServer *metricsServer;
     mutable QMutex loginMessageMutex;
     QString loginMessage;
     QString dbPrefix;
@@ -196,6 +202,9 @@ private:
     bool getEnableInternalSMTPClient() const;
     QHostAddress getServerTCPHost() const;
     QHostAddress getServerWebSocketHost() const;
+    bool getMetricsEnabled() const;
+    QHostAddress getMetricsHost() const;
+    int getMetricsPort() const;
 
 public slots:
     void scheduleShutdown(const QString &reason, int minutes);
@@ -265,6 +274,8 @@ public:
     int getMaxCommandCountPerInterval() const override;
     int getMaxUserTotal() const override;
     bool permitCreateGameAsJudge() const override;
+    int getSpectatorDelay() const override;
+    int getSpectatorCoalescingInterval() const override;
     int getMaxTcpUserLimit() const;
     int getMaxWebSocketUserLimit() const;
     int getUsersWithAddress(const QHostAddress &address) const;
@@ -273,6 +284,11 @@ public:
     QList<AbstractServerSocketInterface *> getUsersWithAddressAsList(const QHostAddress &address) const;
     void incTxBytes(quint64 num);
     void incRxBytes(quint64 num);
+    Servatrice_Metrics *getServatriceMetrics() const
+    {
+        return servatriceMetrics;
+    }
+    Servatrice_OutputBufferStats getOutputBufferStats() const;
     void addDatabaseInterface(QThread *thread, Servatrice_DatabaseInterface *databaseInterface);
 
     bool islConnectionExists(int _serverId) const;
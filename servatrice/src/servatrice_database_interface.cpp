@@ -1,17 +1,22 @@
 #include "servatrice_database_interface.h"
 
 #include "servatrice.h"
+#include "servatrice_log_query.h"
+#include "servatrice_metrics.h"
+#include "servatrice_sql_dialect.h"
 #include "serversocketinterface.h"
 #include "settingscache.h"
 
 #include <QChar>
 #include <QDateTime>
 #include <QDebug>
+#include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLoggingCategory>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QVersionNumber>
 #include <libcockatrice/deck_list/deck_list.h>
 #include <libcockatrice/protocol/pb/game_replay.pb.h>
 #include <libcockatrice/utility/passwordhasher.h>
@@ -28,6 +33,7 @@ Servatrice_DatabaseInterface::~Servatrice_DatabaseInterface()
     // reset all prepared statements
     qDeleteAll(preparedStatements);
     preparedStatements.clear();
+    statementHistograms.clear();
 
     sqlDatabase.close();
 }
@@ -51,6 +57,10 @@ bool Servatrice_DatabaseInterface::initDatabase(const QString &type,
     sqlDatabase.setDatabaseName(databaseName);
     sqlDatabase.setUserName(userName);
     sqlDatabase.setPassword(password);
+    if (isSqlite()) {
+        // the pool connections write to the same file, wait for each other instead of failing
+        sqlDatabase.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    }
 
     return openDatabase();
 }
@@ -60,6 +70,8 @@ bool Servatrice_DatabaseInterface::openDatabase()
     if (sqlDatabase.isOpen()) {
         sqlDatabase.close();
     }
+    // closing the connection rolled back any open transaction
+    sessionTablesLocked = false;
 
     const QString poolStr = instanceId == -1 ? QString("main") : QString("pool %1").arg(instanceId);
     qCDebug(DatabaseInterfaceLog).noquote() << poolStr << "Opening database...";
@@ -68,6 +80,11 @@ bool Servatrice_DatabaseInterface::openDatabase()
         return false;
     }
 
+    if (isSqlite() && !initSqliteConnection()) {
+        qCCritical(DatabaseInterfaceLog) << poolStr << "Error opening database: unable to initialize sqlite database";
+        return false;
+    }
+
     QSqlQuery *versionQuery = prepareQuery("select version from {prefix}_schema_version limit 1");
     if (!execSqlQuery(versionQuery)) {
         qCCritical(DatabaseInterfaceLog) << poolStr << "Error opening database: unable to load database schema version"
@@ -100,9 +117,57 @@ bool Servatrice_DatabaseInterface::openDatabase()
     // reset all prepared statements
     qDeleteAll(preparedStatements);
     preparedStatements.clear();
+    statementHistograms.clear();
     return true;
 }
 
+bool Servatrice_DatabaseInterface::initSqliteConnection()
+{
+    QSqlQuery query(sqlDatabase);
+    // write ahead logging lets the pool connections read while another one writes
+    if (!query.exec("pragma journal_mode=wal") || !query.exec("pragma synchronous=normal") ||
+        !query.exec("pragma foreign_keys=on")) {
+        qCCritical(DatabaseInterfaceLog) << "Error configuring sqlite:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("select sqlite_version()") || !query.next()) {
+        qCCritical(DatabaseInterfaceLog) << "Error reading the sqlite version:" << query.lastError().text();
+        return false;
+    }
+    const QVersionNumber sqliteVersion = QVersionNumber::fromString(query.value(0).toString());
+    if (sqliteVersion < Servatrice_SqlDialect::minimumSqliteVersion()) {
+        qCCritical(DatabaseInterfaceLog) << "Error configuring sqlite: version" << sqliteVersion.toString()
+                                         << "is too old, servatrice needs at least"
+                                         << Servatrice_SqlDialect::minimumSqliteVersion().toString();
+        return false;
+    }
+
+    if (sqlDatabase.tables().contains(server->getDbPrefix() + "_schema_version")) {
+        return true;
+    }
+
+    QFile schemaFile(":/servatrice.sql");
+    if (!schemaFile.open(QIODevice::ReadOnly)) {
+        qCCritical(DatabaseInterfaceLog) << "Error creating sqlite schema: schema file not found";
+        return false;
+    }
+
+    qCInfo(DatabaseInterfaceLog) << "Creating sqlite schema in" << sqlDatabase.databaseName();
+    const QStringList statements =
+        Servatrice_SqlDialect::schemaToSqlite(QString::fromUtf8(schemaFile.readAll()), server->getDbPrefix());
+    sqlDatabase.transaction();
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            qCCritical(DatabaseInterfaceLog) << "Error creating sqlite schema:" << query.lastError().text()
+                                             << "in statement" << statement;
+            sqlDatabase.rollback();
+            return false;
+        }
+    }
+    return sqlDatabase.commit();
+}
+
 bool Servatrice_DatabaseInterface::checkSql()
 {
     if (!sqlDatabase.isValid()) {
@@ -131,18 +196,27 @@ QSqlQuery *Servatrice_DatabaseInterface::prepareQuery(const QString &queryText)
         return preparedStatements.value(queryText);
     }
 
-    QString prefixedQueryText = queryText;
+    QString prefixedQueryText = isSqlite() ? Servatrice_SqlDialect::toSqlite(queryText) : queryText;
     prefixedQueryText.replace("{prefix}", server->getDbPrefix());
     auto *query = new QSqlQuery(sqlDatabase);
     query->prepare(prefixedQueryText);
 
     preparedStatements.insert(queryText, query);
+    if (Servatrice_Metrics *metrics = server->getServatriceMetrics()) {
+        statementHistograms.insert(query, metrics->getSqlHistogram(queryText));
+    }
     return query;
 }
 
 bool Servatrice_DatabaseInterface::execSqlQuery(QSqlQuery *query)
 {
-    if (query->exec()) {
+    Server_LatencyHistogram *histogram = statementHistograms.value(query);
+    Server_MetricsStopwatch timer(histogram != nullptr);
+    const bool ok = query->exec();
+    if (histogram) {
+        histogram->observe(timer.elapsedMicroseconds());
+    }
+    if (ok) {
         return true;
     }
     const QString poolStr = instanceId == -1 ? QString("main") : QString("pool %1").arg(instanceId);
@@ -756,12 +830,38 @@ void Servatrice_DatabaseInterface::clearSessionTables()
 
 void Servatrice_DatabaseInterface::lockSessionTables()
 {
+    if (isSqlite()) {
+        // a write transaction serializes the session bookkeeping of the connections like the table locks on MySQL;
+        // locking again keeps the transaction, as a new "lock tables" keeps the locks of the same tables
+        if (!sessionTablesLocked) {
+            QSqlQuery query(sqlDatabase);
+            sessionTablesLocked = query.exec("begin immediate");
+            if (!sessionTablesLocked) {
+                qCCritical(DatabaseInterfaceLog) << "Error locking the session tables:" << query.lastError().text();
+            }
+        }
+        return;
+    }
+
     QSqlQuery *query = prepareQuery("lock tables {prefix}_sessions write, {prefix}_users read");
     execSqlQuery(query);
 }
 
 void Servatrice_DatabaseInterface::unlockSessionTables()
 {
+    if (isSqlite()) {
+        // the login unlocks on paths that never locked, which "unlock tables" allows as well
+        if (sessionTablesLocked) {
+            sessionTablesLocked = false;
+            QSqlQuery query(sqlDatabase);
+            if (!query.exec("commit")) {
+                qCCritical(DatabaseInterfaceLog) << "Error unlocking the session tables:" << query.lastError().text();
+                query.exec("rollback");
+            }
+        }
+        return;
+    }
+
     QSqlQuery *query = prepareQuery("unlock tables");
     execSqlQuery(query);
 }
@@ -1323,98 +1423,51 @@ QList<ServerInfo_ChatMessage> Servatrice_DatabaseInterface::getMessageLogHistory
                                                                                  bool &game,
                                                                                  bool &room,
                                                                                  int &range,
-                                                                                 int &maxresults)
+                                                                                 int &maxresults,
+                                                                                 qint64 beforeId,
+                                                                                 qint64 &lastId)
 {
 
     QList<ServerInfo_ChatMessage> results;
     ServerInfo_ChatMessage chatMessage;
+    lastId = 0;
 
     if (!checkSql()) {
         return results;
     }
 
-    if (user.isEmpty() && ipaddress.isEmpty() && gameid.isEmpty() && gamename.isEmpty()) {
-        // To ensure quick results and minimal lag, require an indexed field
+    Servatrice_LogQuery logQuery;
+    logQuery.user = user;
+    logQuery.ipAddress = ipaddress;
+    logQuery.gameName = gamename;
+    logQuery.gameId = gameid;
+    logQuery.message = message;
+    logQuery.chat = chat;
+    logQuery.game = game;
+    logQuery.room = room;
+    logQuery.beforeId = beforeId;
+    logQuery.maxResults = maxresults;
+    if (!logQuery.hasFilter()) {
         return results;
     }
 
-    // BUILD QUERY STRING BASED ON PASSED IN VALUES
-    QString queryString = "SELECT * FROM {prefix}_log WHERE `sender_ip` IS NOT NULL";
-    if (!user.isEmpty()) {
-        queryString.append(" AND (`sender_name` = :user_name OR `target_name` = :user_name)");
-    }
-
-    if (!ipaddress.isEmpty()) {
-        queryString.append(" AND `sender_ip` = :ip_to_find");
-    }
-
-    if (!gameid.isEmpty()) {
-        queryString.append(" AND (`target_id` = :game_id AND `target_type` = 'game')");
-    }
-
-    if (!gamename.isEmpty()) {
-        queryString.append(" AND (`target_name` = :game_name AND `target_type` = 'game')");
-    }
-
-    if (!message.isEmpty()) {
-        queryString.append(" AND `log_message` LIKE :log_message");
-    }
-
-    if (chat || game || room) {
-        queryString.append(" AND (");
-
-        if (chat) {
-            queryString.append("`target_type` = 'chat'");
-        }
-
-        if (game) {
-            if (chat) {
-                queryString.append(" OR `target_type` = 'game'");
-            } else {
-                queryString.append("`target_type` = 'game'");
-            }
+    // The date range is turned into the id of the first message inside it, which bounds every filter of the search.
+    if (range) {
+        QSqlQuery *firstIdQuery = prepareQuery("select id from {prefix}_log where log_time >= date_sub(now(), interval "
+                                               ":range_time hour) order by log_time limit 1");
+        firstIdQuery->bindValue(":range_time", range);
+        if (!execSqlQuery(firstIdQuery)) {
+            qCWarning(DatabaseInterfaceLog) << "Failed to collect log history information: SQL Error";
+            return results;
         }
-
-        if (room) {
-            if (game || chat) {
-                queryString.append(" OR `target_type` = 'room'");
-            } else {
-                queryString.append("`target_type` = 'room'");
-            }
+        if (!firstIdQuery->next()) {
+            return results;
         }
-        queryString.append(")");
-    }
-
-    if (range) {
-        queryString.append(" AND log_time >= DATE_SUB(now(), INTERVAL :range_time HOUR)");
-    }
-
-    if (maxresults) {
-        queryString.append(" LIMIT :limit_size");
+        logQuery.firstId = firstIdQuery->value(0).toLongLong();
     }
 
-    QSqlQuery *query = prepareQuery(queryString);
-    if (!user.isEmpty()) {
-        query->bindValue(":user_name", user);
-    }
-    if (!ipaddress.isEmpty()) {
-        query->bindValue(":ip_to_find", ipaddress);
-    }
-    if (!gameid.isEmpty()) {
-        query->bindValue(":game_id", gameid);
-    }
-    if (!gamename.isEmpty()) {
-        query->bindValue(":game_name", gamename);
-    }
-    if (!message.isEmpty()) {
-        query->bindValue(":log_message", message);
-    }
-    if (range) {
-        query->bindValue(":range_time", range);
-    }
-    if (maxresults) {
-        query->bindValue(":limit_size", maxresults);
-    }
+    QSqlQuery *query = prepareQuery(logQuery.statement());
+    logQuery.bindValues(*query);
 
     if (!execSqlQuery(query)) {
         qCWarning(DatabaseInterfaceLog) << "Failed to collect log history information: SQL Error";
@@ -1430,6 +1483,7 @@ QList<ServerInfo_ChatMessage> Servatrice_DatabaseInterface::getMessageLogHistory
         chatMessage.set_target_type(QString(query->value(5).toString()).toStdString());
         chatMessage.set_target_id(QString(query->value(6).toString()).toStdString());
         chatMessage.set_target_name(QString(query->value(7).toString()).toStdString());
+        lastId = query->value(8).toLongLong();
         results << chatMessage;
     }
 
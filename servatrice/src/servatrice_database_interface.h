@@ -10,9 +10,10 @@
 #include <server.h>
 #include <server_database_interface.h>
 
-#define DATABASE_SCHEMA_VERSION 35
+#define DATABASE_SCHEMA_VERSION 36
 
 class Servatrice;
+class Server_LatencyHistogram;
 
 class Servatrice_DatabaseInterface : public Server_DatabaseInterface
 {
@@ -21,7 +22,17 @@ private:
     int instanceId;
     QSqlDatabase sqlDatabase;
     QHash<QString, QSqlQuery *> preparedStatements;
+    // only filled when metrics are enabled
+    QHash<QSqlQuery *, Server_LatencyHistogram *> statementHistograms;
     Servatrice *server;
+    // whether the write transaction standing in for the session table locks on SQLite is open
+    bool sessionTablesLocked = false;
+    bool isSqlite() const
+    {
+        return sqlDatabase.driverName() == "QSQLITE";
+    }
+    /** Sets up a freshly opened SQLite connection and creates the schema of an empty database. */
+    bool initSqliteConnection();
     ServerInfo_User evalUserQueryResult(const QSqlQuery *query, bool complete, bool withId = false);
     /** Must be called after checkSql and server is known to be in auth mode. */
     bool checkUserIsIdBanned(const QString &clientId, QString &banReason, int &banSecondsRemaining);
@@ -132,7 +143,9 @@ public:
                                                        bool &game,
                                                        bool &room,
                                                        int &range,
-                                                       int &maxresults);
+                                                       int &maxresults,
+                                                       qint64 beforeId,
+                                                       qint64 &lastId);
     bool addForgotPassword(const QString &user);
     bool removeForgotPassword(const QString &user) override;
     bool doesForgotPasswordExist(const QString &user);
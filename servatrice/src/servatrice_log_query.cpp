@@ -0,0 +1,97 @@
+#include "servatrice_log_query.h"
+
+#include <QSqlQuery>
+#include <QStringList>
+
+bool Servatrice_LogQuery::hasFilter() const
+{
+    // the message is a substring match, which no index serves
+    return !user.isEmpty() || !ipAddress.isEmpty() || !gameId.isEmpty() || !gameName.isEmpty();
+}
+
+QString Servatrice_LogQuery::statement() const
+{
+    // InnoDB and SQLite append the row id to every secondary index, so each filter is a range scan ending at the page
+    QString conditions = "`sender_ip` IS NOT NULL AND `id` >= :first_id AND `id` < :before_id";
+    if (!ipAddress.isEmpty()) {
+        conditions.append(" AND `sender_ip` = :ip_to_find");
+    }
+
+    if (!gameId.isEmpty()) {
+        conditions.append(" AND (`target_id` = :game_id AND `target_type` = 'game')");
+    }
+
+    if (!gameName.isEmpty()) {
+        conditions.append(" AND (`target_name` = :game_name AND `target_type` = 'game')");
+    }
+
+    if (!message.isEmpty()) {
+        conditions.append(" AND `log_message` LIKE :log_message ESCAPE '!'");
+    }
+
+    QStringList targetTypes;
+    if (chat) {
+        targetTypes << "'chat'";
+    }
+    if (game) {
+        targetTypes << "'game'";
+    }
+    if (room) {
+        targetTypes << "'room'";
+    }
+    if (!targetTypes.isEmpty()) {
+        conditions.append(QString(" AND `target_type` IN (%1)").arg(targetTypes.join(", ")));
+    }
+
+    const QString selectString = "SELECT `log_time`, `sender_id`, `sender_name`, `sender_ip`, `log_message`, "
+                                 "`target_type`, `target_id`, `target_name`, `id` FROM {prefix}_log WHERE ";
+    QString queryString;
+    if (!user.isEmpty()) {
+        // one range scan on each name index instead of merging both indexes over the whole history of the user
+        queryString = QString("SELECT * FROM (%1`sender_name` = :user_name AND %2 ORDER BY `id` DESC LIMIT "
+                              ":limit_size) AS sent UNION SELECT * FROM (%1`target_name` = :user_name AND %2 ORDER BY "
+                              "`id` DESC LIMIT :limit_size) AS received")
+                          .arg(selectString, conditions);
+    } else {
+        queryString = selectString + conditions;
+    }
+    queryString.append(" ORDER BY `id` DESC LIMIT :limit_size");
+    return queryString;
+}
+
+void Servatrice_LogQuery::bindValues(QSqlQuery &query) const
+{
+    query.bindValue(":first_id", firstId);
+    query.bindValue(":before_id", beforeId);
+    query.bindValue(":limit_size", maxResults);
+    if (!user.isEmpty()) {
+        query.bindValue(":user_name", user);
+    }
+    if (!ipAddress.isEmpty()) {
+        query.bindValue(":ip_to_find", ipAddress);
+    }
+    if (!gameId.isEmpty()) {
+        query.bindValue(":game_id", gameId);
+    }
+    if (!gameName.isEmpty()) {
+        query.bindValue(":game_name", gameName);
+    }
+    if (!message.isEmpty()) {
+        query.bindValue(":log_message", containsPattern(message));
+    }
+}
+
+QString Servatrice_LogQuery::containsPattern(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size() + 2);
+    escaped += '%';
+    for (const QChar c : text) {
+        if (c == '!' || c == '%' || c == '_') {
+            escaped += '!';
+        }
+        escaped += c;
+    }
+    escaped += '%';
+    return escaped;
+}
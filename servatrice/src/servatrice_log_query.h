@@ -0,0 +1,48 @@
+#ifndef SERVATRICE_LOG_QUERY_H
+#define SERVATRICE_LOG_QUERY_H
+
+#include <QString>
+
+class QSqlQuery;
+
+/**
+ * A page of the moderators' log search. The statement is written in the MySQL dialect like every other query of
+ * servatrice and matches the same messages on MySQL and SQLite: every filter is bounded by a range of log ids, and
+ * the message filter is a substring match.
+ */
+class Servatrice_LogQuery
+{
+public:
+    QString user;
+    QString ipAddress;
+    QString gameName;
+    QString gameId;
+    QString message;
+    bool chat = false;
+    bool game = false;
+    bool room = false;
+    /** Lowest id to return, the first message of the searched date range. */
+    qint64 firstId = 0;
+    /** The id below which the page starts, the last id of the previous page. */
+    qint64 beforeId = 0;
+    int maxResults = 0;
+
+    /**
+     * To ensure quick results and minimal lag, a search needs a filter on an indexed field, which the message and the
+     * location are not.
+     */
+    bool hasFilter() const;
+    /**
+     * Selects the log time, sender id, name and ip, message, target type, id and name, and the id of the matching
+     * messages, newest first.
+     */
+    QString statement() const;
+    void bindValues(QSqlQuery &query) const;
+
+    /**
+     * @return a LIKE pattern matching any text containing the given text, with '!' as the escape character
+     */
+    static QString containsPattern(const QString &text);
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "servatrice_metrics.h"
+
+#include "servatrice.h"
+
+#include <QMutexLocker>
+#include <QTcpSocket>
+
+// requests larger than this are not scrapes, drop them
+static const int maxRequestSize = 8192;
+static const int maxStatementLabelLength = 80;
+
+Servatrice_Metrics::Servatrice_Metrics(Servatrice *_server) : Server_Metrics(), server(_server)
+{
+}
+
+Server_LatencyHistogram *Servatrice_Metrics::getSqlHistogram(const QString &queryText)
+{
+    QMutexLocker locker(&sqlHistogramsMutex);
+    std::shared_ptr<Server_LatencyHistogram> &histogram = sqlHistograms[queryText];
+    if (!histogram) {
+        histogram = std::make_shared<Server_LatencyHistogram>();
+    }
+    return histogram.get();
+}
+
+void Servatrice_Metrics::appendPrometheus(QString &out) const
+{
+    Server_Metrics::appendPrometheus(out);
+
+    out += "# HELP servatrice_sql_duration_seconds Time spent executing a prepared statement.\n";
+    out += "# TYPE servatrice_sql_duration_seconds histogram\n";
+    {
+        QMutexLocker locker(&sqlHistogramsMutex);
+        for (auto it = sqlHistograms.constBegin(); it != sqlHistograms.constEnd(); ++it) {
+            const QString statement = it.key().simplified().left(maxStatementLabelLength);
+            it.value()->appendPrometheus(out, "servatrice_sql_duration_seconds",
+                                         QString("statement=\"%1\"").arg(escapeLabelValue(statement)));
+        }
+    }
+
+    const Servatrice_OutputBufferStats stats = server->getOutputBufferStats();
+    out += "# HELP servatrice_connections Number of client connections.\n";
+    out += "# TYPE servatrice_connections gauge\n";
+    out += QString("servatrice_connections %1\n").arg(stats.connections);
+    out += "# HELP servatrice_users Number of logged in users.\n";
+    out += "# TYPE servatrice_users gauge\n";
+    out += QString("servatrice_users %1\n").arg(server->getUsersCount());
+    out += "# HELP servatrice_games Number of games.\n";
+    out += "# TYPE servatrice_games gauge\n";
+    out += QString("servatrice_games %1\n").arg(server->getGamesCount());
+    out += "# HELP servatrice_output_buffer_bytes Serialized messages waiting to be written to the client sockets.\n";
+    out += "# TYPE servatrice_output_buffer_bytes gauge\n";
+    out += QString("servatrice_output_buffer_bytes %1\n").arg(stats.totalBytes);
+    out += "# HELP servatrice_output_buffer_messages Messages waiting to be written to the client sockets.\n";
+    out += "# TYPE servatrice_output_buffer_messages gauge\n";
+    out += QString("servatrice_output_buffer_messages %1\n").arg(stats.totalMessages);
+    out += "# HELP servatrice_output_buffer_max_bytes Largest output buffer of a single connection.\n";
+    out += "# TYPE servatrice_output_buffer_max_bytes gauge\n";
+    out += QString("servatrice_output_buffer_max_bytes %1\n").arg(stats.maxBytes);
+    out += "# HELP servatrice_output_buffer_peak_bytes Largest output buffer ever reached by a current connection.\n";
+    out += "# TYPE servatrice_output_buffer_peak_bytes gauge\n";
+    out += QString("servatrice_output_buffer_peak_bytes %1\n").arg(stats.maxPeakBytes);
+}
+
+Servatrice_MetricsServer::Servatrice_MetricsServer(Servatrice_Metrics *_metrics, QObject *parent)
+    : QTcpServer(parent), metrics(_metrics)
+{
+}
+
+void Servatrice_MetricsServer::incomingConnection(qintptr socketDescriptor)
+{
+    auto *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        socket->deleteLater();
+        return;
+    }
+    connect(socket, &QTcpSocket::readyRead, this, &Servatrice_MetricsServer::readRequest);
+    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+}
+
+void Servatrice_MetricsServer::readRequest()
+{
+    auto *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+    if (!request.contains("\r\n\r\n")) {
+        if (request.size() > maxRequestSize) {
+            socket->abort();
+            socket->deleteLater();
+        } else {
+            socket->setProperty("request", request);
+        }
+        return;
+    }
+
+    QByteArray status = "200 OK";
+    QString body;
+    if (request.startsWith("GET ")) {
+        metrics->appendPrometheus(body);
+    } else {
+        status = "405 Method Not Allowed";
+    }
+
+    const QByteArray payload = body.toUtf8();
+    QByteArray response = "HTTP/1.0 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + QByteArray::number(payload.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += payload;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
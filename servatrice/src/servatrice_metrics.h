@@ -0,0 +1,65 @@
+#ifndef SERVATRICE_METRICS_H
+#define SERVATRICE_METRICS_H
+
+#include <QMap>
+#include <QMutex>
+#include <QTcpServer>
+#include <memory>
+#include <server_metrics.h>
+
+class Servatrice;
+class QTcpSocket;
+
+struct Servatrice_OutputBufferStats
+{
+    int connections = 0;
+    int totalMessages = 0;
+    qint64 totalBytes = 0;
+    qint64 maxBytes = 0;
+    qint64 maxPeakBytes = 0;
+};
+
+/**
+ * Adds the servatrice specific measurements (sql statements, connection output buffers) to the
+ * command path metrics of the server library.
+ */
+class Servatrice_Metrics : public Server_Metrics
+{
+public:
+    explicit Servatrice_Metrics(Servatrice *_server);
+
+    /**
+     * Returns the histogram for a prepared statement. The pointer stays valid for the lifetime of the metrics,
+     * so database interfaces look it up once per prepared statement.
+     */
+    Server_LatencyHistogram *getSqlHistogram(const QString &queryText);
+
+    void appendPrometheus(QString &out) const override;
+
+private:
+    Servatrice *server;
+    mutable QMutex sqlHistogramsMutex;
+    QMap<QString, std::shared_ptr<Server_LatencyHistogram>> sqlHistograms;
+};
+
+/**
+ * Minimal HTTP endpoint answering every request with the current metrics in the Prometheus text format.
+ * It is meant to be bound to a local address and scraped by a collector running on the same host.
+ */
+class Servatrice_MetricsServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit Servatrice_MetricsServer(Servatrice_Metrics *_metrics, QObject *parent = nullptr);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private slots:
+    void readRequest();
+
+private:
+    Servatrice_Metrics *metrics;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include "servatrice_sql_dialect.h"
+
+#include <QList>
+#include <QRegularExpression>
+
+namespace
+{
+struct Rewrite
+{
+    QRegularExpression pattern;
+    QString replacement;
+};
+
+QRegularExpression ci(const QString &pattern)
+{
+    return QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption);
+}
+
+// MySQL stores now() in the local time zone, so the SQLite expressions use local time as well;
+// time differences are computed on seconds since the epoch of both sides and are therefore unaffected.
+const QList<Rewrite> &queryRewrites()
+{
+    static const QList<Rewrite> rewrites = {
+        {ci(R"(timestampdiff\(\s*second\s*,\s*now\(\)\s*,\s*date_add\(\s*([\w.]+)\s*,\s*interval\s+([\w.:]+)\s+minute\s*\)\s*\))"),
+         "(strftime('%s', \\1) + \\2 * 60 - strftime('%s', 'now', 'localtime'))"},
+        {ci(R"(date_add\(\s*([\w.]+)\s*,\s*interval\s+([\w.:]+)\s+(second|minute|hour|day)\s*\))"),
+         "datetime(\\1, '+' || \\2 || ' \\3s')"},
+        {ci(R"(date_sub\(\s*now\(\)\s*,\s*interval\s+([\w.:]+)\s+(second|minute|hour|day)\s*\))"),
+         "datetime('now', 'localtime', '-' || \\1 || ' \\2s')"},
+        {ci(R"(\(\s*now\(\)\s*-\s*interval\s+([\w.:]+)\s+(second|minute|hour|day)\s*\))"),
+         "datetime('now', 'localtime', '-' || \\1 || ' \\2s')"},
+        {ci(R"(\butc_timestamp\(\))"), "datetime('now')"},
+        {ci(R"(\bnow\(\))"), "datetime('now', 'localtime')"},
+        {ci(R"(<=>)"), "is"},
+        {ci(R"(\bsubstring\()"), "substr("},
+        {ci(R"(\bon duplicate key update\b)"), "on conflict do update set"},
+    };
+    return rewrites;
+}
+} // namespace
+
+QVersionNumber Servatrice_SqlDialect::minimumSqliteVersion()
+{
+    return QVersionNumber(3, 35);
+}
+
+QString Servatrice_SqlDialect::toSqlite(const QString &query)
+{
+    QString result = query;
+    for (const Rewrite &rewrite : queryRewrites()) {
+        result.replace(rewrite.pattern, rewrite.replacement);
+    }
+    return result;
+}
+
+QStringList Servatrice_SqlDialect::schemaToSqlite(const QString &script, const QString &prefix)
+{
+    static const QRegularExpression versionedComment(R"(/\*!.*?\*/;?)",
+                                                     QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression lineComment(R"((^|\s)--[^\n]*)");
+    static const QRegularExpression defaultPrefix(R"(\bcockatrice_)");
+
+    QString cleaned = script;
+    cleaned.remove(QChar(0xFEFF));
+    cleaned.remove(versionedComment);
+    cleaned.replace(lineComment, "\\1");
+    cleaned.replace(defaultPrefix, prefix + "_");
+
+    QStringList result;
+    for (const QString &rawStatement : cleaned.split(';')) {
+        const QString statement = rawStatement.trimmed();
+        if (statement.isEmpty() || statement.startsWith("SET ", Qt::CaseInsensitive)) {
+            continue;
+        }
+        if (statement.startsWith("CREATE TABLE", Qt::CaseInsensitive)) {
+            result.append(convertCreateTable(statement));
+        } else {
+            result.append(statement);
+        }
+    }
+    return result;
+}
+
+QStringList Servatrice_SqlDialect::convertCreateTable(const QString &statement)
+{
+    static const QRegularExpression createTable(R"(^CREATE TABLE IF NOT EXISTS\s+`?(\w+)`?\s*\((.*)\)[^)]*$)",
+                                                QRegularExpression::CaseInsensitiveOption |
+                                                    QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression uniqueKey(ci(R"(^UNIQUE\s+KEY\s+`?\w+`?\s*(\(.*\))$)"));
+    static const QRegularExpression secondaryKey(ci(R"(^(?:KEY|INDEX)\s+`?(\w+)`?\s*(\(.*\))$)"));
+    static const QRegularExpression column(R"(^(`?\w+`?)\s+(\w+)(\([^)]*\))?(.*)$)");
+    static const QRegularExpression integerType(ci(R"(^(tiny|small|medium|big)?int(eger)?$)"));
+    static const QRegularExpression columnFlags(ci(R"(\b(unsigned|zerofill|auto_increment)\b)"));
+    static const QRegularExpression whitespace(R"(\s+)");
+
+    const QRegularExpressionMatch match = createTable.match(statement);
+    if (!match.hasMatch()) {
+        return {statement};
+    }
+    const QString table = match.captured(1);
+    const QStringList items = splitTopLevel(match.captured(2));
+
+    QString autoIncrementColumn;
+    for (const QString &item : items) {
+        if (item.startsWith('`') && item.contains("auto_increment", Qt::CaseInsensitive)) {
+            autoIncrementColumn = item.section(' ', 0, 0);
+        }
+    }
+
+    QStringList definitions;
+    QStringList indexes;
+    for (QString item : items) {
+        item = item.simplified();
+        if (item.isEmpty()) {
+            continue;
+        }
+
+        if (item.startsWith("PRIMARY KEY", Qt::CaseInsensitive)) {
+            // an auto_increment key becomes an inline "integer primary key" instead
+            if (autoIncrementColumn.isEmpty()) {
+                definitions.append(item);
+            }
+        } else if (const QRegularExpressionMatch unique = uniqueKey.match(item); unique.hasMatch()) {
+            definitions.append("UNIQUE " + unique.captured(1));
+        } else if (const QRegularExpressionMatch key = secondaryKey.match(item); key.hasMatch()) {
+            // index names are global in SQLite
+            indexes.append(QString("CREATE INDEX IF NOT EXISTS `%1_%2` ON `%1` %3")
+                               .arg(table, key.captured(1), key.captured(2)));
+        } else if (item.startsWith("FULLTEXT", Qt::CaseInsensitive)) {
+            // no full-text index without FTS tables, the queries fall back to a substring match
+            continue;
+        } else if (item.startsWith("FOREIGN KEY", Qt::CaseInsensitive)) {
+            definitions.append(item);
+        } else if (const QRegularExpressionMatch col = column.match(item); col.hasMatch()) {
+            const QString name = col.captured(1);
+            QString type = col.captured(2) + col.captured(3);
+            QString constraints = col.captured(4);
+            constraints.remove(columnFlags);
+            constraints = constraints.simplified();
+
+            const bool isInteger = integerType.match(col.captured(2)).hasMatch();
+            if (isInteger) {
+                type = "INTEGER";
+            } else if (col.captured(2).compare("enum", Qt::CaseInsensitive) == 0) {
+                type = "TEXT";
+            }
+
+            if (name == autoIncrementColumn) {
+                definitions.append(QString("%1 INTEGER PRIMARY KEY AUTOINCREMENT").arg(name));
+                continue;
+            }
+            // MySQL fills omitted NOT NULL columns with an implicit default, the queries rely on that
+            if (constraints.contains("NOT NULL", Qt::CaseInsensitive) &&
+                !constraints.contains("DEFAULT", Qt::CaseInsensitive)) {
+                QString implicitDefault = "''";
+                if (isInteger || col.captured(2).compare("double", Qt::CaseInsensitive) == 0) {
+                    implicitDefault = "0";
+                } else if (col.captured(2).compare("datetime", Qt::CaseInsensitive) == 0) {
+                    implicitDefault = "'0000-00-00 00:00:00'";
+                }
+                constraints += " DEFAULT " + implicitDefault;
+            }
+            definitions.append(QString("%1 %2 %3").arg(name, type, constraints).replace(whitespace, " ").trimmed());
+        } else {
+            definitions.append(item);
+        }
+    }
+
+    QStringList result;
+    result.append(QString("CREATE TABLE IF NOT EXISTS `%1` (\n  %2\n)").arg(table, definitions.join(",\n  ")));
+    result.append(indexes);
+    return result;
+}
+
+QStringList Servatrice_SqlDialect::splitTopLevel(const QString &text)
+{
+    QStringList result;
+    QString current;
+    int depth = 0;
+    bool inQuotes = false;
+    QChar quote;
+    for (const QChar c : text) {
+        if (inQuotes) {
+            if (c == quote) {
+                inQuotes = false;
+            }
+        } else if (c == '\'' || c == '"') {
+            inQuotes = true;
+            quote = c;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            result.append(current.trimmed());
+            current.clear();
+            continue;
+        }
+        current += c;
+    }
+    if (!current.trimmed().isEmpty()) {
+        result.append(current.trimmed());
+    }
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef SERVATRICE_SQL_DIALECT_H
+#define SERVATRICE_SQL_DIALECT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVersionNumber>
+
+/**
+ * Translates the MySQL statements used throughout servatrice for the embedded SQLite backend.
+ * Queries are written once in the MySQL dialect; the few MySQL-only constructs they use (date arithmetic, the
+ * null-safe comparison, upserts) are rewritten when a statement is prepared, so the translation cost is paid once per
+ * prepared statement. Table locks have no SQLite statement; the database interface opens a write transaction instead.
+ */
+class Servatrice_SqlDialect
+{
+public:
+    /** The oldest SQLite the rewritten statements run on: upserts without a conflict target need 3.35. */
+    static QVersionNumber minimumSqliteVersion();
+
+    static QString toSqlite(const QString &query);
+
+    /**
+     * Converts the MySQL schema script (servatrice.sql) into SQLite statements, one statement per list entry.
+     * Table options and full-text keys are dropped, auto_increment keys become rowid aliases and secondary keys
+     * become separate create index statements.
+     * @param prefix table prefix replacing the default "cockatrice" prefix of the script
+     */
+    static QStringList schemaToSqlite(const QString &script, const QString &prefix);
+
+private:
+    static QStringList convertCreateTable(const QString &statement);
+    static QStringList splitTopLevel(const QString &text);
+};
+
+#endif
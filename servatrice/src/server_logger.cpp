@@ -1,26 +1,109 @@
 #include "server_logger.h"
 
-#include "settingscache.h"
-
-#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
-#include <QTextStream>
+#include <QSettings>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <vector>
+
+struct ServerLogger::StagedLine
+{
+    quint64 sequence;
+    QString text;
+    StagedLine *next;
+};
+
+/**
+ * The lines one thread logged since the last flush, newest first. The thread pushes and the logger thread takes
+ * them all at once, neither has to lock.
+ */
+struct ServerLogger::StagingBuffer
+{
+    static constexpr quint64 idle = std::numeric_limits<quint64>::max();
+
+    std::atomic<StagedLine *> head = nullptr;
+    /** While the thread is staging a line, no more than the sequence of that line; idle otherwise. */
+    std::atomic<quint64> staging = idle;
+
+    ~StagingBuffer()
+    {
+        StagedLine *line = head.exchange(nullptr);
+        while (line) {
+            StagedLine *next = line->next;
+            delete line;
+            line = next;
+        }
+    }
+};
+
+struct ServerLogger::ThreadState
+{
+    quint64 loggerId = 0;
+    std::shared_ptr<StagingBuffer> buffer;
+    quint64 configurationVersion = 0;
+    std::shared_ptr<const Configuration> configuration;
+    qint64 timestampSecond = -1;
+    QString timestamp;
+};
+
+static std::atomic<quint64> nextLoggerId = 1;
+
+bool ServerLogger::Configuration::accepts(const QString &message) const
+{
+    if (filters.isEmpty()) {
+        return true;
+    }
+    for (const QStringMatcher &filter : filters) {
+        if (filter.indexIn(message) != -1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ServerLogger::Configuration ServerLogger::Configuration::fromSettings(const QSettings &settings)
+{
+    Configuration result;
+    result.writeLog = settings.value("server/writelog", 1).toBool();
+    const QStringList logFilters = settings.value("server/logfilters").toString().split(",", Qt::SkipEmptyParts);
+    for (const QString &logFilter : logFilters) {
+        if (!logFilter.trimmed().isEmpty()) {
+            result.filters.append(QStringMatcher(logFilter, Qt::CaseInsensitive));
+        }
+    }
+    result.rotateSize = settings.value("server/logrotatesize", 0).toLongLong() * 1024 * 1024;
+    result.rotateInterval = settings.value("server/logrotateinterval", 0).toLongLong() * 60 * 60;
+    result.compressRotated = settings.value("server/logrotatecompress", 1).toBool();
+    return result;
+}
 
 ServerLogger::ServerLogger(bool _logToConsole, QObject *parent)
-    : QObject(parent), logToConsole(_logToConsole), flushRunning(false)
+    : QObject(parent), loggerId(nextLoggerId++), logToConsole(_logToConsole), logFile(0), logging(false),
+      configuration(std::make_shared<Configuration>()), configurationVersion(1), nextSequence(0),
+      flushScheduled(false), fileSize(0)
 {
+    compressionPool.setMaxThreadCount(1);
 }
 
 ServerLogger::~ServerLogger()
 {
     flushBuffer();
+    qDeleteAll(heldLines);
+    compressionPool.waitForDone();
     // This does not work with the destroyed() signal as this destructor is called after the main event loop is done.
     thread()->quit();
 }
 
+void ServerLogger::setConfiguration(const Configuration &_configuration)
+{
+    QMutexLocker locker(&configurationMutex);
+    configuration = std::make_shared<const Configuration>(_configuration);
+    ++configurationVersion;
+}
+
 void ServerLogger::startLog(const QString &logFileName)
 {
     if (!logFileName.isEmpty()) {
@@ -33,7 +116,7 @@ void ServerLogger::startLog(const QString &logFileName)
         }
 
         logFile = new QFile(logFileName, this);
-        if (!logFile->open(QIODevice::Append)) {
+        if (!openLogFile()) {
             std::cerr << "ERROR: can't open() logfile." << std::endl;
             delete logFile;
             logFile = 0;
@@ -43,75 +126,249 @@ void ServerLogger::startLog(const QString &logFileName)
         logFile = 0;
     }
 
-    connect(this, SIGNAL(sigFlushBuffer()), this, SLOT(flushBuffer()), Qt::QueuedConnection);
+    logging = logFile != 0;
+}
+
+bool ServerLogger::openLogFile()
+{
+    if (!logFile->open(QIODevice::Append)) {
+        return false;
+    }
+    fileSize = logFile->size();
+    // the age of a log that is appended to counts from when it was created, not from when the server restarted
+    const QFileInfo fileInfo(*logFile);
+    fileOpened = fileSize == 0 ? QDateTime::currentDateTimeUtc() : fileInfo.birthTime().toUTC();
+    if (!fileOpened.isValid()) {
+        // file systems that don't record the birth time
+        fileOpened = fileInfo.lastModified().toUTC();
+    }
+    return true;
+}
+
+ServerLogger::ThreadState &ServerLogger::threadState()
+{
+    thread_local ThreadState state;
+    return state;
+}
+
+std::shared_ptr<const ServerLogger::Configuration> ServerLogger::currentConfiguration(ThreadState &state)
+{
+    // the lock is only taken on the first line a thread logs after a reload
+    if (state.configurationVersion != configurationVersion) {
+        QMutexLocker locker(&configurationMutex);
+        state.configuration = configuration;
+        state.configurationVersion = configurationVersion;
+    }
+    return state.configuration;
 }
 
 void ServerLogger::logMessage(const QString &message, void *caller)
 {
-    if (!logFile) {
+    if (!logging) {
+        return;
+    }
+
+    ThreadState &state = threadState();
+    if (state.loggerId != loggerId) {
+        state.loggerId = loggerId;
+        state.configurationVersion = 0;
+        state.buffer = std::make_shared<StagingBuffer>();
+        QMutexLocker locker(&buffersMutex);
+        buffers.append(state.buffer);
+    }
+
+    const auto config = currentConfiguration(state);
+    if (!config->writeLog || !config->accepts(message)) {
         return;
     }
 
-    QString callerString;
+    // formatting the date is expensive, lines logged within the same second share it
+    const qint64 second = QDateTime::currentSecsSinceEpoch();
+    if (second != state.timestampSecond) {
+        state.timestampSecond = second;
+        state.timestamp = QDateTime::fromSecsSinceEpoch(second).toString();
+    }
+
+    QString text = state.timestamp + " ";
     if (caller) {
-        callerString = QString::number((qulonglong)caller, 16) + " ";
+        text += QString::number((qulonglong)caller, 16) + " ";
     }
+    text += message;
 
-    // filter out all log entries based on values in configuration file
-    bool shouldWeWriteLog = settingsCache->value("server/writelog", 1).toBool();
-    QString logFilters = settingsCache->value("server/logfilters").toString();
-    QStringList listlogFilters = logFilters.split(",", Qt::SkipEmptyParts);
-    bool shouldWeSkipLine = false;
+    // a flush holds back the lines logged after this one until it is on the buffer
+    auto *line = new StagedLine{0, std::move(text), state.buffer->head.load(std::memory_order_relaxed)};
+    state.buffer->staging = nextSequence.load();
+    line->sequence = nextSequence++;
+    while (!state.buffer->head.compare_exchange_weak(line->next, line, std::memory_order_release,
+                                                     std::memory_order_relaxed)) {
+    }
+    state.buffer->staging = StagingBuffer::idle;
 
-    if (!shouldWeWriteLog) {
-        return;
+    if (!flushScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, "flushBuffer", Qt::QueuedConnection);
     }
+}
 
-    if (!logFilters.trimmed().isEmpty()) {
-        shouldWeSkipLine = true;
-        for (const QString &logFilter : listlogFilters) {
-            if (message.contains(logFilter, Qt::CaseInsensitive)) {
-                shouldWeSkipLine = false;
-                break;
+void ServerLogger::flushBuffer()
+{
+    // lines staged from here on schedule another flush
+    flushScheduled = false;
+
+    std::vector<StagedLine *> lines(heldLines.begin(), heldLines.end());
+    heldLines.clear();
+
+    // Every line below this bound is on its buffer by the time the buffers are emptied: a thread still staging one
+    // has its mark set, and a thread that starts staging after its mark was read takes at least nextSequence as read.
+    quint64 writableBelow = nextSequence.load();
+    {
+        QMutexLocker locker(&buffersMutex);
+        for (const auto &buffer : buffers) {
+            writableBelow = std::min(writableBelow, buffer->staging.load());
+        }
+        for (int i = buffers.size() - 1; i >= 0; --i) {
+            const auto &buffer = buffers[i];
+            for (StagedLine *line = buffer->head.exchange(nullptr, std::memory_order_acquire); line;
+                 line = line->next) {
+                lines.push_back(line);
+            }
+            // only this list still holds the buffer once its thread has finished
+            if (buffer.use_count() == 1 && !buffer->head.load()) {
+                buffers.removeAt(i);
             }
         }
     }
+    if (lines.empty()) {
+        return;
+    }
 
-    if (shouldWeSkipLine) {
+    std::sort(lines.begin(), lines.end(),
+              [](const StagedLine *a, const StagedLine *b) { return a->sequence < b->sequence; });
+    // the thread staging the missing line schedules the next flush once it is done
+    while (!lines.empty() && lines.back()->sequence >= writableBelow) {
+        heldLines.prepend(lines.back());
+        lines.pop_back();
+    }
+    if (lines.empty()) {
         return;
     }
 
-    bufferMutex.lock();
-    buffer.append(QDateTime::currentDateTime().toString() + " " + callerString + message);
-    bufferMutex.unlock();
-    emit sigFlushBuffer();
+    QByteArray data;
+    for (StagedLine *line : lines) {
+        if (logToConsole) {
+            std::cout << line->text.toStdString() << std::endl;
+        }
+        data += line->text.toUtf8();
+        data += '\n';
+        delete line;
+    }
+
+    if (!logFile) {
+        return;
+    }
+    rotateIfDue(data.size());
+    if (logFile->isOpen()) {
+        logFile->write(data);
+        logFile->flush();
+        fileSize += data.size();
+    }
 }
 
-void ServerLogger::flushBuffer()
+// rotated logs are compressed this much at a time, so the size of a log is not limited by the memory it would take
+static constexpr qint64 compressionChunkSize = 16 * 1024 * 1024;
+
+/**
+ * @return the data compressed with deflate as one gzip member, empty if it could not be compressed
+ */
+static QByteArray gzipMember(const QByteArray &data)
 {
-    if (flushRunning) {
+    static const auto crcTable = [] {
+        std::vector<quint32> table(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    // qCompress puts a four byte length and the two byte zlib header before the deflate stream and a checksum after
+    const QByteArray compressed = qCompress(data, 9);
+    if (compressed.size() <= 10) {
+        return {};
+    }
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (const char byte : data) {
+        crc = crcTable[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    crc ^= 0xFFFFFFFFu;
+    const auto size = static_cast<quint32>(data.size());
+
+    QByteArray gzip("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\xff", 10);
+    gzip.append(compressed.constData() + 6, compressed.size() - 10);
+    for (quint32 value : {crc, size}) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            gzip.append(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+    return gzip;
+}
+
+/**
+ * Compresses the file into a gzip file next to it and removes it. Every chunk of the file becomes a gzip member of its
+ * own; gunzip and zcat read consecutive members as one file.
+ */
+static void compressRotatedLog(const QString &fileName)
+{
+    QFile in(fileName);
+    if (!in.open(QIODevice::ReadOnly) || in.size() == 0) {
         return;
     }
 
-    flushRunning = true;
-    QTextStream stream(logFile);
-    forever
+    QFile out(fileName + ".gz");
+    bool compressed = out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    while (compressed && !in.atEnd()) {
+        const QByteArray member = gzipMember(in.read(compressionChunkSize));
+        compressed = !member.isEmpty() && out.write(member) == member.size();
+    }
+    if (!compressed || in.error() != QFileDevice::NoError) {
+        std::cerr << "ERROR: Failed to compress rotated log file " << fileName.toStdString() << std::endl;
+        out.remove();
+        return;
+    }
+    in.close();
+    out.close();
+    QFile::remove(fileName);
+}
+
+void ServerLogger::rotateIfDue(qint64 pendingBytes)
+{
+    std::shared_ptr<const Configuration> config;
     {
-        bufferMutex.lock();
-        if (buffer.isEmpty()) {
-            bufferMutex.unlock();
-            flushRunning = false;
-            return;
-        }
-        QString message = buffer.takeFirst();
-        bufferMutex.unlock();
+        QMutexLocker locker(&configurationMutex);
+        config = configuration;
+    }
 
-        stream << message << "\n";
-        stream.flush();
+    const bool tooLarge = config->rotateSize > 0 && fileSize + pendingBytes > config->rotateSize;
+    const bool tooOld =
+        config->rotateInterval > 0 && fileOpened.secsTo(QDateTime::currentDateTimeUtc()) >= config->rotateInterval;
+    if (fileSize == 0 || (!tooLarge && !tooOld)) {
+        return;
+    }
 
-        if (logToConsole) {
-            std::cout << message.toStdString() << std::endl;
-        }
+    const QString fileName = logFile->fileName();
+    const QString rotatedName = fileName + "." + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz");
+    logFile->close();
+    if (!QFile::rename(fileName, rotatedName)) {
+        std::cerr << "ERROR: Failed to rotate log file!" << std::endl;
+    } else if (config->compressRotated) {
+        compressionPool.start([rotatedName] { compressRotatedLog(rotatedName); });
+    }
+
+    if (!openLogFile()) {
+        std::cerr << "ERROR: Failed to open log file for writing!" << std::endl;
     }
 }
 
@@ -124,9 +381,7 @@ void ServerLogger::rotateLogs()
     flushBuffer();
 
     logFile->close();
-    if (!logFile->open(QIODevice::Append)) {
+    if (!openLogFile()) {
         std::cerr << "ERROR: Failed to open log file for writing!" << std::endl;
     }
 }
-
-QFile *ServerLogger::logFile;
@@ -1,36 +1,95 @@
 #ifndef SERVER_LOGGER_H
 #define SERVER_LOGGER_H
 
+#include <QDateTime>
+#include <QList>
 #include <QMutex>
 #include <QObject>
-#include <QStringList>
-#include <QThread>
-#include <QWaitCondition>
+#include <QStringMatcher>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
 
 class QFile;
-class Server_ProtocolHandler;
+class QSettings;
 
+/**
+ * Writes the server log from a thread of its own. Any thread can log: a line is filtered against the configuration
+ * the logger was last given, stamped and put on a staging buffer of the calling thread without taking a lock, and
+ * the logger thread writes everything staged so far in one batch. Lines are written in the order they were logged in,
+ * across threads and batches.
+ *
+ * Besides reopening the log file on request, the logger can rotate it by size or age itself, compressing the rotated
+ * files to gzip in the background.
+ */
 class ServerLogger : public QObject
 {
     Q_OBJECT
 public:
+    struct Configuration
+    {
+        bool writeLog = true;
+        /** Case insensitive, a line is logged if it contains any of them. No filters logs every line. */
+        QList<QStringMatcher> filters;
+        /** Rotate once the file grows past this many bytes, never if 0. */
+        qint64 rotateSize = 0;
+        /** Rotate once the file is this many seconds old, never if 0. */
+        qint64 rotateInterval = 0;
+        bool compressRotated = true;
+
+        bool accepts(const QString &message) const;
+        static Configuration fromSettings(const QSettings &settings);
+    };
+
     ServerLogger(bool _logToConsole, QObject *parent = 0);
     ~ServerLogger();
+
+    /**
+     * Replaces the configuration, can be called from any thread.
+     */
+    void setConfiguration(const Configuration &configuration);
+    void reloadConfiguration(const QSettings &settings)
+    {
+        setConfiguration(Configuration::fromSettings(settings));
+    }
 public slots:
     void startLog(const QString &logFileName);
     void logMessage(const QString &message, void *caller = 0);
+    /**
+     * Reopens the log file, so it can be rotated by an external tool.
+     */
     void rotateLogs();
-private slots:
     void flushBuffer();
-signals:
-    void sigFlushBuffer();
 
 private:
+    struct StagedLine;
+    struct StagingBuffer;
+    struct ThreadState;
+
+    const quint64 loggerId;
     bool logToConsole;
-    static QFile *logFile;
-    bool flushRunning;
-    QStringList buffer;
-    QMutex bufferMutex;
+    QFile *logFile;
+    std::atomic<bool> logging;
+
+    QMutex configurationMutex;
+    std::shared_ptr<const Configuration> configuration;
+    std::atomic<quint64> configurationVersion;
+
+    QMutex buffersMutex;
+    QList<std::shared_ptr<StagingBuffer>> buffers;
+    std::atomic<quint64> nextSequence;
+    std::atomic<bool> flushScheduled;
+    /** Lines taken from the buffers that have to wait for a line logged before them to be staged. */
+    QList<StagedLine *> heldLines;
+
+    qint64 fileSize;
+    QDateTime fileOpened;
+    QThreadPool compressionPool;
+
+    static ThreadState &threadState();
+    std::shared_ptr<const Configuration> currentConfiguration(ThreadState &state);
+    bool openLogFile();
+    void rotateIfDue(qint64 pendingBytes);
 };
 
 #endif
@@ -30,6 +30,7 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QHash>
 #include <QHostAddress>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -84,6 +85,7 @@
 #include <libcockatrice/protocol/pb/serverinfo_replay.pb.h>
 #include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
 #include <libcockatrice/utility/string_limits.h>
+#include <limits>
 #include <server_response_containers.h>
 #include <server_room.h>
 #include <string>
@@ -93,13 +95,19 @@ inline Q_LOGGING_CATEGORY(TcpServerSocketInterfaceLog, "tcp_server_socket_interf
 inline Q_LOGGING_CATEGORY(WebsocketServerSocketInterfaceLog, "websocket_server_socket_interface");
 
 static const int protocolVersion = 14;
+static const int maxReplayListPageSize = 500;
+static const int maxLogHistoryPageSize = 1000;
 
 AbstractServerSocketInterface::AbstractServerSocketInterface(Servatrice *_server,
                                                              Servatrice_DatabaseInterface *_databaseInterface,
                                                              QObject *parent)
     : Server_ProtocolHandler(_server, _databaseInterface, parent), servatrice(_server),
-      sqlInterface(reinterpret_cast<Servatrice_DatabaseInterface *>(databaseInterface))
+      sqlInterface(reinterpret_cast<Servatrice_DatabaseInterface *>(databaseInterface)), outputBufferMessages(0),
+      peakOutputBufferSize(0), outputBufferOverflow(false)
 {
+    maxOutputBufferSize = settingsCache->value("security/max_output_buffer_size", 64 * 1024 * 1024).toLongLong();
+    maxSocketBufferSize = settingsCache->value("security/max_socket_buffer_size", 64 * 1024 * 1024).toLongLong();
+
     // Never call flushOutputQueue directly from outputQueueChanged. In case of a socket error,
     // it could lead to this object being destroyed while another function is still on the call stack. -> mutex
     // deadlocks etc.
@@ -152,11 +160,79 @@ void AbstractServerSocketInterface::catchSocketDisconnected()
 
 void AbstractServerSocketInterface::transmitProtocolItem(const ServerMessage &item)
 {
-    outputQueueMutex.lock();
-    outputQueue.append(item);
-    outputQueueMutex.unlock();
+#if GOOGLE_PROTOBUF_VERSION > 3001000
+    unsigned int size = static_cast<unsigned int>(item.ByteSizeLong());
+#else
+    unsigned int size = static_cast<unsigned int>(item.ByteSize());
+#endif
+
+    QMutexLocker locker(&outputQueueMutex);
+    if (outputBufferOverflow) {
+        // this client is going to be disconnected, don't keep buffering for it
+        return;
+    }
+
+    const bool wasEmpty = outputBuffer.isEmpty();
+    const qsizetype offset = outputBuffer.size();
+    outputBuffer.resize(offset + size + 4);
+    char *frame = outputBuffer.data() + offset;
+    if (!item.SerializeToArray(frame + 4, size)) {
+        outputBuffer.truncate(offset);
+        qCWarning(AbstractServerSocketInterfaceLog) << "serialisation error!";
+        return;
+    }
+    frame[3] = (unsigned char)size;
+    frame[2] = (unsigned char)(size >> 8);
+    frame[1] = (unsigned char)(size >> 16);
+    frame[0] = (unsigned char)(size >> 24);
+
+    ++outputBufferMessages;
+    peakOutputBufferSize = qMax(peakOutputBufferSize, static_cast<qint64>(outputBuffer.size()));
+    if (maxOutputBufferSize > 0 && outputBuffer.size() > maxOutputBufferSize) {
+        outputBufferOverflow = true;
+    }
+    locker.unlock();
+
+    // A flush is already pending while the buffer holds data, only the first message of a burst needs to request one.
+    if (wasEmpty) {
+        emit outputQueueChanged();
+    }
+}
 
-    emit outputQueueChanged();
+void AbstractServerSocketInterface::flushOutputQueue()
+{
+    QMutexLocker locker(&outputQueueMutex);
+    if (outputBuffer.isEmpty()) {
+        return;
+    }
+
+    QByteArray buffer;
+    buffer.swap(outputBuffer);
+    const int messages = outputBufferMessages;
+    outputBufferMessages = 0;
+    const bool overflow = outputBufferOverflow;
+    locker.unlock();
+
+    if (overflow) {
+        if (!deleted) {
+            logger->logMessage(QString("Disconnecting slow client: %1 messages (%2 bytes) queued")
+                                   .arg(messages)
+                                   .arg(buffer.size()),
+                               this);
+            prepareDestroy();
+        }
+        return;
+    }
+
+    // In case the socket write calls catchSocketError(), the mutex must not be locked during this call.
+    emit incTxBytes(writeOutputBuffer(buffer));
+    flushSocket();
+
+    const qint64 socketBytes = getSocketBytesToWrite();
+    if (maxSocketBufferSize > 0 && socketBytes > maxSocketBufferSize && !deleted) {
+        logger->logMessage(QString("Disconnecting slow client: %1 bytes not yet sent").arg(socketBytes), this);
+        prepareDestroy();
+    }
 }
 
 void AbstractServerSocketInterface::logDebugMessage(const QString &message)
@@ -381,82 +457,55 @@ Response::ResponseCode AbstractServerSocketInterface::cmdRemoveFromList(const Co
     return Response::RespOk;
 }
 
-int AbstractServerSocketInterface::getDeckPathId(int basePathId, QStringList path)
+/**
+ * Loads the deck storage tree of the user with one query for all folders and one for all files, unless it is cached.
+ * @return nullptr if the tree could not be loaded
+ */
+const DeckStorageTree *AbstractServerSocketInterface::getDeckStorageTree()
 {
-    if (path.isEmpty()) {
-        return 0;
-    }
-    if (path[0].isEmpty()) {
-        return 0;
-    }
-
-    QSqlQuery *query = sqlInterface->prepareQuery("select id from {prefix}_decklist_folders where id_parent = "
-                                                  ":id_parent and name = :name and id_user = :id_user");
-    query->bindValue(":id_parent", basePathId);
-    query->bindValue(":name", path.takeFirst());
-    query->bindValue(":id_user", userInfo->id());
-    if (!sqlInterface->execSqlQuery(query)) {
-        return -1;
+    if (deckStorageTree) {
+        return &*deckStorageTree;
     }
-    if (!query->next()) {
-        return -1;
-    }
-    int id = query->value(0).toInt();
-    if (path.isEmpty()) {
-        return id;
-    } else {
-        return getDeckPathId(id, path);
-    }
-}
 
-int AbstractServerSocketInterface::getDeckPathId(const QString &path)
-{
-    return getDeckPathId(0, path.split("/"));
-}
+    DeckStorageTree tree;
 
-bool AbstractServerSocketInterface::deckListHelper(int folderId, ServerInfo_DeckStorage_Folder *folder)
-{
     QSqlQuery *query = sqlInterface->prepareQuery(
-        "select id, name from {prefix}_decklist_folders where id_parent = :id_parent and id_user = :id_user");
-    query->bindValue(":id_parent", folderId);
+        "select id, id_parent, name from {prefix}_decklist_folders where id_user = :id_user order by id");
     query->bindValue(":id_user", userInfo->id());
     if (!sqlInterface->execSqlQuery(query)) {
-        return false;
+        return nullptr;
     }
-
-    QMap<int, QString> results;
     while (query->next()) {
-        results[query->value(0).toInt()] = query->value(1).toString();
-    }
-
-    for (int key : results.keys()) {
-        ServerInfo_DeckStorage_TreeItem *newItem = folder->add_items();
-        newItem->set_id(key);
-        newItem->set_name(results.value(key).toStdString());
-
-        if (!deckListHelper(newItem->id(), newItem->mutable_folder())) {
-            return false;
-        }
+        tree.addFolder(query->value(0).toInt(), query->value(1).toInt(), query->value(2).toString());
     }
 
-    query = sqlInterface->prepareQuery("select id, name, upload_time from {prefix}_decklist_files where id_folder = "
-                                       ":id_folder and id_user = :id_user");
-    query->bindValue(":id_folder", folderId);
+    query = sqlInterface->prepareQuery("select id, id_folder, name, upload_time from {prefix}_decklist_files where "
+                                       "id_user = :id_user order by id");
     query->bindValue(":id_user", userInfo->id());
     if (!sqlInterface->execSqlQuery(query)) {
-        return false;
+        return nullptr;
     }
-
     while (query->next()) {
-        ServerInfo_DeckStorage_TreeItem *newItem = folder->add_items();
-        newItem->set_id(query->value(0).toInt());
-        newItem->set_name(query->value(1).toString().toStdString());
-
-        ServerInfo_DeckStorage_File *newFile = newItem->mutable_file();
-        newFile->set_creation_time(query->value(2).toDateTime().toSecsSinceEpoch());
+        tree.addFile(query->value(0).toInt(), query->value(1).toInt(), query->value(2).toString(),
+                     query->value(3).toDateTime().toSecsSinceEpoch());
     }
 
-    return true;
+    deckStorageTree = std::move(tree);
+    return &*deckStorageTree;
+}
+
+void AbstractServerSocketInterface::invalidateDeckStorageTree()
+{
+    deckStorageTree.reset();
+}
+
+int AbstractServerSocketInterface::getDeckPathId(const QString &path)
+{
+    const DeckStorageTree *tree = getDeckStorageTree();
+    if (!tree) {
+        return -1;
+    }
+    return tree->getFolderId(path);
 }
 
 // CHECK AUTHENTICATION!
@@ -471,13 +520,13 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckList(const Command_
 
     sqlInterface->checkSql();
 
-    Response_DeckList *re = new Response_DeckList;
-    ServerInfo_DeckStorage_Folder *root = re->mutable_root();
-
-    if (!deckListHelper(0, root)) {
+    const DeckStorageTree *tree = getDeckStorageTree();
+    if (!tree) {
         return Response::RespContextError;
     }
 
+    Response_DeckList *re = new Response_DeckList;
+    tree->writeFolder(0, re->mutable_root());
     rc.setResponseExtension(re);
     return Response::RespOk;
 }
@@ -507,6 +556,7 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckNewDir(const Comman
     query->bindValue(":id_parent", folderId);
     query->bindValue(":id_user", userInfo->id());
     query->bindValue(":name", name);
+    invalidateDeckStorageTree();
     if (!sqlInterface->execSqlQuery(query)) {
         return Response::RespContextError;
     }
@@ -515,22 +565,24 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckNewDir(const Comman
 
 void AbstractServerSocketInterface::deckDelDirHelper(int basePathId)
 {
-    sqlInterface->checkSql();
-    QSqlQuery *query =
-        sqlInterface->prepareQuery("select id from {prefix}_decklist_folders where id_parent = :id_parent");
-    query->bindValue(":id_parent", basePathId);
-    sqlInterface->execSqlQuery(query);
-    while (query->next()) {
-        deckDelDirHelper(query->value(0).toInt());
+    const DeckStorageTree *tree = getDeckStorageTree();
+    if (!tree) {
+        return;
     }
 
-    query = sqlInterface->prepareQuery("delete from {prefix}_decklist_files where id_folder = :id_folder");
-    query->bindValue(":id_folder", basePathId);
-    sqlInterface->execSqlQuery(query);
+    const QList<int> folderIds = tree->getFolderIdsRecursive(basePathId);
+    invalidateDeckStorageTree();
 
-    query = sqlInterface->prepareQuery("delete from {prefix}_decklist_folders where id = :id");
-    query->bindValue(":id", basePathId);
-    sqlInterface->execSqlQuery(query);
+    for (int folderId : folderIds) {
+        QSqlQuery *query =
+            sqlInterface->prepareQuery("delete from {prefix}_decklist_files where id_folder = :id_folder");
+        query->bindValue(":id_folder", folderId);
+        sqlInterface->execSqlQuery(query);
+
+        query = sqlInterface->prepareQuery("delete from {prefix}_decklist_folders where id = :id");
+        query->bindValue(":id", folderId);
+        sqlInterface->execSqlQuery(query);
+    }
 }
 
 void AbstractServerSocketInterface::sendServerMessage(const QString userName, const QString message)
@@ -586,6 +638,7 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckDel(const Command_D
     query = sqlInterface->prepareQuery("delete from {prefix}_decklist_files where id = :id");
     query->bindValue(":id", cmd.deck_id());
     sqlInterface->execSqlQuery(query);
+    invalidateDeckStorageTree();
 
     return Response::RespOk;
 }
@@ -628,6 +681,7 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckUpload(const Comman
         query->bindValue(":name", deckName);
         query->bindValue(":content", deckStr);
         sqlInterface->execSqlQuery(query);
+        invalidateDeckStorageTree();
 
         Response_DeckUpload *re = new Response_DeckUpload;
         ServerInfo_DeckStorage_TreeItem *fileInfo = re->mutable_new_file();
@@ -644,6 +698,7 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckUpload(const Comman
         query->bindValue(":name", deckName);
         query->bindValue(":content", deckStr);
         sqlInterface->execSqlQuery(query);
+        invalidateDeckStorageTree();
 
         if (query->numRowsAffected() == 0) {
             return Response::RespNameNotFound;
@@ -684,58 +739,116 @@ Response::ResponseCode AbstractServerSocketInterface::cmdDeckDownload(const Comm
     return Response::RespOk;
 }
 
-Response::ResponseCode AbstractServerSocketInterface::cmdReplayList(const Command_ReplayList & /*cmd*/,
+Response::ResponseCode AbstractServerSocketInterface::cmdReplayList(const Command_ReplayList &cmd,
                                                                     ResponseContainer &rc)
 {
     if (authState != PasswordRight) {
         return Response::RespFunctionNotAllowed;
     }
 
+    // Matches are listed newest first, a page token is the id of the last game of the previous page
+    int beforeGameId = std::numeric_limits<int>::max();
+    if (cmd.has_page_token()) {
+        bool ok;
+        beforeGameId = nameFromStdString(cmd.page_token()).toInt(&ok);
+        if (!ok) {
+            return Response::RespInvalidData;
+        }
+    }
+    const int pageSize = cmd.has_page_size() ? qBound(1, static_cast<int>(cmd.page_size()), maxReplayListPageSize)
+                                             : std::numeric_limits<int>::max();
+    // bound as text, which compares correctly against the datetime columns of both MySQL and SQLite
+    const bool filterTime = cmd.has_time_started_from() || cmd.has_time_started_to();
+    const quint32 timeTo = cmd.has_time_started_to() ? cmd.time_started_to() : std::numeric_limits<quint32>::max();
+    const QString timeFromText = QDateTime::fromSecsSinceEpoch(cmd.time_started_from()).toString("yyyy-MM-dd hh:mm:ss");
+    const QString timeToText = QDateTime::fromSecsSinceEpoch(timeTo).toString("yyyy-MM-dd hh:mm:ss");
+    const QString opponentName = nameFromStdString(cmd.opponent_name());
+
     Response_ReplayList *re = new Response_ReplayList;
 
-    QSqlQuery *query1 = sqlInterface->prepareQuery(
+    QSqlQuery *matchQuery = sqlInterface->prepareQuery(
         "select a.id_game, a.replay_name, b.room_name, b.time_started, b.time_finished, b.descr, a.do_not_hide from "
         "{prefix}_replays_access a left join {prefix}_games b on b.id = a.id_game where a.id_player = :id_player and "
-        "(a.do_not_hide = 1 or date_add(b.time_started, interval 7 day) > now())");
-    query1->bindValue(":id_player", userInfo->id());
-    sqlInterface->execSqlQuery(query1);
-    while (query1->next()) {
+        "(a.do_not_hide = 1 or date_add(b.time_started, interval 7 day) > now()) and a.id_game < :before_game and "
+        "(:filter_time = 0 or (b.time_started >= :time_from and b.time_started < :time_to)) and "
+        "(:opponent_filter = '' or exists (select 1 from {prefix}_games_players p where p.id_game = a.id_game and "
+        "p.player_name = :opponent_name)) order by a.id_game desc limit :page_size");
+    matchQuery->bindValue(":id_player", userInfo->id());
+    matchQuery->bindValue(":before_game", beforeGameId);
+    matchQuery->bindValue(":filter_time", filterTime ? 1 : 0);
+    matchQuery->bindValue(":time_from", timeFromText);
+    matchQuery->bindValue(":time_to", timeToText);
+    matchQuery->bindValue(":opponent_filter", opponentName);
+    matchQuery->bindValue(":opponent_name", opponentName);
+    matchQuery->bindValue(":page_size", pageSize);
+    if (!sqlInterface->execSqlQuery(matchQuery)) {
+        delete re;
+        return Response::RespInternalError;
+    }
+
+    QHash<int, ServerInfo_ReplayMatch *> matches;
+    QHash<int, QString> replayNames;
+    int firstGameId = 0;
+    int lastGameId = 0;
+    while (matchQuery->next()) {
         ServerInfo_ReplayMatch *matchInfo = re->add_match_list();
 
-        const int gameId = query1->value(0).toInt();
+        const int gameId = matchQuery->value(0).toInt();
         matchInfo->set_game_id(gameId);
-        matchInfo->set_room_name(query1->value(2).toString().toStdString());
-        const int timeStarted = query1->value(3).toDateTime().toSecsSinceEpoch();
-        const int timeFinished = query1->value(4).toDateTime().toSecsSinceEpoch();
+        matchInfo->set_room_name(matchQuery->value(2).toString().toStdString());
+        const int timeStarted = matchQuery->value(3).toDateTime().toSecsSinceEpoch();
+        const int timeFinished = matchQuery->value(4).toDateTime().toSecsSinceEpoch();
         matchInfo->set_time_started(timeStarted);
         matchInfo->set_length(timeFinished - timeStarted);
-        matchInfo->set_game_name(query1->value(5).toString().toStdString());
-        const QString replayName = query1->value(1).toString();
-        matchInfo->set_do_not_hide(query1->value(6).toBool());
-
-        {
-            QSqlQuery *query2 =
-                sqlInterface->prepareQuery("select player_name from {prefix}_games_players where id_game = :id_game");
-            query2->bindValue(":id_game", gameId);
-            sqlInterface->execSqlQuery(query2);
-            while (query2->next()) {
-                matchInfo->add_player_names(query2->value(0).toString().toStdString());
+        matchInfo->set_game_name(matchQuery->value(5).toString().toStdString());
+        matchInfo->set_do_not_hide(matchQuery->value(6).toBool());
+
+        matches.insert(gameId, matchInfo);
+        replayNames.insert(gameId, matchQuery->value(1).toString());
+        if (matches.size() == 1) {
+            firstGameId = gameId;
+        }
+        lastGameId = gameId;
+    }
+
+    if (!matches.isEmpty()) {
+        // Players and replays of all games in the id range of the page, games that were filtered out are skipped
+        QSqlQuery *playerQuery = sqlInterface->prepareQuery(
+            "select p.id_game, p.player_name from {prefix}_games_players p join {prefix}_replays_access a on "
+            "a.id_game = p.id_game where a.id_player = :id_player and a.id_game between :last_game and :first_game");
+        playerQuery->bindValue(":id_player", userInfo->id());
+        playerQuery->bindValue(":last_game", lastGameId);
+        playerQuery->bindValue(":first_game", firstGameId);
+        sqlInterface->execSqlQuery(playerQuery);
+        while (playerQuery->next()) {
+            if (ServerInfo_ReplayMatch *matchInfo = matches.value(playerQuery->value(0).toInt())) {
+                matchInfo->add_player_names(playerQuery->value(1).toString().toStdString());
             }
         }
-        {
-            QSqlQuery *query3 =
-                sqlInterface->prepareQuery("select id, duration from {prefix}_replays where id_game = :id_game");
-            query3->bindValue(":id_game", gameId);
-            sqlInterface->execSqlQuery(query3);
-            while (query3->next()) {
+
+        QSqlQuery *replayQuery = sqlInterface->prepareQuery(
+            "select r.id_game, r.id, r.duration from {prefix}_replays r join {prefix}_replays_access a on "
+            "a.id_game = r.id_game where a.id_player = :id_player and a.id_game between :last_game and :first_game "
+            "order by r.id");
+        replayQuery->bindValue(":id_player", userInfo->id());
+        replayQuery->bindValue(":last_game", lastGameId);
+        replayQuery->bindValue(":first_game", firstGameId);
+        sqlInterface->execSqlQuery(replayQuery);
+        while (replayQuery->next()) {
+            const int gameId = replayQuery->value(0).toInt();
+            if (ServerInfo_ReplayMatch *matchInfo = matches.value(gameId)) {
                 ServerInfo_Replay *replayInfo = matchInfo->add_replay_list();
-                replayInfo->set_replay_id(query3->value(0).toInt());
-                replayInfo->set_replay_name(replayName.toStdString());
-                replayInfo->set_duration(query3->value(1).toInt());
+                replayInfo->set_replay_id(replayQuery->value(1).toInt());
+                replayInfo->set_replay_name(replayNames.value(gameId).toStdString());
+                replayInfo->set_duration(replayQuery->value(2).toInt());
             }
         }
     }
 
+    if (cmd.has_page_size() && matches.size() == pageSize) {
+        re->set_next_page_token(QString::number(lastGameId).toStdString());
+    }
+
     rc.setResponseExtension(re);
     return Response::RespOk;
 }
@@ -986,16 +1099,31 @@ Response::ResponseCode AbstractServerSocketInterface::cmdGetLogHistory(const Com
     }
 
     int dateRange = cmd.date_range();
-    int maximumResults = cmd.maximum_results();
+    int maximumResults = cmd.maximum_results() == 0
+                             ? maxLogHistoryPageSize
+                             : qMin(static_cast<int>(cmd.maximum_results()), maxLogHistoryPageSize);
+    qint64 beforeId = std::numeric_limits<qint64>::max();
+    if (cmd.has_page_token()) {
+        bool ok;
+        beforeId = nameFromStdString(cmd.page_token()).toLongLong(&ok);
+        if (!ok) {
+            return Response::RespInvalidData;
+        }
+    }
 
     Response_ViewLogHistory *re = new Response_ViewLogHistory;
 
     if (servatrice->getEnableLogQuery()) {
-        QListIterator<ServerInfo_ChatMessage> messageIterator(sqlInterface->getMessageLogHistory(
-            userName, ipAddress, gameName, gameID, message, chatType, gameType, roomType, dateRange, maximumResults));
+        qint64 lastId;
+        QListIterator<ServerInfo_ChatMessage> messageIterator(
+            sqlInterface->getMessageLogHistory(userName, ipAddress, gameName, gameID, message, chatType, gameType,
+                                               roomType, dateRange, maximumResults, beforeId, lastId));
         while (messageIterator.hasNext()) {
             re->add_log_message()->CopyFrom(messageIterator.next());
         }
+        if (re->log_message_size() == maximumResults) {
+            re->set_next_page_token(QString::number(lastId).toStdString());
+        }
     } else {
         ServerInfo_ChatMessage chatMessage;
 
@@ -2009,6 +2137,7 @@ Response::ResponseCode AbstractServerSocketInterface::cmdReloadConfig(const Comm
 {
     logDebugMessage("Received admin command: reloading configuration");
     settingsCache->sync();
+    logger->reloadConfiguration(*settingsCache);
     QMetaObject::invokeMethod(server, "setRequiredFeatures", Q_ARG(QString, server->getRequiredFeatures()));
     return Response::RespOk;
 }
@@ -2258,43 +2387,12 @@ void TcpServerSocketInterface::initSessionDeprecated()
     flushSocket();
 }
 
-void TcpServerSocketInterface::flushOutputQueue()
+qint64 TcpServerSocketInterface::writeOutputBuffer(const QByteArray &buffer)
 {
-    QMutexLocker locker(&outputQueueMutex);
-    if (outputQueue.isEmpty()) {
-        return;
-    }
-
-    int totalBytes = 0;
-    while (!outputQueue.isEmpty()) {
-        ServerMessage item = outputQueue.takeFirst();
-        locker.unlock();
-
-        QByteArray buf;
-#if GOOGLE_PROTOBUF_VERSION > 3001000
-        unsigned int size = static_cast<unsigned int>(item.ByteSizeLong());
-#else
-        unsigned int size = static_cast<unsigned int>(item.ByteSize());
-#endif
-        buf.resize(size + 4);
-        if (item.SerializeToArray(buf.data() + 4, size)) {
-            buf.data()[3] = (unsigned char)size;
-            buf.data()[2] = (unsigned char)(size >> 8);
-            buf.data()[1] = (unsigned char)(size >> 16);
-            buf.data()[0] = (unsigned char)(size >> 24);
-            // In case socket->write() calls catchSocketError(), the mutex must not be locked during this call.
-            writeToSocket(buf);
-        } else {
-            qCWarning(TcpServerSocketInterfaceLog) << "serialisation error!";
-        }
-
-        totalBytes += size + 4;
-        locker.relock();
-    }
-    locker.unlock();
-    emit incTxBytes(totalBytes);
-    // see above wrt mutex
-    flushSocket();
+    // the buffer already holds the wire format of the tcp protocol
+    QByteArray data(buffer);
+    writeToSocket(data);
+    return buffer.size();
 }
 
 void TcpServerSocketInterface::readClient()
@@ -2476,39 +2574,23 @@ bool WebsocketServerSocketInterface::initWebsocketSession()
     return true;
 }
 
-void WebsocketServerSocketInterface::flushOutputQueue()
+qint64 WebsocketServerSocketInterface::writeOutputBuffer(const QByteArray &buffer)
 {
-    QMutexLocker locker(&outputQueueMutex);
-    if (outputQueue.isEmpty()) {
-        return;
-    }
-
+    // websocket messages carry their own framing, strip the length prefixes
     qint64 totalBytes = 0;
-    while (!outputQueue.isEmpty()) {
-        ServerMessage item = outputQueue.takeFirst();
-        locker.unlock();
-
-        QByteArray buf;
-#if GOOGLE_PROTOBUF_VERSION > 3001000
-        unsigned int size = static_cast<unsigned int>(item.ByteSizeLong());
-#else
-        unsigned int size = static_cast<unsigned int>(item.ByteSize());
-#endif
-        buf.resize(size);
-        if (item.SerializeToArray(buf.data(), size)) {
-            // In case socket->write() calls catchSocketError(), the mutex must not be locked during this call.
-            writeToSocket(buf);
-        } else {
-            qCWarning(TcpServerSocketInterfaceLog) << "serialisation error!";
-        }
-
+    const char *data = buffer.constData();
+    qsizetype offset = 0;
+    while (offset + 4 <= buffer.size()) {
+        const quint32 size = (((quint32)(unsigned char)data[offset]) << 24) +
+                             (((quint32)(unsigned char)data[offset + 1]) << 16) +
+                             (((quint32)(unsigned char)data[offset + 2]) << 8) +
+                             ((quint32)(unsigned char)data[offset + 3]);
+        QByteArray message = QByteArray::fromRawData(data + offset + 4, size);
+        writeToSocket(message);
         totalBytes += size;
-        locker.relock();
+        offset += size + 4;
     }
-    locker.unlock();
-    emit incTxBytes(totalBytes);
-    // see above wrt mutex
-    flushSocket();
+    return totalBytes;
 }
 
 void WebsocketServerSocketInterface::binaryMessageReceived(const QByteArray &message)
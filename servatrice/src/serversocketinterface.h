@@ -20,16 +20,18 @@
 #ifndef SERVERSOCKETINTERFACE_H
 #define SERVERSOCKETINTERFACE_H
 
+#include "deck_storage_tree.h"
+
 #include <QHostAddress>
 #include <QMutex>
 #include <QTcpSocket>
 #include <QWebSocket>
+#include <optional>
 #include <server_protocolhandler.h>
 
 class Servatrice;
 class Servatrice_DatabaseInterface;
 class DeckList;
-class ServerInfo_DeckStorage_Folder;
 
 class Command_AddToList;
 class Command_RemoveFromList;
@@ -61,7 +63,7 @@ class AbstractServerSocketInterface : public Server_ProtocolHandler
 protected slots:
     void catchSocketError(QAbstractSocket::SocketError socketError);
     void catchSocketDisconnected();
-    virtual void flushOutputQueue() = 0;
+    void flushOutputQueue();
 signals:
     void outputQueueChanged();
     void incTxBytes(qint64 amount);
@@ -72,19 +74,40 @@ protected:
 
     virtual void writeToSocket(QByteArray &data) = 0;
     virtual void flushSocket() = 0;
+    /**
+     * Writes a buffer of length-prefixed frames, as built by transmitProtocolItem(), to the socket.
+     * @return the number of bytes handed to the socket
+     */
+    virtual qint64 writeOutputBuffer(const QByteArray &buffer) = 0;
+    /**
+     * @return the number of bytes the socket still has to send, or 0 if the socket does not report it
+     */
+    virtual qint64 getSocketBytesToWrite() const = 0;
 
     Servatrice *servatrice;
-    QList<ServerMessage> outputQueue;
-    QMutex outputQueueMutex;
 
 private:
     Servatrice_DatabaseInterface *sqlInterface;
 
+    // Serialized messages waiting for the next flush, each one prefixed by its 4 byte big endian length
+    QByteArray outputBuffer;
+    int outputBufferMessages;
+    qint64 peakOutputBufferSize;
+    bool outputBufferOverflow;
+    mutable QMutex outputQueueMutex;
+
+    // High-water marks for slow consumers, 0 disables the check
+    qint64 maxOutputBufferSize;
+    qint64 maxSocketBufferSize;
+
+    // Deck storage folders and files of the logged in user, reset by every command that modifies them
+    std::optional<DeckStorageTree> deckStorageTree;
+
     Response::ResponseCode cmdAddToList(const Command_AddToList &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdRemoveFromList(const Command_RemoveFromList &cmd, ResponseContainer &rc);
-    int getDeckPathId(int basePathId, QStringList path);
+    const DeckStorageTree *getDeckStorageTree();
+    void invalidateDeckStorageTree();
     int getDeckPathId(const QString &path);
-    bool deckListHelper(int folderId, ServerInfo_DeckStorage_Folder *folder);
     Response::ResponseCode cmdDeckList(const Command_DeckList &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdDeckNewDir(const Command_DeckNewDir &cmd, ResponseContainer &rc);
     void deckDelDirHelper(int basePathId);
@@ -160,6 +183,22 @@ public:
     virtual QString getAddress() const = 0;
 
     void transmitProtocolItem(const ServerMessage &item);
+
+    qint64 getOutputBufferSize() const
+    {
+        QMutexLocker locker(&outputQueueMutex);
+        return outputBuffer.size();
+    }
+    int getOutputBufferMessages() const
+    {
+        QMutexLocker locker(&outputQueueMutex);
+        return outputBufferMessages;
+    }
+    qint64 getPeakOutputBufferSize() const
+    {
+        QMutexLocker locker(&outputQueueMutex);
+        return peakOutputBufferSize;
+    }
 };
 
 class TcpServerSocketInterface : public AbstractServerSocketInterface
@@ -200,11 +239,15 @@ protected:
     {
         socket->flush();
     }
+    qint64 writeOutputBuffer(const QByteArray &buffer);
+    qint64 getSocketBytesToWrite() const
+    {
+        return socket->bytesToWrite();
+    }
     void initSessionDeprecated();
     bool initTcpSession();
 protected slots:
     void readClient();
-    void flushOutputQueue();
 public slots:
     void initConnection(int socketDescriptor);
 };
@@ -244,10 +287,15 @@ protected:
     {
         socket->flush();
     }
+    qint64 writeOutputBuffer(const QByteArray &buffer);
+    qint64 getSocketBytesToWrite() const
+    {
+        // QWebSocket does not expose its pending write buffer
+        return 0;
+    }
     bool initWebsocketSession();
 protected slots:
     void binaryMessageReceived(const QByteArray &message);
-    void flushOutputQueue();
 public slots:
     void initConnection(void *_socket);
 };
@@ -66,9 +66,10 @@ void SignalHandler::internalSigHupHandler()
     std::cerr << "Received SIGHUP" << std::endl;
 #endif
     logger->logMessage("Received SIGHUP, rotating logs and reloading configuration", this);
-    logger->rotateLogs();
+    QMetaObject::invokeMethod(logger, "rotateLogs", Qt::QueuedConnection);
 
     settingsCache->sync();
+    logger->reloadConfiguration(*settingsCache);
 
     snHup->setEnabled(true);
 }
@@ -33,6 +33,37 @@ TEST(CardDatabaseTest, LoadXml)
     ASSERT_EQ(0, db->query()->getAllMainCardTypes().size()) << "Types not empty after clear";
     ASSERT_EQ(NotLoaded, db->getLoadStatus()) << "Incorrect status after clear";
 }
+
+TEST(CardDatabaseTest, CatalogFollowsAddedAndRemovedCards)
+{
+    CardDatabase *db = new CardDatabase(nullptr, new NoopCardPreferenceProvider(), new TestCardDatabasePathProvider(),
+                                        new NoopCardSetPriorityController());
+    db->loadCardDatabases();
+
+    const QMap<QString, int> mainTypes = db->query()->getAllMainCardTypesWithCount();
+    const QMap<QString, int> subTypes = db->query()->getAllSubCardTypesWithCount();
+    ASSERT_EQ(1, subTypes.value("Cat")) << "Wrong subtype count after load";
+    ASSERT_EQ(1, subTypes.value("Doctor")) << "Wrong subtype count after load";
+
+    CardInfoPtr card = CardInfo::newInstance("Lion Cub", "", false,
+                                             {{"maintype", "Creature"},
+                                              {"type", "Creature — Cat Warrior"},
+                                              {"format-catalogtest", "legal"}},
+                                             {}, {}, {}, {});
+    db->addCard(card);
+    ASSERT_EQ(mainTypes.value("Creature") + 1, db->query()->getAllMainCardTypesWithCount().value("Creature"));
+    ASSERT_EQ(2, db->query()->getAllSubCardTypesWithCount().value("Cat")) << "Added card not counted";
+    ASSERT_EQ(1, db->query()->getAllSubCardTypesWithCount().value("Warrior")) << "Added card not counted";
+    ASSERT_EQ(1, db->query()->getAllFormatsWithCount().value("catalogtest")) << "Added card not counted";
+    ASSERT_TRUE(db->query()->getCatalog().cardsWithSubType("Cat").contains("Lion Cub"));
+
+    db->removeCard(card);
+    ASSERT_EQ(mainTypes, db->query()->getAllMainCardTypesWithCount()) << "Removed card still counted";
+    ASSERT_EQ(subTypes, db->query()->getAllSubCardTypesWithCount()) << "Removed card still counted";
+    ASSERT_FALSE(db->query()->getAllFormatsWithCount().contains("catalogtest")) << "Empty format still listed";
+
+    db->clear();
+}
 } // namespace
 
 int main(int argc, char **argv)
@@ -2,6 +2,7 @@
 #include "test_card_database_path_provider.h"
 
 #include "gtest/gtest.h"
+#include <libcockatrice/card/format/card_legalities.h>
 #include <libcockatrice/filters/filter_string.h>
 #include <libcockatrice/interfaces/noop_card_preference_provider.h>
 #include <libcockatrice/interfaces/noop_card_set_priority_controller.h>
@@ -73,6 +74,27 @@ QUERY(Color4, cat, "c!gw", false)
 
 QUERY(BracketNextToUnquotedString, cat, "(o:woof OR o:meow)", true)
 
+QUERY(Format, cat, "f:modern", true)
+QUERY(FormatBanned, cat, "f:legacy", false)
+QUERY(FormatNotListed, cat, "f:vintage", false)
+QUERY(FormatUnknownCard, truth, "f:modern", false)
+QUERY(LegalityBanned, cat, "banned:legacy", true)
+QUERY(LegalityRestricted, cat, "restricted:modern", false)
+
+// fills the format ids of the whole test, so it has to run last
+TEST_F(CardQuery, FormatPastTheIdCap)
+{
+    for (int i = 0; i < FormatIds::maxFormats; ++i) {
+        FormatIds::intern(QString("filler%1").arg(i));
+    }
+    ASSERT_LT(FormatIds::intern("pastcap"), 0);
+
+    cat->setProperty("format-pastcap", "legal");
+    ASSERT_TRUE(FilterString("f:pastcap").check(cat));
+    ASSERT_TRUE(FilterString("legal:pastcap").check(cat));
+    ASSERT_FALSE(FilterString("banned:pastcap").check(cat));
+}
+
 } // namespace
 
 int main(int argc, char **argv)
@@ -0,0 +1,147 @@
+/** @file chat_view_test.cpp
+ *  @brief Tests for the document cap of the chat view and the user level images it shares between messages.
+ *  @ingroup Tests
+ */
+
+#include "mocks.h"
+
+// the chat view is built here, after the mocks took the place of its GUI dependencies
+#include "../../cockatrice/src/interface/widgets/server/chat_view/chat_view.cpp"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QScrollBar>
+#include <QSet>
+#include <QTextBlock>
+
+namespace
+{
+class FakeUserList : public UserListProxy
+{
+public:
+    bool isOwnUserRegistered() const override
+    {
+        return true;
+    }
+    QString getOwnUsername() const override
+    {
+        return "me";
+    }
+    bool isUserBuddy(const QString &userName) const override
+    {
+        return userName == "buddy";
+    }
+    bool isUserIgnored(const QString & /* userName */) const override
+    {
+        return false;
+    }
+    const ServerInfo_User *getOnlineUser(const QString & /* userName */) const override
+    {
+        return nullptr;
+    }
+};
+
+class ChatViewTest : public ::testing::Test
+{
+protected:
+    FakeUserList userList;
+    TabSupervisor tabSupervisor{&userList};
+    ChatView view{&tabSupervisor, nullptr, false};
+
+    void SetUp() override
+    {
+        UserLevelPixmapGenerator::generatedPixmaps = 0;
+    }
+
+    /**
+     * Appends a message while following the newest messages, as a user reading the chat does.
+     */
+    void appendFrom(const QString &userName, int userLevel, const QString &message)
+    {
+        ServerInfo_User user;
+        user.set_name(userName.toStdString());
+        user.set_user_level(userLevel);
+        view.verticalScrollBar()->setValue(view.verticalScrollBar()->maximum());
+        view.appendMessage(message, {}, user);
+    }
+
+    QSet<QString> imageNames() const
+    {
+        QSet<QString> names;
+        for (QTextBlock block = view.document()->begin(); block.isValid(); block = block.next()) {
+            for (auto it = block.begin(); !it.atEnd(); ++it) {
+                const QTextCharFormat format = it.fragment().charFormat();
+                if (format.isImageFormat()) {
+                    names.insert(format.toImageFormat().name());
+                }
+            }
+        }
+        return names;
+    }
+};
+} // namespace
+
+TEST_F(ChatViewTest, DocumentIsCappedAndImagesAreShared)
+{
+    const QStringList senders = {"alice", "bob", "buddy"};
+    for (int i = 0; i < 5000; ++i) {
+        appendFrom(senders[i % senders.size()], ServerInfo_User::IsRegistered, QString("message %1").arg(i));
+    }
+
+    EXPECT_LT(view.document()->blockCount(), maxDocumentBlocks + historyBatchSize);
+    // the two registered users share an image, the buddy gets one of its own
+    EXPECT_EQ(UserLevelPixmapGenerator::generatedPixmaps, 2);
+    const QSet<QString> names = imageNames();
+    EXPECT_EQ(names.size(), 2);
+    for (const QString &name : names) {
+        EXPECT_TRUE(name.startsWith("userlevel:"));
+        EXPECT_FALSE(view.document()->resource(QTextDocument::ImageResource, QUrl(name)).isNull());
+    }
+}
+
+TEST_F(ChatViewTest, HistoryLoadedBackKeepsItsImages)
+{
+    for (int i = 0; i < 1500; ++i) {
+        const bool moderator = i % 2 == 1;
+        appendFrom(moderator ? "mod" : "alice",
+                   moderator ? ServerInfo_User::IsRegistered | ServerInfo_User::IsModerator
+                             : ServerInfo_User::IsRegistered,
+                   QString("message %1").arg(i));
+    }
+    const int blocksBefore = view.document()->blockCount();
+    // what scrolling to the top does
+    QMetaObject::invokeMethod(&view, "loadHistory", Q_ARG(int, view.verticalScrollBar()->minimum()));
+    ASSERT_EQ(view.document()->blockCount(), blocksBefore + historyBatchSize);
+
+    EXPECT_EQ(UserLevelPixmapGenerator::generatedPixmaps, 2);
+    const QSet<QString> names = imageNames();
+    EXPECT_EQ(names.size(), 2);
+    for (const QString &name : names) {
+        EXPECT_FALSE(view.document()->resource(QTextDocument::ImageResource, QUrl(name)).isNull());
+    }
+}
+
+TEST_F(ChatViewTest, ClearingTheChatAddsTheImagesAgain)
+{
+    appendFrom("alice", ServerInfo_User::IsRegistered, "before");
+    view.clearChat();
+    appendFrom("alice", ServerInfo_User::IsRegistered, "after");
+
+    EXPECT_EQ(UserLevelPixmapGenerator::generatedPixmaps, 2);
+    const QSet<QString> names = imageNames();
+    ASSERT_EQ(names.size(), 1);
+    EXPECT_FALSE(view.document()->resource(QTextDocument::ImageResource, QUrl(*names.begin())).isNull());
+}
+
+int main(int argc, char **argv)
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// the moc output of the chat view has to see the mocks as well
+#include "moc_chat_view.cpp"
@@ -0,0 +1,51 @@
+#include "mocks.h"
+
+SoundEngine *soundEngine = nullptr;
+int UserLevelPixmapGenerator::generatedPixmaps = 0;
+
+SettingsCache::SettingsCache() : chatSettings(new ChatSettings(settingsDir.path() + "/", this))
+{
+}
+
+SettingsCache &SettingsCache::instance()
+{
+    static SettingsCache cache;
+    return cache;
+}
+
+ChatSettings &SettingsCache::chat() const
+{
+    return *chatSettings;
+}
+
+void SoundEngine::playSound(const QString & /* fileName */)
+{
+}
+
+QPixmap UserLevelPixmapGenerator::generatePixmap(int height,
+                                                 UserLevelFlags /* userLevel */,
+                                                 ServerInfo_User::PawnColorsOverride /* pawnColors */,
+                                                 bool /* isBuddy */,
+                                                 const QString & /* privLevel */)
+{
+    ++generatedPixmaps;
+    QPixmap pixmap(height, height);
+    pixmap.fill(Qt::black);
+    return pixmap;
+}
+
+UserContextMenu::UserContextMenu(TabSupervisor * /* _tabSupervisor */, QWidget *_parent, AbstractGame * /* _game */)
+    : QObject(_parent)
+{
+}
+
+void UserContextMenu::retranslateUi()
+{
+}
+
+void UserContextMenu::showContextMenu(const QPoint & /* pos */,
+                                      const QString & /* userName */,
+                                      UserLevelFlags /* userLevel */,
+                                      ChatView * /* chatView */)
+{
+}
@@ -0,0 +1,96 @@
+/*
+ * Beware of this preprocessor hack used to replace the settings cache, the sound engine, the pixmap generators, the
+ * tab supervisor and the user list widgets the chat view includes instead of building them and all of their
+ * dependencies.
+ * Always set header guards of mocked objects before including any headers with mocked objects.
+ */
+
+#ifndef CHAT_VIEW_TEST_MOCKS_H
+#define CHAT_VIEW_TEST_MOCKS_H
+
+#define SETTINGSCACHE_H
+#define SOUNDENGINE_H
+#define PIXMAPGENERATOR_H
+#define TAB_SUPERVISOR_H
+#define TAB_ACCOUNT_H
+#define USER_CONTEXT_MENU_H
+#define COCKATRICE_USER_LIST_MANAGER_H
+#define USERLIST_H
+
+#include "../../cockatrice/src/interface/widgets/server/user/user_list_proxy.h"
+
+#include <QObject>
+#include <QPixmap>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <libcockatrice/network/server/remote/user_level.h>
+#include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
+#include <libcockatrice/settings/chat_settings.h>
+#include <libcockatrice/utility/card_ref.h>
+
+class AbstractGame;
+class ChatView;
+
+class SettingsCache : public QObject
+{
+    Q_OBJECT
+public:
+    static SettingsCache &instance();
+    ChatSettings &chat() const;
+signals:
+    void themeChanged();
+
+private:
+    QTemporaryDir settingsDir;
+    ChatSettings *chatSettings;
+    SettingsCache();
+};
+
+class SoundEngine
+{
+public:
+    void playSound(const QString &fileName);
+};
+extern SoundEngine *soundEngine;
+
+class UserLevelPixmapGenerator
+{
+public:
+    // how often a pixmap was generated, the chat view should do so once per distinct user level image
+    static int generatedPixmaps;
+
+    static QPixmap generatePixmap(int height,
+                                  UserLevelFlags userLevel,
+                                  ServerInfo_User::PawnColorsOverride pawnColors,
+                                  bool isBuddy,
+                                  const QString &privLevel);
+};
+
+class TabSupervisor
+{
+public:
+    explicit TabSupervisor(UserListProxy *_userListProxy) : userListProxy(_userListProxy)
+    {
+    }
+    UserListProxy *getUserListManager() const
+    {
+        return userListProxy;
+    }
+
+private:
+    UserListProxy *userListProxy;
+};
+
+class UserContextMenu : public QObject
+{
+    Q_OBJECT
+public:
+    UserContextMenu(TabSupervisor *_tabSupervisor, QWidget *_parent, AbstractGame *_game = nullptr);
+    void retranslateUi();
+    void showContextMenu(const QPoint &pos, const QString &userName, UserLevelFlags userLevel, ChatView *chatView);
+signals:
+    void openMessageDialog(const QString &userName, bool focus);
+};
+
+#endif
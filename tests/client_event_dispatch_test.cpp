@@ -0,0 +1,170 @@
+/** @file client_event_dispatch_test.cpp
+ *  @brief Tests for the batched dispatch of server events from the client thread to the thread that created the
+ *  client.
+ *  @ingroup Tests
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <gtest/gtest.h>
+#include <libcockatrice/network/client/abstract/abstract_client.h>
+#include <libcockatrice/protocol/get_pb_extension.h>
+#include <libcockatrice/protocol/pb/event_server_message.pb.h>
+#include <libcockatrice/protocol/pb/server_message.pb.h>
+#include <functional>
+#include <memory>
+
+namespace
+{
+/**
+ * A client without a connection, receiving the messages it is handed as if they came from a single network read.
+ */
+class FakeClient : public AbstractClient
+{
+public:
+    QThread *sessionEventThread = nullptr;
+    int sessionEventsProcessed = 0;
+
+    void receive(const QStringList &messages)
+    {
+        for (const QString &message : messages) {
+            auto item = std::make_shared<ServerMessage>();
+            item->set_message_type(ServerMessage::SESSION_EVENT);
+            item->mutable_session_event()->MutableExtension(Event_ServerMessage::ext)->set_message(
+                message.toStdString());
+            queueProtocolItem(std::move(item));
+        }
+        flushEventBatch();
+    }
+
+protected:
+    void processSessionEvent(const SessionEvent &event) override
+    {
+        if (getPbExtension(event) == SessionEvent::SERVER_MESSAGE) {
+            sessionEventThread = QThread::currentThread();
+            ++sessionEventsProcessed;
+        }
+    }
+
+    void sendCommandContainer(const CommandContainer & /*cont*/) override
+    {
+    }
+};
+
+/**
+ * A client living in a thread of its own, as the remote client does.
+ */
+class ClientFixture
+{
+public:
+    QThread thread;
+    FakeClient *client;
+    QObject receiver;
+    QStringList received;
+    QList<QThread *> receivedIn;
+
+    ClientFixture()
+    {
+        client = new FakeClient;
+        client->moveToThread(&thread);
+        thread.start();
+        QObject::connect(client, &AbstractClient::serverMessageEventReceived, &receiver,
+                         [this](const Event_ServerMessage &event) {
+                             received.append(QString::fromStdString(event.message()));
+                             receivedIn.append(QThread::currentThread());
+                         });
+    }
+    ~ClientFixture()
+    {
+        destroyClient();
+        thread.quit();
+        thread.wait();
+    }
+
+    void receive(const QStringList &messages)
+    {
+        QMetaObject::invokeMethod(client, [this, messages] { client->receive(messages); },
+                                  Qt::BlockingQueuedConnection);
+    }
+
+    void destroyClient()
+    {
+        if (client) {
+            QMetaObject::invokeMethod(client, [this] { delete client; }, Qt::BlockingQueuedConnection);
+            client = nullptr;
+        }
+    }
+
+    void processEventsUntil(const std::function<bool()> &done)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!done() && timer.elapsed() < 2000) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+    }
+};
+} // namespace
+
+TEST(ClientEventDispatch, EventsReachTheCreatingThreadInOrder)
+{
+    ClientFixture fixture;
+    fixture.receive({"first", "second"});
+    fixture.receive({"third"});
+    fixture.processEventsUntil([&] { return fixture.received.size() == 3; });
+
+    ASSERT_EQ(fixture.received, QStringList({"first", "second", "third"}));
+    for (QThread *thread : fixture.receivedIn) {
+        EXPECT_EQ(thread, QThread::currentThread());
+    }
+}
+
+TEST(ClientEventDispatch, SessionEventsAreProcessedInTheClientThreadFirst)
+{
+    ClientFixture fixture;
+    fixture.receive({"first", "second"});
+
+    // the client has seen the events before any of them was dispatched
+    EXPECT_EQ(fixture.client->sessionEventsProcessed, 2);
+    EXPECT_EQ(fixture.client->sessionEventThread, &fixture.thread);
+    EXPECT_TRUE(fixture.received.isEmpty());
+
+    fixture.processEventsUntil([&] { return fixture.received.size() == 2; });
+    EXPECT_EQ(fixture.received.size(), 2);
+}
+
+TEST(ClientEventDispatch, QueuedBatchesAreDroppedWithTheClient)
+{
+    ClientFixture fixture;
+    fixture.receive({"first", "second"});
+    fixture.destroyClient();
+
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    EXPECT_TRUE(fixture.received.isEmpty());
+}
+
+TEST(ClientEventDispatch, ClientDestroyedWhileDispatching)
+{
+    ClientFixture fixture;
+    QObject::connect(fixture.client, &AbstractClient::serverMessageEventReceived, &fixture.receiver, [&] {
+        // a receiver destroys the client in the middle of a batch, the rest of it is dropped
+        if (fixture.client) {
+            delete fixture.client;
+            fixture.client = nullptr;
+        }
+    });
+    fixture.receive({"first", "second", "third"});
+    fixture.processEventsUntil([&] { return !fixture.received.isEmpty(); });
+    QCoreApplication::processEvents();
+
+    EXPECT_EQ(fixture.received, QStringList({"first"}));
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <libcockatrice/deck_list/deck_list.h>
+#include <libcockatrice/deck_list/deck_list_history_manager.h>
+
+static constexpr int uniqueCards = 500;
+static constexpr int edits = 1000;
+QString largeDeck;
+
+static DeckListCardChange cardChange(const QString &zoneName, int card, int amount)
+{
+    return {zoneName, QString("card %1").arg(card), "SET", QString::number(card), QString("uuid-%1").arg(card), amount};
+}
+
+/**
+ * Alternately adds a copy of a card and moves a copy of it to the sideboard, renaming the deck every 100 edits.
+ */
+static void applyEdits(DeckList &deck, DeckListHistoryManager &history)
+{
+    for (int i = 0; i < edits; ++i) {
+        const int card = (i / 2 * 7) % uniqueCards;
+        if (i % 100 == 99) {
+            DeckListEditableMetadata before = deck.getEditableMetadata();
+            deck.setName(QString("edit %1").arg(i));
+            history.saveChange(DeckListMemento(DeckListMetadataChange{before, deck.getEditableMetadata()}, "rename"),
+                               deck);
+        } else if (i % 2 == 0) {
+            DeckListCardChange change = cardChange(DECK_ZONE_MAIN, card, 1);
+            deck.applyCardChange(change);
+            history.saveChange(DeckListMemento({change}, "add"), deck);
+        } else {
+            QList<DeckListCardChange> changes = {cardChange(DECK_ZONE_MAIN, card, -1),
+                                                 cardChange(DECK_ZONE_SIDE, card, 1)};
+            for (const auto &change : changes) {
+                deck.applyCardChange(change);
+            }
+            history.saveChange(DeckListMemento(changes, "move"), deck);
+        }
+    }
+}
+
+TEST(DeckListHistoryTest, SequentialEdits)
+{
+    DeckList deck(largeDeck);
+    const QString original = deck.writeToString_Native();
+    DeckListHistoryManager history;
+
+    QElapsedTimer timer;
+    timer.start();
+    applyEdits(deck, history);
+    const QString edited = deck.writeToString_Native();
+    qDebug() << edits << "edits took" << timer.elapsed() << "ms," << history.getHistoryBytes() << "bytes of history";
+
+    ASSERT_EQ(history.getUndoStack().size(), edits);
+    ASSERT_EQ(deck.getName(), QString("edit %1").arg(edits - 1));
+    ASSERT_EQ(deck.getCardList({DECK_ZONE_SIDE}).size(), edits / 2 - edits / 100);
+
+    timer.restart();
+    for (int i = 0; i < edits; ++i) {
+        ASSERT_FALSE(history.undo(&deck)) << "A single step was restored from a checkpoint";
+    }
+    qDebug() << edits << "single step undos took" << timer.elapsed() << "ms";
+    ASSERT_EQ(deck.writeToString_Native(), original) << "Undoing every edit did not restore the deck!";
+
+    history.redo(&deck, edits);
+    ASSERT_EQ(deck.writeToString_Native(), edited) << "Redoing every edit did not restore the edited deck!";
+
+    timer.restart();
+    ASSERT_TRUE(history.undo(&deck, edits - 1)) << "Undoing many steps did not use a checkpoint";
+    history.undo(&deck);
+    qDebug() << edits << "undos at once took" << timer.elapsed() << "ms";
+    ASSERT_EQ(deck.writeToString_Native(), original) << "Undoing every edit at once did not restore the deck!";
+    ASSERT_FALSE(history.canUndo());
+}
+
+TEST(DeckListHistoryTest, SnapshotsAndChanges)
+{
+    DeckList deck(largeDeck);
+    const QString original = deck.writeToString_Native();
+    DeckListHistoryManager history;
+
+    history.save(deck.createMemento("clear"));
+    deck.cleanList(true);
+    DeckListCardChange change = cardChange(DECK_ZONE_MAIN, 1, 4);
+    deck.applyCardChange(change);
+    history.saveChange(DeckListMemento({change}, "add"), deck);
+    const QString edited = deck.writeToString_Native();
+
+    ASSERT_FALSE(history.undo(&deck));
+    ASSERT_TRUE(deck.getCardList().isEmpty());
+    ASSERT_TRUE(history.undo(&deck));
+    ASSERT_EQ(deck.writeToString_Native(), original);
+
+    history.redo(&deck, 2);
+    ASSERT_EQ(deck.writeToString_Native(), edited);
+}
+
+TEST(DeckListHistoryTest, ByteLimit)
+{
+    DeckList deck(largeDeck);
+    DeckListHistoryManager history;
+    history.setMaxHistoryBytes(256 * 1024);
+
+    applyEdits(deck, history);
+
+    ASSERT_LE(history.getHistoryBytes(), history.getMaxHistoryBytes());
+    ASSERT_LT(history.getUndoStack().size(), edits);
+    ASSERT_TRUE(history.canUndo());
+}
+
+int main(int argc, char **argv)
+{
+    QStringList deckString{
+        R"(<?xml version="1.0"?><cockatrice_deck version="1"><deckname></deckname><comments></comments><zone name="main">)"};
+    const QString card = R"(<card number="1" name="card %1" setShortName="SET" collectorNumber="%1" uuid="uuid-%1"/>)";
+    for (int i = 0; i < uniqueCards; ++i) {
+        deckString << card.arg(i);
+    }
+    deckString << R"(</zone></cockatrice_deck>)";
+    largeDeck = deckString.join("");
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
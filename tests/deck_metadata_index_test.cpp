@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <libcockatrice/deck_list/deck_metadata_index.h>
+
+namespace
+{
+
+QString writeDeck(const QTemporaryDir &dir, const QString &fileName, const DeckList &deckList)
+{
+    const QString filePath = dir.filePath(fileName);
+    QFile file(filePath);
+    file.open(QIODevice::WriteOnly);
+    deckList.saveToFile_Native(&file);
+    return filePath;
+}
+
+DeckList makeDeck()
+{
+    DeckList deckList;
+    deckList.setName("Mono Red Aggro");
+    deckList.setGameFormat("modern");
+    deckList.setTags({"Aggro", "Budget"});
+    deckList.setBannerCard({"Lightning Bolt", "bolt-id"});
+    deckList.addCard("Lightning Bolt", DECK_ZONE_MAIN);
+    deckList.addCard("Lightning Bolt", DECK_ZONE_MAIN);
+    deckList.addCard("Mountain", DECK_ZONE_MAIN);
+    deckList.addCard("Smash to Smithereens", DECK_ZONE_SIDE);
+    deckList.addCard("Goblin Token", DECK_ZONE_TOKENS);
+    return deckList;
+}
+
+TEST(DeckMetadataIndexTest, ReadsMetadataFromDeckList)
+{
+    const DeckList deckList = makeDeck();
+    const DeckMetadata metadata = DeckMetadata::fromDeckList(deckList);
+
+    ASSERT_EQ(metadata.name, QString("Mono Red Aggro"));
+    ASSERT_EQ(metadata.gameFormat, QString("modern"));
+    ASSERT_EQ(metadata.tags, QStringList({"Aggro", "Budget"}));
+    ASSERT_EQ(metadata.bannerCard.providerId, QString("bolt-id"));
+    ASSERT_EQ(metadata.cardCount, 4); // the token is in neither the main deck nor the sideboard
+    ASSERT_EQ(metadata.deckHash, deckList.getDeckHash());
+    ASSERT_EQ(metadata.cards.size(), 4);
+}
+
+TEST(DeckMetadataIndexTest, SurvivesSaveAndLoad)
+{
+    QTemporaryDir dir;
+    const QString deckPath = writeDeck(dir, "aggro.cod", makeDeck());
+
+    DeckMetadata metadata = DeckMetadata::fromDeckList(makeDeck());
+    metadata.colorIdentity = "R";
+    metadata.colorIdentityPending = true;
+    metadata.setFile(QFileInfo(deckPath));
+
+    {
+        DeckMetadataIndex index(dir.filePath("index/decks.idx"));
+        index.insert(deckPath, metadata);
+        ASSERT_TRUE(index.isDirty());
+        ASSERT_TRUE(index.save());
+        ASSERT_FALSE(index.isDirty());
+    }
+
+    DeckMetadataIndex index(dir.filePath("index/decks.idx"));
+    ASSERT_TRUE(index.load());
+    const DeckMetadata *loaded = index.find(QFileInfo(deckPath));
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(loaded->name, metadata.name);
+    ASSERT_EQ(loaded->tags, metadata.tags);
+    ASSERT_EQ(loaded->colorIdentity, QString("R"));
+    ASSERT_TRUE(loaded->colorIdentityPending);
+    ASSERT_EQ(loaded->cardCount, 4);
+    ASSERT_EQ(loaded->deckHash, metadata.deckHash);
+    ASSERT_EQ(loaded->cards.size(), metadata.cards.size());
+    ASSERT_EQ(loaded->cards.first().name, metadata.cards.first().name);
+}
+
+TEST(DeckMetadataIndexTest, IgnoresEntriesOfChangedFiles)
+{
+    QTemporaryDir dir;
+    const QString deckPath = writeDeck(dir, "aggro.cod", makeDeck());
+
+    DeckMetadata metadata = DeckMetadata::fromDeckList(makeDeck());
+    metadata.setFile(QFileInfo(deckPath));
+    DeckMetadataIndex index(dir.filePath("decks.idx"));
+    index.insert(deckPath, metadata);
+    ASSERT_NE(index.find(QFileInfo(deckPath)), nullptr);
+
+    DeckList changed = makeDeck();
+    changed.setName("Mono Red Burn");
+    writeDeck(dir, "aggro.cod", changed);
+    QFile file(deckPath);
+    file.open(QIODevice::ReadWrite);
+    file.setFileTime(QDateTime::fromMSecsSinceEpoch(metadata.lastModified + 2000), QFileDevice::FileModificationTime);
+    file.close();
+
+    ASSERT_EQ(index.find(QFileInfo(deckPath)), nullptr);
+    QFile::remove(deckPath);
+    ASSERT_EQ(index.find(QFileInfo(deckPath)), nullptr);
+}
+
+TEST(DeckMetadataIndexTest, RemovesEntriesOfMissingFiles)
+{
+    QTemporaryDir dir;
+    DeckMetadataIndex index(dir.filePath("decks.idx"));
+    index.insert(dir.filePath("kept.cod"), DeckMetadata());
+    index.insert(dir.filePath("deleted.cod"), DeckMetadata());
+    index.insert(dir.filePath("sub/other.cod"), DeckMetadata());
+
+    index.removeMissing(dir.path(), {dir.filePath("kept.cod")});
+    ASSERT_EQ(index.size(), 2);
+}
+
+TEST(DeckMetadataIndexTest, RejectsForeignFiles)
+{
+    QTemporaryDir dir;
+    QFile file(dir.filePath("decks.idx"));
+    file.open(QIODevice::WriteOnly);
+    file.write("not an index");
+    file.close();
+
+    DeckMetadataIndex index(dir.filePath("decks.idx"));
+    ASSERT_FALSE(index.load());
+    ASSERT_EQ(index.size(), 0);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QUrl>
+#include <libcockatrice/utility/download_scheduler.h>
+
+static const DownloadScheduler::HostLimit limit = {10, 10};
+
+static QUrl cardUrl(int card, const QString &host = "images.example")
+{
+    return QUrl(QString("https://%1/cards/%2.jpg").arg(host).arg(card));
+}
+
+/**
+ * Stands in for the picture loader and an image host that answers every request after a fixed latency, driven by a
+ * virtual clock so the test neither sleeps nor depends on the speed of the machine.
+ */
+class SimulatedHost
+{
+public:
+    SimulatedHost(DownloadScheduler &_scheduler, qint64 _latency) : scheduler(_scheduler), latency(_latency)
+    {
+    }
+
+    qint64 now = 0;
+    QMap<quintptr, qint64> loadedAt;
+
+    void advanceTo(qint64 time)
+    {
+        for (; now <= time; ++now) {
+            for (auto it = replies.begin(); it != replies.end();) {
+                if (it.value() > now) {
+                    ++it;
+                    continue;
+                }
+                loadedAt.insert(consumers.take(it.key()), now);
+                for (const quintptr waiting : scheduler.finish(it.key())) {
+                    loadedAt.insert(waiting, now);
+                }
+                it = replies.erase(it);
+            }
+            while (auto download = scheduler.takeNext(now)) {
+                replies.insert(download->url, now + latency);
+                consumers.insert(download->url, download->consumer);
+            }
+        }
+    }
+
+private:
+    DownloadScheduler &scheduler;
+    qint64 latency;
+    QMap<QUrl, qint64> replies;
+    QHash<QUrl, quintptr> consumers;
+};
+
+TEST(DownloadSchedulerTest, CoalescesDuplicateUrls)
+{
+    DownloadScheduler scheduler(limit);
+    ASSERT_TRUE(scheduler.request(cardUrl(1), 1, 0));
+    ASSERT_FALSE(scheduler.request(cardUrl(1), 2, 0));
+    ASSERT_EQ(scheduler.queuedCount(), 1);
+
+    auto download = scheduler.takeNext(0);
+    ASSERT_TRUE(download.has_value());
+    ASSERT_EQ(download->consumer, 1u);
+    ASSERT_FALSE(scheduler.takeNext(0).has_value());
+
+    // asking for a url that is being downloaded waits for that download as well
+    ASSERT_FALSE(scheduler.request(cardUrl(1), 3, 0));
+    ASSERT_EQ(scheduler.finish(cardUrl(1)), QList<quintptr>({2, 3}));
+    ASSERT_FALSE(scheduler.isWaiting(2));
+    ASSERT_EQ(scheduler.runningCount(), 0);
+}
+
+TEST(DownloadSchedulerTest, SeenConsumersGoFirst)
+{
+    DownloadScheduler scheduler({1000, 1000});
+    for (int card = 0; card < 10; ++card) {
+        scheduler.request(cardUrl(card), card, 0);
+    }
+    scheduler.touch(7, 1500);
+    scheduler.touch(3, 1800);
+
+    // seen in the same period, so in the order they were requested
+    ASSERT_EQ(scheduler.takeNext(2000)->consumer, 3u);
+    ASSERT_EQ(scheduler.takeNext(2000)->consumer, 7u);
+    for (quintptr card : {0, 1, 2, 4}) {
+        ASSERT_EQ(scheduler.takeNext(2000)->consumer, card);
+    }
+
+    scheduler.touch(9, 2500);
+    ASSERT_EQ(scheduler.takeNext(2500)->consumer, 9u);
+    ASSERT_EQ(scheduler.takeNext(2500)->consumer, 5u);
+}
+
+TEST(DownloadSchedulerTest, CancelDropsDownloadsWithoutConsumers)
+{
+    DownloadScheduler scheduler(limit);
+    scheduler.request(cardUrl(1), 1, 0);
+    scheduler.request(cardUrl(1), 2, 0);
+    scheduler.request(cardUrl(2), 3, 0);
+
+    ASSERT_TRUE(scheduler.cancel(1).isEmpty());
+    ASSERT_EQ(scheduler.cancel(2), cardUrl(1));
+    ASSERT_TRUE(scheduler.cancel(2).isEmpty());
+    ASSERT_EQ(scheduler.queuedCount(), 1);
+    ASSERT_EQ(scheduler.takeNext(0)->consumer, 3u);
+
+    // a consumer moving on to another url leaves the first one behind
+    scheduler.request(cardUrl(4), 4, 0);
+    scheduler.request(cardUrl(5), 4, 0);
+    ASSERT_EQ(scheduler.queuedCount(), 1);
+    ASSERT_EQ(scheduler.takeNext(0)->url, cardUrl(5));
+}
+
+TEST(DownloadSchedulerTest, QueuedConsumersNotSeenSince)
+{
+    DownloadScheduler scheduler(limit);
+    scheduler.request(cardUrl(1), 1, 0);
+    scheduler.request(cardUrl(2), 2, 0);
+    scheduler.request(cardUrl(3), 3, 0);
+    scheduler.touch(2, 900);
+    scheduler.takeNext(1000);
+
+    // consumer 1 is downloading, consumer 2 was seen too recently
+    ASSERT_EQ(scheduler.queuedConsumers(500), QList<quintptr>({3}));
+}
+
+TEST(DownloadSchedulerTest, TokenBucketPerHost)
+{
+    DownloadScheduler scheduler(limit);
+    scheduler.setHostLimit("fast.example", {100, 5});
+    for (int card = 0; card < 100; ++card) {
+        scheduler.request(cardUrl(card), card, 0);
+        scheduler.request(cardUrl(card, "other.example"), 1000 + card, 0);
+        scheduler.request(cardUrl(card, "fast.example"), 2000 + card, 0);
+    }
+
+    QMap<QString, int> started;
+    for (qint64 now = 0; now <= 2000; now += 10) {
+        while (auto download = scheduler.takeNext(now)) {
+            ++started[download->url.host()];
+        }
+    }
+
+    // the burst right away, then the rate, for every host on its own
+    ASSERT_EQ(started["images.example"], 30);
+    ASSERT_EQ(started["other.example"], 30);
+    ASSERT_EQ(started["fast.example"], 100);
+
+    ASSERT_EQ(scheduler.msecsUntilNext(2000), 100);
+    ASSERT_EQ(scheduler.msecsUntilNext(2050), 50);
+    ASSERT_EQ(scheduler.msecsUntilNext(2100), 0);
+}
+
+TEST(DownloadSchedulerTest, VisibleCardsOvertakeOffscreenBacklog)
+{
+    DownloadScheduler scheduler(limit);
+    SimulatedHost host(scheduler, 300);
+
+    // opening a big cube requests every card, then the user scrolls to the end of the list
+    for (int card = 0; card < 500; ++card) {
+        scheduler.request(cardUrl(card), card, 0);
+    }
+    host.advanceTo(1000);
+    for (qint64 now = 1000; now < 3000; now += 100) {
+        for (int card = 480; card < 500; ++card) {
+            scheduler.touch(card, now);
+        }
+        host.advanceTo(now + 100);
+    }
+    host.advanceTo(3500);
+
+    // at 10 requests per second the visible cards would have waited for 48 seconds in order of request
+    for (quintptr card = 480; card < 500; ++card) {
+        ASSERT_TRUE(host.loadedAt.contains(card));
+        ASSERT_LE(host.loadedAt[card], 3500);
+    }
+    ASSERT_LT(host.loadedAt.size(), 60);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
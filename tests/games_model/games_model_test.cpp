@@ -0,0 +1,166 @@
+/** @file games_model_test.cpp
+ *  @brief Tests for the batched updates of the games model and the creator status cache of its proxy.
+ *  @ingroup Tests
+ */
+
+#include "mocks.h"
+
+// the games model is built here, after the mocks took the place of its GUI dependencies
+#include "../../cockatrice/src/interface/widgets/server/games_model.cpp"
+
+#include "gtest/gtest.h"
+#include <QSet>
+#include <QString>
+
+namespace
+{
+class FakeUserList : public UserListProxy
+{
+public:
+    QSet<QString> buddies;
+    mutable int lookups = 0;
+
+    bool isOwnUserRegistered() const override
+    {
+        return true;
+    }
+    QString getOwnUsername() const override
+    {
+        return "me";
+    }
+    bool isUserBuddy(const QString &userName) const override
+    {
+        ++lookups;
+        return buddies.contains(userName);
+    }
+    bool isUserIgnored(const QString & /* userName */) const override
+    {
+        return false;
+    }
+    const ServerInfo_User *getOnlineUser(const QString & /* userName */) const override
+    {
+        return nullptr;
+    }
+};
+
+ServerInfo_Game makeGame(int id, const std::string &description, const std::string &creator = "alice")
+{
+    ServerInfo_Game game;
+    game.set_game_id(id);
+    game.set_description(description);
+    game.set_max_players(2);
+    game.mutable_creator_info()->set_name(creator);
+    return game;
+}
+
+ServerInfo_Game closedGame(int id)
+{
+    ServerInfo_Game game;
+    game.set_game_id(id);
+    game.set_closed(true);
+    return game;
+}
+
+TEST(GamesModelTest, AddCloseAndUpdateInOneBatch)
+{
+    GamesModel model({}, {});
+    model.updateGameList(makeGame(10, "listed"));
+
+    model.beginGameListUpdate();
+    model.updateGameList(makeGame(1, "closed again"));
+    model.updateGameList(makeGame(2, "second"));
+    model.updateGameList(makeGame(3, "third"));
+    model.updateGameList(closedGame(1));
+    model.endGameListUpdate();
+
+    ASSERT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.getGame(0).game_id(), 10);
+    EXPECT_EQ(model.getGame(1).game_id(), 2);
+    EXPECT_EQ(model.getGame(2).game_id(), 3);
+
+    // the games after the dropped one moved up a row, updates have to find them there
+    model.updateGameList(makeGame(3, "third, updated"));
+    model.updateGameList(makeGame(2, "second, updated"));
+    EXPECT_EQ(model.getGame(1).description(), "second, updated");
+    EXPECT_EQ(model.getGame(2).description(), "third, updated");
+
+    model.updateGameList(closedGame(3));
+    ASSERT_EQ(model.rowCount(), 2);
+    EXPECT_EQ(model.getGame(1).game_id(), 2);
+}
+
+TEST(GamesModelTest, CloseListedAndPendingGamesInOneBatch)
+{
+    GamesModel model({}, {});
+    model.beginGameListUpdate();
+    for (int id = 1; id <= 4; ++id) {
+        model.updateGameList(makeGame(id, "listed"));
+    }
+    model.endGameListUpdate();
+
+    model.beginGameListUpdate();
+    model.updateGameList(makeGame(5, "pending"));
+    model.updateGameList(makeGame(6, "pending"));
+    model.updateGameList(closedGame(2));
+    model.updateGameList(closedGame(5));
+    model.beginGameListUpdate();
+    model.updateGameList(closedGame(3));
+    model.updateGameList(makeGame(6, "pending, updated"));
+    model.endGameListUpdate();
+    model.endGameListUpdate();
+
+    ASSERT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.getGame(0).game_id(), 1);
+    EXPECT_EQ(model.getGame(1).game_id(), 4);
+    EXPECT_EQ(model.getGame(2).game_id(), 6);
+    EXPECT_EQ(model.getGame(2).description(), "pending, updated");
+
+    model.updateGameList(makeGame(4, "listed, updated"));
+    EXPECT_EQ(model.getGame(1).description(), "listed, updated");
+}
+
+TEST(GamesProxyModelTest, RefreshPicksUpNewBuddies)
+{
+    FakeUserList userList;
+    GamesModel model({}, {});
+    GamesProxyModel proxy(nullptr, &userList);
+    proxy.setSourceModel(&model);
+    GameFilterConfigs filters;
+    filters.hideNotBuddyCreatedGames = true;
+    proxy.setGameFilters(filters);
+
+    model.updateGameList(makeGame(1, "by alice"));
+    EXPECT_EQ(proxy.rowCount(), 0);
+
+    // a buddy list arriving after the games
+    userList.buddies.insert("alice");
+    EXPECT_EQ(proxy.rowCount(), 0);
+    proxy.refresh();
+    EXPECT_EQ(proxy.rowCount(), 1);
+}
+
+TEST(GamesProxyModelTest, ClosedGamesLeaveTheCreatorCache)
+{
+    FakeUserList userList;
+    GamesModel model({}, {});
+    GamesProxyModel proxy(nullptr, &userList);
+    proxy.setSourceModel(&model);
+    GameFilterConfigs filters;
+    filters.hideNotBuddyCreatedGames = true;
+    proxy.setGameFilters(filters);
+
+    model.updateGameList(makeGame(1, "by alice"));
+    const int lookups = userList.lookups;
+    EXPECT_GT(lookups, 0);
+
+    model.updateGameList(makeGame(1, "by alice, updated"));
+    EXPECT_EQ(userList.lookups, lookups);
+
+    // a game coming back under the same id is looked up again
+    model.updateGameList(closedGame(1));
+    userList.buddies.insert("alice");
+    model.updateGameList(makeGame(1, "by alice, again"));
+    EXPECT_GT(userList.lookups, lookups);
+    EXPECT_EQ(proxy.rowCount(), 1);
+}
+} // namespace
@@ -0,0 +1,28 @@
+#include "mocks.h"
+
+#include <cstdlib>
+
+SettingsCache &SettingsCache::instance()
+{
+    // the tests never load or save the filters
+    std::abort();
+}
+
+GameFiltersSettings &SettingsCache::gameFilters() const
+{
+    std::abort();
+}
+
+QIcon UserLevelPixmapGenerator::generateIcon(int /* minHeight */,
+                                             UserLevelFlags /* userLevel */,
+                                             ServerInfo_User::PawnColorsOverride /* pawnColors */,
+                                             bool /* isBuddy */,
+                                             const QString & /* privLevel */)
+{
+    return QIcon();
+}
+
+QPixmap LockPixmapGenerator::generatePixmap(int /* height */)
+{
+    return QPixmap();
+}
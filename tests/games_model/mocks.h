@@ -0,0 +1,41 @@
+/*
+ * Beware of this preprocessor hack used to replace the settings cache, the pixmap generators and the user list
+ * widgets the games model includes instead of building them and all of their dependencies.
+ * Always set header guards of mocked objects before including any headers with mocked objects.
+ */
+
+#define SETTINGSCACHE_H
+#define PIXMAPGENERATOR_H
+#define TAB_ACCOUNT_H
+#define COCKATRICE_USER_LIST_MANAGER_H
+#define USERLIST_H
+
+#include "../../cockatrice/src/interface/widgets/server/user/user_list_proxy.h"
+
+#include <QIcon>
+#include <QPixmap>
+#include <libcockatrice/network/server/remote/user_level.h>
+#include <libcockatrice/settings/game_filters_settings.h>
+
+class SettingsCache
+{
+public:
+    static SettingsCache &instance();
+    GameFiltersSettings &gameFilters() const;
+};
+
+class UserLevelPixmapGenerator
+{
+public:
+    static QIcon generateIcon(int minHeight,
+                              UserLevelFlags userLevel,
+                              ServerInfo_User::PawnColorsOverride pawnColors,
+                              bool isBuddy,
+                              const QString &privLevel);
+};
+
+class LockPixmapGenerator
+{
+public:
+    static QPixmap generatePixmap(int height);
+};
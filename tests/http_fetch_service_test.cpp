@@ -0,0 +1,246 @@
+#include "gtest/gtest.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <libcockatrice/network/http/http_fetch_service.h>
+#include <algorithm>
+#include <memory>
+
+namespace
+{
+
+/**
+ * Stands in for the EDHREC and Archidekt servers: answers every GET after a fixed latency with a body derived from the
+ * path and an ETag, and with 304 to requests that send that ETag back.
+ */
+class LocalHttpServer : public QObject
+{
+public:
+    explicit LocalHttpServer(int _latencyMsecs) : latencyMsecs(_latencyMsecs)
+    {
+        server.listen(QHostAddress::LocalHost);
+        connect(&server, &QTcpServer::newConnection, this, [this] {
+            while (QTcpSocket *socket = server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readRequest(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(server.serverPort()).arg(path));
+    }
+
+    int hits = 0;
+    int notModified = 0;
+    int active = 0;
+    int maxActive = 0;
+
+private:
+    QTcpServer server;
+    int latencyMsecs;
+    QHash<QTcpSocket *, QByteArray> buffers;
+
+    static QByteArray etagFor(const QByteArray &path)
+    {
+        return "\"" + path.toHex() + "\"";
+    }
+
+    void readRequest(QTcpSocket *socket)
+    {
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+        if (!buffer.contains("\r\n\r\n")) {
+            return;
+        }
+        const QList<QByteArray> lines = buffer.split('\n');
+        buffers.remove(socket);
+
+        const QByteArray path = lines.first().split(' ').value(1);
+        QByteArray ifNoneMatch;
+        for (const QByteArray &line : lines) {
+            if (line.toLower().startsWith("if-none-match:")) {
+                ifNoneMatch = line.mid(line.indexOf(':') + 1).trimmed();
+            }
+        }
+
+        ++hits;
+        maxActive = std::max(maxActive, ++active);
+        QPointer<QTcpSocket> guard(socket);
+        QTimer::singleShot(latencyMsecs, this, [this, guard, path, ifNoneMatch] {
+            --active;
+            if (!guard) {
+                return;
+            }
+            QByteArray response;
+            if (ifNoneMatch == etagFor(path)) {
+                ++notModified;
+                response = "HTTP/1.1 304 Not Modified\r\nETag: " + etagFor(path) +
+                           "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            } else {
+                const QByteArray body = "body of " + path;
+                response = "HTTP/1.1 200 OK\r\nETag: " + etagFor(path) +
+                           "\r\nContent-Length: " + QByteArray::number(body.size()) +
+                           "\r\nConnection: close\r\n\r\n" + body;
+            }
+            guard->write(response);
+            guard->disconnectFromHost();
+        });
+    }
+};
+
+bool waitUntil(const std::function<bool()> &condition, int timeoutMsecs = 3000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMsecs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+TEST(HttpFetchServiceTest, DeduplicatesConcurrentFetches)
+{
+    QTemporaryDir cacheDir;
+    LocalHttpServer server(50);
+    HttpFetchService service(cacheDir.path());
+    QObject context;
+
+    QList<HttpFetchService::Response> responses;
+    for (int i = 0; i < 3; ++i) {
+        service.fetch(
+            server.url("/commanders/year.json"), &context,
+            [&responses](const HttpFetchService::Response &response) { responses.append(response); }, 3600);
+    }
+
+    ASSERT_TRUE(waitUntil([&] { return responses.size() == 3; }));
+    ASSERT_EQ(server.hits, 1);
+    for (const auto &response : responses) {
+        ASSERT_TRUE(response.isOk());
+        ASSERT_EQ(response.body, QByteArray("body of /commanders/year.json"));
+        ASSERT_FALSE(response.fromCache);
+    }
+}
+
+TEST(HttpFetchServiceTest, ServesFreshResponsesFromDisk)
+{
+    QTemporaryDir cacheDir;
+    LocalHttpServer server(10);
+    QObject context;
+    std::unique_ptr<HttpFetchService::Response> received;
+    const auto callback = [&received](const HttpFetchService::Response &response) {
+        received = std::make_unique<HttpFetchService::Response>(response);
+    };
+
+    {
+        HttpFetchService service(cacheDir.path());
+        service.fetch(server.url("/tags.json"), &context, callback, 3600);
+        ASSERT_TRUE(waitUntil([&] { return received != nullptr; }));
+    }
+
+    // a new service, as after restarting the client, finds the response on disk
+    received.reset();
+    HttpFetchService service(cacheDir.path());
+    service.fetch(server.url("/tags.json"), &context, callback, 3600);
+    ASSERT_EQ(received, nullptr); // never called from within fetch()
+    ASSERT_TRUE(waitUntil([&] { return received != nullptr; }));
+    ASSERT_TRUE(received->fromCache);
+    ASSERT_EQ(received->body, QByteArray("body of /tags.json"));
+    ASSERT_EQ(server.hits, 1);
+}
+
+TEST(HttpFetchServiceTest, RevalidatesExpiredResponses)
+{
+    QTemporaryDir cacheDir;
+    LocalHttpServer server(10);
+    HttpFetchService service(cacheDir.path());
+    QObject context;
+    std::unique_ptr<HttpFetchService::Response> received;
+    const auto callback = [&received](const HttpFetchService::Response &response) {
+        received = std::make_unique<HttpFetchService::Response>(response);
+    };
+
+    service.fetch(server.url("/top/year.json"), &context, callback, 0);
+    ASSERT_TRUE(waitUntil([&] { return received != nullptr; }));
+    ASSERT_FALSE(received->fromCache);
+
+    received.reset();
+    service.fetch(server.url("/top/year.json"), &context, callback, 0);
+    ASSERT_TRUE(waitUntil([&] { return received != nullptr; }));
+    ASSERT_EQ(server.hits, 2);
+    ASSERT_EQ(server.notModified, 1);
+    ASSERT_TRUE(received->fromCache);
+    ASSERT_EQ(received->body, QByteArray("body of /top/year.json"));
+}
+
+TEST(HttpFetchServiceTest, BoundsConcurrentRequests)
+{
+    QTemporaryDir cacheDir;
+    LocalHttpServer server(30);
+    HttpFetchService service(cacheDir.path());
+    service.setMaxConcurrentRequests(2);
+    QObject context;
+
+    int received = 0;
+    for (int deck = 0; deck < 8; ++deck) {
+        service.fetch(
+            server.url(QString("/decks/%1/").arg(deck)), &context,
+            [&received](const HttpFetchService::Response &response) {
+                if (response.isOk()) {
+                    ++received;
+                }
+            },
+            3600);
+    }
+
+    ASSERT_TRUE(waitUntil([&] { return received == 8; }));
+    ASSERT_EQ(server.hits, 8);
+    ASSERT_LE(server.maxActive, 2);
+    ASSERT_EQ(service.runningCount(), 0);
+}
+
+TEST(HttpFetchServiceTest, DropsCallbacksOfDestroyedContexts)
+{
+    QTemporaryDir cacheDir;
+    LocalHttpServer server(30);
+    HttpFetchService service(cacheDir.path());
+    service.setMaxConcurrentRequests(1);
+    QObject survivor;
+    auto closedTab = std::make_unique<QObject>();
+
+    int survivorCalls = 0;
+    int closedTabCalls = 0;
+    service.fetch(
+        server.url("/first.json"), &survivor, [&](const HttpFetchService::Response &) { ++survivorCalls; }, 3600);
+    service.fetch(
+        server.url("/first.json"), closedTab.get(), [&](const HttpFetchService::Response &) { ++closedTabCalls; },
+        3600);
+    // queued behind the first fetch and only wanted by the closed tab, so never requested
+    service.fetch(
+        server.url("/second.json"), closedTab.get(), [&](const HttpFetchService::Response &) { ++closedTabCalls; },
+        3600);
+    closedTab.reset();
+
+    ASSERT_TRUE(waitUntil([&] { return survivorCalls == 1 && service.runningCount() == 0; }));
+    QCoreApplication::processEvents();
+    ASSERT_EQ(closedTabCalls, 0);
+    ASSERT_EQ(server.hits, 1);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    QCoreApplication app(argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+/** @file servatrice_log_query_test.cpp
+ *  @brief Tests for the filters and paging of the moderators' log search, run against the SQLite schema.
+ *  @ingroup Tests
+ */
+
+#include "servatrice_log_query.h"
+#include "servatrice_sql_dialect.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace
+{
+/**
+ * An in-memory SQLite database with the servatrice schema, the way servatrice creates it for the SQLite backend.
+ */
+class LogQueryTest : public ::testing::Test
+{
+protected:
+    QSqlDatabase db;
+
+    void SetUp() override
+    {
+        db = QSqlDatabase::addDatabase("QSQLITE", "log_query_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open()) << db.lastError().text().toStdString();
+
+        QFile schemaFile(SERVATRICE_SCHEMA);
+        ASSERT_TRUE(schemaFile.open(QIODevice::ReadOnly));
+        QSqlQuery query(db);
+        for (const QString &statement :
+             Servatrice_SqlDialect::schemaToSqlite(QString::fromUtf8(schemaFile.readAll()), "cockatrice")) {
+            ASSERT_TRUE(query.exec(statement)) << query.lastError().text().toStdString() << " in "
+                                               << statement.toStdString();
+        }
+    }
+
+    void TearDown() override
+    {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("log_query_test");
+    }
+
+    void addMessage(const QString &sender,
+                    const QString &target,
+                    const QString &targetType,
+                    const QString &message,
+                    const QVariant &senderIp = QString("10.0.0.1"))
+    {
+        QSqlQuery query(db);
+        query.prepare("insert into cockatrice_log (log_time, sender_name, sender_ip, log_message, target_type, "
+                      "target_id, target_name) values (datetime('now'), :sender, :ip, :message, :type, 1, :target)");
+        query.bindValue(":sender", sender);
+        query.bindValue(":ip", senderIp);
+        query.bindValue(":message", message);
+        query.bindValue(":type", targetType);
+        query.bindValue(":target", target);
+        ASSERT_TRUE(query.exec()) << query.lastError().text().toStdString();
+    }
+
+    /**
+     * @return the messages the search finds, newest first, and the id of the last one in lastId
+     */
+    QStringList find(Servatrice_LogQuery logQuery, qint64 *lastId = nullptr)
+    {
+        if (logQuery.beforeId == 0) {
+            logQuery.beforeId = std::numeric_limits<qint64>::max();
+        }
+        if (logQuery.maxResults == 0) {
+            logQuery.maxResults = 1000;
+        }
+
+        QSqlQuery query(db);
+        QString statement = Servatrice_SqlDialect::toSqlite(logQuery.statement());
+        statement.replace("{prefix}", "cockatrice");
+        EXPECT_TRUE(query.prepare(statement)) << query.lastError().text().toStdString();
+        logQuery.bindValues(query);
+        EXPECT_TRUE(query.exec()) << query.lastError().text().toStdString();
+
+        QStringList messages;
+        while (query.next()) {
+            messages << query.value(4).toString();
+            if (lastId) {
+                *lastId = query.value(8).toLongLong();
+            }
+        }
+        return messages;
+    }
+};
+} // namespace
+
+TEST_F(LogQueryTest, NeedsAFilterOnAnIndexedField)
+{
+    Servatrice_LogQuery logQuery;
+    logQuery.chat = logQuery.game = logQuery.room = true;
+    EXPECT_FALSE(logQuery.hasFilter());
+    logQuery.message = "hello";
+    EXPECT_FALSE(logQuery.hasFilter());
+    logQuery.gameName = "some game";
+    EXPECT_TRUE(logQuery.hasFilter());
+}
+
+TEST_F(LogQueryTest, MessageIsAnEscapedSubstringMatch)
+{
+    addMessage("alice", "Lobby", "room", "Hello there");
+    addMessage("bob", "Lobby", "room", "well, hello");
+    addMessage("carol", "Lobby", "room", "goodbye");
+    addMessage("alice", "Lobby", "room", "100% sure");
+    addMessage("alice", "Lobby", "room", "1000 sure");
+    addMessage("alice", "Lobby", "room", "a_b");
+    addMessage("alice", "Lobby", "room", "axb");
+    addMessage("alice", "Lobby", "room", "wow!");
+
+    Servatrice_LogQuery logQuery;
+    logQuery.message = "hello";
+    EXPECT_EQ(find(logQuery), QStringList({"well, hello", "Hello there"}));
+    logQuery.message = "0% s";
+    EXPECT_EQ(find(logQuery), QStringList({"100% sure"}));
+    logQuery.message = "a_b";
+    EXPECT_EQ(find(logQuery), QStringList({"a_b"}));
+    logQuery.message = "w!";
+    EXPECT_EQ(find(logQuery), QStringList({"wow!"}));
+}
+
+TEST_F(LogQueryTest, SkipsMessagesWithoutSenderIp)
+{
+    addMessage("alice", "Lobby", "room", "logged with an ip");
+    addMessage("alice", "Lobby", "room", "logged without an ip", QVariant());
+
+    Servatrice_LogQuery logQuery;
+    logQuery.user = "alice";
+    EXPECT_EQ(find(logQuery), QStringList({"logged with an ip"}));
+}
+
+TEST_F(LogQueryTest, UserMatchesSenderOrTargetAndLocations)
+{
+    addMessage("alice", "bob", "chat", "to bob");
+    addMessage("bob", "alice", "chat", "to alice");
+    addMessage("carol", "Lobby", "room", "not about alice");
+    addMessage("alice", "Lobby", "room", "in the lobby");
+
+    Servatrice_LogQuery logQuery;
+    logQuery.user = "alice";
+    EXPECT_EQ(find(logQuery), QStringList({"in the lobby", "to alice", "to bob"}));
+    logQuery.chat = true;
+    EXPECT_EQ(find(logQuery), QStringList({"to alice", "to bob"}));
+}
+
+TEST_F(LogQueryTest, PagesAreBoundedByIds)
+{
+    for (int i = 0; i < 5; ++i) {
+        addMessage("alice", "Lobby", "room", QString("message %1").arg(i));
+    }
+
+    Servatrice_LogQuery logQuery;
+    logQuery.user = "alice";
+    logQuery.maxResults = 2;
+    qint64 lastId = 0;
+    EXPECT_EQ(find(logQuery, &lastId), QStringList({"message 4", "message 3"}));
+
+    logQuery.beforeId = lastId;
+    EXPECT_EQ(find(logQuery, &lastId), QStringList({"message 2", "message 1"}));
+
+    // a date range starting at the first message, then one starting right at the page
+    logQuery.beforeId = lastId;
+    logQuery.firstId = lastId - 1;
+    EXPECT_EQ(find(logQuery), QStringList({"message 0"}));
+    logQuery.firstId = lastId;
+    EXPECT_TRUE(find(logQuery).isEmpty());
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
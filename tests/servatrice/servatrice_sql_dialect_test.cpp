@@ -0,0 +1,236 @@
+/** @file servatrice_sql_dialect_test.cpp
+ *  @brief Tests for the SQLite rewrites of the servatrice statements, run against the SQLite schema.
+ *  @ingroup Tests
+ */
+
+#include "servatrice_sql_dialect.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QVersionNumber>
+#include <gtest/gtest.h>
+
+namespace
+{
+/**
+ * @return the statements of the prepareQuery calls with a literal argument in a servatrice source file, with the
+ * string literals of each call joined
+ */
+QStringList literalStatements(const QString &sourceFile)
+{
+    static const QRegularExpression call(R"re(prepareQuery\(\s*((?:"(?:[^"\\]|\\.)*"\s*)+)\))re");
+    static const QRegularExpression literal(R"re("((?:[^"\\]|\\.)*)")re");
+
+    QFile file(QDir(SERVATRICE_SOURCE_DIR).filePath(sourceFile));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    const QString source = QString::fromUtf8(file.readAll());
+
+    QStringList statements;
+    for (auto calls = call.globalMatch(source); calls.hasNext();) {
+        QString statement;
+        for (auto literals = literal.globalMatch(calls.next().captured(1)); literals.hasNext();) {
+            statement += literals.next().captured(1).replace("\\\"", "\"");
+        }
+        statements.append(statement);
+    }
+    return statements;
+}
+
+/**
+ * An in-memory SQLite database with the servatrice schema, the way servatrice creates it for the SQLite backend.
+ */
+class SqlDialectTest : public ::testing::Test
+{
+protected:
+    QSqlDatabase db;
+
+    void SetUp() override
+    {
+        db = QSqlDatabase::addDatabase("QSQLITE", "sql_dialect_test");
+        db.setDatabaseName(":memory:");
+        ASSERT_TRUE(db.open()) << db.lastError().text().toStdString();
+
+        QFile schemaFile(SERVATRICE_SCHEMA);
+        ASSERT_TRUE(schemaFile.open(QIODevice::ReadOnly));
+        QSqlQuery query(db);
+        for (const QString &statement :
+             Servatrice_SqlDialect::schemaToSqlite(QString::fromUtf8(schemaFile.readAll()), "cockatrice")) {
+            ASSERT_TRUE(query.exec(statement)) << query.lastError().text().toStdString() << " in "
+                                               << statement.toStdString();
+        }
+    }
+
+    void TearDown() override
+    {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("sql_dialect_test");
+    }
+
+    /**
+     * Prepares a statement of the MySQL dialect the way servatrice does for SQLite.
+     */
+    QSqlQuery prepare(const QString &mysqlStatement)
+    {
+        QString statement = Servatrice_SqlDialect::toSqlite(mysqlStatement);
+        statement.replace("{prefix}", "cockatrice");
+        QSqlQuery query(db);
+        EXPECT_TRUE(query.prepare(statement))
+            << query.lastError().text().toStdString() << " in " << statement.toStdString();
+        return query;
+    }
+
+    void exec(const QString &statement)
+    {
+        QSqlQuery query(db);
+        ASSERT_TRUE(query.exec(statement)) << query.lastError().text().toStdString();
+    }
+
+    QVariant firstValue(QSqlQuery &query)
+    {
+        EXPECT_TRUE(query.exec()) << query.lastError().text().toStdString();
+        EXPECT_TRUE(query.next());
+        return query.value(0);
+    }
+};
+} // namespace
+
+TEST_F(SqlDialectTest, BundledSqliteIsRecentEnough)
+{
+    QSqlQuery query(db);
+    ASSERT_TRUE(query.exec("select sqlite_version()") && query.next());
+    EXPECT_GE(QVersionNumber::fromString(query.value(0).toString()), Servatrice_SqlDialect::minimumSqliteVersion());
+}
+
+TEST_F(SqlDialectTest, EveryRewrittenStatementPrepares)
+{
+    const QStringList sourceFiles = {"servatrice_database_interface.cpp", "serversocketinterface.cpp",
+                                     "servatrice.cpp"};
+    int rewritten = 0;
+    for (const QString &sourceFile : sourceFiles) {
+        const QStringList statements = literalStatements(sourceFile);
+        ASSERT_FALSE(statements.isEmpty()) << sourceFile.toStdString();
+        for (const QString &statement : statements) {
+            if (Servatrice_SqlDialect::toSqlite(statement) != statement) {
+                ++rewritten;
+                prepare(statement);
+            }
+        }
+    }
+    // now(), utc_timestamp(), the ban queries, the upsert and the date ranges
+    EXPECT_GE(rewritten, 20);
+}
+
+TEST_F(SqlDialectTest, TableLocksAreNotRewritten)
+{
+    const QString lock = "lock tables {prefix}_sessions write, {prefix}_users read";
+    EXPECT_EQ(Servatrice_SqlDialect::toSqlite(lock), lock);
+    EXPECT_EQ(Servatrice_SqlDialect::toSqlite("unlock tables"), "unlock tables");
+}
+
+TEST_F(SqlDialectTest, BanSecondsRemainingAndPermanentBans)
+{
+    exec("insert into cockatrice_bans (user_name, ip_address, time_from, minutes) values "
+         "('timed', '10.0.0.1', datetime('now', 'localtime', '-10 minutes'), 30), "
+         "('permanent', '10.0.0.2', datetime('now', 'localtime', '-10 minutes'), 0)");
+
+    QSqlQuery query = prepare("select timestampdiff(second, now(), date_add(b.time_from, interval b.minutes minute)), "
+                              "b.minutes <=> 0, b.visible_reason from {prefix}_bans b where b.time_from = (select "
+                              "max(c.time_from) from {prefix}_bans c where c.user_name = :name2) and b.user_name = "
+                              ":name1");
+    query.bindValue(":name2", "timed");
+    query.bindValue(":name1", "timed");
+    ASSERT_TRUE(query.exec()) << query.lastError().text().toStdString();
+    ASSERT_TRUE(query.next());
+    EXPECT_NEAR(query.value(0).toInt(), 20 * 60, 5);
+    EXPECT_EQ(query.value(1).toInt(), 0);
+
+    query.bindValue(":name2", "permanent");
+    query.bindValue(":name1", "permanent");
+    ASSERT_TRUE(query.exec()) << query.lastError().text().toStdString();
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(query.value(1).toInt(), 1);
+}
+
+TEST_F(SqlDialectTest, IntervalsBeforeNow)
+{
+    exec("insert into cockatrice_forgot_password (name, requestDate) values "
+         "('alice', datetime('now', 'localtime', '-2 hours'))");
+    QSqlQuery insert = prepare("insert into {prefix}_forgot_password (name,requestDate) values (:username,NOW())");
+    insert.bindValue(":username", "alice");
+    ASSERT_TRUE(insert.exec()) << insert.lastError().text().toStdString();
+
+    QSqlQuery recent = prepare("select count(name) from {prefix}_forgot_password where name = :user_name AND "
+                               "requestDate > (now() - interval :minutes minute)");
+    recent.bindValue(":user_name", "alice");
+    recent.bindValue(":minutes", 30);
+    EXPECT_EQ(firstValue(recent).toInt(), 1);
+    recent.bindValue(":minutes", 180);
+    EXPECT_EQ(firstValue(recent).toInt(), 2);
+
+    exec("insert into cockatrice_log (log_time, log_message) values (datetime('now', 'localtime', '-3 hours'), 'old'), "
+         "(datetime('now', 'localtime', '-30 minutes'), 'new')");
+    QSqlQuery range = prepare("select log_message from {prefix}_log where log_time >= date_sub(now(), interval "
+                              ":range_time hour) order by log_time limit 1");
+    range.bindValue(":range_time", 1);
+    EXPECT_EQ(firstValue(range).toString(), "new");
+}
+
+TEST_F(SqlDialectTest, IntervalsAfterAColumn)
+{
+    exec("insert into cockatrice_games (id, time_started) values (1, datetime('now', 'localtime', '-8 days')), "
+         "(2, datetime('now', 'localtime', '-1 days'))");
+    QSqlQuery query = prepare("select id from {prefix}_games where date_add(time_started, interval 7 day) > now()");
+    EXPECT_EQ(firstValue(query).toInt(), 2);
+    EXPECT_FALSE(query.next());
+}
+
+TEST_F(SqlDialectTest, UpsertWithoutConflictTarget)
+{
+    QSqlQuery query = prepare("INSERT INTO {prefix}_card_art_name_rules (card_name, card_provider_id, mode, reason, "
+                              "created_by) VALUES (:name, :provider, :mode, :reason, :uid) ON DUPLICATE KEY UPDATE "
+                              "mode=:mode2, reason=:reason2");
+    for (const QString &mode : {"ALLOW", "DENY"}) {
+        query.bindValue(":name", "Island");
+        query.bindValue(":provider", "scryfall");
+        query.bindValue(":mode", mode);
+        query.bindValue(":reason", mode);
+        query.bindValue(":uid", QVariant());
+        query.bindValue(":mode2", mode);
+        query.bindValue(":reason2", mode);
+        ASSERT_TRUE(query.exec()) << query.lastError().text().toStdString();
+    }
+
+    QSqlQuery rules(db);
+    ASSERT_TRUE(rules.exec("select count(*), max(mode) from cockatrice_card_art_name_rules") && rules.next());
+    EXPECT_EQ(rules.value(0).toInt(), 1);
+    EXPECT_EQ(rules.value(1).toString(), "DENY");
+}
+
+TEST_F(SqlDialectTest, FunctionsAndTimestamps)
+{
+    QSqlQuery substring = prepare("SELECT SUBSTRING('abcdef', 1, 3)");
+    EXPECT_EQ(firstValue(substring).toString(), "abc");
+
+    // the "yyyy-MM-dd hh:mm:ss" format of MySQL datetimes
+    QSqlQuery timestamps = prepare("select length(utc_timestamp()), length(now())");
+    ASSERT_TRUE(timestamps.exec() && timestamps.next()) << timestamps.lastError().text().toStdString();
+    EXPECT_EQ(timestamps.value(0).toInt(), 19);
+    EXPECT_EQ(timestamps.value(1).toInt(), 19);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+/** @file server_logger_performance_test.cpp
+ *  @brief Tests for the filters, staging and rotation of the servatrice logger, and a lines per second benchmark.
+ *  @ingroup Tests
+ */
+
+#include "server_logger.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+static constexpr int threads = 4;
+static constexpr int linesPerThread = 50000;
+
+namespace
+{
+/**
+ * A logger running in a thread of its own, as servatrice runs it.
+ */
+class LoggerFixture
+{
+public:
+    QTemporaryDir dir;
+    QThread thread;
+    ServerLogger *logger;
+
+    explicit LoggerFixture(const ServerLogger::Configuration &configuration = {})
+    {
+        logger = new ServerLogger(false);
+        logger->setConfiguration(configuration);
+        logger->moveToThread(&thread);
+        thread.start();
+        QMetaObject::invokeMethod(logger, "startLog", Qt::BlockingQueuedConnection, Q_ARG(QString, logFileName()));
+    }
+    ~LoggerFixture()
+    {
+        if (logger) {
+            QMetaObject::invokeMethod(logger, "deleteLater");
+        }
+        thread.wait();
+    }
+
+    QString logFileName() const
+    {
+        return dir.filePath("server.log");
+    }
+
+    QStringList flushedLines()
+    {
+        QMetaObject::invokeMethod(logger, "flushBuffer", Qt::BlockingQueuedConnection);
+        QFile file(logFileName());
+        if (!file.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        return QString::fromUtf8(file.readAll()).split("\n", Qt::SkipEmptyParts);
+    }
+};
+
+void logFromThreads(ServerLogger *logger, int lines, const QString &prefix = "line")
+{
+    std::vector<std::unique_ptr<QThread>> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back(QThread::create([=] {
+            for (int i = 0; i < lines; ++i) {
+                logger->logMessage(QString("%1 %2 %3").arg(prefix).arg(t).arg(i));
+            }
+        }));
+        writers.back()->start();
+    }
+    for (auto &writer : writers) {
+        writer->wait();
+    }
+}
+} // namespace
+
+TEST(ServerLogger, FiltersAreCaseInsensitive)
+{
+    ServerLogger::Configuration configuration;
+    EXPECT_TRUE(configuration.accepts("anything"));
+
+    configuration.filters.append(QStringMatcher("_Login", Qt::CaseInsensitive));
+    configuration.filters.append(QStringMatcher("Registration", Qt::CaseInsensitive));
+    EXPECT_TRUE(configuration.accepts("user logged in (_LOGIN)"));
+    EXPECT_TRUE(configuration.accepts("registration of foo"));
+    EXPECT_FALSE(configuration.accepts("Incoming connection"));
+}
+
+TEST(ServerLogger, LinesOfEveryThreadAreWrittenInOrder)
+{
+    LoggerFixture fixture;
+    logFromThreads(fixture.logger, 1000);
+
+    const QStringList lines = fixture.flushedLines();
+    ASSERT_EQ(lines.size(), threads * 1000);
+    std::vector<int> next(threads, 0);
+    for (const QString &line : lines) {
+        const QStringList words = line.split(" ");
+        const int thread = words[words.size() - 2].toInt();
+        ASSERT_EQ(words.last().toInt(), next[thread]) << line.toStdString();
+        ++next[thread];
+    }
+}
+
+TEST(ServerLogger, WriteLogAndFiltersFromConfiguration)
+{
+    ServerLogger::Configuration configuration;
+    configuration.filters.append(QStringMatcher("keep", Qt::CaseInsensitive));
+    LoggerFixture fixture(configuration);
+
+    fixture.logger->logMessage("Keep this");
+    fixture.logger->logMessage("drop this");
+    ASSERT_EQ(fixture.flushedLines().size(), 1);
+
+    configuration.writeLog = false;
+    fixture.logger->setConfiguration(configuration);
+    fixture.logger->logMessage("keep, but logging is off");
+    ASSERT_EQ(fixture.flushedLines().size(), 1);
+}
+
+TEST(ServerLogger, RotatesBySizeAndCompresses)
+{
+    ServerLogger::Configuration configuration;
+    configuration.rotateSize = 1000;
+    auto fixture = std::make_unique<LoggerFixture>(configuration);
+    const QString dirPath = fixture->dir.path();
+
+    qint64 bytes = 0;
+    for (int i = 0; i < 40; ++i) {
+        fixture->logger->logMessage(QString("rotated line %1").arg(i));
+        bytes += fixture->flushedLines().last().toUtf8().size() + 1;
+    }
+    // the logger waits for the compression when it is destroyed
+    QMetaObject::invokeMethod(fixture->logger, "deleteLater");
+    fixture->thread.wait();
+    fixture->logger = nullptr;
+
+    const QStringList rotated = QDir(dirPath).entryList({"server.log.*.gz"}, QDir::Files);
+    ASSERT_FALSE(rotated.isEmpty());
+    // compressed files replace the rotated ones
+    EXPECT_EQ(QDir(dirPath).entryList({"server.log.*"}, QDir::Files).size(), rotated.size());
+
+    qint64 rotatedBytes = 0;
+    for (const QString &name : rotated) {
+        QFile file(QDir(dirPath).filePath(name));
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        const QByteArray gzip = file.readAll();
+        ASSERT_GT(gzip.size(), 18);
+        EXPECT_EQ(static_cast<quint8>(gzip[0]), 0x1f);
+        EXPECT_EQ(static_cast<quint8>(gzip[1]), 0x8b);
+        // the last four bytes hold the uncompressed size
+        quint32 size = 0;
+        for (int i = 0; i < 4; ++i) {
+            size |= static_cast<quint32>(static_cast<quint8>(gzip[gzip.size() - 4 + i])) << (8 * i);
+        }
+        EXPECT_LE(size, 1000u);
+        rotatedBytes += size;
+    }
+    QFile current(QDir(dirPath).filePath("server.log"));
+    EXPECT_EQ(rotatedBytes + current.size(), bytes);
+}
+
+TEST(ServerLogger, LinesPerSecond)
+{
+    ServerLogger::Configuration configuration;
+    configuration.filters.append(QStringMatcher("connection", Qt::CaseInsensitive));
+    configuration.filters.append(QStringMatcher("login", Qt::CaseInsensitive));
+    LoggerFixture fixture(configuration);
+
+    QElapsedTimer timer;
+    timer.start();
+    logFromThreads(fixture.logger, linesPerThread, "Incoming connection");
+    logFromThreads(fixture.logger, linesPerThread, "Filtered out");
+    const QStringList lines = fixture.flushedLines();
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+
+    qDebug() << threads * linesPerThread * 2 << "lines from" << threads << "threads, half of them filtered, took"
+             << elapsed << "ms," << threads * linesPerThread * 2 * 1000 / elapsed << "lines per second";
+    ASSERT_EQ(lines.size(), threads * linesPerThread);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -176,6 +176,40 @@ TEST(ServerCardCounter, IncrementDoesNotExceedMax)
     EXPECT_EQ(card.getCounter(1), MAX_COUNTER_VALUE);
 }
 
+TEST(ServerCardCounter, CountersAreSortedById)
+{
+    Server_Card card(CardRef{"TestCard", ""}, 1, 0, 0);
+    ASSERT_TRUE(card.setCounter(5, 1));
+    ASSERT_TRUE(card.setCounter(2, 2));
+    ASSERT_TRUE(card.setCounter(9, 3));
+    ASSERT_TRUE(card.setCounter(2, 0));
+
+    ServerInfo_Card info;
+    card.getInfo(&info);
+    ASSERT_EQ(info.counter_list_size(), 2);
+    EXPECT_EQ(info.counter_list(0).id(), 5);
+    EXPECT_EQ(info.counter_list(1).id(), 9);
+    EXPECT_EQ(info.counter_list(1).value(), 3);
+}
+
+TEST(ServerCardCounter, ResetStateClearsCounters)
+{
+    Server_Card card(CardRef{"TestCard", ""}, 1, 0, 0);
+    ASSERT_TRUE(card.setCounter(1, 3));
+    card.setPT("2/2");
+    card.setAnnotation("note");
+
+    card.resetState(true);
+    EXPECT_TRUE(card.getCounters().isEmpty());
+    EXPECT_TRUE(card.getPT().isEmpty());
+    EXPECT_EQ(card.getAnnotation(), "note");
+
+    card.resetState();
+    EXPECT_TRUE(card.getAnnotation().isEmpty());
+    EXPECT_TRUE(card.incrementCounter(1, 1));
+    EXPECT_EQ(card.getCounter(1), 1);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
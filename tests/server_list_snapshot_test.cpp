@@ -0,0 +1,65 @@
+/** @file server_list_snapshot_test.cpp
+ *  @brief Tests for the versioned game and user list snapshots of the server.
+ *  @ingroup Tests
+ */
+
+#include <gtest/gtest.h>
+#include <libcockatrice/network/server/remote/server_list_snapshot.h>
+#include <libcockatrice/protocol/pb/serverinfo_game.pb.h>
+
+static ServerInfo_Game makeGame(int gameId, int playerCount)
+{
+    ServerInfo_Game game;
+    game.set_game_id(gameId);
+    game.set_description("game");
+    game.set_player_count(playerCount);
+    return game;
+}
+
+TEST(ServerListSnapshot, SnapshotIsSharedUntilChanged)
+{
+    Server_ListSnapshot<int, ServerInfo_Game> list;
+    list.insert(1, makeGame(1, 1));
+
+    auto first = list.get();
+    EXPECT_EQ(first, list.get());
+    ASSERT_EQ(first->items.size(), 1);
+
+    list.insert(2, makeGame(2, 1));
+    auto second = list.get();
+    EXPECT_NE(first, second);
+    EXPECT_GT(second->version, first->version);
+    EXPECT_EQ(first->items.size(), 1);
+    EXPECT_EQ(second->items.size(), 2);
+}
+
+TEST(ServerListSnapshot, MergeKeepsUnchangedFields)
+{
+    Server_ListSnapshot<int, ServerInfo_Game> list;
+    list.insert(1, makeGame(1, 1));
+
+    ServerInfo_Game delta;
+    delta.set_game_id(1);
+    delta.set_player_count(2);
+    delta.set_started(true);
+    list.merge(1, delta);
+
+    const ServerInfo_Game &game = list.get()->items.first();
+    EXPECT_EQ(game.player_count(), 2);
+    EXPECT_TRUE(game.started());
+    EXPECT_EQ(game.description(), "game");
+}
+
+TEST(ServerListSnapshot, UpdatesOfRemovedEntriesAreDropped)
+{
+    Server_ListSnapshot<int, ServerInfo_Game> list;
+    list.insert(1, makeGame(1, 1));
+    list.remove(1);
+    const quint64 version = list.getVersion();
+
+    list.merge(1, makeGame(1, 3));
+    list.update(1, makeGame(1, 3));
+    list.remove(1);
+    EXPECT_EQ(list.getVersion(), version);
+    EXPECT_TRUE(list.get()->items.isEmpty());
+}
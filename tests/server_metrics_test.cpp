@@ -0,0 +1,54 @@
+/** @file server_metrics_test.cpp
+ *  @brief Tests for the Prometheus output of Server_Metrics.
+ *  @ingroup Tests
+ */
+
+#include <gtest/gtest.h>
+#include <libcockatrice/network/server/remote/server_metrics.h>
+#include <libcockatrice/protocol/pb/game_commands.pb.h>
+
+TEST(ServerLatencyHistogram, BucketsAreCumulative)
+{
+    Server_LatencyHistogram histogram;
+    histogram.observe(10);      // first bucket
+    histogram.observe(700);     // <= 1ms
+    histogram.observe(9000000); // above the last bound
+
+    QString out;
+    histogram.appendPrometheus(out, "test_seconds", QString());
+    EXPECT_TRUE(out.contains("test_seconds_bucket{le=\"5e-05\"} 1\n"));
+    EXPECT_TRUE(out.contains("test_seconds_bucket{le=\"0.001\"} 2\n"));
+    EXPECT_TRUE(out.contains("test_seconds_bucket{le=\"5\"} 2\n"));
+    EXPECT_TRUE(out.contains("test_seconds_bucket{le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(out.contains("test_seconds_count 3\n"));
+}
+
+TEST(ServerLatencyHistogram, LabelsArePrefixed)
+{
+    Server_LatencyHistogram histogram;
+    histogram.observe(100);
+
+    QString out;
+    histogram.appendPrometheus(out, "test_seconds", "lock=\"rooms\"");
+    EXPECT_TRUE(out.contains("test_seconds_bucket{lock=\"rooms\",le=\"0.0001\"} 1\n"));
+    EXPECT_TRUE(out.contains("test_seconds_count{lock=\"rooms\"} 1\n"));
+}
+
+TEST(ServerMetrics, CommandsAreLabelledByName)
+{
+    Server_Metrics metrics;
+    metrics.observeCommand(Server_Metrics::GameCommandCategory, GameCommand::DRAW_CARDS, 200);
+    // unknown command types outside of the tracked range are ignored
+    metrics.observeCommand(Server_Metrics::GameCommandCategory, 5, 200);
+
+    QString out;
+    metrics.appendPrometheus(out);
+    EXPECT_TRUE(out.contains("servatrice_command_duration_seconds_count{category=\"game\",command=\"DRAW_CARDS\"} 1"));
+    EXPECT_EQ(out.count("servatrice_command_duration_seconds_count"), 1);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
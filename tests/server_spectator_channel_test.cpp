@@ -0,0 +1,317 @@
+/** @file server_spectator_channel_test.cpp
+ *  @brief Tests for the ordering, subscriptions, coalescing, delay and closing of the spectator channel of a game.
+ *  @ingroup Tests
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <libcockatrice/network/server/remote/game/server_spectator.h>
+#include <libcockatrice/network/server/remote/game/server_spectator_channel.h>
+#include <libcockatrice/network/server/remote/server_abstractuserinterface.h>
+#include <libcockatrice/protocol/pb/game_event_container.pb.h>
+#include <libcockatrice/protocol/pb/serverinfo_user.pb.h>
+#include <libcockatrice/protocol/pb/session_event.pb.h>
+#include <memory>
+
+namespace
+{
+/**
+ * Records what is sent to one spectator: "session" for a session event, "game" and the player ids of the events of a
+ * game event container.
+ */
+class FakeUserInterface : public Server_AbstractUserInterface
+{
+public:
+    /** Called outside the lock for every container, from the thread delivering it. */
+    std::function<void()> onGameEvent;
+
+    FakeUserInterface() : Server_AbstractUserInterface(nullptr)
+    {
+    }
+
+    int getLastCommandTime() const override
+    {
+        return 0;
+    }
+    bool addSaidMessageSize(int /*size*/) override
+    {
+        return true;
+    }
+
+    void sendProtocolItem(const Response & /*item*/) override
+    {
+    }
+    void sendProtocolItem(const SessionEvent & /*item*/) override
+    {
+        QMutexLocker locker(&mutex);
+        items.append("session");
+    }
+    void sendProtocolItem(const GameEventContainer &item) override
+    {
+        QStringList playerIds;
+        for (const GameEvent &event : item.event_list()) {
+            playerIds.append(QString::number(event.player_id()));
+        }
+        {
+            QMutexLocker locker(&mutex);
+            items.append("game " + playerIds.join(","));
+        }
+        if (onGameEvent) {
+            onGameEvent();
+        }
+    }
+    void sendProtocolItem(const RoomEvent & /*item*/) override
+    {
+    }
+
+    QStringList received() const
+    {
+        QMutexLocker locker(&mutex);
+        return items;
+    }
+
+private:
+    mutable QMutex mutex;
+    QStringList items;
+};
+
+/**
+ * A spectator together with the user interface it sends to.
+ */
+struct Watcher
+{
+    FakeUserInterface userInterface;
+    Server_Spectator spectator;
+
+    explicit Watcher(int playerId) : spectator(nullptr, playerId, ServerInfo_User(), false, &userInterface)
+    {
+    }
+};
+
+std::shared_ptr<const GameEventContainer> makeContainer(int playerId, bool withContext = false)
+{
+    auto cont = std::make_shared<GameEventContainer>();
+    cont->set_game_id(1);
+    cont->add_event_list()->set_player_id(playerId);
+    if (withContext) {
+        cont->mutable_context();
+    }
+    return cont;
+}
+
+void publishToAll(Server_SpectatorChannel &channel, int playerId, bool withContext = false)
+{
+    channel.publish(makeContainer(playerId, withContext),
+                    GameEventStorageItem::SendToPrivate | GameEventStorageItem::SendToOthers, -1, false);
+}
+
+/**
+ * Runs the event loop, which times the delayed deliveries, until the condition holds or a second has passed.
+ */
+bool waitFor(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > 1000) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        QThread::msleep(1);
+    }
+    return true;
+}
+} // namespace
+
+TEST(ServerSpectatorChannel, ContainersArriveInPublishOrder)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    broadcaster.setMaxThreadCount(4);
+    Watcher first(10), second(11);
+    Server_SpectatorChannel channel(&broadcaster, 0, 0);
+    channel.subscribe(&first.spectator);
+    channel.subscribe(&second.spectator);
+
+    QStringList expected;
+    for (int i = 0; i < 1000; ++i) {
+        publishToAll(channel, i);
+        expected.append(QString("game %1").arg(i));
+    }
+
+    ASSERT_TRUE(waitFor([&] { return second.userInterface.received().size() == expected.size(); }));
+    ASSERT_TRUE(waitFor([&] { return first.userInterface.received().size() == expected.size(); }));
+    EXPECT_EQ(first.userInterface.received(), expected);
+    EXPECT_EQ(second.userInterface.received(), expected);
+}
+
+TEST(ServerSpectatorChannel, PrivateContainersOnlyReachTheirPlayer)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher privateWatcher(10), otherWatcher(11);
+    Server_SpectatorChannel channel(&broadcaster, 0, 0);
+    channel.subscribe(&privateWatcher.spectator);
+    channel.subscribe(&otherWatcher.spectator);
+
+    channel.publish(makeContainer(1), GameEventStorageItem::SendToPrivate, 10, false);
+    channel.publish(makeContainer(2), GameEventStorageItem::SendToOthers, 10, false);
+    channel.publish(makeContainer(3), GameEventStorageItem::SendToPrivate, 10, true);
+    channel.close();
+
+    EXPECT_EQ(privateWatcher.userInterface.received(), QStringList({"game 1", "game 3"}));
+    EXPECT_EQ(otherWatcher.userInterface.received(), QStringList({"game 2", "game 3"}));
+}
+
+TEST(ServerSpectatorChannel, SubscriptionsChangedDuringADrain)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher leaving(10), staying(11), joining(12);
+    Server_SpectatorChannel channel(&broadcaster, 0, 0);
+
+    // the first delivery to the leaving spectator blocks the drain until it is released
+    QSemaphore delivering, release;
+    std::atomic<bool> blocked = false;
+    leaving.userInterface.onGameEvent = [&] {
+        if (!blocked.exchange(true)) {
+            delivering.release();
+            release.acquire();
+        }
+    };
+    channel.subscribe(&leaving.spectator);
+    channel.subscribe(&staying.spectator);
+    publishToAll(channel, 1);
+    ASSERT_TRUE(delivering.tryAcquire(1, 1000));
+    publishToAll(channel, 2);
+
+    std::atomic<bool> subscribed = false, unsubscribed = false;
+    std::unique_ptr<QThread> changer(QThread::create([&] {
+        channel.subscribe(&joining.spectator);
+        subscribed = true;
+        channel.unsubscribe(&leaving.spectator);
+        unsubscribed = true;
+    }));
+    changer->start();
+
+    // subscribing and unsubscribing another spectator don't wait for the running delivery, unsubscribing the
+    // spectator it sends to does
+    ASSERT_TRUE(waitFor([&] { return subscribed.load(); }));
+    channel.unsubscribe(&staying.spectator);
+    QThread::msleep(50);
+    EXPECT_FALSE(unsubscribed);
+    release.release();
+    ASSERT_TRUE(changer->wait(1000));
+    ASSERT_TRUE(unsubscribed);
+
+    publishToAll(channel, 3);
+    ASSERT_TRUE(waitFor([&] { return !joining.userInterface.received().isEmpty(); }));
+    channel.close();
+
+    // the spectator joined after the second container was published and left before the third
+    EXPECT_EQ(joining.userInterface.received(), QStringList({"game 3"}));
+    EXPECT_TRUE(staying.userInterface.received().isEmpty());
+    const QStringList left = leaving.userInterface.received();
+    ASSERT_FALSE(left.isEmpty());
+    EXPECT_EQ(left.first(), "game 1");
+    EXPECT_FALSE(left.contains("game 3"));
+}
+
+TEST(ServerSpectatorChannel, CoalescesContainersWithoutContext)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher first(10), second(11);
+    Server_SpectatorChannel channel(&broadcaster, 0, 100);
+    channel.subscribe(&first.spectator);
+
+    // nothing is delivered before the event loop runs the timer of the coalescing interval
+    publishToAll(channel, 1);
+    publishToAll(channel, 2);
+    publishToAll(channel, 3);
+    publishToAll(channel, 4, true);
+    publishToAll(channel, 5);
+    publishToAll(channel, 6);
+    channel.subscribe(&second.spectator);
+    publishToAll(channel, 7);
+    publishToAll(channel, 8);
+
+    const QStringList expected({"game 1,2,3", "game 4", "game 5,6", "game 7,8"});
+    ASSERT_TRUE(waitFor([&] { return first.userInterface.received().size() == expected.size(); }));
+    EXPECT_EQ(first.userInterface.received(), expected);
+    EXPECT_EQ(second.userInterface.received(), QStringList({"game 7,8"}));
+}
+
+TEST(ServerSpectatorChannel, CloseSendsEverythingRightAway)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher watcher(10);
+    Server_SpectatorChannel channel(&broadcaster, 10000, 0);
+    channel.subscribe(&watcher.spectator);
+    publishToAll(channel, 1);
+    publishToAll(channel, 2);
+    EXPECT_TRUE(watcher.userInterface.received().isEmpty());
+
+    channel.close();
+    EXPECT_EQ(watcher.userInterface.received(), QStringList({"game 1", "game 2"}));
+    EXPECT_FALSE(channel.hasSubscribers());
+
+    publishToAll(channel, 3);
+    channel.subscribe(&watcher.spectator);
+    QCoreApplication::processEvents();
+    EXPECT_EQ(watcher.userInterface.received().size(), 2);
+}
+
+TEST(ServerSpectatorChannel, CloseOnTheBroadcasterCallsBackAfterDelivery)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher watcher(10);
+    Server_SpectatorChannel channel(&broadcaster, 10000, 0);
+    channel.subscribe(&watcher.spectator);
+    publishToAll(channel, 1);
+    publishToAll(channel, 2);
+
+    std::atomic<bool> closed = false;
+    QStringList receivedWhenClosed;
+    channel.close([&] {
+        receivedWhenClosed = watcher.userInterface.received();
+        closed = true;
+    });
+    publishToAll(channel, 3);
+
+    ASSERT_TRUE(waitFor([&] { return closed.load(); }));
+    EXPECT_EQ(receivedWhenClosed, QStringList({"game 1", "game 2"}));
+    EXPECT_FALSE(channel.hasSubscribers());
+    EXPECT_EQ(watcher.userInterface.received(), receivedWhenClosed);
+}
+
+TEST(ServerSpectatorChannel, JoinedEventsAreDelayedToTheJoiningSpectator)
+{
+    Server_SpectatorBroadcaster broadcaster;
+    Watcher watching(10), joining(11);
+    Server_SpectatorChannel channel(&broadcaster, 200, 0);
+    channel.subscribe(&watching.spectator);
+
+    QElapsedTimer timer;
+    timer.start();
+    publishToAll(channel, 1);
+    channel.subscribe(&joining.spectator, std::make_shared<SessionEvent>(), makeContainer(100));
+    publishToAll(channel, 2);
+    EXPECT_TRUE(joining.userInterface.received().isEmpty());
+
+    ASSERT_TRUE(waitFor([&] { return joining.userInterface.received().size() == 3; }));
+    EXPECT_GE(timer.elapsed(), 150);
+    EXPECT_EQ(joining.userInterface.received(), QStringList({"session", "game 100", "game 2"}));
+    ASSERT_TRUE(waitFor([&] { return watching.userInterface.received().size() == 2; }));
+    EXPECT_EQ(watching.userInterface.received(), QStringList({"game 1", "game 2"}));
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,257 @@
+/** @file server_timer_wheel_performance_test.cpp
+ *  @brief Tests for the timer wheel and the ring counters of the server, and a benchmark of an idle server.
+ *  @ingroup Tests
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QList>
+#include <ctime>
+#include <gtest/gtest.h>
+#include <libcockatrice/network/server/remote/server_ring_counter.h>
+#include <libcockatrice/network/server/remote/server_timer_wheel.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr int connections = 10000;
+static constexpr int games = 3000;
+static constexpr int simulatedSeconds = 600;
+
+TEST(ServerTimerWheel, FiresAtExpiry)
+{
+    Server_TimerWheel wheel(100);
+    QList<qint64> fired;
+    Server_TimerWheel::Timer soon([&] { fired.append(wheel.now()); });
+    Server_TimerWheel::Timer later([&] { fired.append(wheel.now()); });
+    wheel.schedule(soon, 103);
+    wheel.schedule(later, 100 + 5000);
+    EXPECT_EQ(wheel.size(), 2);
+
+    wheel.advanceTo(102);
+    EXPECT_TRUE(fired.isEmpty());
+    wheel.advanceTo(103);
+    EXPECT_EQ(fired, QList<qint64>({103}));
+
+    wheel.advanceTo(5099);
+    EXPECT_EQ(fired.size(), 1);
+    wheel.advanceTo(6000);
+    EXPECT_EQ(fired, QList<qint64>({103, 5100}));
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(ServerTimerWheel, EveryDelayFiresOnTime)
+{
+    Server_TimerWheel wheel(7);
+    const std::vector<qint64> delays = {1, 2, 63, 64, 65, 127, 4095, 4096, 4097, 300000, 262144};
+    std::vector<qint64> firedAt(delays.size(), -1);
+    std::vector<std::unique_ptr<Server_TimerWheel::Timer>> timers;
+    for (size_t i = 0; i < delays.size(); ++i) {
+        timers.push_back(std::make_unique<Server_TimerWheel::Timer>([&, i] { firedAt[i] = wheel.now(); }));
+        wheel.scheduleIn(*timers.back(), delays[i]);
+    }
+
+    wheel.advanceTo(7 + 400000);
+    for (size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_EQ(firedAt[i], 7 + delays[i]) << "delay " << delays[i];
+    }
+}
+
+TEST(ServerTimerWheel, DelaysBeyondTheWheelArePlacedAgain)
+{
+    Server_TimerWheel wheel;
+    qint64 firedAt = -1;
+    Server_TimerWheel::Timer timer([&] { firedAt = wheel.now(); });
+    const qint64 expiry = Server_TimerWheel::MaxDelay + 1000;
+    wheel.schedule(timer, expiry);
+
+    wheel.advanceTo(Server_TimerWheel::MaxDelay);
+    EXPECT_EQ(firedAt, -1);
+    EXPECT_TRUE(timer.isScheduled());
+    wheel.advanceTo(expiry);
+    EXPECT_EQ(firedAt, expiry);
+}
+
+TEST(ServerTimerWheel, CancelAndReschedule)
+{
+    Server_TimerWheel wheel;
+    int count = 0;
+    Server_TimerWheel::Timer timer([&] { ++count; });
+    wheel.schedule(timer, 10);
+    timer.cancel();
+    EXPECT_FALSE(timer.isScheduled());
+    wheel.advanceTo(20);
+    EXPECT_EQ(count, 0);
+
+    wheel.schedule(timer, 30);
+    wheel.schedule(timer, 25);
+    EXPECT_EQ(wheel.size(), 1);
+    wheel.advanceTo(40);
+    EXPECT_EQ(count, 1);
+
+    {
+        Server_TimerWheel::Timer destroyed([&] { ++count; });
+        wheel.schedule(destroyed, 45);
+    }
+    EXPECT_EQ(wheel.size(), 0);
+    wheel.advanceTo(50);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(ServerTimerWheel, CallbacksCanRescheduleThemselves)
+{
+    Server_TimerWheel wheel;
+    int count = 0;
+    Server_TimerWheel::Timer timer;
+    timer.setCallback([&] {
+        ++count;
+        wheel.scheduleIn(timer, 1);
+    });
+    wheel.schedule(timer, 1);
+    wheel.advanceTo(200);
+    EXPECT_EQ(count, 200);
+}
+
+TEST(ServerTimerWheel, PastExpiryFiresOnNextTick)
+{
+    Server_TimerWheel wheel(50);
+    qint64 firedAt = -1;
+    Server_TimerWheel::Timer timer([&] { firedAt = wheel.now(); });
+    wheel.schedule(timer, 10);
+    wheel.advanceTo(51);
+    EXPECT_EQ(firedAt, 51);
+}
+
+TEST(ServerTimerWheel, RandomDeadlinesFireInOrder)
+{
+    Server_TimerWheel wheel(1000);
+    std::mt19937 random(49);
+    std::uniform_int_distribution<qint64> delay(1, 20000);
+    std::vector<std::unique_ptr<Server_TimerWheel::Timer>> timers;
+    std::vector<qint64> expected, firedAt;
+    for (int i = 0; i < 2000; ++i) {
+        firedAt.push_back(-1);
+        timers.push_back(std::make_unique<Server_TimerWheel::Timer>([&, i] { firedAt[i] = wheel.now(); }));
+        expected.push_back(1000 + delay(random));
+        wheel.schedule(*timers.back(), expected.back());
+    }
+    for (int i = 0; i < 2000; i += 7) {
+        timers[i]->cancel();
+        expected[i] = -1;
+    }
+
+    for (qint64 time = 1000; time <= 22000; time += 333) {
+        wheel.advanceTo(time);
+    }
+    EXPECT_EQ(firedAt, expected);
+}
+
+TEST(ServerRingCounter, WindowMovesWithTime)
+{
+    Server_RingCounter counter(3);
+    EXPECT_EQ(counter.add(10, 2), 2);
+    EXPECT_EQ(counter.add(11, 3), 5);
+    EXPECT_EQ(counter.add(12, 1), 6);
+    EXPECT_EQ(counter.add(13, 1), 5);
+    EXPECT_EQ(counter.total(14), 2);
+    EXPECT_EQ(counter.total(16), 0);
+    EXPECT_EQ(counter.add(100, 4), 4);
+}
+
+TEST(ServerRingCounter, SingleSlotAccumulatesWithinATick)
+{
+    Server_RingCounter counter;
+    counter.add(0, 1);
+    EXPECT_EQ(counter.add(0, 1), 2);
+    EXPECT_EQ(counter.add(1, 1), 1);
+
+    counter.setSlotCount(2);
+    EXPECT_EQ(counter.total(1), 0);
+}
+
+namespace
+{
+/**
+ * A connection as the protocol handler keeps it: one deadline, data arriving in between only moves the last data
+ * time and is counted for the flood limits.
+ */
+struct IdleConnection
+{
+    static constexpr int maxInactivityTime = 15;
+
+    Server_TimerWheel *wheel;
+    Server_TimerWheel::Timer deadline;
+    Server_RingCounter messageCount{10};
+    qint64 lastDataReceived;
+    int checks = 0;
+    bool disconnected = false;
+
+    IdleConnection(Server_TimerWheel *_wheel) : wheel(_wheel), lastDataReceived(_wheel->now())
+    {
+        deadline.setCallback([this] { check(); });
+        check();
+    }
+
+    void check()
+    {
+        ++checks;
+        if (wheel->now() - lastDataReceived > maxInactivityTime) {
+            disconnected = true;
+            return;
+        }
+        wheel->schedule(deadline, lastDataReceived + maxInactivityTime + 1);
+    }
+
+    void receive()
+    {
+        lastDataReceived = wheel->now();
+        messageCount.add(lastDataReceived, 1);
+    }
+};
+} // namespace
+
+TEST(ServerTimerWheel, IdleServerPerformance)
+{
+    Server_TimerWheel wheel;
+    std::vector<std::unique_ptr<IdleConnection>> clients;
+    for (int i = 0; i < connections; ++i) {
+        clients.push_back(std::make_unique<IdleConnection>(&wheel));
+    }
+
+    // every game checks the pings of its players once a second
+    int pingChecks = 0;
+    std::vector<std::unique_ptr<Server_TimerWheel::Timer>> gameClocks;
+    for (int i = 0; i < games; ++i) {
+        auto *gameClock = new Server_TimerWheel::Timer;
+        gameClock->setCallback([&, gameClock] {
+            ++pingChecks;
+            wheel.scheduleIn(*gameClock, 1);
+        });
+        gameClocks.emplace_back(gameClock);
+        wheel.scheduleIn(*gameClock, 1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const std::clock_t cpuStart = std::clock();
+    for (int second = 1; second <= simulatedSeconds; ++second) {
+        wheel.advanceTo(second);
+        // each client sends something every few seconds, like the keepalive pings of an idle client
+        for (int i = second % 5; i < connections; i += 5) {
+            clients[i]->receive();
+        }
+    }
+    const double cpuMsecs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    long long connectionChecks = 0;
+    for (const auto &client : clients) {
+        ASSERT_FALSE(client->disconnected);
+        connectionChecks += client->checks;
+    }
+    qDebug() << connections << "connections and" << games << "games idling for" << simulatedSeconds << "seconds took"
+             << timer.elapsed() << "ms," << cpuMsecs << "ms of cpu," << connectionChecks << "connection checks";
+
+    ASSERT_EQ(pingChecks, games * simulatedSeconds);
+    // a clock tick per connection and second would be 6 million
+    ASSERT_LT(connectionChecks, static_cast<long long>(connections) * simulatedSeconds / 10);
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <libcockatrice/utility/text_pattern_matcher.h>
+
+static constexpr int highlightWords = 500;
+static constexpr int messages = 20000;
+
+static QString matchedText(const QString &text, const TextPatternMatcher::Match &match)
+{
+    return text.mid(match.start, match.length);
+}
+
+TEST(TextPatternMatcherTest, WholeWordsOnly)
+{
+    TextPatternMatcher matcher;
+    matcher.addPattern("word", 1);
+    matcher.build();
+
+    const QString text = "word sword words (word)! word-play Word";
+    const auto matches = matcher.findAll(text);
+    ASSERT_EQ(matches.size(), 3);
+    ASSERT_EQ(matches[0].start, 0);
+    ASSERT_EQ(matches[1].start, text.indexOf("(word)") + 1);
+    ASSERT_EQ(matchedText(text, matches[2]), "Word");
+}
+
+TEST(TextPatternMatcherTest, LongestMatchWins)
+{
+    TextPatternMatcher matcher;
+    matcher.addPattern("bob", 1);
+    matcher.addPattern("@bob", 2);
+    matcher.addPattern("he", 3);
+    matcher.addPattern("hers", 4);
+    matcher.build();
+
+    const QString text = "hi @BOB, hers he";
+    const auto matches = matcher.findAll(text);
+    ASSERT_EQ(matches.size(), 3);
+    ASSERT_EQ(matchedText(text, matches[0]), "@BOB");
+    ASSERT_EQ(matches[0].tag, 2);
+    ASSERT_EQ(matches[1].tag, 4);
+    ASSERT_EQ(matches[2].tag, 3);
+}
+
+TEST(TextPatternMatcherTest, FirstTagWinsAndEmptyPatternsAreIgnored)
+{
+    TextPatternMatcher matcher;
+    ASSERT_TRUE(matcher.isEmpty());
+    matcher.addPattern("", 1);
+    ASSERT_TRUE(matcher.isEmpty());
+    matcher.addPattern("Alert", 2);
+    matcher.addPattern("alert", 3);
+    matcher.build();
+
+    const auto matches = matcher.findAll("ALERT");
+    ASSERT_EQ(matches.size(), 1);
+    ASSERT_EQ(matches[0].tag, 2);
+}
+
+TEST(TextPatternMatcherTest, ManyPatterns)
+{
+    TextPatternMatcher matcher;
+    for (int i = 0; i < highlightWords; ++i) {
+        matcher.addPattern(QString("word%1").arg(i), i);
+    }
+    matcher.addPattern("@moderator", -1);
+    matcher.build();
+
+    QStringList lines;
+    for (int i = 0; i < messages; ++i) {
+        lines << QString("message %1 from a busy room, mentioning word%2 and @moderator, ending with %3!")
+                     .arg(i)
+                     .arg(i % (highlightWords * 2))
+                     .arg(i * 7);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int found = 0;
+    for (const QString &line : lines) {
+        found += matcher.findAll(line).size();
+    }
+    qDebug() << messages << "messages against" << highlightWords << "patterns took" << timer.elapsed() << "ms";
+
+    // half of the messages mention a highlight word, every message mentions the moderator
+    ASSERT_EQ(found, messages / 2 + messages);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}